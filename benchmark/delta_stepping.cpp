@@ -0,0 +1,146 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+// Compares the delta-stepping shortest path cores with the Bellman-Ford ones on a road-like
+// graph: a side x side grid of two-way roads with random lengths, plus a few long highways
+// between random crossings. SPSPCore is an unweighted BFS, so the single pair search is
+// compared with SSSPCore, the only weighted search there was.
+//
+// g++ -fopenmp -std=c++17 -I../deps/fma-common -I../include -I../src -I../procedures/algo_cpp
+//     -O3 -g -o delta_stepping delta_stepping.cpp ../procedures/algo_cpp/sssp_core.cpp
+//     ../procedures/algo_cpp/mssp_core.cpp ../procedures/algo_cpp/spsp_core.cpp
+//     ../build/output/liblgraph.so -lgflags
+// ./delta_stepping <side> <num_threads> [delta]
+
+#include <omp.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "olap/olap_on_disk.h"
+#include "./algo.h"
+
+double GetTime() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+class RandomNumberGenerator {
+    uint64_t s[2];
+
+ public:
+    explicit RandomNumberGenerator(uint64_t seed) {
+        s[0] = seed * 0x9E3779B97F4A7C15ull + 1;
+        s[1] = s[0] ^ 0xBF58476D1CE4E5B9ull;
+    }
+    uint64_t next() {
+        uint64_t s1 = s[0];
+        const uint64_t s0 = s[1];
+        s[0] = s0;
+        s1 ^= s1 << 23;
+        s[1] = s1 ^ s0 ^ (s1 >> 17) ^ (s0 >> 26);
+        return s[1] + s0;
+    }
+};
+
+// each road is loaded once, DUAL_DIRECTION makes it two-way
+std::vector<EdgeUnit<double>> MakeRoadGraph(size_t side) {
+    RandomNumberGenerator rng(side);
+    std::vector<EdgeUnit<double>> edges;
+    auto add_edge = [&](size_t src, size_t dst, double length) {
+        EdgeUnit<double> edge;
+        edge.src = src;
+        edge.dst = dst;
+        edge.edge_data = length;
+        edges.push_back(edge);
+    };
+    for (size_t r = 0; r < side; r++) {
+        for (size_t c = 0; c < side; c++) {
+            size_t v = r * side + c;
+            if (c + 1 < side) add_edge(v, v + 1, 1 + rng.next() % 100);
+            if (r + 1 < side) add_edge(v, v + side, 1 + rng.next() % 100);
+        }
+    }
+    size_t num_vertices = side * side;
+    for (size_t i = 0; i < side; i++) {
+        size_t src = rng.next() % num_vertices;
+        size_t dst = rng.next() % num_vertices;
+        // a highway is about twice as fast as the roads between its ends
+        double length = 25.0 * (std::abs((double)(src / side) - (double)(dst / side)) +
+                                std::abs((double)(src % side) - (double)(dst % side)));
+        add_edge(src, dst, length + 1);
+    }
+    return edges;
+}
+
+size_t CountMismatches(OlapBase<double>& graph, ParallelVector<double>& expected,
+                       ParallelVector<double>& actual) {
+    size_t mismatches = 0;
+    for (size_t v = 0; v < graph.NumVertices(); v++) {
+        if (expected[v] != actual[v]) mismatches++;
+    }
+    return mismatches;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " <side> <num_threads> [delta]" << std::endl;
+        return 1;
+    }
+    size_t side = std::atol(argv[1]);
+    int num_threads = std::atoi(argv[2]);
+    double delta = argc > 3 ? std::atof(argv[3]) : 0;
+    omp_set_num_threads(num_threads);
+
+    auto edges = MakeRoadGraph(side);
+    OlapOnDisk<double> graph;
+    graph.LoadFromArray((char*)edges.data(), side * side, edges.size(), DUAL_DIRECTION);
+    size_t root = 0;
+    std::vector<size_t> roots = {0, side * side - 1, side * side / 2};
+    std::pair<size_t, size_t> search_pair(0, side * side - 1);
+
+    auto expected = graph.AllocVertexArray<double>();
+    auto actual = graph.AllocVertexArray<double>();
+    double time_start = GetTime();
+    SSSPCore(graph, root, expected);
+    double bf_cost = GetTime() - time_start;
+    time_start = GetTime();
+    SSSPDeltaCore(graph, root, actual, delta);
+    double ds_cost = GetTime() - time_start;
+    std::cout << "sssp: bellman-ford " << bf_cost << "s, delta-stepping " << ds_cost
+              << "s, mismatches " << CountMismatches(graph, expected, actual) << std::endl;
+
+    time_start = GetTime();
+    MSSPCore(graph, roots, expected);
+    bf_cost = GetTime() - time_start;
+    time_start = GetTime();
+    MSSPDeltaCore(graph, roots, actual, delta);
+    ds_cost = GetTime() - time_start;
+    std::cout << "mssp: bellman-ford " << bf_cost << "s, delta-stepping " << ds_cost
+              << "s, mismatches " << CountMismatches(graph, expected, actual) << std::endl;
+
+    time_start = GetTime();
+    SSSPCore(graph, search_pair.first, expected);
+    bf_cost = GetTime() - time_start;
+    time_start = GetTime();
+    double length = SPSPDeltaCore(graph, search_pair, delta);
+    ds_cost = GetTime() - time_start;
+    std::cout << "spsp: bellman-ford " << bf_cost << "s, delta-stepping " << ds_cost
+              << "s, length " << length << " (expected " << expected[search_pair.second]
+              << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,225 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+// Compares the storage engines behind KvStore on the key-value access patterns of the simple
+// benchmark: vertices are written in ascending order of vid, edges are written to random
+// vertices, a neighborhood lookup reads the keys of one vertex.
+//
+// g++ -fopenmp -std=c++17 -I../deps/fma-common -I../include -I../src
+//     -I../deps/install/include -O3 -g -o kv_engine kv_engine.cpp
+//     ../build/output/liblgraph.so -lgflags
+// ./kv_engine <dir> <lmdb|rocksdb> <n> <num_threads>
+
+#include <omp.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lgraph/lgraph_exceptions.h"
+#include "core/kv_store.h"
+
+using namespace lgraph;
+
+static const size_t VID_SIZE = 5;
+static const size_t VALUE_SIZE = 20;  // "no" and "name" of the simple benchmark
+
+double GetTime() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+class RandomNumberGenerator {
+    uint64_t s[2];
+
+ public:
+    explicit RandomNumberGenerator(uint64_t seed) {
+        s[0] = seed * 0x9E3779B97F4A7C15ull + 1;
+        s[1] = s[0] ^ 0xBF58476D1CE4E5B9ull;
+    }
+    uint64_t next() {
+        uint64_t s1 = s[0];
+        const uint64_t s0 = s[1];
+        s[0] = s0;
+        s1 ^= s1 << 23;
+        s[1] = s1 ^ s0 ^ (s1 >> 17) ^ (s0 >> 26);
+        return s[1] + s0;
+    }
+};
+
+// vid in big endian, followed by the vid of the other end of an edge, like the keys of the
+// graph table, so the keys of a vertex are next to each other
+std::string MakeKey(uint64_t vid, int64_t dst = -1) {
+    std::string key(dst < 0 ? VID_SIZE : 2 * VID_SIZE, 0);
+    for (size_t i = 0; i < VID_SIZE; i++) key[i] = (char)(vid >> (8 * (VID_SIZE - 1 - i)));
+    for (size_t i = VID_SIZE; i < key.size(); i++)
+        key[i] = (char)((uint64_t)dst >> (8 * (2 * VID_SIZE - 1 - i)));
+    return key;
+}
+
+class KvEngineBenchmark {
+    std::unique_ptr<KvStore> store_;
+    std::unique_ptr<KvTable> table_;
+    std::string value_ = std::string(VALUE_SIZE, 'v');
+    std::atomic<uint64_t> vertices_{0};
+
+ public:
+    KvEngineBenchmark(const std::string& dir, const std::string& engine) {
+        if (engine == "rocksdb") {
+            store_ = std::make_unique<RocksDBKvStore>(dir);
+        } else {
+            store_ = std::make_unique<LMDBKvStore>(dir, (size_t)1 << 40);
+        }
+        auto txn = store_->CreateWriteTxn();
+        // the table has the name of the graph table, so it is set up like one
+        table_ = store_->OpenTable(*txn, "_graph_", true, ComparatorDesc::DefaultComparator());
+        txn->Commit();
+    }
+
+    double WriteVertexBatch(size_t count, size_t batch) {
+        double time_start = GetTime();
+        for (size_t i = 0; i < count; i += batch) {
+            auto txn = store_->CreateWriteTxn();
+            for (size_t j = i; j < i + batch && j < count; j++) {
+                table_->AppendKv(*txn, Value::ConstRef(MakeKey(vertices_++)),
+                                 Value::ConstRef(value_));
+            }
+            txn->Commit();
+        }
+        return count / (GetTime() - time_start);
+    }
+
+    double WriteEdgeBatch(size_t count, size_t batch) {
+        RandomNumberGenerator rng(count);
+        double time_start = GetTime();
+        for (size_t i = 0; i < count; i += batch) {
+            auto txn = store_->CreateWriteTxn();
+            for (size_t j = i; j < i + batch && j < count; j++) {
+                table_->SetValue(*txn,
+                                 Value::ConstRef(MakeKey(rng.next() % vertices_,
+                                                         rng.next() % vertices_)),
+                                 Value::ConstRef(value_));
+            }
+            txn->Commit();
+        }
+        return count / (GetTime() - time_start);
+    }
+
+    // each thread writes its own edges, the writers of lmdb and of pessimistic rocksdb txns
+    // wait for each other, optimistic ones only fail if they write the same key
+    double WriteEdgeMt(size_t count, size_t num_threads, bool optimistic) {
+        omp_set_num_threads(num_threads);
+        std::atomic<size_t> conflicts(0);
+        double time_start = GetTime();
+#pragma omp parallel
+        {
+            RandomNumberGenerator rng(omp_get_thread_num() + count);
+            for (size_t i = 0; i < count / num_threads; i++) {
+                try {
+                    auto txn = store_->CreateWriteTxn(optimistic);
+                    table_->SetValue(*txn,
+                                     Value::ConstRef(MakeKey(rng.next() % vertices_,
+                                                             rng.next() % vertices_)),
+                                     Value::ConstRef(value_));
+                    txn->Commit();
+                } catch (lgraph_api::LgraphException& e) {
+                    if (e.code() != lgraph_api::ErrorCode::TxnConflict) throw;
+                    conflicts++;
+                }
+            }
+        }
+        double throughput = count / (GetTime() - time_start);
+        std::cout << "conflicts: " << conflicts << std::endl;
+        return throughput;
+    }
+
+    size_t ReadNeighbour(KvTransaction& txn, uint64_t vid) {
+        size_t n = 0;
+        std::string key = MakeKey(vid);
+        auto it = table_->GetClosestIterator(txn, Value::ConstRef(key));
+        for (; it->IsValid(); it->Next()) {
+            Value k = it->GetKey();
+            if (k.Size() < VID_SIZE || memcmp(k.Data(), key.data(), VID_SIZE) != 0) break;
+            n += it->GetValue().Size();
+        }
+        return n;
+    }
+
+    double ReadNeighbourMt(size_t count, size_t num_threads) {
+        omp_set_num_threads(num_threads);
+        size_t checksum = 0;
+        double time_start = GetTime();
+#pragma omp parallel reduction(+ : checksum)
+        {
+            RandomNumberGenerator rng(omp_get_thread_num());
+            auto txn = store_->CreateReadTxn();
+            for (size_t i = 0; i < count / num_threads; i++)
+                checksum += ReadNeighbour(*txn, rng.next() % vertices_);
+        }
+        double throughput = count / (GetTime() - time_start);
+        std::cout << "checksum: " << checksum << std::endl;
+        return throughput;
+    }
+
+    double GetVertexMt(size_t count, size_t num_threads) {
+        omp_set_num_threads(num_threads);
+        size_t checksum = 0;
+        double time_start = GetTime();
+#pragma omp parallel reduction(+ : checksum)
+        {
+            RandomNumberGenerator rng(omp_get_thread_num());
+            auto txn = store_->CreateReadTxn();
+            for (size_t i = 0; i < count / num_threads; i++) {
+                checksum += table_->GetValue(*txn, Value::ConstRef(MakeKey(rng.next() %
+                                                                           vertices_)))
+                                .Size();
+            }
+        }
+        double throughput = count / (GetTime() - time_start);
+        std::cout << "checksum: " << checksum << std::endl;
+        return throughput;
+    }
+};
+
+int main(int argc, char** argv) {
+    if (argc < 5) {
+        std::cerr << "usage: " << argv[0] << " <dir> <lmdb|rocksdb> <n> <num_threads>"
+                  << std::endl;
+        return 1;
+    }
+    std::string dir(argv[1]);
+    std::string engine(argv[2]);
+    size_t n = std::atol(argv[3]);
+    size_t num_threads = std::atol(argv[4]);
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    KvEngineBenchmark bm(dir, engine);
+    std::cout << "vertex insertion (batch): " << bm.WriteVertexBatch(n, 20000) << std::endl;
+    std::cout << "edge insertion (batch): " << bm.WriteEdgeBatch(n * 10, 20000) << std::endl;
+    std::cout << "edge insertion: " << bm.WriteEdgeMt(n, num_threads, false) << std::endl;
+    if (engine == "rocksdb") {
+        std::cout << "edge insertion (optimistic): " << bm.WriteEdgeMt(n, num_threads, true)
+                  << std::endl;
+    }
+    std::cout << "vertex lookup: " << bm.GetVertexMt(n, num_threads) << std::endl;
+    std::cout << "neighborhood lookup: " << bm.ReadNeighbourMt(n, num_threads) << std::endl;
+    return 0;
+}
@@ -192,4 +192,6 @@ cdef extern from "lgraph/lgraph_db.h" namespace "lgraph_api":
         Transaction CreateReadTxn()
         Transaction CreateWriteTxn()
         Transaction CreateWriteTxn(bint optimistic)
-        Transaction ForkTxn(Transaction & txn) nogil
\ No newline at end of file
+        Transaction ForkTxn(Transaction & txn) nogil
+        Transaction CreateSnapshotReadTxn()
+        Transaction CreateSnapshotReadTxn(double max_age_seconds)
\ No newline at end of file
@@ -0,0 +1,51 @@
+# distutils: language = c++
+from olap_base cimport *
+from lgraph_db cimport *
+from libcpp.string cimport string
+
+cdef extern from "lgraph/olap_sampling.h" namespace "lgraph_api::olap" :
+    cdef cppclass SubgraphSampler[EdgeData]:
+        SubgraphSampler(OlapOnDB[EdgeData] & graph, uint64_t seed) except +
+        void NeighborSample(const size_t *seeds, size_t num_seeds, size_t fanout) except + nogil
+        void RandomWalk(const size_t *seeds, size_t num_seeds, size_t walk_length) except + nogil
+        void Node2VecWalk(const size_t *seeds, size_t num_seeds, size_t walk_length, size_t num_walks, double p, double q, int64_t *walks) except + nogil
+        void EdgeSample(double sample_rate) except + nogil
+        void NegativeSample(size_t num_samples) except + nogil
+        size_t NumNodes() nogil
+        size_t NumEdges() nogil
+        void Export(GraphDB & db, const string & feature_key, const string & label_key, size_t feature_num, int64_t *nodes, float *features, int64_t *labels, int64_t *vertex_types, int64_t *src, int64_t *dst, int64_t *edge_types) except + nogil
+        void Clear() nogil
+
+ctypedef fused Sampler:
+    SubgraphSampler[Empty]
+    SubgraphSampler[double]
+
+# Allocates the numpy arrays of a sampled batch, fills them in place with
+# Sampler.Export and appends them to NodeInfo ([node, feature, label,
+# vertex_type]) and EdgeInfo ([src, dst, edge_type]). The arrays are
+# contiguous, so torch.from_numpy / torch.from_dlpack share their memory.
+cdef inline void ExportBatch(Sampler *sampler, GraphDB *db, size_t feature_num, list NodeInfo, list EdgeInfo) except *:
+    import numpy as np
+    cdef size_t num_nodes = sampler.NumNodes()
+    cdef size_t num_edges = sampler.NumEdges()
+    node = np.empty((num_nodes,), dtype=np.int64)
+    feature = np.zeros((num_nodes, feature_num), dtype=np.float32)
+    label = np.zeros((num_nodes,), dtype=np.int64)
+    vertex_type = np.zeros((num_nodes,), dtype=np.int64)
+    src = np.empty((num_edges,), dtype=np.int64)
+    dst = np.empty((num_edges,), dtype=np.int64)
+    edge_type = np.zeros((num_edges,), dtype=np.int64)
+    cdef int64_t *node_ptr = <int64_t *><size_t>node.ctypes.data
+    cdef float *feature_ptr = <float *><size_t>feature.ctypes.data
+    cdef int64_t *label_ptr = <int64_t *><size_t>label.ctypes.data
+    cdef int64_t *vertex_type_ptr = <int64_t *><size_t>vertex_type.ctypes.data
+    cdef int64_t *src_ptr = <int64_t *><size_t>src.ctypes.data
+    cdef int64_t *dst_ptr = <int64_t *><size_t>dst.ctypes.data
+    cdef int64_t *edge_type_ptr = <int64_t *><size_t>edge_type.ctypes.data
+    cdef string feature_key = b"feature_float"
+    cdef string label_key = b"label"
+    with nogil:
+        sampler.Export(db[0], feature_key, label_key, feature_num, node_ptr, feature_ptr,
+                       label_ptr, vertex_type_ptr, src_ptr, dst_ptr, edge_type_ptr)
+    NodeInfo.extend([node, feature, label, vertex_type])
+    EdgeInfo.extend([src, dst, edge_type])
@@ -155,6 +155,23 @@ class GraphDB {
      */
     Transaction ForkTxn(Transaction &txn);
 
+    /**
+     * @brief   Creates a read transaction on a point-in-time copy of the graph, for long
+     *          analytics such as an OlapOnDB extraction. A long read transaction on the graph
+     *          keeps the pages it reads from being reused, so the data file grows while others
+     *          write. A transaction on a copy does not, however long it runs. A copy is shared
+     *          by the transactions created while it is at most max_age_seconds old, and is
+     *          deleted when the last one ends. Plugins and fulltext indexes cannot be used in
+     *          the transaction.
+     *
+     * @exception   InvalidGraphDB Thrown when currently GraphDB is invalid.
+     *
+     * @param   max_age_seconds (Optional) How old a copy made earlier can be to be read.
+     *
+     * @returns The new read transaction.
+     */
+    Transaction CreateSnapshotReadTxn(double max_age_seconds = 60);
+
     /**
      * @brief   Flushes buffered data to disk. If there have been some async transactions, there
      *          could be data that are written to this graph, but not persisted to disk yet.
@@ -551,6 +568,37 @@ class GraphDB {
      */
     bool DeleteVectorIndex(bool is_vertex, const std::string& label, const std::string& field);
 
+    /**
+     * @brief   Keeps the values of 'vertex_label:field' in a column store as well, so that
+     *          scans and aggregates of the field read that field only. The column is built
+     *          from the existing vertices before returning.
+     *
+     * @exception   InvalidGraphDB     Thrown when currently GraphDB is invalid.
+     * @exception   WriteNotAllowed    Thrown when called on a GraphDB with read-only access level.
+     * @exception   InputError         Thrown if label or field does not exist, or the field is a
+     *                                 BLOB or FLOAT_VECTOR.
+     *
+     * @param   label   The label.
+     * @param   field   The field.
+     *
+     * @returns True if it succeeds, false if the column already exists.
+     */
+    bool AddVertexColumn(const std::string& label, const std::string& field);
+
+    /**
+     * @brief   Deletes the column store of 'vertex_label:field'
+     *
+     * @exception   InvalidGraphDB     Thrown when currently GraphDB is invalid.
+     * @exception   WriteNotAllowed    Thrown when called on a GraphDB with read-only access level.
+     * @exception   InputError         Thrown if label or field does not exist.
+     *
+     * @param   label   The label.
+     * @param   field   The field.
+     *
+     * @returns True if it succeeds, false if the column does not exist.
+     */
+    bool DeleteVertexColumn(const std::string& label, const std::string& field);
+
     /**
      * @brief   Get graph description
      *
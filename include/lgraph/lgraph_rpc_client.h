@@ -259,6 +259,13 @@ class RpcClient {
          */
         std::string GetUrl();
 
+        /**
+         * @brief   Set the staleness allowed for reads, see RpcClient::SetMaxStaleness.
+         *
+         * @param   max_staleness_ms    Staleness in milliseconds, negative for no guarantee.
+         */
+        void SetMaxStaleness(int64_t max_staleness_ms);
+
         /**
          * @brief   Client log out
          */
@@ -285,6 +292,7 @@ class RpcClient {
         std::string password;
         std::string token;
         int64_t server_version;
+        int64_t max_staleness_ms = -1;
         // A Channel represents a communication line to a Server. Notice that
         // Channel is thread-safe and can be shared by all threads in your program.
         std::shared_ptr<lgraph_rpc::m_channel> channel;
@@ -571,6 +579,17 @@ class RpcClient {
 
     int64_t Restore(const std::vector<BackupLogEntry>& requests);
 
+    /**
+     * @brief   Set how stale the reads served by followers may be. With 0, a follower
+     *          serves a read only after applying everything the master had applied when the
+     *          read arrived, so reads are linearizable. With a positive value, the follower
+     *          may use the master's applied index it learned at most that long ago. A
+     *          negative value, the default, reads whatever the follower has applied.
+     *
+     * @param   max_staleness_ms    Staleness in milliseconds.
+     */
+    void SetMaxStaleness(int64_t max_staleness_ms);
+
     /**
      * @brief   Client log out
      */
@@ -578,6 +597,7 @@ class RpcClient {
 
  private:
     ClientType client_type;
+    int64_t max_staleness_ms = -1;
     std::string user;
     std::string password;
 
@@ -8,6 +8,8 @@
 //  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 
 #pragma once
+#include <functional>
+#include <limits>
 #include <memory>
 #include <string>
 #include <type_traits>
@@ -599,6 +601,26 @@ class Transaction {
      */
     bool IsEdgeIndexed(const std::string& label, const std::string& field);
 
+    /**
+     * @brief   Calls f(vid, value) for the non-null values of 'vertex_label:field' of the
+     *          vertices in [vid_start, vid_end), in ascending order of vid, reading the column
+     *          store of the field instead of the vertices. Stops if f returns false.
+     *
+     * @exception   InvalidTxn          Thrown when called on an invalid transaction.
+     * @exception   InputError          Thrown if label or field does not exist, or the field
+     *                                  has no column store.
+     *
+     * @param   label       The label.
+     * @param   field       The field.
+     * @param   f           The function called for each value.
+     * @param   vid_start   The first vid.
+     * @param   vid_end     The vid after the last one.
+     */
+    void ScanVertexColumn(const std::string& label, const std::string& field,
+                          const std::function<bool(int64_t, const FieldData&)>& f,
+                          int64_t vid_start = 0,
+                          int64_t vid_end = std::numeric_limits<int64_t>::max());
+
     /**
      * @brief   Gets vertex by unique index. Throws exception if there is no such vertex.
      *
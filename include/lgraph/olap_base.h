@@ -23,6 +23,10 @@
 #include <omp.h>
 #include <string.h>
 #include <sys/mman.h>
+#include <fcntl.h>
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
 
 #include <algorithm>
 #include <condition_variable>
@@ -30,6 +34,7 @@
 #include <future>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <type_traits>
 #include <utility>
@@ -627,6 +632,296 @@ class VertexLockGuard {
     ~VertexLockGuard();
 };
 
+/**
+ * @brief   BucketedFrontier keeps active vertices in buckets ordered by
+ *          priority, e.g. the tentative distance divided by the bucket
+ *          width in delta-stepping. Vertices are pushed into thread-local
+ *          buckets while a parallel step is running, and Advance() gathers
+ *          the lowest non-empty bucket into the frontier of the next step.
+ *
+ *          Only the N_CYCLIC_BUCKETS buckets from the current one on are
+ *          kept as a ring, vertices pushed further go to an overflow list
+ *          which is redistributed when the ring reaches them. So the memory
+ *          used is bounded by the pushes, whatever the bucket indexes.
+ *
+ *          A vertex may be pushed several times, so the work function should
+ *          skip entries that have become stale.
+ */
+class BucketedFrontier {
+ public:
+    static constexpr size_t N_CYCLIC_BUCKETS = 64;
+
+ private:
+    struct LocalBuckets {
+        // bucket b is ring[b % N_CYCLIC_BUCKETS] while it is within the ring
+        std::vector<std::vector<size_t> > ring;
+        // (vid, bucket) of the vertices pushed beyond the ring
+        std::vector<std::pair<size_t, size_t> > overflow;
+        size_t min_overflow = (size_t)-1;
+    };
+    std::vector<LocalBuckets> local_buckets_;
+    std::vector<size_t> frontier_;
+    size_t curr_bucket_;
+
+ public:
+    BucketedFrontier();
+
+    BucketedFrontier(const BucketedFrontier &rhs) = delete;
+    BucketedFrontier(BucketedFrontier &&rhs) = default;
+    BucketedFrontier& operator=(BucketedFrontier &&rhs) = default;
+
+    /**
+     * @brief   Push a vertex into a bucket. This is thread-safe when called
+     *          from the work function of a parallel process.
+     *
+     * @param   vid     The vertex id (in the Graph) to push.
+     * @param   bucket  The bucket to push into. A bucket lower than the
+     *                  current one is taken as the current one.
+     */
+    void Push(size_t vid, size_t bucket);
+
+    /**
+     * @brief   Move the lowest non-empty bucket into the frontier. This should
+     *          not be called while a parallel step is running.
+     *
+     * @return  False if all buckets are empty.
+     */
+    bool Advance();
+
+    /**
+     * @brief   Get the index of the bucket held by the frontier.
+     *
+     * @return  The index of the current bucket.
+     */
+    size_t CurrentBucket() const { return curr_bucket_; }
+
+    /**
+     * @brief   Get the number of vertices in the frontier.
+     *
+     * @return  The number of vertices in the frontier.
+     */
+    size_t Size() const { return frontier_.size(); }
+
+    size_t operator[](size_t i) const { return frontier_[i]; }
+
+    /**
+     * @brief   Clear the frontier and all buckets.
+     */
+    void Clear();
+};
+
+/**
+ * @brief   The size ratio above which IntersectForEach switches from the
+ *          block merge to galloping search over the longer array.
+ */
+static constexpr size_t INTERSECT_GALLOP_RATIO = 32;
+
+/**
+ * @brief   Visit the common elements of two sorted arrays by galloping: each
+ *          element of the short array is searched in the long one with an
+ *          exponential probe followed by a binary search.
+ *
+ * @return  The number of common elements.
+ */
+template <bool Swapped, typename VisitFunc>
+size_t IntersectGallop(const size_t *a, size_t size_a, const size_t *b, size_t size_b,
+                       VisitFunc &visit) {
+    size_t count = 0;
+    size_t j = 0;
+    for (size_t i = 0; i < size_a && j < size_b; i++) {
+        size_t target = a[i];
+        size_t step = 1;
+        size_t lo = j;
+        while (j + step < size_b && b[j + step] < target) {
+            lo = j + step;
+            step <<= 1;
+        }
+        size_t hi = std::min(j + step + 1, size_b);
+        j = std::lower_bound(b + lo, b + hi, target) - b;
+        if (j < size_b && b[j] == target) {
+            if (Swapped) {
+                visit(j, i);
+            } else {
+                visit(i, j);
+            }
+            count++;
+            j++;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief   Visit the common elements of two sorted arrays with a block merge.
+ *          Blocks of both arrays are compared all-against-all with SIMD
+ *          instructions when the compiler targets AVX2 or SSE4.1, and the
+ *          block whose maximum is smaller is skipped; the remainder is
+ *          merged with a branchless scalar loop.
+ *
+ * @return  The number of common elements.
+ */
+template <typename VisitFunc>
+size_t IntersectMerge(const size_t *a, size_t size_a, const size_t *b, size_t size_b,
+                      VisitFunc &visit) {
+    size_t count = 0;
+    size_t i = 0, j = 0;
+#if defined(__AVX2__)
+    static_assert(sizeof(size_t) == 8, "64-bit vertex ids are expected");
+    while (i + 4 <= size_a && j + 4 <= size_b) {
+        __m256i block_a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+        __m256i block_b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + j));
+        // lane l of the r-th rotation of block_b holds b[j + ((l + r) & 3)]
+        int masks[4];
+        for (int r = 0; r < 4; r++) {
+            masks[r] = _mm256_movemask_pd(
+                _mm256_castsi256_pd(_mm256_cmpeq_epi64(block_a, block_b)));
+            block_b = _mm256_permute4x64_epi64(block_b, _MM_SHUFFLE(0, 3, 2, 1));
+        }
+        int mask = masks[0] | masks[1] | masks[2] | masks[3];
+        while (mask) {
+            int l = __builtin_ctz(mask);
+            int r = 0;
+            while (!(masks[r] & (1 << l))) r++;
+            visit(i + l, j + ((l + r) & 3));
+            count++;
+            mask &= mask - 1;
+        }
+        size_t max_a = a[i + 3], max_b = b[j + 3];
+        i += (max_a <= max_b) ? 4 : 0;
+        j += (max_b <= max_a) ? 4 : 0;
+    }
+#elif defined(__SSE4_1__)
+    static_assert(sizeof(size_t) == 8, "64-bit vertex ids are expected");
+    while (i + 2 <= size_a && j + 2 <= size_b) {
+        __m128i block_a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        __m128i block_b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + j));
+        int direct = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(block_a, block_b)));
+        block_b = _mm_shuffle_epi32(block_b, _MM_SHUFFLE(1, 0, 3, 2));
+        int swapped = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(block_a, block_b)));
+        int mask = direct | swapped;
+        while (mask) {
+            int l = __builtin_ctz(mask);
+            visit(i + l, j + ((direct & (1 << l)) ? l : (l ^ 1)));
+            count++;
+            mask &= mask - 1;
+        }
+        size_t max_a = a[i + 1], max_b = b[j + 1];
+        i += (max_a <= max_b) ? 2 : 0;
+        j += (max_b <= max_a) ? 2 : 0;
+    }
+#endif
+    while (i < size_a && j < size_b) {
+        size_t x = a[i], y = b[j];
+        if (x == y) {
+            visit(i, j);
+            count++;
+        }
+        i += (x <= y);
+        j += (y <= x);
+    }
+    return count;
+}
+
+/**
+ * @brief   Visit the common elements of two ascending arrays of distinct
+ *          vertex ids, such as the lists held by SortedNeighbours. Galloping
+ *          search is used when one array is much longer than the other, and
+ *          the block merge otherwise.
+ *
+ * @tparam  VisitFunc   Callable as visit(pos_a, pos_b), where a[pos_a] ==
+ *                      b[pos_b] is a common element. Common elements are
+ *                      visited in ascending order.
+ * @param   a       The first array.
+ * @param   size_a  The length of the first array.
+ * @param   b       The second array.
+ * @param   size_b  The length of the second array.
+ * @param   visit   The function called on each common element.
+ *
+ * @return  The number of common elements.
+ */
+template <typename VisitFunc>
+size_t IntersectForEach(const size_t *a, size_t size_a, const size_t *b, size_t size_b,
+                        VisitFunc visit) {
+    if (size_a == 0 || size_b == 0 || a[size_a - 1] < b[0] || b[size_b - 1] < a[0]) return 0;
+    if (size_a * INTERSECT_GALLOP_RATIO < size_b) {
+        return IntersectGallop<false>(a, size_a, b, size_b, visit);
+    }
+    if (size_b * INTERSECT_GALLOP_RATIO < size_a) {
+        return IntersectGallop<true>(b, size_b, a, size_a, visit);
+    }
+    return IntersectMerge(a, size_a, b, size_b, visit);
+}
+
+/**
+ * @brief   Count the common elements of two ascending arrays of distinct
+ *          vertex ids.
+ *
+ * @return  The number of common elements.
+ */
+inline size_t IntersectCount(const size_t *a, size_t size_a, const size_t *b, size_t size_b) {
+    return IntersectForEach(a, size_a, b, size_b, [](size_t, size_t) {});
+}
+
+/**
+ * @brief   SortedNeighbours holds the distinct out-neighbours of every vertex
+ *          as ascending arrays in a compact CSR, without self loops, so that
+ *          they can be intersected with IntersectForEach.
+ *
+ *          When built oriented, an edge (u, v) is only kept in the list of
+ *          the endpoint of lower rank, where vertices are ranked by
+ *          (out-degree, vid). On a symmetric graph every undirected edge is
+ *          then stored once, every triangle is found exactly once by
+ *          intersecting the lists of the two endpoints of each kept edge, and
+ *          no list is longer than about sqrt(2|E|), which keeps the work of
+ *          high-degree vertices bounded.
+ */
+class SortedNeighbours {
+    std::vector<size_t> offsets_;
+    std::vector<size_t> neighbours_;
+
+ public:
+    SortedNeighbours() = default;
+    SortedNeighbours(const SortedNeighbours &rhs) = delete;
+    SortedNeighbours(SortedNeighbours &&rhs) = default;
+    SortedNeighbours& operator=(SortedNeighbours &&rhs) = default;
+
+    /**
+     * @brief   Build the lists from the out-edges of a graph.
+     *
+     * @param   graph       The graph.
+     * @param   oriented    Whether to keep only the neighbours of higher rank.
+     */
+    template <typename EdgeData>
+    void Build(OlapBase<EdgeData> &graph, bool oriented);
+
+    /**
+     * @brief   Drop the edges for which keep returns false, preserving the
+     *          order of the remaining ones. Edge indexes are renumbered.
+     *
+     * @param   graph   The graph the lists were built from.
+     * @param   keep    Called with the index of each edge.
+     */
+    template <typename EdgeData>
+    void Retain(OlapBase<EdgeData> &graph, std::function<bool(size_t)> keep);
+
+    size_t NumVertices() const { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+
+    size_t NumEdges() const { return neighbours_.size(); }
+
+    /**
+     * @brief   Get the index of the first edge of a vertex. The edges of
+     *          vertex vid are indexed [Offset(vid), Offset(vid) + Degree(vid)),
+     *          which can be used to address per-edge arrays.
+     */
+    size_t Offset(size_t vid) const { return offsets_[vid]; }
+
+    size_t Degree(size_t vid) const { return offsets_[vid + 1] - offsets_[vid]; }
+
+    const size_t *Begin(size_t vid) const { return neighbours_.data() + offsets_[vid]; }
+
+    const size_t *End(size_t vid) const { return neighbours_.data() + offsets_[vid + 1]; }
+};
+
 /**
  * The default reduce function which uses the plus operator.
  */
@@ -644,6 +939,50 @@ static constexpr size_t MAX_NUM_EDGES = 1ul << 22;
 static constexpr size_t MAX_NUM_EDGES = 1ul << 36;
 #endif
 
+/**
+ * @brief   Header of the binary CSR files written by OlapBase::WriteCsr.
+ *          The header is followed by the out index, the out edges, the in
+ *          index and in edges (only for DUAL_DIRECTION graphs) and the id
+ *          map. Every section starts at a multiple of CSR_FILE_ALIGNMENT, so
+ *          that it can be mapped on its own and backed by huge pages. The id
+ *          map holds num_vertices + 1 offsets followed by the names of the
+ *          vertices, and is empty if the graph was written without names.
+ */
+struct CsrFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t edge_direction_policy;
+    uint64_t adj_unit_size;
+    uint64_t num_vertices;
+    uint64_t num_edges;
+    uint64_t out_index_offset;
+    uint64_t out_edges_offset;
+    uint64_t in_index_offset;
+    uint64_t in_edges_offset;
+    uint64_t names_offset;
+    uint64_t names_size;
+};
+
+static constexpr char CSR_FILE_MAGIC[8] = {'L', 'G', 'R', 'A', 'P', 'H', 'C', 'S'};
+static constexpr uint32_t CSR_FILE_VERSION = 1;
+static constexpr size_t CSR_FILE_ALIGNMENT = 1ul << 21;
+
+/**
+ * @brief   Map [offset, offset + size) of a file privately, with huge page and
+ *          read-ahead hints. The returned memory can be owned by a
+ *          ParallelVector, which unmaps it on destruction.
+ *
+ * @exception   std::runtime_error  Raised when the range cannot be mapped.
+ */
+void *MapFileRange(int fd, size_t offset, size_t size);
+
+/**
+ * @brief   Write size bytes of data at offset of a file.
+ *
+ * @exception   std::runtime_error  Raised when the write fails.
+ */
+void WriteFileRange(int fd, size_t offset, const void *data, size_t size);
+
 /**
  * @brief   Graph
  * @tparam  EdgeData
@@ -831,6 +1170,103 @@ class OlapBase {
         }
     }
 
+    /**
+     * @brief   Load the graph from a binary CSR file written by WriteCsr. The
+     *          index and edge sections are mapped instead of read, so the
+     *          graph is ready without parsing the edges or constructing.
+     *
+     * @exception   std::runtime_error  Raised when the file cannot be mapped,
+     *                                  or does not match EdgeData.
+     *
+     * @param           path            The path of the CSR file.
+     * @param   [out]   vertex_names    Optional, filled with the id map of the
+     *                                  file, which must have been written.
+     */
+    void MapCsr(const std::string &path, std::vector<std::string> *vertex_names = nullptr) {
+        if (this->num_vertices_ != 0 || this->num_edges_ != 0) {
+            throw std::runtime_error("Graph should not be loaded twice!");
+        }
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Failed to open csr file " + path);
+        try {
+            CsrFileHeader header;
+            if (pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+                memcmp(header.magic, CSR_FILE_MAGIC, sizeof(header.magic)) != 0) {
+                throw std::runtime_error(path + " is not a csr file");
+            }
+            if (header.version != CSR_FILE_VERSION) {
+                throw std::runtime_error("Unsupported csr file version " +
+                                         std::to_string(header.version));
+            }
+            if (header.adj_unit_size != sizeof(AdjUnit<EdgeData>)) {
+                throw std::runtime_error("Edge data of the csr file does not match the graph");
+            }
+            if (header.num_vertices == 0 || header.num_edges == 0) {
+                throw std::runtime_error("Construct empty graph");
+            }
+            if (vertex_names && header.names_size == 0) {
+                throw std::runtime_error("The csr file has no id map");
+            }
+            size_t num_vertices = header.num_vertices;
+            this->out_index_ = ParallelVector<size_t>(
+                (size_t *)MapFileRange(fd, header.out_index_offset,
+                                       sizeof(size_t) * (num_vertices + 1)),
+                num_vertices + 1);
+            size_t num_out_edges = this->out_index_[num_vertices];
+            this->out_edges_ = ParallelVector<AdjUnit<EdgeData>>(
+                (AdjUnit<EdgeData> *)MapFileRange(fd, header.out_edges_offset,
+                                                  sizeof(AdjUnit<EdgeData>) * num_out_edges),
+                num_out_edges);
+            this->edge_direction_policy_ = (EdgeDirectionPolicy)header.edge_direction_policy;
+            if (this->edge_direction_policy_ == DUAL_DIRECTION) {
+                this->in_index_ = ParallelVector<size_t>(
+                    (size_t *)MapFileRange(fd, header.in_index_offset,
+                                           sizeof(size_t) * (num_vertices + 1)),
+                    num_vertices + 1);
+                size_t num_in_edges = this->in_index_[num_vertices];
+                this->in_edges_ = ParallelVector<AdjUnit<EdgeData>>(
+                    (AdjUnit<EdgeData> *)MapFileRange(fd, header.in_edges_offset,
+                                                      sizeof(AdjUnit<EdgeData>) * num_in_edges),
+                    num_in_edges);
+            }
+            if (vertex_names) {
+                ParallelVector<char> names(
+                    (char *)MapFileRange(fd, header.names_offset, header.names_size),
+                    header.names_size);
+                const uint64_t *offsets = (const uint64_t *)names.Data();
+                const char *chars = names.Data() + sizeof(uint64_t) * (num_vertices + 1);
+                vertex_names->resize(num_vertices);
+                for (size_t vi = 0; vi < num_vertices; vi++) {
+                    (*vertex_names)[vi].assign(chars + offsets[vi], offsets[vi + 1] - offsets[vi]);
+                }
+            }
+            this->num_vertices_ = num_vertices;
+            this->num_edges_ = header.num_edges;
+        } catch (...) {
+            close(fd);
+            throw;
+        }
+        close(fd);
+
+        this->lock_array_.ReAlloc(this->num_vertices_);
+        this->lock_array_.Resize(this->num_vertices_, false);
+        this->out_degree_.ReAlloc(this->num_vertices_);
+        this->out_degree_.Resize(this->num_vertices_, (size_t)0);
+        if (this->edge_direction_policy_ == DUAL_DIRECTION) {
+            this->in_degree_.ReAlloc(this->num_vertices_);
+            this->in_degree_.Resize(this->num_vertices_, (size_t)0);
+        }
+        this->template ProcessVertexInRange<size_t>(
+            [&](size_t vi) {
+                this->out_degree_[vi] = this->out_index_[vi + 1] - this->out_index_[vi];
+                if (this->edge_direction_policy_ == DUAL_DIRECTION) {
+                    this->in_degree_[vi] = this->in_index_[vi + 1] - this->in_index_[vi];
+                }
+                return 0;
+            },
+            0, this->num_vertices_);
+    }
+
  public:
     /**
      * @brief   Constructor of Graph.
@@ -908,6 +1344,83 @@ class OlapBase {
         out_edges_.Swap(in_edges_);
     }
 
+    /**
+     * @brief   Write the graph to a binary CSR file (see CsrFileHeader), which
+     *          can be loaded back with MapCsr.
+     *
+     * @exception   std::runtime_error  Raised when the file cannot be written.
+     *
+     * @param   path            The path of the CSR file.
+     * @param   vertex_name     Optional, the original id of a vertex. If given,
+     *                          the ids of all the vertices are stored as the
+     *                          id map of the file.
+     */
+    void WriteCsr(const std::string &path,
+                  std::function<std::string(size_t)> vertex_name = nullptr) {
+        if (num_vertices_ == 0 || num_edges_ == 0) {
+            throw std::runtime_error("Write empty graph");
+        }
+        CsrFileHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, CSR_FILE_MAGIC, sizeof(header.magic));
+        header.version = CSR_FILE_VERSION;
+        header.edge_direction_policy = edge_direction_policy_;
+        header.adj_unit_size = sizeof(AdjUnit<EdgeData>);
+        header.num_vertices = num_vertices_;
+        header.num_edges = num_edges_;
+
+        size_t file_size = CSR_FILE_ALIGNMENT;
+        auto place = [&](size_t size) {
+            size_t offset = file_size;
+            file_size += (size + CSR_FILE_ALIGNMENT - 1) / CSR_FILE_ALIGNMENT * CSR_FILE_ALIGNMENT;
+            return offset;
+        };
+        size_t index_size = sizeof(size_t) * (num_vertices_ + 1);
+        size_t out_edges_size = sizeof(AdjUnit<EdgeData>) * out_index_[num_vertices_];
+        header.out_index_offset = place(index_size);
+        header.out_edges_offset = place(out_edges_size);
+        size_t in_edges_size = 0;
+        if (edge_direction_policy_ == DUAL_DIRECTION) {
+            in_edges_size = sizeof(AdjUnit<EdgeData>) * in_index_[num_vertices_];
+            header.in_index_offset = place(index_size);
+            header.in_edges_offset = place(in_edges_size);
+        }
+        std::vector<uint64_t> name_offsets;
+        std::string names;
+        if (vertex_name) {
+            name_offsets.reserve(num_vertices_ + 1);
+            name_offsets.push_back(0);
+            for (size_t vi = 0; vi < num_vertices_; vi++) {
+                names.append(vertex_name(vi));
+                name_offsets.push_back(names.size());
+            }
+            header.names_size = sizeof(uint64_t) * name_offsets.size() + names.size();
+            header.names_offset = place(header.names_size);
+        }
+
+        int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) throw std::runtime_error("Failed to create csr file " + path);
+        try {
+            WriteFileRange(fd, 0, &header, sizeof(header));
+            WriteFileRange(fd, header.out_index_offset, out_index_.Data(), index_size);
+            WriteFileRange(fd, header.out_edges_offset, out_edges_.Data(), out_edges_size);
+            if (edge_direction_policy_ == DUAL_DIRECTION) {
+                WriteFileRange(fd, header.in_index_offset, in_index_.Data(), index_size);
+                WriteFileRange(fd, header.in_edges_offset, in_edges_.Data(), in_edges_size);
+            }
+            if (vertex_name) {
+                size_t offsets_size = sizeof(uint64_t) * name_offsets.size();
+                WriteFileRange(fd, header.names_offset, name_offsets.data(), offsets_size);
+                WriteFileRange(fd, header.names_offset + offsets_size, names.data(),
+                               names.size());
+            }
+        } catch (...) {
+            close(fd);
+            throw;
+        }
+        close(fd);
+    }
+
     /**
      * @brief   Get number of vertices of the Graph.
      *
@@ -941,6 +1454,28 @@ class OlapBase {
      */
     ParallelBitset AllocVertexSubset() { return ParallelBitset(num_vertices_); }
 
+    /**
+     * @brief   Allocate a BucketedFrontier for priority-ordered processing.
+     *
+     * @return  An empty BucketedFrontier.
+     */
+    BucketedFrontier AllocBucketedFrontier() { return BucketedFrontier(); }
+
+    /**
+     * @brief   Allocate the sorted, deduplicated out-neighbour lists of all
+     *          vertices for set intersections.
+     *
+     * @param   oriented    (Optional) Whether to keep each edge only at its
+     *                      endpoint of lower (out-degree, vid) rank.
+     *
+     * @return  The SortedNeighbours of the Graph.
+     */
+    SortedNeighbours AllocSortedNeighbours(bool oriented = false) {
+        SortedNeighbours neighbours;
+        neighbours.Build(*this, oriented);
+        return neighbours;
+    }
+
     /**
      * @brief   Lock some vertex to ensure correct concurrent updates.
      *
@@ -1282,8 +1817,108 @@ class OlapBase {
                 return work(algorithm, vi);
             }, active_vertices, zero, reduce);
     }
+
+    /**
+     * @brief   Process the vertices of the current bucket of a BucketedFrontier
+     *          in parallel. The work function may push vertices into the same
+     *          frontier; they become visible after the next Advance().
+     *
+     * @exception   std::runtime_error  Raised when a runtime error condition
+     *                                  occurs.
+     *
+     * @tparam  ReducedSum  Type of the reduced sum.
+     * @param           work        The function describing each vertex's work.
+     * @param [in,out]  frontier    The frontier to process.
+     * @param           zero        (Optional) The initial value for reduction.
+     * @param           reduce      (Optional) The function describing the
+     *                              reduction logic.
+     *
+     * @return  A reduction value.
+     */
+    template <typename ReducedSum>
+    ReducedSum ProcessVertexBucket(
+        std::function<ReducedSum(size_t)> work, BucketedFrontier &frontier,
+        ReducedSum zero = 0,
+        std::function<ReducedSum(ReducedSum, ReducedSum)> reduce = reduce_plus<ReducedSum>) {
+        return ProcessVertexInRange<ReducedSum>(
+            [&frontier, &work](size_t i) {
+                return work(frontier[i]);
+            }, 0, frontier.Size(), zero, reduce);
+    }
 };
 
+template <typename EdgeData>
+void SortedNeighbours::Build(OlapBase<EdgeData> &graph, bool oriented) {
+    size_t num_vertices = graph.NumVertices();
+    std::vector<size_t> staging_offsets(num_vertices + 1, 0);
+    for (size_t vi = 0; vi < num_vertices; vi++) {
+        staging_offsets[vi + 1] = staging_offsets[vi] + graph.OutDegree(vi);
+    }
+    std::vector<size_t> staging(staging_offsets[num_vertices]);
+    offsets_.assign(num_vertices + 1, 0);
+    graph.template ProcessVertexInRange<size_t>(
+        [&](size_t vi) {
+            size_t degree = graph.OutDegree(vi);
+            size_t *begin = staging.data() + staging_offsets[vi];
+            size_t *end = begin;
+            for (auto &edge : graph.OutEdges(vi)) {
+                size_t nbr = edge.neighbour;
+                if (nbr == vi) continue;
+                if (oriented) {
+                    size_t nbr_degree = graph.OutDegree(nbr);
+                    if (nbr_degree < degree || (nbr_degree == degree && nbr < vi)) continue;
+                }
+                *end++ = nbr;
+            }
+            std::sort(begin, end);
+            offsets_[vi + 1] = std::unique(begin, end) - begin;
+            return 0;
+        },
+        0, num_vertices);
+    for (size_t vi = 0; vi < num_vertices; vi++) {
+        offsets_[vi + 1] += offsets_[vi];
+    }
+    neighbours_.resize(offsets_[num_vertices]);
+    graph.template ProcessVertexInRange<size_t>(
+        [&](size_t vi) {
+            std::copy(staging.data() + staging_offsets[vi],
+                      staging.data() + staging_offsets[vi] + Degree(vi),
+                      neighbours_.data() + offsets_[vi]);
+            return 0;
+        },
+        0, num_vertices);
+}
+
+template <typename EdgeData>
+void SortedNeighbours::Retain(OlapBase<EdgeData> &graph, std::function<bool(size_t)> keep) {
+    size_t num_vertices = NumVertices();
+    std::vector<size_t> offsets(num_vertices + 1, 0);
+    graph.template ProcessVertexInRange<size_t>(
+        [&](size_t vi) {
+            size_t out = offsets_[vi];
+            for (size_t ei = offsets_[vi]; ei < offsets_[vi + 1]; ei++) {
+                if (keep(ei)) neighbours_[out++] = neighbours_[ei];
+            }
+            offsets[vi + 1] = out - offsets_[vi];
+            return 0;
+        },
+        0, num_vertices);
+    for (size_t vi = 0; vi < num_vertices; vi++) {
+        offsets[vi + 1] += offsets[vi];
+    }
+    std::vector<size_t> neighbours(offsets[num_vertices]);
+    graph.template ProcessVertexInRange<size_t>(
+        [&](size_t vi) {
+            std::copy(neighbours_.data() + offsets_[vi],
+                      neighbours_.data() + offsets_[vi] + (offsets[vi + 1] - offsets[vi]),
+                      neighbours.data() + offsets[vi]);
+            return 0;
+        },
+        0, num_vertices);
+    offsets_.swap(offsets);
+    neighbours_.swap(neighbours);
+}
+
 template <typename T>
 T ForEachVertex(GraphDB &db, Transaction &txn, std::vector<Worker> &workers,
                 const std::vector<int64_t>& vertices,
@@ -1487,6 +1487,38 @@ class OlapOnDB : public OlapBase<EdgeData> {
         return a;
     }
 
+    /**
+     * @brief    Extract a vertex array from the column store of a vertex field, reading the
+     *           values of that field only instead of the vertices. Vertices without a value
+     *           keep a default VertexData.
+     *
+     * @param    label      The vertex label.
+     * @param    field      The field, which must have a column store.
+     * @param    extract    The function describing the extraction logic.
+     *
+     * @return   A ParallelVector containing each vertex's extracted data.
+     */
+    template <typename VertexData>
+    ParallelVector<VertexData> ExtractVertexColumn(
+        const std::string &label, const std::string &field,
+        std::function<void(const FieldData &, VertexData &)> extract) {
+        auto task_ctx = GetThreadContext();
+        ParallelVector<VertexData> a(this->num_vertices_, this->num_vertices_);
+        a.Fill(VertexData());
+        size_t n = 0;
+        txn_.ScanVertexColumn(label, field, [&](int64_t vid, const FieldData &value) {
+            if (++n % 1024 == 0 && ShouldKillThisTask(task_ctx)) return false;
+            if (flags_ & SNAPSHOT_IDMAPPING) {
+                if (vid_map_.contains(vid)) extract(value, a[vid_map_.find(vid)]);
+            } else if ((size_t)vid < this->num_vertices_) {
+                extract(value, a[vid]);
+            }
+            return true;
+        });
+        if (ShouldKillThisTask(task_ctx)) throw std::runtime_error("Task killed");
+        return a;
+    }
+
     /**
      * @brief    Write vertex data to a file.
      *
@@ -0,0 +1,510 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+/**
+ *  @file   olap_sampling.h
+ *  @brief  Multi-threaded sampling kernels for graph learning over OlapOnDB.
+ *          A SubgraphSampler collects the vertices and edges of a mini-batch,
+ *          then exports them into contiguous buffers provided by the caller,
+ *          e.g. numpy arrays which can be handed to torch via DLPack without
+ *          copying.
+ */
+
+#pragma once
+
+#include <omp.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "lgraph/olap_on_db.h"
+
+namespace lgraph_api {
+namespace olap {
+
+/**
+ * @brief   SubgraphSampler samples the edges of a mini-batch with one of the
+ *          kernels below. Kernels can be called several times to accumulate
+ *          edges. The vertices of the batch are the seeds and the endpoints of
+ *          the sampled edges, each reported once in ascending vid order.
+ *
+ *          Randomness is derived from the seed given on construction and the
+ *          position of each task, so a batch is reproducible regardless of the
+ *          number of threads.
+ *
+ * @tparam  EdgeData    Type of the edge data.
+ */
+template <typename EdgeData>
+class SubgraphSampler {
+    OlapOnDB<EdgeData> &graph_;
+    uint64_t seed_;
+    uint64_t round_;
+    ParallelBitset sampled_;
+    std::vector<size_t> src_;
+    std::vector<size_t> dst_;
+    std::vector<size_t> nodes_;
+    bool nodes_ready_;
+
+    /** splitmix64, a small generator that can be created per task */
+    static uint64_t NextRandom(uint64_t &state) {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    static double NextUniform(uint64_t &state) {
+        return (NextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    uint64_t TaskState(size_t task) const {
+        uint64_t state = seed_ ^ (round_ * 0xd1b54a32d192ed03ull);
+        state ^= task * 0x9e3779b97f4a7c15ull;
+        NextRandom(state);
+        return state;
+    }
+
+    /**
+     * Appends edges produced into fixed per-task slots: task i wrote count[i]
+     * edges starting at slot offset[i]. Slots are compacted in task order.
+     */
+    void AppendSlots(const std::vector<size_t> &slot_src, const std::vector<size_t> &slot_dst,
+                     const std::vector<size_t> &offset, const std::vector<size_t> &count) {
+        size_t num_tasks = count.size();
+        std::vector<size_t> out(num_tasks + 1, 0);
+        for (size_t i = 0; i < num_tasks; i++) out[i + 1] = out[i] + count[i];
+        size_t base = src_.size();
+        src_.resize(base + out[num_tasks]);
+        dst_.resize(base + out[num_tasks]);
+        graph_.template ProcessVertexInRange<size_t>(
+            [&](size_t i) {
+                for (size_t k = 0; k < count[i]; k++) {
+                    src_[base + out[i] + k] = slot_src[offset[i] + k];
+                    dst_[base + out[i] + k] = slot_dst[offset[i] + k];
+                    sampled_.Add(slot_src[offset[i] + k]);
+                    sampled_.Add(slot_dst[offset[i] + k]);
+                }
+                return 0;
+            },
+            0, num_tasks);
+        nodes_ready_ = false;
+        round_++;
+    }
+
+    void AddSeeds(const size_t *seeds, size_t num_seeds) {
+        for (size_t i = 0; i < num_seeds; i++) {
+            if (seeds[i] >= graph_.NumVertices()) {
+                throw std::runtime_error("seed vertex out of range");
+            }
+            sampled_.Add(seeds[i]);
+        }
+        nodes_ready_ = false;
+    }
+
+    bool HasOutEdge(size_t src, size_t dst) {
+        for (auto &edge : graph_.OutEdges(src)) {
+            if (edge.neighbour == dst) return true;
+        }
+        return false;
+    }
+
+    /** edge weight for node2vec, non-positive or absent weights count as 1 */
+    static double EdgeWeight(const AdjUnit<EdgeData> &edge) {
+        if constexpr (std::is_same<EdgeData, Empty>::value) {
+            return 1;
+        } else {
+            double weight = (double)edge.edge_data;
+            return weight > 0 ? weight : 1;
+        }
+    }
+
+ public:
+    explicit SubgraphSampler(OlapOnDB<EdgeData> &graph, uint64_t seed = std::random_device()())
+        : graph_(graph),
+          seed_(seed),
+          round_(0),
+          sampled_(graph.NumVertices()),
+          nodes_ready_(false) {}
+
+    SubgraphSampler(const SubgraphSampler &rhs) = delete;
+
+    /**
+     * @brief   Sample up to fanout out-edges of each seed, uniformly with
+     *          replacement. Seeds with at most fanout out-edges keep all of them.
+     *
+     * @param   seeds       The seed vertices (in the Graph).
+     * @param   num_seeds   The number of seeds.
+     * @param   fanout      The number of neighbours to sample per seed.
+     */
+    void NeighborSample(const size_t *seeds, size_t num_seeds, size_t fanout) {
+        AddSeeds(seeds, num_seeds);
+        std::vector<size_t> slot_src(num_seeds * fanout), slot_dst(num_seeds * fanout);
+        std::vector<size_t> offset(num_seeds), count(num_seeds, 0);
+        graph_.template ProcessVertexInRange<size_t>(
+            [&](size_t i) {
+                size_t src = seeds[i];
+                size_t degree = graph_.OutDegree(src);
+                auto edges = graph_.OutEdges(src);
+                uint64_t state = TaskState(i);
+                offset[i] = i * fanout;
+                size_t n = std::min(degree, fanout);
+                for (size_t k = 0; k < n; k++) {
+                    size_t pick = degree <= fanout ? k : NextRandom(state) % degree;
+                    slot_src[offset[i] + k] = src;
+                    slot_dst[offset[i] + k] = edges[pick].neighbour;
+                }
+                count[i] = n;
+                return 0;
+            },
+            0, num_seeds);
+        AppendSlots(slot_src, slot_dst, offset, count);
+    }
+
+    /**
+     * @brief   Walk walk_length uniform random steps from each seed and
+     *          sample the traversed edges. A walk stops early at a vertex
+     *          without out-edges.
+     *
+     * @param   seeds       The seed vertices (in the Graph).
+     * @param   num_seeds   The number of seeds.
+     * @param   walk_length The number of steps of each walk.
+     */
+    void RandomWalk(const size_t *seeds, size_t num_seeds, size_t walk_length) {
+        AddSeeds(seeds, num_seeds);
+        std::vector<size_t> slot_src(num_seeds * walk_length), slot_dst(num_seeds * walk_length);
+        std::vector<size_t> offset(num_seeds), count(num_seeds, 0);
+        graph_.template ProcessVertexInRange<size_t>(
+            [&](size_t i) {
+                size_t cur = seeds[i];
+                uint64_t state = TaskState(i);
+                offset[i] = i * walk_length;
+                size_t k = 0;
+                for (; k < walk_length; k++) {
+                    size_t degree = graph_.OutDegree(cur);
+                    if (degree == 0) break;
+                    size_t next = graph_.OutEdges(cur)[NextRandom(state) % degree].neighbour;
+                    slot_src[offset[i] + k] = cur;
+                    slot_dst[offset[i] + k] = next;
+                    cur = next;
+                }
+                count[i] = k;
+                return 0;
+            },
+            0, num_seeds);
+        AppendSlots(slot_src, slot_dst, offset, count);
+    }
+
+    /**
+     * @brief   Run num_walks second-order node2vec walks from each seed, and
+     *          sample the traversed edges. A step from cur, having arrived
+     *          from prev, picks a neighbour x with probability proportional to
+     *          weight(cur, x) times 1/p if x is prev, 1 if x is an out-neighbour
+     *          of prev and 1/q otherwise. Steps are drawn by rejection sampling,
+     *          so no per-edge alias tables are built.
+     *
+     * @param           seeds       The seed vertices (in the Graph).
+     * @param           num_seeds   The number of seeds.
+     * @param           walk_length The number of vertices of each walk,
+     *                              including the seed.
+     * @param           num_walks   The number of walks per seed.
+     * @param           p           The return parameter, positive and finite.
+     * @param           q           The in-out parameter, positive and finite.
+     * @param [out]     walks       A row-major (num_seeds * num_walks) x
+     *                              walk_length buffer receiving the walks, walk
+     *                              j of seed i in row j * num_seeds + i. Rows of
+     *                              walks that stop early are padded with -1.
+     */
+    void Node2VecWalk(const size_t *seeds, size_t num_seeds, size_t walk_length,
+                      size_t num_walks, double p, double q, int64_t *walks) {
+        // the biases are 1/p and 1/q, a step could never be accepted if they were 0 or NaN
+        if (!(p > 0) || !(q > 0) || std::isinf(p) || std::isinf(q)) {
+            throw std::invalid_argument("node2vec p and q must be positive and finite");
+        }
+        if (walk_length == 0) return;
+        AddSeeds(seeds, num_seeds);
+        size_t num_tasks = num_seeds * num_walks;
+        size_t steps = walk_length - 1;
+        std::vector<size_t> slot_src(num_tasks * steps), slot_dst(num_tasks * steps);
+        std::vector<size_t> offset(num_tasks), count(num_tasks, 0);
+        double max_bias = std::max(1.0, std::max(1.0 / p, 1.0 / q));
+        graph_.template ProcessVertexInRange<size_t>(
+            [&](size_t t) {
+                int64_t *walk = walks + t * walk_length;
+                std::fill(walk, walk + walk_length, -1);
+                size_t cur = seeds[t % num_seeds];
+                size_t prev = (size_t)-1;
+                uint64_t state = TaskState(t);
+                offset[t] = t * steps;
+                walk[0] = cur;
+                size_t k = 0;
+                for (; k < steps; k++) {
+                    size_t degree = graph_.OutDegree(cur);
+                    if (degree == 0) break;
+                    auto edges = graph_.OutEdges(cur);
+                    double max_weight = 0;
+                    for (auto &edge : edges) max_weight = std::max(max_weight, EdgeWeight(edge));
+                    size_t next;
+                    while (true) {
+                        auto &edge = edges[NextRandom(state) % degree];
+                        next = edge.neighbour;
+                        double bias = 1;
+                        if (prev != (size_t)-1) {
+                            if (next == prev) {
+                                bias = 1.0 / p;
+                            } else if (!HasOutEdge(prev, next)) {
+                                bias = 1.0 / q;
+                            }
+                        }
+                        if (NextUniform(state) * max_weight * max_bias <
+                            EdgeWeight(edge) * bias) {
+                            break;
+                        }
+                    }
+                    slot_src[offset[t] + k] = cur;
+                    slot_dst[offset[t] + k] = next;
+                    walk[k + 1] = next;
+                    prev = cur;
+                    cur = next;
+                }
+                count[t] = k;
+                return 0;
+            },
+            0, num_tasks);
+        AppendSlots(slot_src, slot_dst, offset, count);
+    }
+
+    /**
+     * @brief   Keep each edge of the graph with probability sample_rate.
+     *
+     * @param   sample_rate The probability to sample an edge.
+     */
+    void EdgeSample(double sample_rate) {
+        size_t num_vertices = graph_.NumVertices();
+        std::vector<size_t> offset(num_vertices + 1, 0), count(num_vertices, 0);
+        for (size_t vi = 0; vi < num_vertices; vi++) {
+            offset[vi + 1] = offset[vi] + graph_.OutDegree(vi);
+        }
+        std::vector<size_t> slot_src(offset[num_vertices]), slot_dst(offset[num_vertices]);
+        graph_.template ProcessVertexInRange<size_t>(
+            [&](size_t vi) {
+                uint64_t state = TaskState(vi);
+                size_t k = 0;
+                for (auto &edge : graph_.OutEdges(vi)) {
+                    if (NextUniform(state) < sample_rate) {
+                        slot_src[offset[vi] + k] = vi;
+                        slot_dst[offset[vi] + k] = edge.neighbour;
+                        k++;
+                    }
+                }
+                count[vi] = k;
+                return 0;
+            },
+            0, num_vertices);
+        offset.pop_back();
+        AppendSlots(slot_src, slot_dst, offset, count);
+    }
+
+    /**
+     * @brief   Sample num_samples uniform vertex pairs and keep those which are
+     *          not edges of the graph (negative edges). Self pairs are dropped,
+     *          so nothing is sampled from a graph of less than two vertices.
+     *
+     * @param   num_samples The number of pairs to draw.
+     */
+    void NegativeSample(size_t num_samples) {
+        size_t num_vertices = graph_.NumVertices();
+        if (num_vertices < 2) return;
+        std::vector<size_t> slot_src(num_samples), slot_dst(num_samples);
+        std::vector<size_t> offset(num_samples), count(num_samples, 0);
+        graph_.template ProcessVertexInRange<size_t>(
+            [&](size_t i) {
+                uint64_t state = TaskState(i);
+                size_t src = NextRandom(state) % num_vertices;
+                size_t dst = NextRandom(state) % num_vertices;
+                offset[i] = i;
+                if (src == dst || HasOutEdge(src, dst)) return 0;
+                slot_src[i] = src;
+                slot_dst[i] = dst;
+                count[i] = 1;
+                return 0;
+            },
+            0, num_samples);
+        AppendSlots(slot_src, slot_dst, offset, count);
+    }
+
+    /**
+     * @brief   Get the number of vertices of the batch.
+     */
+    size_t NumNodes() {
+        if (!nodes_ready_) {
+            nodes_.clear();
+            size_t num_vertices = graph_.NumVertices();
+            for (size_t vi = 0; vi < num_vertices; vi++) {
+                if (sampled_.Has(vi)) nodes_.push_back(vi);
+            }
+            nodes_ready_ = true;
+        }
+        return nodes_.size();
+    }
+
+    /**
+     * @brief   Get the number of edges of the batch.
+     */
+    size_t NumEdges() const { return src_.size(); }
+
+    /**
+     * @brief   Write the batch into caller-provided contiguous buffers. Vertex
+     *          fields are read in parallel straight into the feature matrix,
+     *          so the buffers can be exported to tensors without copying. Any
+     *          buffer may be nullptr to skip it.
+     *
+     * @param           db              The db the graph was built from.
+     * @param           feature_key     The field holding the feature vector as
+     *                                  packed floats.
+     * @param           label_key       The int64 field holding the label.
+     * @param           feature_num     The length of the feature vector.
+     * @param [out]     nodes           NumNodes() vertex ids (in the Graph).
+     * @param [out]     features        NumNodes() x feature_num, row-major.
+     *                                  Rows of vertices without the feature
+     *                                  field are left untouched.
+     * @param [out]     labels          NumNodes() labels.
+     * @param [out]     vertex_types    NumNodes() vertex label ids.
+     * @param [out]     src             NumEdges() source vertex ids.
+     * @param [out]     dst             NumEdges() destination vertex ids.
+     * @param [out]     edge_types      NumEdges() edge label ids.
+     */
+    void Export(GraphDB &db, const std::string &feature_key,
+                const std::string &label_key, size_t feature_num, int64_t *nodes,
+                float *features, int64_t *labels, int64_t *vertex_types, int64_t *src,
+                int64_t *dst, int64_t *edge_types) {
+        size_t num_nodes = NumNodes();
+        size_t num_edges = NumEdges();
+        auto txn = db.CreateReadTxn();
+        // field ids of the feature and label fields, indexed by label id
+        std::vector<int64_t> feature_fid, label_fid;
+        for (auto &label : txn.ListVertexLabels()) {
+            size_t lid = txn.GetVertexLabelId(label);
+            if (lid >= feature_fid.size()) {
+                feature_fid.resize(lid + 1, -1);
+                label_fid.resize(lid + 1, -1);
+            }
+            for (auto &spec : txn.GetVertexSchema(label)) {
+                if (spec.name == feature_key) {
+                    feature_fid[lid] = txn.GetVertexFieldId(lid, feature_key);
+                } else if (spec.name == label_key) {
+                    label_fid[lid] = txn.GetVertexFieldId(lid, label_key);
+                }
+            }
+        }
+        // an exception must not leave the parallel region, it is kept and rethrown after it;
+        // every thread still runs into both loops, skipping their bodies once one has failed
+        std::exception_ptr error;
+        std::mutex error_mutex;
+        std::atomic<bool> failed(false);
+        auto keep_error = [&]() {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) error = std::current_exception();
+            failed = true;
+        };
+        auto worker = Worker::SharedWorker();
+        worker->Delegate([&]() {
+#pragma omp parallel
+            {
+                std::unique_ptr<Transaction> local_txn;
+                std::unique_ptr<VertexIterator> vit;
+                try {
+                    local_txn.reset(new Transaction(db.ForkTxn(txn)));
+                    vit.reset(new VertexIterator(local_txn->GetVertexIterator()));
+                } catch (...) {
+                    keep_error();
+                }
+#pragma omp for schedule(dynamic, 64)
+                for (size_t i = 0; i < num_nodes; i++) {
+                    if (failed) continue;
+                    try {
+                        size_t vid = nodes_[i];
+                        if (nodes) nodes[i] = vid;
+                        if (!features && !labels && !vertex_types) continue;
+                        vit->Goto(graph_.OriginalVid(vid));
+                        size_t lid = vit->GetLabelId();
+                        if (vertex_types) vertex_types[i] = lid;
+                        if (lid >= feature_fid.size()) continue;
+                        if (features && feature_fid[lid] >= 0) {
+                            auto field = vit->GetField(feature_fid[lid]);
+                            if (!field.IsNull()) {
+                                std::string buf = field.ToString();
+                                memcpy(features + i * feature_num, buf.data(),
+                                       std::min(buf.size(), feature_num * sizeof(float)));
+                            }
+                        }
+                        if (labels && label_fid[lid] >= 0) {
+                            auto field = vit->GetField(label_fid[lid]);
+                            if (!field.IsNull()) labels[i] = field.AsInt64();
+                        }
+                    } catch (...) {
+                        keep_error();
+                    }
+                }
+#pragma omp for schedule(dynamic, 64)
+                for (size_t i = 0; i < num_edges; i++) {
+                    if (failed) continue;
+                    try {
+                        if (src) src[i] = src_[i];
+                        if (dst) dst[i] = dst_[i];
+                        if (!edge_types) continue;
+                        int64_t dst_vid = graph_.OriginalVid(dst_[i]);
+                        vit->Goto(graph_.OriginalVid(src_[i]));
+                        for (auto eit = vit->GetOutEdgeIterator(); eit.IsValid(); eit.Next()) {
+                            if (eit.GetDst() == dst_vid) {
+                                edge_types[i] = eit.GetLabelId();
+                                break;
+                            }
+                        }
+                    } catch (...) {
+                        keep_error();
+                    }
+                }
+                vit.reset();
+                if (local_txn) local_txn->Abort();
+            }
+        });
+        txn.Abort();
+        if (error) std::rethrow_exception(error);
+    }
+
+    /**
+     * @brief   Drop the sampled vertices and edges, to sample the next batch.
+     */
+    void Clear() {
+        sampled_.Clear();
+        src_.clear();
+        dst_.clear();
+        nodes_.clear();
+        nodes_ready_ = false;
+    }
+};
+
+}  // namespace olap
+}  // namespace lgraph_api
@@ -4,6 +4,7 @@ sys.path.append("../../build/output/")
 import argparse
 import time
 import random
+import numpy as np
 import torch
 import torch.nn as nn
 import torch.nn.functional as F
@@ -39,13 +40,25 @@ def construct_graph():
 # https://docs.dgl.ai/en/0.8.x/tutorials/multi/2_node_classification.html#sphx-glr-tutorials-multi-2-node-classification-py
 
 def remap(src, dst, nodes_idx):
-    nodes_idx_map = {}
-    for i in range(0, len(nodes_idx)):
-        nodes_idx_map[nodes_idx[i]] = i
-    for i in range(0, len(src)):
-        src[i] = nodes_idx_map[src[i]]
-    for i in range(0, len(dst)):
-        dst[i] = nodes_idx_map[dst[i]]
+    # nodes_idx is sorted ascending by the sampling procedures
+    return np.searchsorted(nodes_idx, src), np.searchsorted(nodes_idx, dst)
+
+
+def prefetch(dataloader, depth=2):
+    # the sampling procedures release the GIL, so the next batches are sampled
+    # while the current one is being trained on
+    q = queue.Queue(maxsize=depth)
+    end = object()
+    def produce():
+        for graph in dataloader:
+            q.put(graph)
+        q.put(end)
+    Thread(target=produce, daemon=True).start()
+    while True:
+        graph = q.get()
+        if graph is end:
+            return
+        yield graph
 
 
 class TugraphSample(object):
@@ -91,10 +104,11 @@ class TugraphSample(object):
         del db
         del galaxy
 
-        remap(EdgeInfo[0], EdgeInfo[1], NodeInfo[0])
-        g = dgl.graph((EdgeInfo[0], EdgeInfo[1]))
-        g.ndata['feat'] = torch.tensor(NodeInfo[1])
-        g.ndata['label'] = torch.tensor(NodeInfo[2])
+        src, dst = remap(EdgeInfo[0], EdgeInfo[1], NodeInfo[0])
+        g = dgl.graph((torch.from_numpy(src), torch.from_numpy(dst)),
+                num_nodes=len(NodeInfo[0]))
+        g.ndata['feat'] = torch.from_numpy(NodeInfo[1])
+        g.ndata['label'] = torch.from_numpy(NodeInfo[2])
         return g
 
 def test_fork(args):
@@ -156,7 +170,7 @@ def train(dataloader, model):
     optimizer = torch.optim.Adam(model.parameters(), lr=1e-2, weight_decay=5e-4)
     model.train()
     s = time.time()
-    for graph in dataloader:
+    for graph in prefetch(dataloader):
         load_time = time.time()
         graph = dgl.add_self_loop(graph)
         logits = model(graph, graph.ndata['feat'])
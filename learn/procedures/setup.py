@@ -43,7 +43,7 @@ ext_modules = [
         include_dirs=["../../src", "../../include"],
         library_dirs=['../../build/output'],
         extra_link_args=['-Wall', '-g', "-fno-gnu-unique", "-fPIC", "--std=c++17", "-rdynamic", "-O3", "-fopenmp"]
-    )
+    ),
     Extension(
         'node2vec_sampling', ['node2vec_sampling.py'],
         libraries=['lgraph'],
@@ -14,6 +14,9 @@
 
 #pragma once
 
+#include <cmath>
+#include <stdexcept>
+#include <string>
 #include <unordered_set>
 #include "lgraph/olap_base.h"
 
@@ -22,6 +25,61 @@ using namespace lgraph_api::olap;
 
 const double SSSP_INIT_VALUE = 2e10;
 
+/**
+ * @brief    Choose the bucket width of delta-stepping shortest path algorithms, and check that
+ *           the graph can be searched by delta-stepping.
+ *
+ * @exception    std::runtime_error    Raised when an edge weight is negative or NaN, or when
+ *                                     delta is infinite.
+ *
+ * @param[in]    graph    The graph to compute on.
+ * @param[in]    delta    The requested width, non-positive to use the average edge weight.
+ *
+ * @return   The bucket width to use, which is positive and finite.
+ */
+inline double DeltaSteppingWidth(OlapBase<double>& graph, double delta) {
+    if (std::isinf(delta)) throw std::runtime_error("delta must be finite");
+    size_t num_invalid = graph.ProcessVertexInRange<size_t>(
+        [&](size_t v_i) {
+            size_t local_invalid = 0;
+            for (auto& edge : graph.OutEdges(v_i)) {
+                if (!(edge.edge_data >= 0)) local_invalid += 1;
+            }
+            return local_invalid;
+        },
+        0, graph.NumVertices());
+    if (num_invalid != 0) {
+        throw std::runtime_error("delta-stepping needs non-negative edge weights, " +
+                                 std::to_string(num_invalid) + " edges are negative or NaN");
+    }
+    if (delta > 0) return delta;
+    if (graph.NumEdges() == 0) return 1.0;
+    double total_weight = graph.ProcessVertexInRange<double>(
+        [&](size_t v_i) {
+            double local_weight = 0;
+            for (auto& edge : graph.OutEdges(v_i)) local_weight += edge.edge_data;
+            return local_weight;
+        },
+        0, graph.NumVertices());
+    delta = total_weight / graph.NumEdges();
+    return delta > 0 && !std::isinf(delta) ? delta : 1.0;
+}
+
+/**
+ * @brief    Get the delta-stepping bucket of a distance. Distances too large for a bucket index
+ *           share the last bucket.
+ *
+ * @param[in]    distance    The non-negative distance.
+ * @param[in]    delta       The bucket width returned by DeltaSteppingWidth.
+ *
+ * @return   The bucket of the distance.
+ */
+inline size_t DeltaSteppingBucket(double distance, double delta) {
+    const size_t max_bucket = (size_t)1 << 62;
+    double bucket = distance / delta;
+    return bucket < (double)max_bucket ? (size_t)bucket : max_bucket;
+}
+
 /**
  * @brief    Compute the shortest path length between any two vertices in the graph.
  *
@@ -105,6 +163,20 @@ void PPRCore(OlapBase<Empty>& graph, ParallelVector<double>& curr, size_t root,
  */
 void SSSPCore(OlapBase<double>& graph, size_t root, ParallelVector<double>& distance);
 
+/**
+ * \brief   Perform a delta-stepping SSSP from root vertex. Vertices are settled
+ *          bucket by bucket with lock-free relaxations, which does far less work
+ *          than SSSPCore on weighted graphs with a large diameter. Edge weights
+ *          must be non-negative.
+ *
+ * \param               graph     The graph to compute on.
+ * \param               root      The root vertex id to start sssp from.
+ * \param   [in,out]    distance  The ParallelVector to store distance.
+ * \param               delta     The bucket width, non-positive to use the average edge weight.
+ */
+void SSSPDeltaCore(OlapBase<double>& graph, size_t root, ParallelVector<double>& distance,
+                   double delta = 0);
+
 /**
  * \brief   Compute the weakly connected components.
  *
@@ -304,6 +376,18 @@ void MotifCore(OlapBase<Empty>& graph, ParallelVector<size_t>& motif_vertices, i
  */
 void MSSPCore(OlapBase<double>& graph, std::vector<size_t> roots, ParallelVector<double>& distance);
 
+/**
+ * @brief    Compute Multiple-source Shortest Paths with delta-stepping. Edge weights must be
+ *           non-negative.
+ *
+ * @param[in]       graph          The graph to compute on.
+ * @param[in]       root           The set of root vertex.
+ * @param[in,out]   distance       The ParallelVector to store shostest distance.
+ * @param[in]       delta          The bucket width, non-positive to use the average edge weight.
+ */
+void MSSPDeltaCore(OlapBase<double>& graph, std::vector<size_t> roots,
+                   ParallelVector<double>& distance, double delta = 0);
+
 /**
  * @brief    Compute the Subgraph Isomorphism Algorithm.
  *
@@ -370,6 +454,20 @@ double SLPACore(OlapBase<Empty>& graph,
  */
 size_t SPSPCore(OlapBase<Empty>& graph, std::pair<size_t, size_t> search_pair);
 
+/**
+ * @brief    Compute the weighted Single Pair Shortest Path with delta-stepping. The search
+ *           stops as soon as no remaining bucket can improve the distance to the destination.
+ *           Edge weights must be non-negative.
+ *
+ * @param[in]    graph           The graph to compute on.
+ * @param[in]    search_pair     The vertex pair to compute.
+ * @param[in]    delta           The bucket width, non-positive to use the average edge weight.
+ *
+ * @return    return the shortest path distance of search pair, SSSP_INIT_VALUE if unreachable.
+ */
+double SPSPDeltaCore(OlapBase<double>& graph, std::pair<size_t, size_t> search_pair,
+                     double delta = 0);
+
 /**
  * @brief    Compute the Trustrank algorithm.
  *
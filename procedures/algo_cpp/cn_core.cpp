@@ -18,39 +18,20 @@
 using namespace lgraph_api;
 using namespace lgraph_api::olap;
 
-size_t cn_count_common(AdjList<Empty> & list_a, AdjList<Empty> & list_b) {
-    size_t local_count = 0;
-    AdjUnit<Empty> * ptr_a = list_a.begin();
-    AdjUnit<Empty> * ptr_b = list_b.begin();
-    while (ptr_a != list_a.end() && ptr_b != list_b.end()) {
-        if (ptr_a->neighbour < ptr_b->neighbour) {
-          ptr_a++;
-        } else if (ptr_a->neighbour > ptr_b->neighbour) {
-          ptr_b++;
-        } else {
-          local_count++;
-          ptr_a++;
-          ptr_b++;
-        }
+std::vector<size_t> cn_neighbour_set(OlapBase<Empty> & graph, size_t vid) {
+    std::vector<size_t> neighbours;
+    neighbours.reserve(graph.OutDegree(vid));
+    for (auto & edge : graph.OutEdges(vid)) {
+        neighbours.push_back(edge.neighbour);
     }
-    return local_count;
-}
-
-int cn_compare(const void * a, const void * b) {
-    const AdjUnit<Empty> * ptr_a = (const AdjUnit<Empty>*) a;
-    const AdjUnit<Empty> * ptr_b = (const AdjUnit<Empty>*) b;
-    return (ptr_a->neighbour - ptr_b->neighbour);
+    std::sort(neighbours.begin(), neighbours.end());
+    neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+    return neighbours;
 }
 
 size_t CNCore(OlapBase<Empty> & graph, std::pair<size_t, size_t> search_pair) {
-    size_t src = search_pair.first;
-    size_t dst = search_pair.second;
-
-    qsort(graph.OutEdges(src).begin(), graph.OutDegree(src), sizeof(AdjUnit<Empty>), cn_compare);
-    qsort(graph.OutEdges(dst).begin(), graph.OutDegree(dst), sizeof(AdjUnit<Empty>), cn_compare);
-
-    AdjList<Empty> src_list = graph.OutEdges(src);
-    AdjList<Empty> dst_list = graph.OutEdges(dst);
+    std::vector<size_t> src_list = cn_neighbour_set(graph, search_pair.first);
+    std::vector<size_t> dst_list = cn_neighbour_set(graph, search_pair.second);
 
-    return cn_count_common(src_list, dst_list);
+    return IntersectCount(src_list.data(), src_list.size(), dst_list.data(), dst_list.size());
 }
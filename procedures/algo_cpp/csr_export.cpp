@@ -0,0 +1,97 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+/*
+ * Writes a snapshot of the graph to a binary csr file, which standalone
+ * algorithms can then map with --type csr instead of loading edge lists.
+ */
+#include "lgraph/olap_on_db.h"
+#include "tools/json.hpp"
+
+using namespace lgraph_api;
+using namespace lgraph_api::olap;
+using json = nlohmann::json;
+
+/**
+ * Processes a request on a GraphDB.
+ *
+ * @param db The reference to the GraphDB object on which the request will be processed.
+ * @param request The input request in JSON format.
+ *        The request should contain the following parameters:
+ *        - "output_file": The path of the csr file to write.
+ *        - "undirected": Whether to write the graph as undirected, defaults to false.
+ *        - "id_mapping": Whether to map the vertex ids to a dense range and store
+ *          the original ids in the file, defaults to false.
+ * @param response The output response in JSON format.
+ *        The response will contain the following parameters:
+ *        - "num_vertices": The number of vertices in the graph.
+ *        - "num_edges": The number of edges in the graph.
+ *        - "prepare_cost": The time cost of preparing the graph data.
+ *        - "output_cost": The time cost of writing the csr file.
+ *        - "total_cost": The total time cost.
+ * @return True if the request is processed successfully, false otherwise.
+ */
+extern "C" bool Process(GraphDB& db, const std::string& request, std::string& response) {
+    double start_time;
+
+    // prepare
+    start_time = get_time();
+    std::string output_file = "";
+    bool undirected = false;
+    bool id_mapping = false;
+    std::cout << "Input: " << request << std::endl;
+    try {
+        json input = json::parse(request);
+        parse_from_json(output_file, "output_file", input);
+        parse_from_json(undirected, "undirected", input);
+        parse_from_json(id_mapping, "id_mapping", input);
+    } catch (std::exception& e) {
+        response = "json parse error: " + std::string(e.what());
+        std::cout << response << std::endl;
+        return false;
+    }
+    if (output_file == "") {
+        response = "output_file is required";
+        return false;
+    }
+
+    auto txn = db.CreateReadTxn();
+    size_t flags = SNAPSHOT_PARALLEL;
+    if (undirected) flags |= SNAPSHOT_UNDIRECTED;
+    if (id_mapping) flags |= SNAPSHOT_IDMAPPING;
+    OlapOnDB<Empty> olapondb(db, txn, flags);
+    auto prepare_cost = get_time() - start_time;
+
+    // output
+    start_time = get_time();
+    if (id_mapping) {
+        olapondb.WriteCsr(output_file,
+                          [&](size_t vid) { return std::to_string(olapondb.OriginalVid(vid)); });
+    } else {
+        olapondb.WriteCsr(output_file);
+    }
+    auto output_cost = get_time() - start_time;
+
+    // return
+    {
+        json output;
+        output["num_vertices"] = olapondb.NumVertices();
+        output["num_edges"] = olapondb.NumEdges();
+        output["prepare_cost"] = prepare_cost;
+        output["output_cost"] = output_cost;
+        output["total_cost"] = prepare_cost + output_cost;
+        response = output.dump();
+    }
+    return true;
+}
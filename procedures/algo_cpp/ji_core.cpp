@@ -18,76 +18,22 @@
 using namespace lgraph_api;
 using namespace lgraph_api::olap;
 
-size_t JiCountCommon(AdjList<Empty> &list_a, AdjList<Empty> &list_b, size_t a, size_t b) {
-    size_t local_count = 0;
-    AdjUnit<Empty> *ptr_a = list_a.begin();
-    AdjUnit<Empty> *ptr_b = list_b.begin();
-    size_t pre_a = -1;
-    size_t pre_b = -1;
-    while (ptr_a != list_a.end() && ptr_b != list_b.end()) {
-        if (pre_a == ptr_a->neighbour || ptr_a->neighbour == a) {
-            ptr_a++;
-            continue;
-        }
-        if (pre_b == ptr_b->neighbour || ptr_b->neighbour == b) {
-            ptr_b++;
-            continue;
-        }
-        if (ptr_a->neighbour < ptr_b->neighbour) {
-            pre_a = ptr_a->neighbour;
-            ptr_a++;
-        } else if (ptr_a->neighbour > ptr_b->neighbour) {
-            pre_b = ptr_b->neighbour;
-            ptr_b++;
-        } else {
-            pre_a = ptr_a->neighbour;
-            pre_b = ptr_b->neighbour;
-            local_count++;
-            ptr_a++;
-            ptr_b++;
-        }
+std::vector<size_t> JiNeighbourSet(OlapBase<Empty> &graph, size_t vid) {
+    std::vector<size_t> neighbours;
+    neighbours.reserve(graph.OutDegree(vid));
+    for (auto &edge : graph.OutEdges(vid)) {
+        if (edge.neighbour != vid) neighbours.push_back(edge.neighbour);
     }
-    return local_count;
-}
-
-int JiCompare(const void *a, const void *b) {
-    const AdjUnit<Empty> *ptr_a = (const AdjUnit<Empty> *)a;
-    const AdjUnit<Empty> *ptr_b = (const AdjUnit<Empty> *)b;
-    return (ptr_a->neighbour - ptr_b->neighbour);
+    std::sort(neighbours.begin(), neighbours.end());
+    neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+    return neighbours;
 }
 
 double JiCore(OlapBase<Empty> &graph, std::pair<size_t, size_t> search_pair) {
-    size_t src = search_pair.first;
-    size_t dst = search_pair.second;
-
-    qsort(graph.OutEdges(src).begin(), graph.OutDegree(src), sizeof(AdjUnit<Empty>),
-          JiCompare);
-    qsort(graph.OutEdges(dst).begin(), graph.OutDegree(dst), sizeof(AdjUnit<Empty>),
-          JiCompare);
-
-    size_t prev = (size_t)-1;
-    size_t src_valid_degree = 0;
-    for (auto &edge : graph.OutEdges(src)) {
-        auto nbr = edge.neighbour;
-        if (prev == nbr || nbr == src) {
-            continue;
-        } else {
-            src_valid_degree += 1;
-            prev = nbr;
-        }
-    }
-
-    prev = (size_t)-1;
-    size_t dst_valid_degree = 0;
-    for (auto &edge : graph.OutEdges(dst)) {
-        auto nbr = edge.neighbour;
-        if (prev == nbr || nbr == dst) {
-            continue;
-        } else {
-            dst_valid_degree += 1;
-            prev = nbr;
-        }
-    }
+    std::vector<size_t> src_list = JiNeighbourSet(graph, search_pair.first);
+    std::vector<size_t> dst_list = JiNeighbourSet(graph, search_pair.second);
+    size_t src_valid_degree = src_list.size();
+    size_t dst_valid_degree = dst_list.size();
 
     double score = 0.0;
     if (src_valid_degree == 0 && dst_valid_degree == 0) {
@@ -95,9 +41,8 @@ double JiCore(OlapBase<Empty> &graph, std::pair<size_t, size_t> search_pair) {
     } else if (src_valid_degree == 0 || dst_valid_degree == 0) {
         score = 0.0;
     } else {
-        AdjList<Empty> src_list = graph.OutEdges(src);
-        AdjList<Empty> dst_list = graph.OutEdges(dst);
-        size_t count = JiCountCommon(src_list, dst_list, src, dst);
+        size_t count = IntersectCount(src_list.data(), src_valid_degree,
+                                      dst_list.data(), dst_valid_degree);
         score = 1.0 * count / (src_valid_degree + dst_valid_degree - count);
     }
 
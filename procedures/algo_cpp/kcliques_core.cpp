@@ -18,158 +18,68 @@
 using namespace lgraph_api;
 using namespace lgraph_api::olap;
 
-bool CheckClique(std::vector<std::vector<int> >& edges, int k, int* clique) {
-    auto compare_edge = [&](const int& a, const int& b) -> bool { return (a > b) ? true : false; };
-    for (int i = 0; i < k - 1; i++) {
-        auto& outgoing_adj = edges[clique[i]];
-        if (!std::binary_search(outgoing_adj.begin(), outgoing_adj.end(), clique[k],
-                                compare_edge)) {
-            return false;
+/**
+ * Extend a clique of `depth` vertices whose common higher-ranked neighbours
+ * are candidates[depth - 1], counting the cliques of value_k vertices.
+ */
+size_t ExtendClique(SortedNeighbours& neighbours, int value_k, int depth,
+                    std::vector<size_t>& clique, std::vector<std::vector<size_t> >& candidates,
+                    ParallelVector<size_t>& cliques_cnt) {
+    auto& cands = candidates[depth - 1];
+    if (depth == value_k - 1) {
+        for (auto v : cands) {
+            write_add(&cliques_cnt[v], (size_t)1);
         }
+        for (int c_v = 0; c_v < depth; c_v++) {
+            write_add(&cliques_cnt[clique[c_v]], cands.size());
+        }
+        return cands.size();
     }
-    return true;
+    size_t local_cnt = 0;
+    auto& next = candidates[depth];
+    for (size_t i = 0; i < cands.size(); i++) {
+        size_t v = cands[i];
+        next.clear();
+        IntersectForEach(cands.data(), cands.size(), neighbours.Begin(v), neighbours.Degree(v),
+                         [&](size_t pos_cands, size_t pos_v) {
+                             next.push_back(cands[pos_cands]);
+                         });
+        if (next.size() + depth + 1 < (size_t)value_k) {
+            continue;
+        }
+        clique[depth] = v;
+        local_cnt += ExtendClique(neighbours, value_k, depth + 1, clique, candidates,
+                                  cliques_cnt);
+    }
+    return local_cnt;
 }
 
 size_t KCliquesCore(OlapBase<Empty>& graph, int value_k, ParallelVector<size_t>& cliques_cnt) {
     size_t vertices_num = graph.NumVertices();
-    std::vector<int> orders;
-    auto index_order = graph.AllocVertexArray<int>();
-    index_order.Fill(0);
-    orders.resize(vertices_num);
-
-    auto compare_adj = [](const void* a, const void* b) -> int {
-        auto ptr_a = (AdjUnit<Empty>*)a;
-        auto ptr_b = (AdjUnit<Empty>*)b;
-        return ptr_a->neighbour > ptr_b->neighbour ? 1 : -1;
-    };
-    graph.ProcessVertexInRange<int>(
-        [&](size_t v) {
-            orders[v] = v;
-            auto out_edges = graph.OutEdges(v);
-            std::qsort(out_edges.begin(), graph.OutDegree(v), sizeof(AdjUnit<Empty>), compare_adj);
-            return 0;
-        },
-        0, vertices_num);
-    // order[v] = m中存储的是排名为v的节点m
-    auto compare_index = [&](const int& a, const int& b) -> bool {
-        return (graph.OutDegree(a) > graph.OutDegree(b)) ? true : false;
-    };
-    std::sort(orders.begin(), orders.end(), compare_index);
-    // index_order[v] = m：节点v的排名为m，排名顺序由出边数决定
-    graph.ProcessVertexInRange<int>(
-        [&](size_t v) {
-            index_order[orders[v]] = v;
-            return 0;
-        },
-        0, vertices_num);
-
-    auto edge_num = graph.AllocVertexArray<int>();
-    edge_num.Fill(0);
-    auto num_edges = graph.ProcessVertexInRange<size_t>(
-        [&](size_t v) {
-            size_t v_order = index_order[v];
-            size_t local_edges_num = 0;
-            size_t pre = -1;
-            for (auto e : graph.OutEdges(v)) {
-                size_t neighbour_order = index_order[e.neighbour];
-                if (pre == e.neighbour) {
-                    continue;
-                } else {
-                    pre = e.neighbour;
-                }
-
-                if (v_order > neighbour_order) {
-                    local_edges_num++;
-                }
-            }
-            edge_num[v] = local_edges_num;
-            return local_edges_num;
-        },
-        0, vertices_num);
-    std::cout << "num_edges = " << num_edges << std::endl;
-
-    std::vector<std::vector<int> > edges(vertices_num);
-    for (size_t i = 0; i < vertices_num; i++) {
-        edges[i].resize(edge_num[orders[i]]);
+    if (value_k < 1) {
+        return 0;
+    }
+    if (value_k == 1) {
+        cliques_cnt.Fill(1);
+        return vertices_num;
     }
 
-    size_t sorted_edges = graph.ProcessVertexInRange<size_t>(
-        [&](size_t i) {
-            int vid = orders[i];
-            size_t local_index = 0;
-            size_t pre = -1;
-            for (auto e : graph.OutEdges(vid)) {
-                if (pre == e.neighbour) {
-                    continue;
-                } else {
-                    pre = e.neighbour;
-                }
-                size_t neighbour_index = index_order[e.neighbour];
-                if (neighbour_index < i) {
-                    edges[i][local_index] = neighbour_index;
-                    local_index++;
-                }
-            }
-            return local_index;
-        },
-        0, vertices_num);
-
-    assert(sorted_edges == num_edges);
-    std::cout << "sorted_edges = " << sorted_edges << std::endl;
-
-    auto compare_edge = [&](const int& a, const int& b) -> bool { return (a > b) ? true : false; };
-
-    graph.ProcessVertexInRange<int>(
-        [&](size_t i) {
-            std::sort(edges[i].begin(), edges[i].end(), compare_edge);
-            return 0;
-        },
-        0, vertices_num);
+    // each edge is kept at its endpoint of lower rank, so that every clique is
+    // listed exactly once from its lowest-ranked vertex
+    auto neighbours = graph.AllocSortedNeighbours(true);
+    std::cout << "num_edges = " << neighbours.NumEdges() << std::endl;
     printf("sorted\n");
 
     size_t kcliques = graph.ProcessVertexInRange<size_t>(
         [&](size_t v_0) {
-            size_t local_cnt = 0;
-            int* clique = new int[value_k];
-            size_t* degree_offset = new size_t[value_k];
-            memset(clique, -1, value_k * sizeof(int));
-            memset(degree_offset, 0, value_k * sizeof(size_t));
-            int idx = 1;
-            clique[0] = v_0;
-            while (idx > 0) {
-                int pre_v = clique[idx - 1];
-                auto out_edges = edges[pre_v];
-                size_t edge_idx = 0;
-                for (edge_idx = degree_offset[idx - 1]; edge_idx < edges[pre_v].size();
-                     edge_idx++) {
-                    auto nbr = *(out_edges.begin() + edge_idx);
-                    assert(nbr < pre_v);
-                    clique[idx] = nbr;
-                    if (!CheckClique(edges, idx, clique)) {
-                        continue;
-                    }
-                    if (idx == value_k - 1) {
-                        for (int c_v = 0; c_v < value_k; c_v++) {
-                            write_add(&cliques_cnt[orders[clique[c_v]]], (size_t)1);
-                        }
-                        local_cnt++;
-                        continue;
-                    }
-                    degree_offset[idx] = 0;
-                    degree_offset[idx - 1] = edge_idx + 1;
-                    idx++;
-                    break;
-                }
-                if (edge_idx >= edges[pre_v].size()) {
-                    clique[idx] = -1;
-                    idx--;
-                    degree_offset[idx] = 0;
-                    clique[idx] = -1;
-                }
+            if (neighbours.Degree(v_0) + 1 < (size_t)value_k) {
+                return (size_t)0;
             }
-            delete clique;
-            delete degree_offset;
-            return local_cnt;
+            std::vector<size_t> clique(value_k);
+            std::vector<std::vector<size_t> > candidates(value_k);
+            clique[0] = v_0;
+            candidates[0].assign(neighbours.Begin(v_0), neighbours.End(v_0));
+            return ExtendClique(neighbours, value_k, 1, clique, candidates, cliques_cnt);
         },
         0, vertices_num);
 
@@ -18,101 +18,47 @@
 using namespace lgraph_api;
 using namespace lgraph_api::olap;
 
-size_t count_common(ParallelVector<size_t>& num_triangle,
-                    AdjList<Empty>& list_a, AdjList<Empty>& list_b, size_t a, size_t b) {
-    size_t local_count = 0;
-    AdjUnit<Empty>* ptr_a = list_a.begin();
-    AdjUnit<Empty>* ptr_b = list_b.begin();
-    size_t pre_a = -1;
-    size_t pre_b = -1;
-    size_t threshold = (a < b) ? a : b;
-    while (ptr_a != list_a.end() && ptr_b != list_b.end()
-                && ptr_a->neighbour < threshold && ptr_b->neighbour < threshold) {
-        if (pre_a == ptr_a->neighbour) {
-            ptr_a++;
-            continue;
-        }
-        if (pre_b == ptr_b->neighbour) {
-            ptr_b++;
-            continue;
-        }
-        if (ptr_a->neighbour < ptr_b->neighbour) {
-            pre_a = ptr_a->neighbour;
-            ptr_a++;
-        } else if (ptr_a->neighbour > ptr_b->neighbour) {
-            pre_b = ptr_b->neighbour;
-            ptr_b++;
-        } else {
-            pre_a = ptr_a->neighbour;
-            pre_b = ptr_b->neighbour;
-            write_add(&num_triangle[a], (size_t)1);
-            write_add(&num_triangle[b], (size_t)1);
-            write_add(&num_triangle[pre_a], (size_t)1);
-            local_count++;
-            ptr_a++;
-            ptr_b++;
-        }
-    }
-    return local_count;
-}
-
-int compare(const void *a, const void *b) {
-    const AdjUnit<Empty> *ptr_a = (const AdjUnit<Empty> *)a;
-    const AdjUnit<Empty> *ptr_b = (const AdjUnit<Empty> *)b;
-    return (ptr_a->neighbour - ptr_b->neighbour);
-}
-
 double LCCCore(OlapBase<Empty>& graph, ParallelVector<double>& score) {
     score.Fill(0.0);
     size_t num_vertices = graph.NumVertices();
     auto num_triangle = graph.AllocVertexArray<size_t>();
     num_triangle.Fill(0);
-
-    graph.ProcessVertexInRange<size_t>(
-        [&](size_t vi) {
-            auto edges = graph.OutEdges(vi);
-            qsort(edges.begin(), graph.OutDegree(vi), sizeof(AdjUnit<Empty>), compare);
-            return 1;
-        },
-        0, num_vertices);
+    // every edge is kept at one endpoint only, so the distinct degree of a
+    // vertex is the length of its own list plus the lists it appears in
+    auto valid_degree = graph.AllocVertexArray<size_t>();
+    valid_degree.Fill(0);
+    auto neighbours = graph.AllocSortedNeighbours(true);
 
     graph.ProcessVertexInRange<size_t>(
         [&](size_t src) {
-            if (graph.OutDegree(src) < 2) {return (size_t)0;}
-                size_t local_count = 0;
-                AdjList<Empty> src_adj = graph.OutEdges(src);
-                size_t pre = -1;
-                for (auto edge : src_adj) {
-                    size_t dst = edge.neighbour;
-                    if (pre == dst) {
-                        continue;
-                    } else {
-                        pre = dst;
-                    }
-                    if (src < dst) {
-                        AdjList<Empty> neighbour_adj = graph.OutEdges(dst);
-                        local_count += count_common(num_triangle, src_adj, neighbour_adj, src, dst);
-                    }
+            size_t local_count = 0;
+            const size_t* src_adj = neighbours.Begin(src);
+            size_t src_degree = neighbours.Degree(src);
+            write_add(&valid_degree[src], src_degree);
+            for (size_t i = 0; i < src_degree; i++) {
+                size_t dst = src_adj[i];
+                write_add(&valid_degree[dst], (size_t)1);
+                size_t common = IntersectForEach(src_adj, src_degree,
+                    neighbours.Begin(dst), neighbours.Degree(dst),
+                    [&](size_t pos_src, size_t pos_dst) {
+                        write_add(&num_triangle[src_adj[pos_src]], (size_t)1);
+                    });
+                if (common != 0) {
+                    write_add(&num_triangle[dst], common);
+                    local_count += common;
                 }
-                return local_count;
+            }
+            if (local_count != 0) {
+                write_add(&num_triangle[src], local_count);
+            }
+            return local_count;
         },
         0, num_vertices);
 
     graph.ProcessVertexInRange<size_t>(
         [&](size_t v) {
-            size_t valid_degree = 0;
-            size_t prev_nbr = (size_t)-1;
-            for (auto edge : graph.OutEdges(v)) {
-                auto nbr = edge.neighbour;
-                if (nbr == prev_nbr || nbr == v) {
-                    continue;
-                } else {
-                    valid_degree += 1;
-                    prev_nbr = nbr;
-                }
-            }
-            if (valid_degree < 2) return 0;
-            score[v] = 2.0 * num_triangle[v] / (valid_degree) / (valid_degree - 1);
+            if (valid_degree[v] < 2) return 0;
+            score[v] = 2.0 * num_triangle[v] / (valid_degree[v]) / (valid_degree[v] - 1);
             return 0;
         },
         0, num_vertices);
@@ -57,3 +57,33 @@ void MSSPCore(OlapBase<double>& graph,
         active_in.Swap(active_out);
     }
 }
+
+void MSSPDeltaCore(OlapBase<double>& graph, std::vector<size_t> roots,
+                   ParallelVector<double>& distance, double delta) {
+    delta = DeltaSteppingWidth(graph, delta);
+    distance.Fill(SSSP_INIT_VALUE);
+    auto frontier = graph.AllocBucketedFrontier();
+    for (auto ele : roots) {
+        distance[ele] = 0.0;
+        frontier.Push(ele, 0);
+    }
+    for (int ii = 0; frontier.Advance(); ii++) {
+        size_t bucket = frontier.CurrentBucket();
+        printf("activates(%d) <= %lu in bucket %lu\n", ii, frontier.Size(), bucket);
+        graph.ProcessVertexBucket<size_t>(
+            [&](size_t v_i) {
+                if (distance[v_i] < delta * bucket) return (size_t)0;
+                size_t local_num_activations = 0;
+                for (auto& edge : graph.OutEdges(v_i)) {
+                    size_t dst = edge.neighbour;
+                    double update_distance = distance[v_i] + edge.edge_data;
+                    if (write_min(&distance[dst], update_distance)) {
+                        frontier.Push(dst, DeltaSteppingBucket(update_distance, delta));
+                        local_num_activations += 1;
+                    }
+                }
+                return local_num_activations;
+            },
+            frontier);
+    }
+}
@@ -26,6 +26,7 @@ extern "C" bool Process(GraphDB& db, const std::string& request, std::string& re
     std::string root_label = "node";
     std::string root_field = "id";
     std::string output_file = "";
+    double delta = 0;
 
     // prepare
     start_time = get_time();
@@ -37,6 +38,7 @@ extern "C" bool Process(GraphDB& db, const std::string& request, std::string& re
             root_values.push_back(item.get<std::string>());
         }
         parse_from_json(output_file, "output_file", input);
+        parse_from_json(delta, "delta", input);
     } catch (std::exception& e) {
         throw std::runtime_error("json parse error");
     }
@@ -55,7 +57,11 @@ extern "C" bool Process(GraphDB& db, const std::string& request, std::string& re
      // core
     start_time = get_time();
     ParallelVector<double> distance = olapondb.AllocVertexArray<double>();
-    MSSPCore(olapondb, roots, distance);
+    if (delta == 0) {
+        MSSPCore(olapondb, roots, distance);
+    } else {
+        MSSPDeltaCore(olapondb, roots, distance, delta);
+    }
     auto core_cost = get_time() - start_time;
 
     if (output_file != "") {
@@ -33,16 +33,21 @@ class MyConfig : public ConfigBase<double> {
  public:
     std::string name = "mssp";
     std::string roots_dir = "";
+    double delta = 0;
 
     void AddParameter(fma_common::Configuration & config) {
         ConfigBase<double>::AddParameter(config);
         config.Add(roots_dir, "roots_dir", true)
             .Comment("roots_dir of mssp");
+        config.Add(delta, "delta", true)
+            .Comment("bucket width of delta-stepping, 0 for Bellman-Ford, "
+                     "negative for the average edge weight");
     }
     void Print() {
         ConfigBase<double>::Print();
         std::cout << "  name: " << name << std::endl;
         std::cout << "  roots_dir: " << roots_dir << std::endl;
+        std::cout << "  delta: " << delta << std::endl;
     }
     MyConfig(int & argc, char** & argv) : ConfigBase<double>(argc, argv) {
         parse_line = parse_line_weighted<double>;
@@ -90,7 +95,11 @@ int main(int argc, char ** argv) {
     // core
     start_time = get_time();
     ParallelVector<double> distance = graph.AllocVertexArray<double>();
-    MSSPCore(graph, roots, distance);
+    if (config.delta == 0) {
+        MSSPCore(graph, roots, distance);
+    } else {
+        MSSPDeltaCore(graph, roots, distance, config.delta);
+    }
     memUsage.print();
     memUsage.reset();
     auto core_cost = get_time() - start_time;
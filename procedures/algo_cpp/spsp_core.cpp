@@ -108,3 +108,37 @@ size_t SPSPCore(OlapBase<Empty> & graph, std::pair<size_t, size_t> search_pair)
     }
     return result_length;
 }
+
+double SPSPDeltaCore(OlapBase<double>& graph, std::pair<size_t, size_t> search_pair,
+                     double delta) {
+    size_t root_src = search_pair.first;
+    size_t root_dst = search_pair.second;
+    delta = DeltaSteppingWidth(graph, delta);
+
+    auto distance = graph.AllocVertexArray<double>();
+    distance.Fill(SSSP_INIT_VALUE);
+    distance[root_src] = 0.0;
+    auto frontier = graph.AllocBucketedFrontier();
+    frontier.Push(root_src, 0);
+    while (frontier.Advance()) {
+        size_t bucket = frontier.CurrentBucket();
+        // every vertex left in this or a later bucket is at least this far away
+        if (distance[root_dst] <= delta * bucket) break;
+        graph.ProcessVertexBucket<size_t>(
+            [&](size_t src) {
+                if (distance[src] < delta * bucket) return (size_t)0;
+                size_t activated = 0;
+                for (auto& edge : graph.OutEdges(src)) {
+                    size_t dst = edge.neighbour;
+                    double update_distance = distance[src] + edge.edge_data;
+                    if (write_min(&distance[dst], update_distance)) {
+                        frontier.Push(dst, DeltaSteppingBucket(update_distance, delta));
+                        activated += 1;
+                    }
+                }
+                return activated;
+            },
+            frontier);
+    }
+    return distance[root_dst];
+}
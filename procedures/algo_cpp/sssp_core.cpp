@@ -49,3 +49,33 @@ void SSSPCore(OlapBase<double>& graph, size_t root, ParallelVector<double>& dist
         active_in.Swap(active_out);
     }
 }
+
+void SSSPDeltaCore(OlapBase<double>& graph, size_t root, ParallelVector<double>& distance,
+                   double delta) {
+    delta = DeltaSteppingWidth(graph, delta);
+    std::cout << "root:" << root << ", delta:" << delta << std::endl;
+    distance.Fill(SSSP_INIT_VALUE);
+    distance[root] = 0.0;
+    auto frontier = graph.AllocBucketedFrontier();
+    frontier.Push(root, 0);
+    for (int ii = 0; frontier.Advance(); ii++) {
+        size_t bucket = frontier.CurrentBucket();
+        printf("activates(%d) <= %lu in bucket %lu\n", ii, frontier.Size(), bucket);
+        graph.ProcessVertexBucket<size_t>(
+            [&](size_t v_i) {
+                // settled in an earlier bucket after being pushed here
+                if (distance[v_i] < delta * bucket) return (size_t)0;
+                size_t local_num_activations = 0;
+                for (auto& edge : graph.OutEdges(v_i)) {
+                    size_t dst = edge.neighbour;
+                    double update_distance = distance[v_i] + edge.edge_data;
+                    if (write_min(&distance[dst], update_distance)) {
+                        frontier.Push(dst, DeltaSteppingBucket(update_distance, delta));
+                        local_num_activations += 1;
+                    }
+                }
+                return local_num_activations;
+            },
+            frontier);
+    }
+}
@@ -30,6 +30,8 @@ using json = nlohmann::json;
  *        - "root_label": The label of the root vertex.
  *        - "root_field": The field of the root vertex.
  *        - "output_file": Sssp distance to be written to the file.
+ *        - "delta": (Optional) The bucket width of delta-stepping. 0 (default) runs
+ *          Bellman-Ford, a negative value uses the average edge weight.
  * @param response The output response in JSON format.
  *        The response will contain the following parameters:
  *        - "max_distance_vid": The vertex id with the maximum distance.
@@ -51,6 +53,7 @@ extern "C" bool Process(GraphDB& db, const std::string& request, std::string& re
     std::string root_label = "node";
     std::string root_field = "id";
     std::string output_file = "";
+    double delta = 0;
     std::cout << "Input: " << request << std::endl;
     try {
         json input = json::parse(request);
@@ -58,6 +61,7 @@ extern "C" bool Process(GraphDB& db, const std::string& request, std::string& re
         parse_from_json(root_label, "root_label", input);
         parse_from_json(root_field, "root_field", input);
         parse_from_json(output_file, "output_file", input);
+        parse_from_json(delta, "delta", input);
     } catch (std::exception& e) {
         response = "json parse error: " + std::string(e.what());
         std::cout << response << std::endl;
@@ -73,7 +77,11 @@ extern "C" bool Process(GraphDB& db, const std::string& request, std::string& re
     // core
     start_time = get_time();
     ParallelVector<double> distance = olapondb.AllocVertexArray<double>();
-    SSSPCore(olapondb, olapondb.MappedVid(root_vid), distance);
+    if (delta == 0) {
+        SSSPCore(olapondb, olapondb.MappedVid(root_vid), distance);
+    } else {
+        SSSPDeltaCore(olapondb, olapondb.MappedVid(root_vid), distance, delta);
+    }
     auto core_cost = get_time() - start_time;
 
     // output
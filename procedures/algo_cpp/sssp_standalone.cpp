@@ -25,16 +25,21 @@ class MyConfig : public ConfigBase<double> {
  public:
     std::string root = "0";
     std::string name = std::string("sssp");
+    double delta = 0;
 
     void AddParameter(fma_common::Configuration & config) {
         ConfigBase<double>::AddParameter(config);
         config.Add(root, "root", true).Comment("the root of sssp");
+        config.Add(delta, "delta", true)
+            .Comment("bucket width of delta-stepping, 0 for Bellman-Ford, "
+                     "negative for the average edge weight");
     }
 
     void Print() {
         ConfigBase<double>::Print();
         std::cout << "  name: " << name << std::endl;
         std::cout << "  root: " << root << std::endl;
+        std::cout << "  delta: " << delta << std::endl;
     }
 
     MyConfig(int &argc, char** &argv): ConfigBase<double>(argc, argv) {
@@ -78,7 +83,11 @@ int main(int argc, char** argv) {
     // core
     start_time = get_time();
     ParallelVector<double> distance = graph.AllocVertexArray<double>();
-    SSSPCore(graph, root_vid, distance);
+    if (config.delta == 0) {
+        SSSPCore(graph, root_vid, distance);
+    } else {
+        SSSPDeltaCore(graph, root_vid, distance, config.delta);
+    }
     memUsage.print();
     memUsage.reset();
     auto core_cost = get_time() - start_time;
@@ -22,6 +22,8 @@ set(LGRAPH_CYPHER_SRC   # find cypher/ -name "*.cpp" | sort
         cypher/execution_plan/ops/op_apply.cpp
         cypher/execution_plan/ops/op_argument.cpp
         cypher/execution_plan/ops/op_cartesian_product.cpp
+        cypher/execution_plan/ops/op_hash_join.cpp
+        cypher/execution_plan/ops/op_expand_intersect.cpp
         cypher/execution_plan/ops/op_create.cpp
         cypher/execution_plan/ops/op_gql_create.cpp
         cypher/execution_plan/ops/op_delete.cpp
@@ -30,6 +32,7 @@ set(LGRAPH_CYPHER_SRC   # find cypher/ -name "*.cpp" | sort
         cypher/execution_plan/ops/op_expand_all.cpp
         cypher/execution_plan/ops/op_filter.cpp
         cypher/execution_plan/ops/op_node_index_seek.cpp
+        cypher/execution_plan/ops/op_node_index_scan.cpp
         cypher/execution_plan/ops/op_node_index_seek_dynamic.cpp
         cypher/execution_plan/ops/op_immediate_argument.cpp
         cypher/execution_plan/ops/op_inquery_call.cpp
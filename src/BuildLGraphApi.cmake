@@ -25,6 +25,7 @@ GenerateProtobufCpp(${CMAKE_CURRENT_LIST_DIR}/protobuf
 
 set(LGRAPH_CORE_SRC
         core/audit_logger.cpp
+        core/column_store.cpp
         core/data_type.cpp
         core/edge_index.cpp
         core/field_extractor_base.cpp
@@ -41,6 +42,10 @@ set(LGRAPH_CORE_SRC
         core/lmdb_store.cpp
         core/lmdb_table.cpp
         core/lmdb_transaction.cpp
+        core/rocksdb_iterator.cpp
+        core/rocksdb_store.cpp
+        core/rocksdb_table.cpp
+        core/rocksdb_transaction.cpp
         core/kv_table_comparators.cpp
         core/lgraph_date_time.cpp
         core/lgraph_spatial.cpp
@@ -110,6 +115,7 @@ target_include_directories(${TARGET_LGRAPH} PUBLIC
 
 if (CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
     target_link_libraries(${TARGET_LGRAPH} PUBLIC
+            librocksdb.a
             vsag
             libgomp.a
             -static-libstdc++
@@ -131,6 +137,7 @@ if (CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
 elseif (CMAKE_CXX_COMPILER_ID MATCHES "Clang")
     if (CMAKE_SYSTEM_NAME STREQUAL "Darwin")
         target_link_libraries(${TARGET_LGRAPH} PUBLIC
+                librocksdb.a
                 vsag
                 /opt/OpenBLAS/lib/libopenblas.a
                 faiss
@@ -142,6 +149,7 @@ elseif (CMAKE_CXX_COMPILER_ID MATCHES "Clang")
                 ${JAVA_JVM_LIBRARY})
     else ()
         target_link_libraries(${TARGET_LGRAPH} PUBLIC
+                librocksdb.a
                 vsag
                 /opt/OpenBLAS/lib/libopenblas.a
                 faiss
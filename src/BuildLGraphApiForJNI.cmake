@@ -29,6 +29,7 @@ GenerateProtobufCpp(${CMAKE_CURRENT_LIST_DIR}/protobuf
 
 set(LGRAPH_CORE_SRC
         core/audit_logger.cpp
+        core/column_store.cpp
         core/data_type.cpp
         core/edge_index.cpp
         core/field_extractor_base.cpp
@@ -45,6 +46,10 @@ set(LGRAPH_CORE_SRC
         core/lmdb_store.cpp
         core/lmdb_table.cpp
         core/lmdb_transaction.cpp
+        core/rocksdb_iterator.cpp
+        core/rocksdb_store.cpp
+        core/rocksdb_table.cpp
+        core/rocksdb_transaction.cpp
         core/kv_table_comparators.cpp
         core/lgraph_date_time.cpp
         core/lightning_graph.cpp
@@ -112,6 +117,7 @@ target_include_directories(${TARGET_LGRAPH} PUBLIC
 
 if (CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
     target_link_libraries(${TARGET_LGRAPH} PUBLIC
+            librocksdb.a
             libgomp.a
             -static-libstdc++
             -static-libgcc
@@ -130,6 +136,7 @@ if (CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
 elseif (CMAKE_CXX_COMPILER_ID MATCHES "Clang")
     if (CMAKE_SYSTEM_NAME STREQUAL "Darwin")
         target_link_libraries(${TARGET_LGRAPH} PUBLIC
+                librocksdb.a
                 ${Boost_LIBRARIES}
                 omp
                 pthread
@@ -138,6 +145,7 @@ elseif (CMAKE_CXX_COMPILER_ID MATCHES "Clang")
                 ${JAVA_JVM_LIBRARY})
     else ()
         target_link_libraries(${TARGET_LGRAPH} PUBLIC
+                librocksdb.a
                 rt
                 omp
                 pthread
@@ -48,6 +48,7 @@ add_library(${TARGET_SERVER_LIB} STATIC
         server/lgraph_server.cpp
         server/state_machine.cpp
         server/ha_state_machine.cpp
+        server/ha_snapshot.cpp
         server/db_management_client.cpp
         import/import_online.cpp
         import/import_v2.cpp
@@ -16,6 +16,7 @@
 
 #include <gflags/gflags.h>
 #include <filesystem>
+#include <iterator>
 #include <shared_mutex>
 #include <boost/endian/conversion.hpp>
 #include <boost/lexical_cast.hpp>
@@ -203,6 +204,10 @@ bool RaftConfig::Check() {
         LOG_WARN() << "election_tick should be greater than 10";
         return false;
     }
+    if (apply_batch_size < 1) {
+        LOG_WARN() << "apply_batch_size should be greater than 0";
+        return false;
+    }
     return true;
 }
 
@@ -231,9 +236,11 @@ bool RaftLogStoreConfig::Check() {
 }
 
 RaftDriver::RaftDriver(std::function<void(uint64_t index, const RaftRequest&)> apply,
+                       std::function<void(uint64_t index)> persist_apply_index,
                        uint64_t apply_id, int64_t node_id, std::vector<eraft::Peer> init_peers,
                        const RaftLogStoreConfig& store_config, const RaftConfig& config)
     : apply_(std::move(apply)),
+      persist_apply_index_(std::move(persist_apply_index)),
       apply_id_(apply_id),
       node_id_(node_id),
       init_peers_(std::move(init_peers)),
@@ -271,6 +278,8 @@ eraft::Error RaftDriver::Run() {
     }
     storage_ = std::make_shared<RaftLogStorage>(db, cf_handles[0], cf_handles[1]);
     auto applied = std::max(apply_id_, storage_->GetApplyIndex());
+    committed_index_ = applied;
+    applied_index_ = applied;
     auto nodes = storage_->GetNodeInfos();
     if (nodes.has_value()) {
         node_infos_.ParseFromString(nodes.value());
@@ -442,6 +451,11 @@ RaftStatus RaftDriver::GetRaftStatus() {
         rs.s = rn_->GetStatus();
         rs.first_log = storage_->FirstIndex().first - 1;
         rs.last_log = storage_->LastIndex().first;
+        rs.committed_index = committed_index_;
+        rs.applied_index = applied_index_;
+        rs.apply_batches = apply_batches_;
+        rs.last_apply_lag_us = last_apply_lag_us_;
+        rs.max_apply_lag_us = max_apply_lag_us_;
         promise.set_value(rs);
     });
     return future.get();
@@ -526,44 +540,120 @@ void RaftDriver::CheckReady() {
             }
         }
         if (!has_confchange) {
-            apply_service_.post([this, committedEntries = std::move(ready.committedEntries_)]() {
-                Apply(committedEntries);
-            });
+            EnqueueCommitted(std::move(ready.committedEntries_));
         } else {
             LOG_INFO() << "there is ConfChange in committed entries, entries size: "
                        << ready.committedEntries_.size();
+            // conf changes are applied on this thread, after the entries committed before them
+            WaitCommittedApplied();
+            committed_index_ = ready.committedEntries_.back().index();
             Apply(ready.committedEntries_);
         }
     }
     rn_->Advance({});
 }
 
+void RaftDriver::EnqueueCommitted(std::vector<raftpb::Entry> entries) {
+    committed_index_ = entries.back().index();
+    bool need_post;
+    {
+        std::lock_guard<std::mutex> guard(committed_mutex_);
+        need_post = committed_queue_.empty();
+        committed_queue_.push_back({std::move(entries), steady_clock::now()});
+    }
+    // the raft thread goes on persisting and sending new entries while these are applied
+    if (need_post) {
+        apply_service_.post([this]() { DrainCommitted(); });
+    }
+}
+
+void RaftDriver::DrainCommitted() {
+    std::vector<CommittedEntries> queue;
+    {
+        std::lock_guard<std::mutex> guard(committed_mutex_);
+        queue.swap(committed_queue_);
+    }
+    if (queue.empty()) {
+        return;
+    }
+    std::vector<raftpb::Entry> entries;
+    if (queue.size() == 1) {
+        entries = std::move(queue[0].entries);
+    } else {
+        for (auto& committed : queue) {
+            std::move(committed.entries.begin(), committed.entries.end(),
+                      std::back_inserter(entries));
+        }
+    }
+    Apply(entries);
+    uint64_t lag = duration_cast<microseconds>(steady_clock::now() -
+                                               queue.front().commit_time).count();
+    last_apply_lag_us_ = lag;
+    if (lag > max_apply_lag_us_) {
+        max_apply_lag_us_ = lag;
+    }
+}
+
+void RaftDriver::WaitCommittedApplied() {
+    // the apply service runs its tasks in order, so the entries enqueued before are applied
+    // once this one runs
+    std::promise<void> promise;
+    apply_service_.post([&promise]() { promise.set_value(); });
+    promise.get_future().wait();
+}
+
 void RaftDriver::Apply(const std::vector<raftpb::Entry>& entries) {
-    for (const auto& entry : entries) {
+    // parse the normal entries and take the contexts of those proposed by this node
+    // for the whole batch up front
+    std::vector<RaftRequest> requests(entries.size());
+    std::vector<std::shared_ptr<bolt_raft::PromiseContext>> contexts(entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].type() == raftpb::EntryNormal && !entries[i].data().empty()) {
+            auto ret = requests[i].ParseFromString(entries[i].data());
+            FMA_ASSERT(ret);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> guard(promise_mutex_);
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (entries[i].type() != raftpb::EntryNormal || entries[i].data().empty()) {
+                continue;
+            }
+            auto iter = pending_promise_.find(requests[i].id());
+            if (iter != pending_promise_.end()) {
+                contexts[i] = std::move(iter->second);
+                pending_promise_.erase(iter);
+            }
+        }
+    }
+    // The apply index is persisted after every entry by default. With apply_batch_size > 1 it is
+    // persisted once per apply_batch_size entries, and the entries applied after the last
+    // persisted index are applied again after a crash.
+    uint64_t unpersisted = 0;
+    auto persist_apply_index = [&](uint64_t index) {
+        persist_apply_index_(index);
+        applied_index_ = index;
+        unpersisted = 0;
+    };
+    for (size_t i = 0; i < entries.size(); i++) {
+        const auto& entry = entries[i];
         switch (entry.type()) {
         case raftpb::EntryNormal:
             {
                 if (entry.data().empty()) {
                     continue;
                 }
-                RaftRequest request;
-                auto ret = request.ParseFromString(entry.data());
-                FMA_ASSERT(ret);
-                std::shared_ptr<bolt_raft::PromiseContext> context;
-                {
-                    std::lock_guard<std::mutex> guard(promise_mutex_);
-                    auto iter = pending_promise_.find(request.id());
-                    if (iter != pending_promise_.end()) {
-                        context = iter->second;
-                        pending_promise_.erase(iter);
-                    }
-                }
+                auto& context = contexts[i];
                 if (context) {
+                    // entries are applied in log order, so the next one waits for this one
                     context->index = entry.index();
                     context->commited.set_value();
                     context->applied.get_future().wait();
                 } else {
-                    apply_(entry.index(), request);
+                    apply_(entry.index(), requests[i]);
+                }
+                if (++unpersisted >= raft_config_.apply_batch_size) {
+                    persist_apply_index(entry.index());
                 }
                 break;
             }
@@ -649,6 +739,12 @@ void RaftDriver::Apply(const std::vector<raftpb::Entry>& entries) {
             }
         }
     }
+    if (unpersisted > 0) {
+        persist_apply_index(entries.back().index());
+    } else if (!entries.empty()) {
+        applied_index_ = entries.back().index();
+    }
+    apply_batches_++;
 }
 
 }  // namespace bolt_raft
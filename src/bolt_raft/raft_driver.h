@@ -89,12 +89,22 @@ struct RaftStatus {
     eraft::Status s;
     uint64_t first_log = 0;
     uint64_t last_log = 0;
+    // apply progress, the lags are from an entry being committed to it being applied
+    uint64_t committed_index = 0;
+    uint64_t applied_index = 0;
+    uint64_t apply_batches = 0;
+    uint64_t last_apply_lag_us = 0;
+    uint64_t max_apply_lag_us = 0;
 };
 
 struct RaftConfig {
     int64_t tick_interval = 0;
     int64_t election_tick = 0;
     int64_t heartbeat_tick = 0;
+    // maximum number of entries applied before the apply index is persisted. Entries applied
+    // after the last persisted index are applied again after a crash, so values above 1 are
+    // only safe when every entry is idempotent.
+    uint64_t apply_batch_size = 1;
     bool Check();
 };
 
@@ -109,7 +119,8 @@ struct RaftLogStoreConfig {
 
 class RaftDriver {
  public:
-    RaftDriver(std::function<void(uint64_t index, const RaftRequest&)> apply, uint64_t apply_id,
+    RaftDriver(std::function<void(uint64_t index, const RaftRequest&)> apply,
+               std::function<void(uint64_t index)> persist_apply_index, uint64_t apply_id,
                int64_t node_id, std::vector<eraft::Peer> init_peers,
                const RaftLogStoreConfig& store_config, const RaftConfig& config);
     eraft::Error Run();
@@ -125,14 +136,23 @@ class RaftDriver {
     void Tick();
     void CheckAndCompactLog();
     void CheckReady();
+    void EnqueueCommitted(std::vector<raftpb::Entry> entries);
+    void DrainCommitted();
+    void WaitCommittedApplied();
     void Apply(const std::vector<raftpb::Entry>& entries);
 
+    struct CommittedEntries {
+        std::vector<raftpb::Entry> entries;
+        std::chrono::steady_clock::time_point commit_time;
+    };
+
     std::vector<std::thread> threads_;
     boost::asio::io_service raft_service_;
     boost::asio::io_service timer_service_;
     boost::asio::io_service apply_service_;
     boost::asio::io_service client_service_;
     std::function<void(uint64_t, const RaftRequest&)> apply_;
+    std::function<void(uint64_t)> persist_apply_index_;
     uint64_t apply_id_;
     uint64_t node_id_;
     std::vector<eraft::Peer> init_peers_;
@@ -149,6 +169,14 @@ class RaftDriver {
     std::mutex promise_mutex_;
     std::unordered_map<uint64_t, std::shared_ptr<PromiseContext>> pending_promise_;
     std::unordered_set<uint64_t> mark_unreachable_;
+    // committed entries waiting for the apply thread, which takes all of them at once
+    std::mutex committed_mutex_;
+    std::vector<CommittedEntries> committed_queue_;
+    std::atomic<uint64_t> committed_index_{0};
+    std::atomic<uint64_t> applied_index_{0};
+    std::atomic<uint64_t> apply_batches_{0};
+    std::atomic<uint64_t> last_apply_lag_us_{0};
+    std::atomic<uint64_t> max_apply_lag_us_{0};
     RaftLogStoreConfig store_config_;
     RaftConfig raft_config_;
 };
@@ -79,6 +79,7 @@ LGraphResponse RpcClient::RpcSingleClient::HandleRequest(LGraphRequest* req) {
     cntl->request_attachment().append(FLAGS_attachment);
     req->set_client_version(server_version);
     req->set_token(token);
+    if (max_staleness_ms >= 0) req->set_max_staleness_ms(max_staleness_ms);
     LGraphRPCService_Stub stub(channel.get());
     LGraphResponse resp;
     stub.HandleRequest(cntl.get(), req, &resp, nullptr);
@@ -98,6 +99,7 @@ bool RpcClient::RpcSingleClient::HandleGraphQueryRequest(lgraph::GraphQueryType
     LGraphRequest req;
     req.set_client_version(server_version);
     req.set_token(token);
+    if (max_staleness_ms >= 0) req.set_max_staleness_ms(max_staleness_ms);
     lgraph::GraphQueryRequest* cypher_req = req.mutable_graph_query_request();
     cypher_req->set_type(type == lgraph::GraphQueryType::CYPHER ?
         lgraph::ProtoGraphQueryType::CYPHER : lgraph::ProtoGraphQueryType::GQL);
@@ -542,6 +544,10 @@ std::string RpcClient::RpcSingleClient::GetUrl() {
     return url;
 }
 
+void RpcClient::RpcSingleClient::SetMaxStaleness(int64_t max_staleness_ms) {
+    this->max_staleness_ms = max_staleness_ms;
+}
+
 void RpcClient::RpcSingleClient::Logout() {
     LGraphRequest request;
     request.set_is_write_op(false);
@@ -807,6 +813,12 @@ bool RpcClient::ImportDataFromFile(std::string &result, const std::string &conf_
     return DoubleCheckQuery(fun);
 }
 
+void RpcClient::SetMaxStaleness(int64_t max_staleness_ms) {
+    this->max_staleness_ms = max_staleness_ms;
+    if (base_client) base_client->SetMaxStaleness(max_staleness_ms);
+    for (auto &c : client_pool) c->SetMaxStaleness(max_staleness_ms);
+}
+
 void RpcClient::Logout() {
     auto logoutFun = [](const std::shared_ptr<RpcSingleClient>& c) {
         try {
@@ -849,6 +861,7 @@ void RpcClient::RefreshClientPool() {
                 continue;
             }
             auto c = std::make_shared<RpcSingleClient>(node["rpc_address"], user, password);
+            c->SetMaxStaleness(max_staleness_ms);
             if (node["state"] == "MASTER") {
                 leader_client = c;
             }
@@ -857,6 +870,7 @@ void RpcClient::RefreshClientPool() {
     } else if (client_type == INDIRECT_HA_CONNECTION) {
         for (auto &url : urls) {
             auto c = std::make_shared<RpcSingleClient>(url, user, password);
+            c->SetMaxStaleness(max_staleness_ms);
             std::string result;
             c->CallCypher(result, "CALL dbms.ha.clusterInfo()", "default", true, 10);
             nlohmann::json cluster_info = nlohmann::json::parse(result.c_str());
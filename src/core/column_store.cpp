@@ -0,0 +1,422 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+#include "lgraph/lgraph_exceptions.h"
+#include "core/column_store.h"
+#include "core/field_data_helper.h"
+
+namespace lgraph {
+
+static int64_t ReadInt(const char* p, size_t size) {
+    // fields of a fast altered label may be stored with the size of their old type
+    switch (size) {
+    case 1:
+        return *reinterpret_cast<const int8_t*>(p);
+    case 2:
+        return *reinterpret_cast<const int16_t*>(p);
+    case 4:
+        return *reinterpret_cast<const int32_t*>(p);
+    case 8:
+        return *reinterpret_cast<const int64_t*>(p);
+    default:
+        THROW_CODE(InternalError, "Invalid size of an integral field: {}", size);
+    }
+}
+
+static Value WriteInt(int64_t x, size_t size) {
+    switch (size) {
+    case 1:
+        return Value::ConstRef((int8_t)x).MakeCopy();
+    case 2:
+        return Value::ConstRef((int16_t)x).MakeCopy();
+    case 4:
+        return Value::ConstRef((int32_t)x).MakeCopy();
+    default:
+        return Value::ConstRef(x).MakeCopy();
+    }
+}
+
+static int BitWidth(uint64_t x) {
+    int w = 0;
+    while (x) {
+        w++;
+        x >>= 1;
+    }
+    return w;
+}
+
+static void PackBits(std::string& out, const std::vector<uint64_t>& xs, int width) {
+    size_t start = out.size();
+    out.resize(start + (xs.size() * width + 7) / 8, 0);
+    uint8_t* p = reinterpret_cast<uint8_t*>(&out[start]);
+    size_t bit = 0;
+    for (uint64_t x : xs) {
+        for (int b = 0; b < width;) {
+            int off = bit % 8;
+            int n = std::min(width - b, 8 - off);
+            p[bit / 8] |= (uint8_t)(((x >> b) & ((1u << n) - 1)) << off);
+            b += n;
+            bit += n;
+        }
+    }
+}
+
+// reads n values of width bits from p, p must hold (n * width + 7) / 8 bytes
+template <typename F>
+static void UnpackBits(const uint8_t* p, size_t n, int width, const F& f) {
+    size_t bit = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t x = 0;
+        for (int b = 0; b < width;) {
+            int off = bit % 8;
+            int k = std::min(width - b, 8 - off);
+            x |= (uint64_t)((p[bit / 8] >> off) & ((1u << k) - 1)) << b;
+            b += k;
+            bit += k;
+        }
+        f(i, x);
+    }
+}
+
+class BlockReader {
+    const char* p_;
+    const char* end_;
+
+ public:
+    explicit BlockReader(const Value& v) : p_(v.Data()), end_(v.Data() + v.Size()) {}
+
+    const char* Read(size_t n) {
+        if ((size_t)(end_ - p_) < n) THROW_CODE(InternalError, "Column block is truncated.");
+        const char* p = p_;
+        p_ += n;
+        return p;
+    }
+
+    template <typename T>
+    T Read() {
+        T t;
+        memcpy(&t, Read(sizeof(T)), sizeof(T));
+        return t;
+    }
+
+    std::string ReadString() {
+        uint32_t size = Read<uint32_t>();
+        return std::string(Read(size), size);
+    }
+
+    bool End() const { return p_ == end_; }
+};
+
+template <typename T>
+static void Append(std::string& out, const T& t) {
+    out.append(reinterpret_cast<const char*>(&t), sizeof(T));
+}
+
+static void AppendString(std::string& out, const std::string& s) {
+    Append(out, (uint32_t)s.size());
+    out.append(s);
+}
+
+ColumnBlock::ColumnBlock(FieldType type) : type_(type) {
+    if (IsIntegral(type_)) {
+        ints_.resize(SIZE);
+    } else if (IsReal(type_)) {
+        reals_.resize(SIZE);
+    } else {
+        strs_.resize(SIZE);
+    }
+    Clear();
+}
+
+bool ColumnBlock::IsIntegral(FieldType type) {
+    switch (type) {
+    case FieldType::BOOL:
+    case FieldType::INT8:
+    case FieldType::INT16:
+    case FieldType::INT32:
+    case FieldType::INT64:
+    case FieldType::DATE:
+    case FieldType::DATETIME:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool ColumnBlock::IsReal(FieldType type) {
+    return type == FieldType::FLOAT || type == FieldType::DOUBLE;
+}
+
+void ColumnBlock::Clear() { memset(present_, 0, sizeof(present_)); }
+
+bool ColumnBlock::Empty() const {
+    for (auto w : present_) {
+        if (w) return false;
+    }
+    return true;
+}
+
+void ColumnBlock::Set(size_t i, const Value& v) {
+    present_[i / 64] |= (uint64_t)1 << (i % 64);
+    if (IsIntegral(type_)) {
+        ints_[i] = ReadInt(v.Data(), v.Size());
+    } else if (IsReal(type_)) {
+        reals_[i] = v.Size() == sizeof(float) ? v.AsType<float>() : v.AsType<double>();
+    } else {
+        strs_[i] = v.AsString();
+    }
+}
+
+void ColumnBlock::SetNull(size_t i) {
+    present_[i / 64] &= ~((uint64_t)1 << (i % 64));
+    if (!strs_.empty()) std::string().swap(strs_[i]);
+}
+
+Value ColumnBlock::Get(size_t i) const {
+    if (IsIntegral(type_)) return WriteInt(ints_[i], field_data_helper::FieldTypeSize(type_));
+    if (type_ == FieldType::FLOAT) return Value::ConstRef((float)reals_[i]).MakeCopy();
+    if (type_ == FieldType::DOUBLE) return Value::ConstRef(reals_[i]).MakeCopy();
+    return Value::ConstRef(strs_[i]);
+}
+
+FieldData ColumnBlock::GetFieldData(size_t i) const {
+    if (IsNull(i)) return FieldData();
+    return field_data_helper::ValueToFieldData(Get(i), type_);
+}
+
+void ColumnBlock::Decode(const Value& v) {
+    BlockReader r(v);
+    auto encoding = (Encoding)r.Read<uint8_t>();
+    memcpy(present_, r.Read(sizeof(present_)), sizeof(present_));
+    std::vector<size_t> slots;
+    for (size_t i = 0; i < SIZE; i++) {
+        if (!IsNull(i)) slots.push_back(i);
+    }
+    switch (encoding) {
+    case BIT_PACKED:
+        {
+            int64_t base = r.Read<int64_t>();
+            int width = r.Read<uint8_t>();
+            auto p = reinterpret_cast<const uint8_t*>(r.Read((slots.size() * width + 7) / 8));
+            UnpackBits(p, slots.size(), width, [&](size_t k, uint64_t x) {
+                ints_[slots[k]] = (int64_t)((uint64_t)base + x);
+            });
+            break;
+        }
+    case DICTIONARY:
+        {
+            std::vector<std::string> dict(r.Read<uint32_t>());
+            for (auto& s : dict) s = r.ReadString();
+            int width = r.Read<uint8_t>();
+            auto p = reinterpret_cast<const uint8_t*>(r.Read((slots.size() * width + 7) / 8));
+            UnpackBits(p, slots.size(), width, [&](size_t k, uint64_t x) {
+                if (x >= dict.size()) THROW_CODE(InternalError, "Column block is corrupted.");
+                strs_[slots[k]] = dict[x];
+            });
+            break;
+        }
+    case PLAIN:
+        for (auto i : slots) {
+            if (type_ == FieldType::FLOAT) {
+                reals_[i] = r.Read<float>();
+            } else if (type_ == FieldType::DOUBLE) {
+                reals_[i] = r.Read<double>();
+            } else {
+                strs_[i] = r.ReadString();
+            }
+        }
+        break;
+    default:
+        THROW_CODE(InternalError, "Unknown column block encoding: {}", (int)encoding);
+    }
+    if (!r.End()) THROW_CODE(InternalError, "Column block is corrupted.");
+}
+
+Value ColumnBlock::Encode() const {
+    std::vector<size_t> slots;
+    for (size_t i = 0; i < SIZE; i++) {
+        if (!IsNull(i)) slots.push_back(i);
+    }
+    std::string out;
+    std::string values;
+    Encoding encoding = PLAIN;
+    if (IsIntegral(type_)) {
+        encoding = BIT_PACKED;
+        int64_t base = slots.empty() ? 0 : ints_[slots[0]];
+        uint64_t range = 0;
+        for (auto i : slots) base = std::min(base, ints_[i]);
+        std::vector<uint64_t> xs;
+        xs.reserve(slots.size());
+        for (auto i : slots) {
+            xs.push_back((uint64_t)ints_[i] - (uint64_t)base);
+            range = std::max(range, xs.back());
+        }
+        int width = BitWidth(range);
+        Append(values, base);
+        Append(values, (uint8_t)width);
+        PackBits(values, xs, width);
+    } else if (IsReal(type_)) {
+        for (auto i : slots) {
+            if (type_ == FieldType::FLOAT) {
+                Append(values, (float)reals_[i]);
+            } else {
+                Append(values, reals_[i]);
+            }
+        }
+    } else {
+        // dictionary encoding pays off when values repeat, e.g. for enum-like strings
+        std::unordered_map<std::string, uint64_t> ids;
+        std::vector<const std::string*> dict;
+        std::vector<uint64_t> xs;
+        size_t plain_size = 0;
+        size_t dict_size = sizeof(uint32_t) + sizeof(uint8_t);
+        for (auto i : slots) {
+            auto r = ids.emplace(strs_[i], dict.size());
+            if (r.second) {
+                dict.push_back(&r.first->first);
+                dict_size += sizeof(uint32_t) + strs_[i].size();
+            }
+            xs.push_back(r.first->second);
+            plain_size += sizeof(uint32_t) + strs_[i].size();
+        }
+        int width = BitWidth(dict.empty() ? 0 : dict.size() - 1);
+        dict_size += (xs.size() * width + 7) / 8;
+        if (dict_size < plain_size) {
+            encoding = DICTIONARY;
+            Append(values, (uint32_t)dict.size());
+            for (auto s : dict) AppendString(values, *s);
+            Append(values, (uint8_t)width);
+            PackBits(values, xs, width);
+        } else {
+            for (auto i : slots) AppendString(values, strs_[i]);
+        }
+    }
+    out.reserve(1 + sizeof(present_) + values.size());
+    Append(out, (uint8_t)encoding);
+    out.append(reinterpret_cast<const char*>(present_), sizeof(present_));
+    out.append(values);
+    return Value(out);
+}
+
+void ColumnBlock::AddToStat(ColumnStat& stat) const {
+    size_t n = 0;
+    bool numeric = FieldData::IsInteger(type_) || IsReal(type_);
+    // the bounds of the block are compared with the column ones once
+    size_t min_i = SIZE, max_i = SIZE;
+    for (size_t i = 0; i < SIZE; i++) {
+        if (IsNull(i)) continue;
+        n++;
+        if (IsIntegral(type_)) {
+            if (numeric) stat.sum += (double)ints_[i];
+            if (min_i == SIZE || ints_[i] < ints_[min_i]) min_i = i;
+            if (max_i == SIZE || ints_[i] > ints_[max_i]) max_i = i;
+        } else if (IsReal(type_)) {
+            stat.sum += reals_[i];
+            if (min_i == SIZE || reals_[i] < reals_[min_i]) min_i = i;
+            if (max_i == SIZE || reals_[i] > reals_[max_i]) max_i = i;
+        } else if (type_ == FieldType::STRING) {
+            if (min_i == SIZE || strs_[i] < strs_[min_i]) min_i = i;
+            if (max_i == SIZE || strs_[i] > strs_[max_i]) max_i = i;
+        }
+    }
+    stat.count += n;
+    if (min_i != SIZE) {
+        FieldData min = GetFieldData(min_i);
+        FieldData max = GetFieldData(max_i);
+        if (stat.min.IsNull() || min < stat.min) stat.min = min;
+        if (stat.max.IsNull() || max > stat.max) stat.max = max;
+    }
+}
+
+ColumnStore::ColumnStore(std::shared_ptr<KvTable> table, FieldType type)
+    : table_(std::move(table)), type_(type) {}
+
+void ColumnStore::WriteBlock(KvTransaction& txn, int64_t block, const ColumnBlock& b) {
+    if (b.Empty()) {
+        table_->DeleteKey(txn, BlockKey(block));
+    } else {
+        table_->SetValue(txn, BlockKey(block), b.Encode());
+    }
+}
+
+void ColumnStore::SetValue(KvTransaction& txn, ColumnWriteBuffer& buffer, VertexId vid,
+                           const Value& v) {
+    buffer.GetBlock(txn, *this, vid / ColumnBlock::SIZE).Set(vid % ColumnBlock::SIZE, v);
+}
+
+void ColumnStore::DeleteValue(KvTransaction& txn, ColumnWriteBuffer& buffer, VertexId vid) {
+    buffer.GetBlock(txn, *this, vid / ColumnBlock::SIZE).SetNull(vid % ColumnBlock::SIZE);
+}
+
+bool ColumnStore::GetValue(KvTransaction& txn, VertexId vid, Value& v) {
+    Value block = table_->GetValue(txn, BlockKey(vid / ColumnBlock::SIZE));
+    if (block.Empty()) return false;
+    ColumnBlock b(type_);
+    b.Decode(block);
+    if (b.IsNull(vid % ColumnBlock::SIZE)) return false;
+    v = b.Get(vid % ColumnBlock::SIZE).MakeCopy();
+    return true;
+}
+
+ColumnStat ColumnStore::GetStat(KvTransaction& txn) {
+    ColumnStat stat;
+    ColumnBlock block(type_);
+    auto it = table_->GetIterator(txn);
+    for (it->GotoFirstKey(); it->IsValid(); it->Next()) {
+        Value v = it->GetValue();
+        block.Decode(v);
+        block.AddToStat(stat);
+        stat.n_blocks++;
+        stat.bytes += v.Size();
+    }
+    return stat;
+}
+
+ColumnBlock& ColumnWriteBuffer::GetBlock(KvTransaction& txn, ColumnStore& store,
+                                         int64_t block) {
+    auto it = blocks_.find(std::make_pair(&store, block));
+    if (it != blocks_.end()) return it->second;
+    ColumnBlock b(store.Type());
+    // read for update, so that optimistic txns writing the same block conflict
+    Value old = store.table_->GetValue(txn, ColumnStore::BlockKey(block), true);
+    if (!old.Empty()) b.Decode(old);
+    return blocks_.emplace(std::make_pair(&store, block), std::move(b)).first->second;
+}
+
+void ColumnWriteBuffer::Flush(KvTransaction& txn) {
+    for (auto& kv : blocks_) kv.first.first->WriteBlock(txn, kv.first.second, kv.second);
+    blocks_.clear();
+}
+
+void ColumnStore::Builder::Add(VertexId vid, const Value& v) {
+    int64_t block = vid / ColumnBlock::SIZE;
+    if (block != curr_) {
+        Finish();
+        curr_ = block;
+    }
+    block_.Set(vid % ColumnBlock::SIZE, v);
+}
+
+void ColumnStore::Builder::Finish() {
+    if (curr_ >= 0 && !block_.Empty()) {
+        store_->table_->AppendKv(*txn_, BlockKey(curr_), block_.Encode());
+    }
+    block_.Clear();
+    curr_ = -1;
+}
+}  // namespace lgraph
@@ -0,0 +1,204 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/data_type.h"
+#include "core/kv_store.h"
+#include "core/kv_table_comparators.h"
+#include "core/value.h"
+
+namespace lgraph {
+
+/** Statistics of a column, computed from the column store alone. */
+struct ColumnStat {
+    size_t count = 0;     // number of non-null values
+    size_t n_blocks = 0;  // number of blocks
+    size_t bytes = 0;     // encoded size of the blocks
+    FieldData min;        // NUL if there is no value
+    FieldData max;
+    double sum = 0;  // sum of the values of a numeric column
+};
+
+/**
+ * The values of one field of SIZE consecutive vids. A block is kept in the
+ * column table as one value:
+ *
+ *      uint8_t encoding
+ *      uint64_t present[SIZE / 64]   bit i is set if vid i has a value
+ *      values of the present vids, in vid order, as given by the encoding
+ *
+ * Integral fields (BOOL, INT*, DATE, DATETIME) are BIT_PACKED: the minimum as int64_t, a
+ * uint8_t bit width, and the offsets from the minimum in that many bits each. FLOAT and
+ * DOUBLE are PLAIN. Other fields are PLAIN, a uint32_t size followed by the bytes of each
+ * value, or DICTIONARY if that is smaller: the distinct values like in PLAIN, preceded by
+ * their uint32_t count, followed by a uint8_t bit width and the bit-packed ids of the values.
+ */
+class ColumnBlock {
+ public:
+    static const size_t SIZE = 1024;
+    enum Encoding : uint8_t { PLAIN = 0, BIT_PACKED = 1, DICTIONARY = 2 };
+
+ private:
+    FieldType type_;
+    uint64_t present_[SIZE / 64];
+    // the values, only the one of the kind of type_ is used
+    std::vector<int64_t> ints_;
+    std::vector<double> reals_;
+    std::vector<std::string> strs_;
+
+ public:
+    explicit ColumnBlock(FieldType type);
+
+    static bool IsIntegral(FieldType type);
+
+    static bool IsReal(FieldType type);
+
+    void Decode(const Value& v);
+
+    Value Encode() const;
+
+    void Clear();
+
+    bool Empty() const;
+
+    bool IsNull(size_t i) const { return !(present_[i / 64] & ((uint64_t)1 << (i % 64))); }
+
+    /** Sets the value of slot i, v is the field as stored in a record. */
+    void Set(size_t i, const Value& v);
+
+    void SetNull(size_t i);
+
+    /** Gets the value of slot i, as stored in a record with the current field type. */
+    Value Get(size_t i) const;
+
+    FieldData GetFieldData(size_t i) const;
+
+    /** Adds the values of the block to stat. */
+    void AddToStat(ColumnStat& stat) const;
+};
+
+class ColumnStore;
+
+/**
+ * The column blocks a write transaction has modified, decoded. Writing a value decodes the
+ * block of the vid the first time the transaction touches it, and Flush() encodes and writes
+ * each block once, so a batch of vertices costs one decode and one encode per block rather
+ * than per vertex. A STRING block keeps up to ColumnBlock::SIZE strings until it is flushed.
+ */
+class ColumnWriteBuffer {
+    std::map<std::pair<ColumnStore*, int64_t>, ColumnBlock> blocks_;
+
+ public:
+    /** Gets the decoded block of a column, reading it for update on the first access. */
+    ColumnBlock& GetBlock(KvTransaction& txn, ColumnStore& store, int64_t block);
+
+    /** Writes the modified blocks, which must be done before the txn commits or reads them. */
+    void Flush(KvTransaction& txn);
+
+    void Clear() { blocks_.clear(); }
+
+    bool Empty() const { return blocks_.empty(); }
+};
+
+/**
+ * A column store keeps the values of one vertex field in a table of its own, in blocks of
+ * vids. Scans and aggregates of the field read the blocks instead of the vertices, so they
+ * read the bytes of that field only. The column is written in the transaction that writes
+ * the vertex, through the ColumnWriteBuffer of the transaction.
+ */
+class ColumnStore {
+    friend class ColumnWriteBuffer;
+
+    std::shared_ptr<KvTable> table_;
+    FieldType type_;
+
+    static Value BlockKey(int64_t block) { return Value::ConstRef(block).MakeCopy(); }
+
+    void WriteBlock(KvTransaction& txn, int64_t block, const ColumnBlock& b);
+
+ public:
+    ColumnStore(std::shared_ptr<KvTable> table, FieldType type);
+
+    static std::unique_ptr<KvTable> OpenTable(KvTransaction& txn, KvStore& store,
+                                              const std::string& name) {
+        return store.OpenTable(txn, name, true, ComparatorDesc::SingleDataComp(FieldType::INT64));
+    }
+
+    /** BLOB and FLOAT_VECTOR fields cannot be kept in a column store. */
+    static bool IsColumnType(FieldType type) {
+        return type != FieldType::BLOB && type != FieldType::FLOAT_VECTOR &&
+               type != FieldType::NUL;
+    }
+
+    FieldType Type() const { return type_; }
+
+    /** Sets the value of vid, v is the field as stored in the record of the vertex. */
+    void SetValue(KvTransaction& txn, ColumnWriteBuffer& buffer, VertexId vid, const Value& v);
+
+    /** Sets the value of vid to null. */
+    void DeleteValue(KvTransaction& txn, ColumnWriteBuffer& buffer, VertexId vid);
+
+    /** Gets the value of vid, returns false if it is null. */
+    bool GetValue(KvTransaction& txn, VertexId vid, Value& v);
+
+    /**
+     * Calls f(vid, value) for the non-null values of the vids in [start, end), in vid order.
+     * The value is the field as stored in a record. Stops if f returns false.
+     */
+    template <typename F>
+    void Scan(KvTransaction& txn, VertexId start, VertexId end, const F& f) {
+        ColumnBlock block(type_);
+        auto it = table_->GetClosestIterator(txn, BlockKey(start / ColumnBlock::SIZE));
+        for (; it->IsValid(); it->Next()) {
+            int64_t b = it->GetKey().AsType<int64_t>();
+            if (b * (int64_t)ColumnBlock::SIZE >= end) break;
+            block.Decode(it->GetValue());
+            for (size_t i = 0; i < ColumnBlock::SIZE; i++) {
+                VertexId vid = b * ColumnBlock::SIZE + i;
+                if (vid < start || block.IsNull(i)) continue;
+                if (vid >= end) break;
+                if (!f(vid, block.Get(i))) return;
+            }
+        }
+    }
+
+    /** Gets the statistics of the column, reading the column table only. */
+    ColumnStat GetStat(KvTransaction& txn);
+
+    void Clear(KvTransaction& txn) { table_->Drop(txn); }
+
+    /** Writes the values of the column in ascending order of vid, when building a column. */
+    class Builder {
+        ColumnStore* store_;
+        KvTransaction* txn_;
+        ColumnBlock block_;
+        int64_t curr_ = -1;
+
+     public:
+        Builder(ColumnStore& store, KvTransaction& txn)
+            : store_(&store), txn_(&txn), block_(store.type_) {}
+
+        void Add(VertexId vid, const Value& v);
+
+        void Finish();
+    };
+};
+}  // namespace lgraph
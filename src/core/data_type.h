@@ -163,6 +163,11 @@ struct DBConfig {
 
     FullTextIndexOptions ft_index_options;
     bool enable_realtime_count = true;
+    // save the pages in memory on close and prefetch them on open
+    bool persist_hot_pages = false;
+    // storage engine of a new graph, lmdb or rocksdb, a graph that exists keeps the engine it
+    // was created with
+    std::string kv_engine = _detail::KV_ENGINE_LMDB;
 
     template <typename StreamT>
     size_t Serialize(StreamT& stream) const {
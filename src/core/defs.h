@@ -97,6 +97,12 @@ static const char* const PYTHON_PLUGIN_TABLE = "_python_plugin_";  // plugin_nam
 static const char* const CPP_PLUGIN_DIR = "_cpp_plugin_";
 static const char* const PYTHON_PLUGIN_DIR = "_python_plugin_";
 static const char* const FULLTEXT_INDEX_DIR = "_fulltext_index_";
+static const char* const HOT_PAGES_FILE = "_hot_pages_";  // pages in memory at last close
+static const char* const ROCKSDB_DIR = "_rocksdb_";  // store of a graph kept in rocksdb
+static const char* const READ_SNAPSHOT_DIR = "_read_snapshots_";  // copies for long reads
+// storage engines a graph can be kept in
+static const char* const KV_ENGINE_LMDB = "lmdb";
+static const char* const KV_ENGINE_ROCKSDB = "rocksdb";
 static const char* const NAME_SEPARATOR = "_@lgraph@_";
 static const char* const COMPOSITE_INDEX_KEY_SEPARATOR = "_";
 static const char* const VERTEX_FULLTEXT_INDEX = "vertex_fulltext";
@@ -105,6 +111,7 @@ static const char* const VERTEX_INDEX = "vertex_index";
 static const char* const COMPOSITE_INDEX = "composite_index";
 static const char* const EDGE_INDEX = "edge_index";
 static const char* const VERTEX_VECTOR_INDEX = "vertex_vector_index";
+static const char* const VERTEX_COLUMN = "vertex_column";
 static const char* const USER_TABLE_NAME = "_user_table_";
 static const char* const ROLE_TABLE_NAME = "_role_table_";
 static const char* const GRAPH_CONFIG_TABLE_NAME = "_graph_config_table_";
@@ -15,6 +15,7 @@
 #pragma once
 
 #include "core/blob_manager.h"
+#include "core/column_store.h"
 #include "core/field_data_helper.h"
 #include "core/vertex_index.h"
 #include "core/edge_index.h"
@@ -45,6 +46,8 @@ class FieldExtractorBase {
     bool fulltext_indexed_ = false;
     // vector index
     std::shared_ptr<VectorIndex> vector_index_;
+    // column store, shared by the copies of a schema like the vector index
+    std::shared_ptr<ColumnStore> column_store_;
 
  public:
     FieldExtractorBase() : vertex_index_(nullptr), edge_index_(nullptr), vector_index_(nullptr) {}
@@ -64,6 +67,7 @@ class FieldExtractorBase {
         vertex_index_.reset(rhs.vertex_index_ ? new VertexIndex(*rhs.vertex_index_) : nullptr);
         edge_index_.reset(rhs.edge_index_ ? new EdgeIndex(*rhs.edge_index_) : nullptr);
         vector_index_ = rhs.vector_index_;
+        column_store_ = rhs.column_store_;
     }
 
     FieldExtractorBase(FieldExtractorBase&& rhs) noexcept {
@@ -73,6 +77,7 @@ class FieldExtractorBase {
         vertex_index_ = std::move(rhs.vertex_index_);
         edge_index_ = std::move(rhs.edge_index_);
         vector_index_ = std::move(rhs.vector_index_);
+        column_store_ = std::move(rhs.column_store_);
         rhs.vertex_index_ = nullptr;
         rhs.edge_index_ = nullptr;
         rhs.vertex_index_ = nullptr;
@@ -86,6 +91,7 @@ class FieldExtractorBase {
         vertex_index_ = std::move(rhs.vertex_index_);
         edge_index_ = std::move(rhs.edge_index_);
         vector_index_ = std::move(rhs.vector_index_);
+        column_store_ = std::move(rhs.column_store_);
         return *this;
     }
 
@@ -97,6 +103,7 @@ class FieldExtractorBase {
         edge_index_.reset(rhs.edge_index_ ? new EdgeIndex(*rhs.edge_index_) : nullptr);
         fulltext_indexed_ = rhs.fulltext_indexed_;
         vector_index_ = rhs.vector_index_;
+        column_store_ = rhs.column_store_;
         return *this;
     }
 
@@ -129,6 +136,8 @@ class FieldExtractorBase {
 
     VectorIndex* GetVectorIndex() const { return vector_index_.get(); }
 
+    ColumnStore* GetColumnStore() const { return column_store_.get(); }
+
     // Set field info and index info.
     void SetVertexIndex(VertexIndex* index) { vertex_index_.reset(index); }
 
@@ -136,6 +145,8 @@ class FieldExtractorBase {
 
     void SetVectorIndex(VectorIndex* vectorindex) { vector_index_.reset(vectorindex); }
 
+    void SetColumnStore(ColumnStore* column_store) { column_store_.reset(column_store); }
+
     void SetFullTextIndex(bool fulltext_indexed) { fulltext_indexed_ = fulltext_indexed; }
 
     void SetFieldSpecId(FieldId field_id) {def_.id = field_id;}
@@ -82,18 +82,21 @@ size_t FieldExtractorV2::GetDataSize(const Value& record) const {
         // In the worst case, we need to reach the last offset to determine the length of this data.
         // The last offset should correspond to a fieldid of (count + 1),
         // as we do not store the offset for field0.
-        FieldId count = GetRecordCount(record);
-        DataOffset data_offset = GetFieldOffset(record, GetFieldId());
-        DataOffset next_data_offset = data_offset;
-        for (int i = GetFieldId() + 1; i <= count + 1; i++) {
-            if (GetFieldOffset(record, i) != 0) {
-                next_data_offset = GetFieldOffset(record, i);
-                break;
-            }
-        }
+        return GetFixedAreaSize(record, GetFieldId());
+    }
+}
 
-        return next_data_offset - data_offset;
+size_t FieldExtractorV2::GetFixedAreaSize(const Value& record, FieldId id) const {
+    FieldId count = GetRecordCount(record);
+    DataOffset data_offset = GetFieldOffset(record, id);
+    DataOffset next_data_offset = data_offset;
+    for (int i = id + 1; i <= count + 1; i++) {
+        if (GetFieldOffset(record, i) != 0) {
+            next_data_offset = GetFieldOffset(record, i);
+            break;
+        }
     }
+    return next_data_offset - data_offset;
 }
 
 size_t FieldExtractorV2::GetFieldOffset(const Value& record, const FieldId id) const {
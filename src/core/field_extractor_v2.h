@@ -152,6 +152,11 @@ class FieldExtractorV2 : public FieldExtractorBase {
 
     size_t GetDataSize(const Value& record) const override;
 
+    // Return the size field id takes in the fixed-data area: the data of a fixed-length field,
+    // the data pointer of a variable-length one, or nothing if it was deleted when the record
+    // was written.
+    size_t GetFixedAreaSize(const Value& record, FieldId id) const;
+
     void* GetFieldPointer(const Value& record) const override;
 
     FieldId GetFieldId() const override {
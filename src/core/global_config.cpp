@@ -46,6 +46,7 @@ std::map<std::string, std::string> lgraph::GlobalConfig::FormatAsOptions() const
     AddOption(options, "Backup log enable", enable_backup_log);
     AddOption(options, "Whether the token is unlimited", unlimited_token);
     AddOption(options, "reset admin password if you forget", reset_admin_password);
+    AddOption(options, "persist hot pages", persist_hot_pages);
     AddOption(options, "HA enable", enable_ha);
     if (enable_ha) {
         AddOption(options, "HA init group", ha_conf);
@@ -57,6 +58,8 @@ std::map<std::string, std::string> lgraph::GlobalConfig::FormatAsOptions() const
         AddOption(options, "HA wait dead(ms)", ha_node_remove_ms);
         AddOption(options, "HA node join(s)", ha_node_join_group_s);
         AddOption(options, "Bootstrap Role", ha_bootstrap_role);
+        AddOption(options, "HA physical replication", ha_physical_replication);
+        AddOption(options, "HA snapshot chunk size(MB)", ha_snapshot_chunk_size_mb);
     }
     AddOption(options, "bolt port", bolt_port);
     AddOption(options, "number of bolt io threads", bolt_io_thread_num);
@@ -108,6 +111,7 @@ std::map<std::string, lgraph::FieldData> lgraph::GlobalConfig::ToFieldDataMap()
         v["audit_log_expire"] = FieldData((int64_t)audit_log_expire);
     }
     v["enable_backup_log"] = FieldData(enable_backup_log);
+    v["persist_hot_pages"] = FieldData(persist_hot_pages);
     v[lgraph::_detail::OPT_DB_DURABLE] = FieldData(durable);
     v[lgraph::_detail::OPT_TXN_OPTIMISTIC] = FieldData(txn_optimistic);
     v[lgraph::_detail::OPT_IP_CHECK_ENABLE] = FieldData(enable_ip_check);
@@ -129,6 +133,8 @@ std::map<std::string, lgraph::FieldData> lgraph::GlobalConfig::ToFieldDataMap()
         v["ha_node_remove_ms"] = FieldData(ha_node_remove_ms);
         v["ha_node_join_group_s"] = FieldData(ha_node_join_group_s);
         v["ha_bootstrap_role"] = FieldData(ha_bootstrap_role);
+        v["ha_physical_replication"] = FieldData(ha_physical_replication);
+        v["ha_snapshot_chunk_size_mb"] = FieldData(ha_snapshot_chunk_size_mb);
     }
     v["browser.credential_timeout"] = FieldData(browser_options.credential_timeout);
     v["browser.retain_connection_credentials"] =
@@ -194,6 +200,7 @@ fma_common::Configuration lgraph::GlobalConfig::InitConfig
     thread_limit = 0;
     unlimited_token = false;
     enable_realtime_count = true;
+    persist_hot_pages = false;
     reset_admin_password = false;
     // fulltext index
     ft_index_options.enable_fulltext_index = false;
@@ -214,6 +221,8 @@ fma_common::Configuration lgraph::GlobalConfig::InitConfig
     ha_is_witness = false;
     ha_enable_witness_to_leader = false;
     ha_first_snapshot_start_time = "";
+    ha_physical_replication = false;
+    ha_snapshot_chunk_size_mb = 64;
 
     // bolt
     bolt_port = 0;
@@ -226,6 +235,7 @@ fma_common::Configuration lgraph::GlobalConfig::InitConfig
     bolt_raft_tick_interval = 100;
     bolt_raft_election_tick = 10;
     bolt_raft_heartbeat_tick = 1;
+    bolt_raft_apply_batch_size = 1;
 
     bolt_raft_logstore_cache = 1024;  // MB
     bolt_raft_logstore_threads = 4;
@@ -296,6 +306,9 @@ fma_common::Configuration lgraph::GlobalConfig::InitConfig
         .Comment("Reset admin password if you forget.");
     argparser.Add(enable_realtime_count, "realtime vertex and edge count", true)
         .Comment("Whether to enable realtime vertex and edge count.");
+    argparser.Add(persist_hot_pages, "persist_hot_pages", true)
+        .Comment("Save the pages in memory when a graph is closed, and prefetch them when it "
+            "is opened again.");
 
 #if LGRAPH_ENABLE_FULLTEXT_INDEX
     argparser.Add(ft_index_options.enable_fulltext_index, "enable_fulltext_index", true)
@@ -339,6 +352,12 @@ fma_common::Configuration lgraph::GlobalConfig::InitConfig
     argparser.Add(ha_first_snapshot_start_time, "ha_first_snapshot_start_time", true)
         .Comment(R"("First snapshot start time whose format is "HH:MM:SS", and the default value is "
             "" indicating a random time.)");
+    argparser.Add(ha_physical_replication, "ha_physical_replication", true)
+        .Comment("Replicate the kv writes of cypher queries and plugin calls instead of "
+            "re-executing them on followers.");
+    argparser.Add(ha_snapshot_chunk_size_mb, "ha_snapshot_chunk_size_mb", true)
+        .Comment("Size of the compressed chunks HA snapshots are split into, in MB. Unchanged "
+            "chunks are not transferred again. 0 to transfer whole files.");
     argparser.Add(bolt_port, "bolt_port", true)
         .Comment("Bolt protocol port.");
     argparser.Add(bolt_io_thread_num, "bolt_io_thread_num", true)
@@ -366,6 +385,9 @@ fma_common::Configuration lgraph::GlobalConfig::InitConfig
         .Comment("Bolt raft heartbeat tick.");
     argparser.Add(bolt_raft_election_tick, "bolt_raft_election_tick", true)
         .Comment("Bolt raft election tick.");
+    argparser.Add(bolt_raft_apply_batch_size, "bolt_raft_apply_batch_size", true)
+        .Comment("Maximum number of bolt raft entries applied before the apply index is saved. "
+                 "Values above 1 replay entries after a crash and need idempotent writes.");
 
     argparser.Add(bolt_raft_logstore_cache, "bolt_raft_logstore_cache", true)
         .Comment("Bolt raft logstore cache in MB.");
@@ -58,6 +58,8 @@ struct BasicConfigs {
     bool ha_is_witness = false;    // node is witness or not
     bool ha_enable_witness_to_leader = false;  // enable witness to leader or not
     std::string ha_first_snapshot_start_time;  // first snapshot start time
+    bool ha_physical_replication = false;  // replicate kv writes instead of requests
+    int ha_snapshot_chunk_size_mb = 64;  // split snapshot files into chunks, 0 to disable
                                                     // whose format is "HH:MM:SS",
                                                     // and the default value is ""
                                                     // indicating a random time.
@@ -81,6 +83,8 @@ struct BasicConfigs {
     bool reset_admin_password = false;
     // vertex and edge count
     bool enable_realtime_count = true;
+    // prefetch the pages that were in memory when the graphs were last closed
+    bool persist_hot_pages = false;
     // bolt
     int bolt_port = 0;
     int bolt_io_thread_num = 1;
@@ -91,6 +95,7 @@ struct BasicConfigs {
     uint64_t bolt_raft_tick_interval = 100;
     uint64_t bolt_raft_election_tick = 10;
     uint64_t bolt_raft_heartbeat_tick = 1;
+    uint64_t bolt_raft_apply_batch_size = 1;
 
     std::string bolt_raft_logstore_path;
     uint64_t bolt_raft_logstore_cache = 1024;
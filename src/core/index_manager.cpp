@@ -33,6 +33,7 @@ IndexManager::IndexManager(KvTransaction& txn, SchemaManager* v_schema_manager,
     size_t v_ft_index_len = strlen(_detail::VERTEX_FULLTEXT_INDEX);
     size_t e_ft_index_len = strlen(_detail::EDGE_FULLTEXT_INDEX);
     size_t vector_index_len = strlen(_detail::VERTEX_VECTOR_INDEX);
+    size_t column_len = strlen(_detail::VERTEX_COLUMN);
     auto it = index_list_table_->GetIterator(txn);
     for (it->GotoFirstKey(); it->IsValid(); it->Next()) {
         std::string index_name = it->GetKey().AsString();
@@ -47,6 +48,7 @@ IndexManager::IndexManager(KvTransaction& txn, SchemaManager* v_schema_manager,
             auto tbl =
                 VertexIndex::OpenTable(txn, db_->GetStore(), index_name, fe->Type(), idx.type);
             VertexIndex* index = new VertexIndex(std::move(tbl), fe->Type(), idx.type);
+            index->SetIncludeFields(std::move(idx.include_fields));
             index->SetReady();
             schema->MarkVertexIndexed(fe->GetFieldId(), index);
         } else if (index_name.size() > e_index_len &&
@@ -145,6 +147,16 @@ IndexManager::IndexManager(KvTransaction& txn, SchemaManager* v_schema_manager,
             schema->MarkVectorIndexed(extractor->GetFieldId(), vector_index.release());
             LOG_INFO() << FMA_FMT("end building vertex vector index for {}:{} in detached model",
                                   idx.label, idx.field);
+        } else if (index_name.size() > column_len &&
+                   index_name.substr(index_name.size() - column_len) == _detail::VERTEX_COLUMN) {
+            _detail::IndexEntry col = LoadIndex(it->GetValue());
+            FMA_DBG_CHECK_EQ(col.table_name, it->GetKey().AsString());
+            Schema* schema = v_schema_manager->GetSchema(col.label);
+            FMA_DBG_ASSERT(schema);
+            const _detail::FieldExtractorBase* fe = schema->GetFieldExtractor(col.field);
+            FMA_DBG_ASSERT(fe);
+            auto tbl = ColumnStore::OpenTable(txn, db_->GetStore(), index_name);
+            schema->MarkColumnStored(fe->GetFieldId(), new ColumnStore(std::move(tbl), fe->Type()));
         } else {
             LOG_ERROR() << "Unknown index type: " << index_name;
         }
@@ -285,6 +297,57 @@ bool IndexManager::DeleteFullTextIndex(KvTransaction& txn, bool is_vertex, const
     return true;
 }
 
+bool IndexManager::AddVertexColumn(KvTransaction& txn, const std::string& label,
+                                   const std::string& field, FieldType dt,
+                                   std::unique_ptr<ColumnStore>& column_store) {
+    if (!ColumnStore::IsColumnType(dt)) {
+        THROW_CODE(InputError, "Fields of type {} cannot be kept in a column store.",
+                   field_data_helper::FieldTypeName(dt));
+    }
+    // the column is listed like an index, with a type that is not used
+    _detail::IndexEntry col;
+    col.label = label;
+    col.field = field;
+    col.table_name = GetVertexColumnTableName(label, field);
+    col.type = IndexType::NonuniqueIndex;
+
+    auto it = index_list_table_->GetIterator(txn, Value::ConstRef(col.table_name));
+    if (it->IsValid()) return false;  // already exist
+    Value colv;
+    StoreIndex(col, colv);
+    it->AddKeyValue(Value::ConstRef(col.table_name), colv);
+
+    auto tbl = ColumnStore::OpenTable(txn, db_->GetStore(), col.table_name);
+    column_store.reset(new ColumnStore(std::move(tbl), dt));
+    return true;
+}
+
+bool IndexManager::DeleteVertexColumn(KvTransaction& txn, const std::string& label,
+                                      const std::string& field) {
+    std::string table_name = GetVertexColumnTableName(label, field);
+    if (!index_list_table_->DeleteKey(txn, Value::ConstRef(table_name)))
+        return false;  // does not exist
+    bool r = db_->GetStore().DeleteTable(txn, table_name);
+    FMA_DBG_ASSERT(r);
+    return true;
+}
+
+std::vector<std::pair<std::string, std::string>> IndexManager::ListVertexColumns(
+    KvTransaction& txn) {
+    std::vector<std::pair<std::string, std::string>> ret;
+    size_t column_len = strlen(_detail::VERTEX_COLUMN);
+    auto it = index_list_table_->GetIterator(txn);
+    for (it->GotoFirstKey(); it->IsValid(); it->Next()) {
+        std::string name = it->GetKey().AsString();
+        if (name.size() > column_len &&
+            name.substr(name.size() - column_len) == _detail::VERTEX_COLUMN) {
+            _detail::IndexEntry col = LoadIndex(it->GetValue());
+            ret.emplace_back(col.label, col.field);
+        }
+    }
+    return ret;
+}
+
 bool IndexManager::DeleteVertexIndex(KvTransaction& txn, const std::string& label,
                                      const std::string& field) {
     std::string table_name = GetVertexIndexTableName(label, field);
@@ -297,6 +360,20 @@ bool IndexManager::DeleteVertexIndex(KvTransaction& txn, const std::string& labe
     return true;
 }
 
+bool IndexManager::SetVertexIndexInclude(KvTransaction& txn, const std::string& label,
+                                         const std::string& field,
+                                         const std::vector<std::string>& fields) {
+    std::string table_name = GetVertexIndexTableName(label, field);
+    auto it = index_list_table_->GetIterator(txn, Value::ConstRef(table_name));
+    if (!it->IsValid()) return false;
+    _detail::IndexEntry idx = LoadIndex(it->GetValue());
+    idx.include_fields = fields;
+    Value idxv;
+    StoreIndex(idx, idxv);
+    it->SetValue(idxv);
+    return true;
+}
+
 bool IndexManager::DeleteEdgeIndex(KvTransaction& txn, const std::string& label,
                                    const std::string& field) {
     std::string table_name = GetEdgeIndexTableName(label, field);
@@ -21,6 +21,7 @@
 #include "fma-common/binary_buffer.h"
 #include "fma-common/binary_read_write_helper.h"
 
+#include "core/column_store.h"
 #include "core/data_type.h"
 #include "core/defs.h"
 #include "core/vertex_index.h"
@@ -39,17 +40,23 @@ struct IndexEntry {
         : label(std::move(rhs.label)),
           field(std::move(rhs.field)),
           table_name(std::move(rhs.table_name)),
-          type(rhs.type) {}
+          type(rhs.type),
+          include_fields(std::move(rhs.include_fields)) {}
 
     std::string label;
     std::string field;
     std::string table_name;
     IndexType type;
+    // fields stored in a unique vertex index along with the vid, written after
+    // the other members only when non-empty, see IndexManager::LoadIndex
+    std::vector<std::string> include_fields;
 
     template <typename StreamT>
     size_t Serialize(StreamT& buf) const {
-        return BinaryWrite(buf, label) + BinaryWrite(buf, field) + BinaryWrite(buf, table_name) +
-               BinaryWrite(buf, type);
+        size_t res = BinaryWrite(buf, label) + BinaryWrite(buf, field) +
+                     BinaryWrite(buf, table_name) + BinaryWrite(buf, type);
+        if (!include_fields.empty()) res += BinaryWrite(buf, include_fields);
+        return res;
     }
 
     template <typename StreamT>
@@ -174,10 +181,17 @@ class IndexManager {
                _detail::VERTEX_VECTOR_INDEX;
     }
 
+    static std::string GetVertexColumnTableName(const std::string& label,
+                                                const std::string& field) {
+        return label + _detail::NAME_SEPARATOR + field + _detail::NAME_SEPARATOR +
+               _detail::VERTEX_COLUMN;
+    }
+
     static _detail::IndexEntry LoadIndex(const Value& v) {
         fma_common::BinaryBuffer buf(v.Data(), v.Size());
         _detail::IndexEntry idx;
         size_t r = fma_common::BinaryRead(buf, idx);
+        if (r < v.Size()) r += fma_common::BinaryRead(buf, idx.include_fields);
         if (r != v.Size()) THROW_CODE(InternalError, "Failed to load index meta info from buffer");
         return idx;
     }
@@ -278,6 +292,10 @@ class IndexManager {
 
     bool DeleteVertexIndex(KvTransaction& txn, const std::string& label, const std::string& field);
 
+    /** Stores the include fields of a vertex index, returns false if there is no such index. */
+    bool SetVertexIndexInclude(KvTransaction& txn, const std::string& label,
+                               const std::string& field, const std::vector<std::string>& fields);
+
     bool DeleteEdgeIndex(KvTransaction& txn, const std::string& label, const std::string& field);
 
     bool DeleteVertexCompositeIndex(KvTransaction& txn, const std::string& label,
@@ -289,6 +307,16 @@ class IndexManager {
     bool DeleteFullTextIndex(KvTransaction& txn, bool is_vertex, const std::string& label,
                              const std::string& field);
 
+    /** Adds the column store of a vertex field, returns false if it already exists. */
+    bool AddVertexColumn(KvTransaction& txn, const std::string& label, const std::string& field,
+                         FieldType dt, std::unique_ptr<ColumnStore>& column_store);
+
+    bool DeleteVertexColumn(KvTransaction& txn, const std::string& label,
+                            const std::string& field);
+
+    /** Lists the (label, field) of the vertex column stores. */
+    std::vector<std::pair<std::string, std::string>> ListVertexColumns(KvTransaction& txn);
+
     std::vector<VectorIndexSpec> ListVectorIndex(KvTransaction& txn);
 
     // vertex index
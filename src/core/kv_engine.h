@@ -15,10 +15,13 @@
 #include <iostream>
 #include <memory>
 #include "core/value.h"
+#include "core/kv_space_stat.h"
 #include "core/kv_table_comparators.h"
 
 namespace lgraph {
 
+class KvWriteSet;
+
 class KvTransaction {
  public:
     KvTransaction() = default;
@@ -31,6 +34,8 @@ class KvTransaction {
     virtual bool IsValid() const = 0;
     virtual size_t TxnId()  = 0;
     virtual int64_t LastOpId() const  = 0;
+    // The write set recorded for replication, nullptr if this txn is not recorded.
+    virtual KvWriteSet* GetWriteSet() { return nullptr; }
 };
 
 class KvTable;
@@ -104,9 +109,27 @@ class KvStore {
     virtual void Flush() = 0;
     virtual void DropAll(KvTransaction& txn) = 0;
     virtual void DumpStat(KvTransaction& txn, size_t& memory_size, size_t& height) = 0;
+    virtual void DumpStat(KvTransaction& txn, KvSpaceStat& stat) = 0;
     virtual size_t Backup(const std::string& path, bool compact = false) = 0;
     virtual void Snapshot(KvTransaction& txn, const std::string& path, bool compaction = false) = 0;
     virtual void LoadSnapshot(const std::string& snapshot_path) = 0;
-    virtual void WarmUp(size_t* size) = 0;
+    // makes a copy of the last committed state in path, which can be opened as a store, the
+    // blocks of the files are shared with the copy where the file system allows it; it may
+    // take the write lock, so the calling thread must not hold a write txn
+    virtual void Clone(const std::string& path) = 0;
+    // loads the given tables, or the whole store if tables is empty, into memory with
+    // n_threads threads (0 for one per core), size is set to the size of the keys and values
+    virtual void WarmUp(size_t* size, const std::vector<std::string>& tables = {},
+                        size_t n_threads = 0) = 0;
+    // records the pages in memory to path, so that PrefetchHotPages can load them back
+    virtual void SaveHotPages(const std::string& path) = 0;
+    virtual void PrefetchHotPages(const std::string& path) = 0;
+    // online compaction: StartCompaction copies the store while it is being written,
+    // FinishCompaction switches to the copy, it must be called with no transaction open; a
+    // store that CompactsInPlace is compacted by StartCompaction alone, with nothing to switch
+    virtual bool CompactsInPlace() const = 0;
+    virtual void StartCompaction() = 0;
+    virtual void FinishCompaction() = 0;
+    virtual void AbortCompaction() = 0;
 };
 }  // namespace lgraph
@@ -0,0 +1,35 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace lgraph {
+
+// Space used by a store, in bytes. The data file of a store does not shrink when data is
+// deleted, the space freed is kept for reuse, so a file much larger than used_size is
+// fragmented and can be compacted.
+struct KvSpaceStat {
+    size_t file_size = 0;   // size of the data file
+    size_t used_size = 0;   // pages holding data, including the pages of the b-tree branches
+    size_t free_size = 0;   // pages freed by earlier transactions, waiting to be reused
+    size_t height = 0;      // height of the highest table
+    // read txns open, optimistic write txns included since they also read a snapshot, and
+    // how long the oldest of them has been open, in seconds. The pages a read txn sees are
+    // not reused until it ends, so a long reader makes the file grow while others write.
+    size_t readers = 0;
+    double oldest_reader_age = 0;
+};
+}  // namespace lgraph
@@ -24,4 +24,5 @@ typedef MockKvTable KvTable;
 }  // namespace lgraph
 #else
 #include "core/lmdb_store.h"
+#include "core/rocksdb_store.h"
 #endif
@@ -193,9 +193,18 @@ static int LexicalKeyBothVidCompareFunc(const MDB_val* a, const MDB_val* b) {
 struct CompositeKeyCompare {
     inline static std::vector<FieldType> data_types = {};
     static int CompositeKeyWithVidCompareFunc(const MDB_val* a, const MDB_val* b) {
+        return CompareWithVid(data_types, a, b);
+    }
+
+    static int CompositeKeyCompareFunc(const MDB_val* a, const MDB_val* b) {
+        return Compare(data_types, a, b);
+    }
+
+    static int CompareWithVid(const std::vector<FieldType>& data_types, const MDB_val* a,
+                              const MDB_val* b) {
         MDB_val pa{a->mv_size - VID_SIZE, a->mv_data};
         MDB_val pb{b->mv_size - VID_SIZE, b->mv_data};
-        int res = CompositeKeyCompareFunc(&pa, &pb);
+        int res = Compare(data_types, &pa, &pb);
         if (res != 0)
             return res;
         int64_t a_vid = GetVid((char*)a->mv_data + a->mv_size - VID_SIZE);
@@ -203,7 +212,8 @@ struct CompositeKeyCompare {
         return a_vid < b_vid ? -1 : a_vid > b_vid ? 1 : 0;
     }
 
-    static int CompositeKeyCompareFunc(const MDB_val* a, const MDB_val* b) {
+    static int Compare(const std::vector<FieldType>& data_types, const MDB_val* a,
+                       const MDB_val* b) {
         int len = data_types.size();
         std::vector<int16_t> offset_a(len + 1), offset_b(len + 1);
         for (int i = 1; i < len; ++i) {
@@ -355,4 +365,10 @@ KeySortFunc GetKeyComparator(const ComparatorDesc& desc) {
         THROW_CODE(KvException, "Unrecognized comparator type: {}", desc.comp_type);
     }
 }
+
+int CompareCompositeKey(const std::vector<FieldType>& data_types, bool with_vid,
+                        const MDB_val* a, const MDB_val* b) {
+    return with_vid ? _detail::CompositeKeyCompare::CompareWithVid(data_types, a, b)
+                    : _detail::CompositeKeyCompare::Compare(data_types, a, b);
+}
 }  // namespace lgraph
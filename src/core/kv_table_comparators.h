@@ -55,4 +55,10 @@ struct ComparatorDesc {
 };
 
 KeySortFunc GetKeyComparator(const ComparatorDesc& desc);
+
+// Compares two composite keys of the given field types. The function GetKeyComparator returns
+// for a composite key reads the types of the table opened last, a store that compares keys
+// after the tables are opened, such as in a background compaction, uses this instead.
+int CompareCompositeKey(const std::vector<FieldType>& data_types, bool with_vid,
+                        const MDB_val* a, const MDB_val* b);
 }  // namespace lgraph
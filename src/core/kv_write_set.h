@@ -0,0 +1,129 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "fma-common/type_traits.h"
+#include "core/value.h"
+
+namespace lgraph {
+class KvStore;
+
+/**
+ * The puts and deletes of one write transaction, in the order they were made. Values are
+ * recorded without the version prefix the store adds, so that the write set can be applied to
+ * another store as ordinary SetValue and DeleteKey calls.
+ *
+ * A transaction that also changes state outside of the kv tables, such as creating a table or
+ * updating a fulltext index, is marked unreplicable: its write set alone does not reproduce it.
+ */
+class KvWriteSet {
+ public:
+    struct Op {
+        std::string table;
+        std::string key;
+        std::string value;
+        bool is_delete = false;
+    };
+
+ private:
+    const KvStore* store_;
+    std::vector<Op> ops_;
+    size_t bytes_ = 0;
+    std::string unreplicable_reason_;
+
+ public:
+    explicit KvWriteSet(const KvStore* store) : store_(store) {}
+
+    DISABLE_COPY(KvWriteSet);
+
+    void Put(const std::string& table, const Value& key, const Value& value) {
+        ops_.emplace_back(Op{table, key.AsString(), value.AsString(), false});
+        bytes_ += key.Size() + value.Size();
+    }
+
+    void Delete(const std::string& table, const Value& key) {
+        ops_.emplace_back(Op{table, key.AsString(), std::string(), true});
+        bytes_ += key.Size();
+    }
+
+    void MarkUnreplicable(const std::string& reason) {
+        if (unreplicable_reason_.empty()) unreplicable_reason_ = reason;
+    }
+
+    bool IsReplicable() const { return unreplicable_reason_.empty(); }
+
+    const std::string& UnreplicableReason() const { return unreplicable_reason_; }
+
+    const KvStore* GetStore() const { return store_; }
+
+    const std::vector<Op>& GetOps() const { return ops_; }
+
+    bool Empty() const { return ops_.empty(); }
+
+    /** @brief   Total size of the keys and values written. */
+    size_t Bytes() const { return bytes_; }
+};
+
+/**
+ * Records the write sets of the write transactions created by the current thread while it is
+ * in scope. Right before such a transaction commits, its write set is handed to on_commit,
+ * which may throw to abort the commit. Once on_commit has returned, on_committed is called with
+ * whether the commit succeeded. Code about to write through another process or thread, where
+ * nothing is recorded, calls OnUnrecordedWrites() first, which may throw to refuse.
+ * Recorders nest, the innermost one is used.
+ */
+class KvWriteSetRecorder {
+    std::function<void(KvWriteSet&)> on_commit_;
+    std::function<void(const std::string&)> on_unrecorded_writes_;
+    std::function<void(bool)> on_committed_;
+    KvWriteSetRecorder* prev_;
+
+    static KvWriteSetRecorder*& CurrentRef() {
+        static thread_local KvWriteSetRecorder* curr = nullptr;
+        return curr;
+    }
+
+ public:
+    KvWriteSetRecorder(std::function<void(KvWriteSet&)> on_commit,
+                       std::function<void(const std::string&)> on_unrecorded_writes,
+                       std::function<void(bool)> on_committed = nullptr)
+        : on_commit_(std::move(on_commit)),
+          on_unrecorded_writes_(std::move(on_unrecorded_writes)),
+          on_committed_(std::move(on_committed)),
+          prev_(CurrentRef()) {
+        CurrentRef() = this;
+    }
+
+    ~KvWriteSetRecorder() { CurrentRef() = prev_; }
+
+    DISABLE_COPY(KvWriteSetRecorder);
+
+    void OnCommit(KvWriteSet& write_set) { on_commit_(write_set); }
+
+    void OnCommitted(bool success) {
+        if (on_committed_) on_committed_(success);
+    }
+
+    void OnUnrecordedWrites(const std::string& reason) { on_unrecorded_writes_(reason); }
+
+    /** @brief   The recorder of the current thread, nullptr if there is none. */
+    static KvWriteSetRecorder* Current() { return CurrentRef(); }
+};
+}  // namespace lgraph
@@ -11,23 +11,41 @@
  * distributed under the License is distributed on an "AS IS" BASIS,
  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
  */
+#include <chrono>
+#include <exception>
+#include <filesystem>
 #include <memory>
+#include <thread>
 #include <boost/algorithm/string.hpp>
 #include "db/galaxy.h"
 #include "core/index_manager.h"
 #include "core/lightning_graph.h"
+#include "core/rocksdb_store.h"
 #include "import/import_config_parser.h"
 #include "fma-common/hardware_info.h"
 
 namespace lgraph {
 thread_local bool LightningGraph::in_transaction_ = false;
 
-LightningGraph::LightningGraph(const DBConfig& conf) : config_(conf) { Open(); }
+LightningGraph::LightningGraph(const DBConfig& conf) : config_(conf) {
+    // copies left by CreateSnapshotReadTxn when the process stopped
+    std::error_code ec;
+    std::filesystem::remove_all(config_.dir + "/" + _detail::READ_SNAPSHOT_DIR, ec);
+    Open();
+}
 
 LightningGraph::~LightningGraph() { Close(); }
 
 void LightningGraph::Close() {
     _HoldWriteLock(meta_lock_);
+    if (store_ && config_.persist_hot_pages) {
+        try {
+            store_->SaveHotPages(config_.dir + "/" + _detail::HOT_PAGES_FILE);
+        } catch (std::exception& e) {
+            LOG_WARN() << "Failed to save hot pages of graph " << config_.name << ": "
+                       << e.what();
+        }
+    }
     fulltext_index_.reset();
     index_manager_.reset();
     graph_.reset();
@@ -99,9 +117,12 @@ void LightningGraph::DropAllVertex() {
                 ext->GetVectorIndex()->Clear();
             }
         }
-        // clear detached property data
+        // clear detached property data and columns
         for (auto& name : curr_schema->v_schema_manager.GetAllLabels()) {
             auto s = curr_schema->v_schema_manager.GetSchema(name);
+            for (auto fid : s->GetColumnFields()) {
+                s->GetFieldExtractor(fid)->GetColumnStore()->Clear(txn.GetTxn());
+            }
             if (s->DetachProperty()) {
                 s->GetPropertyTable().Drop(txn.GetTxn());
             }
@@ -129,6 +150,13 @@ void LightningGraph::GetDBStat(size_t& msize, size_t& next_vid) {
     next_vid = graph_->GetNextVid(txn.GetTxn());
 }
 
+KvSpaceStat LightningGraph::GetSpaceStat() {
+    Transaction txn = CreateReadTxn();
+    KvSpaceStat stat;
+    store_->DumpStat(txn.GetTxn(), stat);
+    return stat;
+}
+
 size_t LightningGraph::GetNumVertices() {
     Transaction txn = CreateReadTxn();
     return graph_->GetLooseNumVertex(txn.GetTxn());
@@ -356,6 +384,10 @@ bool LightningGraph::DelLabel(const std::string& label, bool is_vertex, size_t*
                                                 schema->GetFieldExtractor(fid)->Name());
             }
         }
+        for (auto& fid : schema->GetColumnFields()) {
+            index_manager_->DeleteVertexColumn(txn.GetTxn(), label,
+                                               schema->GetFieldExtractor(fid)->Name());
+        }
         // delete detached property table
         schema->GetPropertyTable().Delete(txn.GetTxn());
     } else if (is_vertex) {  // now delete every node/edge that has this label
@@ -468,6 +500,10 @@ bool LightningGraph::DelLabel(const std::string& label, bool is_vertex, size_t*
                                               schema->GetFieldExtractor(fid)->Name());
             to_unindex->UnVertexIndex(fid);
         }
+        for (auto& fid : schema->GetColumnFields()) {
+            index_manager_->DeleteVertexColumn(txn.GetTxn(), label,
+                                               schema->GetFieldExtractor(fid)->Name());
+        }
     } else {
         // this is edge label, just scan and delete edges
         graph_->_ScanAndDelete(
@@ -643,6 +679,7 @@ bool LightningGraph::_AlterLabel(
         }
     }
     modify_index(curr_schema, new_schema, rollback_actions, txn);
+    if (is_vertex) _DropStaleIndexIncludes(txn, label, curr_schema, new_schema);
 
     // assign new schema and commit
     schema_.Assign(new_schema_info.release());
@@ -844,6 +881,9 @@ bool LightningGraph::AlterLabelDelFields(const std::string& label,
             } else if (extractor->GetVectorIndex()) {
                 index_manager_->DeleteVectorIndex(txn.GetTxn(), label, extractor->Name());
             }
+            if (extractor->GetColumnStore()) {
+                index_manager_->DeleteVertexColumn(txn.GetTxn(), label, extractor->Name());
+            }
         }
         auto composite_index_key = curr_schema->GetRelationalCompositeIndexKey(fids);
         for (const auto &cidx : composite_index_key) {
@@ -1097,6 +1137,11 @@ bool LightningGraph::AlterLabelModFields(const std::string& label,
                 new_schema->UnEdgeIndex(f);
                 index_manager_->DeleteEdgeIndex(txn.GetTxn(), label, extractor->Name());
             }
+            // the values in the column keep the old type
+            if (extractor->GetColumnStore()) {
+                new_schema->UnColumnStore(f);
+                index_manager_->DeleteVertexColumn(txn.GetTxn(), label, extractor->Name());
+            }
         }
         auto composite_index_key = curr_schema->GetRelationalCompositeIndexKey(mod_fids);
         for (const auto &cidx : composite_index_key) {
@@ -1115,6 +1160,98 @@ bool LightningGraph::AlterLabelModFields(const std::string& label,
 #endif
 }
 
+bool LightningGraph::UpgradeLabelRecords(bool is_vertex, const std::string& label,
+                                         size_t batch_size, size_t interval_ms,
+                                         size_t* n_upgraded) {
+    if (batch_size == 0) THROW_CODE(InputError, "Batch size must be positive.");
+    LOG_INFO() << FMA_FMT("Upgrading records of {} label [{}], batch_size={}, interval_ms={}.",
+                          is_vertex ? "vertex" : "edge", label, batch_size, interval_ms);
+    size_t upgraded = 0;
+    // where the next batch starts, a key of the detached property table or a vertex id
+    std::string next_key;
+    VertexId next_vid = 0;
+    bool done = false;
+    while (!done) {
+        // Each batch is a transaction of its own, and the schema is looked up again in it,
+        // since it may have been altered since the last batch.
+        Transaction txn = CreateWriteTxn(false);
+        ScopedRef<SchemaInfo> schema_info = schema_.GetScopedRef();
+        SchemaManager* sm =
+            is_vertex ? &schema_info->v_schema_manager : &schema_info->e_schema_manager;
+        Schema* schema = sm->GetSchema(label);
+        if (!schema) return false;
+        // records of other labels are always written in the current layout
+        if (!schema->GetFastAlterSchema()) break;
+        LabelId lid = schema->GetLabelId();
+        size_t scanned = 0;
+        if (schema->DetachProperty()) {
+            auto kv_iter = schema->GetPropertyTable().GetIterator(txn.GetTxn());
+            if (next_key.empty()) {
+                kv_iter->GotoFirstKey();
+            } else {
+                kv_iter->GotoClosestKey(Value::ConstRef(next_key));
+            }
+            for (; kv_iter->IsValid() && scanned < batch_size; kv_iter->Next(), scanned++) {
+                Value prop = kv_iter->GetValue();
+                if (!schema->RecordNeedsUpgrade(prop)) continue;
+                kv_iter->SetValue(schema->UpgradeRecord(prop));
+                upgraded++;
+            }
+            done = !kv_iter->IsValid();
+            if (!done) next_key = kv_iter->GetKey().AsString();
+        } else {
+            // The records are found by walking the whole vertex table, so the batch is bounded
+            // by the vertices and edges visited, not by the records of the label, or a batch of
+            // a sparse label would hold the write lock for most of the table. A vertex is never
+            // split between two batches.
+            std::unique_ptr<graph::VertexIterator> vit(new graph::VertexIterator(
+                graph_->GetUnmanagedVertexIterator(&txn.GetTxn(), next_vid, true)));
+            for (; vit->IsValid() && scanned < batch_size; vit->Next()) {
+                scanned++;
+                if (is_vertex) {
+                    Value prop = vit->GetProperty();
+                    if (SchemaManager::GetRecordLabelId(prop) != lid) continue;
+                    if (!schema->RecordNeedsUpgrade(prop)) continue;
+                    vit->SetProperty(schema->UpgradeRecord(prop));
+                    upgraded++;
+                    continue;
+                }
+                // both copies of an edge are upgraded, but counted once
+                for (auto eit = vit->GetOutEdgeIterator(); eit.IsValid(); eit.Next()) {
+                    scanned++;
+                    if (eit.GetLabelId() != lid) continue;
+                    Value prop = eit.GetProperty();
+                    if (!schema->RecordNeedsUpgrade(prop)) continue;
+                    Value new_prop = schema->UpgradeRecord(prop);
+                    eit.RefreshContentIfKvIteratorModified();
+                    eit.SetProperty(new_prop);
+                    upgraded++;
+                }
+                vit->RefreshContentIfKvIteratorModified();
+                for (auto eit = vit->GetInEdgeIterator(); eit.IsValid(); eit.Next()) {
+                    scanned++;
+                    if (eit.GetLabelId() != lid) continue;
+                    Value prop = eit.GetProperty();
+                    if (!schema->RecordNeedsUpgrade(prop)) continue;
+                    Value new_prop = schema->UpgradeRecord(prop);
+                    eit.RefreshContentIfKvIteratorModified();
+                    eit.SetProperty(new_prop);
+                }
+                vit->RefreshContentIfKvIteratorModified();
+            }
+            done = !vit->IsValid();
+            if (!done) next_vid = vit->GetId();
+        }
+        txn.Commit();
+        LOG_DEBUG() << "Upgraded " << upgraded << " records.";
+        if (!done && interval_ms > 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+    }
+    LOG_INFO() << FMA_FMT("Upgraded {} records of label [{}].", upgraded, label);
+    if (n_upgraded) *n_upgraded = upgraded;
+    return true;
+}
+
 /**
  * Adds an index to 'label:field'
  *
@@ -2817,6 +2954,142 @@ bool LightningGraph::DeleteIndex(const std::string& label, const std::string& fi
     return false;
 }
 
+bool LightningGraph::AlterVertexIndexInclude(const std::string& label, const std::string& field,
+                                             const std::vector<std::string>& include_fields) {
+    _HoldWriteLock(meta_lock_);
+    Transaction txn = CreateWriteTxn(false);
+    ScopedRef<SchemaInfo> curr_schema = schema_.GetScopedRef();
+    std::unique_ptr<SchemaInfo> old_schema_backup(new SchemaInfo(*curr_schema.Get()));
+    std::unique_ptr<SchemaInfo> new_schema(new SchemaInfo(*curr_schema.Get()));
+    Schema* schema = new_schema->v_schema_manager.GetSchema(label);
+    if (!schema) throw LabelNotExistException(label);
+    VertexIndex* index = schema->GetFieldExtractor(field)->GetVertexIndex();
+    if (!index) return false;
+    if (!index->IsUnique()) {
+        THROW_CODE(InputError, "Only unique vertex indexes can include fields, [{}:{}] is not.",
+                   label, field);
+    }
+    std::unordered_set<std::string> included;
+    for (auto& f : include_fields) {
+        auto* fe = schema->GetFieldExtractor(f);
+        if (f == field) THROW_CODE(InputError, "Field [{}] is the key of the index.", f);
+        if (fe->Type() == FieldType::BLOB || fe->Type() == FieldType::FLOAT_VECTOR) {
+            THROW_CODE(InputError, "Field [{}] of type {} cannot be included in an index.", f,
+                       field_data_helper::FieldTypeName(fe->Type()));
+        }
+        if (!included.insert(f).second) {
+            THROW_CODE(InputError, "Field [{}] is included more than once.", f);
+        }
+    }
+    index_manager_->SetVertexIndexInclude(txn.GetTxn(), label, field, include_fields);
+    index->SetIncludeFields(include_fields);
+    index->RewriteIncluded(txn.GetTxn(), [&](VertexId vid) {
+        if (schema->DetachProperty()) {
+            return schema->GetVertexIndexIncluded(
+                *index, schema->GetDetachedVertexProperty(txn.GetTxn(), vid));
+        }
+        auto vit = txn.GetVertexIterator(vid);
+        return schema->GetVertexIndexIncluded(*index, vit.GetProperty());
+    });
+    // install the new schema
+    schema_.Assign(new_schema.release());
+    AutoCleanupAction revert_assign_new_schema(
+        [&]() { schema_.Assign(old_schema_backup.release()); });
+    txn.Commit();
+    revert_assign_new_schema.Cancel();
+    return true;
+}
+
+void LightningGraph::_DropStaleIndexIncludes(Transaction& txn, const std::string& label,
+                                             Schema* curr_schema, Schema* new_schema) {
+    // the included fields are not rewritten when altered, so indexes including a
+    // deleted or retyped field stop including fields
+    for (auto fid : new_schema->GetIndexedFields()) {
+        auto* fe = new_schema->GetFieldExtractor(fid);
+        VertexIndex* index = fe->GetVertexIndex();
+        if (!index || index->GetIncludeFields().empty()) continue;
+        bool stale = false;
+        for (auto& f : index->GetIncludeFields()) {
+            auto* old_fe = curr_schema->TryGetFieldExtractor(f);
+            auto* new_fe = new_schema->TryGetFieldExtractor(f);
+            stale = stale || !old_fe || !new_fe || new_fe->IsDeleted() ||
+                    old_fe->Type() != new_fe->Type();
+        }
+        if (!stale) continue;
+        index_manager_->SetVertexIndexInclude(txn.GetTxn(), label, fe->Name(), {});
+        index->SetIncludeFields({});
+    }
+}
+
+bool LightningGraph::AddVertexColumn(const std::string& label, const std::string& field) {
+    _HoldWriteLock(meta_lock_);
+    Transaction txn = CreateWriteTxn(false);
+    std::unique_ptr<SchemaInfo> new_schema(new SchemaInfo(*schema_.GetScopedRef().Get()));
+    Schema* schema = new_schema->v_schema_manager.GetSchema(label);
+    if (!schema) throw LabelNotExistException(label);
+    const _detail::FieldExtractorBase* extractor = schema->GetFieldExtractor(field);
+    if (extractor->GetColumnStore()) return false;
+    std::unique_ptr<ColumnStore> column_store;
+    if (!index_manager_->AddVertexColumn(txn.GetTxn(), label, field, extractor->Type(),
+                                         column_store)) {
+        return false;
+    }
+    LOG_INFO() << FMA_FMT("start building vertex column for {}:{}", label, field);
+    // vertices are read in the order of vid, so the blocks are written one after another
+    ColumnStore::Builder builder(*column_store, txn.GetTxn());
+    uint64_t count = 0;
+    auto add = [&](VertexId vid, const Value& prop) {
+        if (extractor->GetIsNull(prop)) return;
+        builder.Add(vid, extractor->GetConstRef(prop));
+        if (++count % 1000000 == 0) LOG_INFO() << "column count: " << count;
+    };
+    if (schema->DetachProperty()) {
+        auto kv_iter = schema->GetPropertyTable().GetIterator(txn.GetTxn());
+        for (kv_iter->GotoFirstKey(); kv_iter->IsValid(); kv_iter->Next()) {
+            add(graph::KeyPacker::GetVidFromPropertyTableKey(kv_iter->GetKey()),
+                kv_iter->GetValue());
+        }
+    } else {
+        LabelId lid = schema->GetLabelId();
+        for (auto vit = txn.GetVertexIterator(); vit.IsValid(); vit.Next()) {
+            if (txn.GetVertexLabelId(vit) == lid) add(vit.GetId(), vit.GetProperty());
+        }
+    }
+    builder.Finish();
+    LOG_INFO() << "column count: " << count;
+    LOG_INFO() << FMA_FMT("end building vertex column for {}:{}", label, field);
+    schema->MarkColumnStored(extractor->GetFieldId(), column_store.release());
+    txn.Commit();
+    schema_.Assign(new_schema.release());
+    return true;
+}
+
+bool LightningGraph::DeleteVertexColumn(const std::string& label, const std::string& field) {
+    _HoldWriteLock(meta_lock_);
+    Transaction txn = CreateWriteTxn(false);
+    ScopedRef<SchemaInfo> curr_schema = schema_.GetScopedRef();
+    std::unique_ptr<SchemaInfo> old_schema_backup(new SchemaInfo(*curr_schema.Get()));
+    std::unique_ptr<SchemaInfo> new_schema(new SchemaInfo(*curr_schema.Get()));
+    Schema* schema = new_schema->v_schema_manager.GetSchema(label);
+    if (!schema) throw LabelNotExistException(label);
+    const _detail::FieldExtractorBase* extractor = schema->GetFieldExtractor(field);
+    if (!extractor->GetColumnStore()) return false;
+    if (!index_manager_->DeleteVertexColumn(txn.GetTxn(), label, field)) return false;
+    schema->UnColumnStore(extractor->GetFieldId());
+    // install the new schema
+    schema_.Assign(new_schema.release());
+    AutoCleanupAction revert_assign_new_schema(
+        [&]() { schema_.Assign(old_schema_backup.release()); });
+    txn.Commit();
+    revert_assign_new_schema.Cancel();
+    return true;
+}
+
+std::vector<std::pair<std::string, std::string>> LightningGraph::ListVertexColumns(
+    KvTransaction& txn) {
+    return index_manager_->ListVertexColumns(txn);
+}
+
 bool LightningGraph::DeleteCompositeIndex(const std::string& label,
                                           const std::vector<std::string>& fields,
                                           bool is_vertex) {
@@ -2962,7 +3235,7 @@ const DBConfig& LightningGraph::GetConfig() const { return config_; }
  * \return  Transaction ID of the last committed transaction.
  */
 size_t LightningGraph::Backup(const std::string& path, bool compact) {
-    auto ret = store_->Backup(path, compact);
+    auto ret = store_->Backup(GetStoreDir(path, kv_engine_), compact);
     if (fulltext_index_) {
         fulltext_index_->Commit();
         fulltext_index_->Backup(path + "/" + _detail::FULLTEXT_INDEX_DIR);
@@ -2986,7 +3259,7 @@ void LightningGraph::Snapshot(Transaction& txn, const std::string& path) {
         fs.Remove(path + fma_common::LocalFileSystem::PATH_SEPERATOR() + "data.mdb");
         fs.Remove(path + fma_common::LocalFileSystem::PATH_SEPERATOR() + "lock.mdb");
     }
-    store_->Snapshot(txn.GetTxn(), path);
+    store_->Snapshot(txn.GetTxn(), GetStoreDir(path, kv_engine_));
 }
 
 void LightningGraph::LoadSnapshot(const std::string& path) {
@@ -2995,14 +3268,85 @@ void LightningGraph::LoadSnapshot(const std::string& path) {
     plugin_manager_.reset();
     index_manager_.reset();
     graph_.reset();
-    store_->LoadSnapshot(path);
+    store_->LoadSnapshot(GetStoreDir(path, kv_engine_));
     Open();
 }
 
+void LightningGraph::Compact(KillableRWLock* switch_lock) {
+    store_->StartCompaction();
+    // nothing to switch to, so the db is neither locked nor reopened
+    if (store_->CompactsInPlace()) return;
+    bool locked = false;
+    try {
+        // waits for the requests running, and their transactions, to finish
+        std::unique_ptr<AutoWriteLock> switch_guard;
+        if (switch_lock) switch_guard.reset(new AutoWriteLock(*switch_lock, GetMyThreadId()));
+        _HoldWriteLock(meta_lock_);
+        locked = true;
+        // as in LoadSnapshot, this is now the only thread accessing this db
+        plugin_manager_.reset();
+        index_manager_.reset();
+        graph_.reset();
+        // FinishCompaction leaves the store as it was if it fails, reopen the db either way
+        std::exception_ptr error;
+        try {
+            store_->FinishCompaction();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        Open();
+        if (error) std::rethrow_exception(error);
+    } catch (...) {
+        if (!locked) store_->AbortCompaction();
+        throw;
+    }
+}
+
 /** Warmups this DB */
 
-void LightningGraph::WarmUp() const {
-    store_->WarmUp(nullptr);
+void LightningGraph::WarmUp(const std::vector<std::string>& labels, bool indexes_only,
+                            size_t n_threads) const {
+    if (labels.empty() && !indexes_only) return store_->WarmUp(nullptr, {}, n_threads);
+    std::vector<std::string> all_tables;
+    {
+        auto txn = store_->CreateReadTxn();
+        all_tables = store_->ListAllTables(*txn);
+    }
+    auto schema = schema_.GetScopedRef();
+    std::vector<std::string> tables;
+    auto add_label = [&](const std::string& label, bool is_vertex) {
+        // index tables are named label + NAME_SEPARATOR + ...
+        std::string prefix = label + _detail::NAME_SEPARATOR;
+        for (auto& t : all_tables) {
+            if (t.compare(0, prefix.size(), prefix) == 0) tables.push_back(t);
+        }
+        const SchemaManager& sm =
+            is_vertex ? schema->v_schema_manager : schema->e_schema_manager;
+        if (!indexes_only && sm.GetSchema(label)->DetachProperty()) {
+            tables.push_back((is_vertex ? _detail::VERTEX_PROPERTY_TABLE_PREFIX
+                                        : _detail::EDGE_PROPERTY_TABLE_PREFIX) + label);
+        }
+    };
+    if (labels.empty()) {
+        for (auto& l : schema->v_schema_manager.GetAllLabels()) add_label(l, true);
+        for (auto& l : schema->e_schema_manager.GetAllLabels()) add_label(l, false);
+    }
+    for (auto& l : labels) {
+        bool found = false;
+        if (schema->v_schema_manager.GetSchema(l)) {
+            add_label(l, true);
+            found = true;
+        }
+        if (schema->e_schema_manager.GetSchema(l)) {
+            add_label(l, false);
+            found = true;
+        }
+        if (!found) throw LabelNotExistException(l);
+    }
+    std::sort(tables.begin(), tables.end());
+    tables.erase(std::unique(tables.begin(), tables.end()), tables.end());
+    if (tables.empty()) return;
+    store_->WarmUp(nullptr, tables, n_threads);
 }
 
 PluginManager* LightningGraph::GetPluginManager() const { return plugin_manager_.get(); }
@@ -3023,10 +3367,37 @@ size_t LightningGraph::GetCurrentVersion() {
 ScopedRef<SchemaInfo> LightningGraph::GetSchemaInfo() { return schema_.GetScopedRef(); }
 #endif
 
+std::string LightningGraph::GetStoreDir(const std::string& dir, const std::string& kv_engine) {
+    if (kv_engine == _detail::KV_ENGINE_ROCKSDB) return dir + "/" + _detail::ROCKSDB_DIR;
+    return dir;
+}
+
 void LightningGraph::Open() {
     Close();
-    store_.reset(new LMDBKvStore(
-        config_.dir, config_.db_size, config_.durable, config_.create_if_not_exist));
+    static std::atomic<uint64_t> last_open_id(0);
+    open_id_ = ++last_open_id;
+    // a graph keeps the engine it was created with, config_.kv_engine is for new graphs
+    std::error_code ec;
+    if (RocksDBKvStore::IsStoreDir(GetStoreDir(config_.dir, _detail::KV_ENGINE_ROCKSDB))) {
+        kv_engine_ = _detail::KV_ENGINE_ROCKSDB;
+    } else if (std::filesystem::exists(config_.dir + "/data.mdb", ec)) {
+        kv_engine_ = _detail::KV_ENGINE_LMDB;
+    } else if (config_.kv_engine == _detail::KV_ENGINE_LMDB ||
+               config_.kv_engine == _detail::KV_ENGINE_ROCKSDB) {
+        kv_engine_ = config_.kv_engine;
+    } else {
+        THROW_CODE(InputError, "Unknown kv engine [{}], expecting {} or {}.", config_.kv_engine,
+                   _detail::KV_ENGINE_LMDB, _detail::KV_ENGINE_ROCKSDB);
+    }
+    if (kv_engine_ == _detail::KV_ENGINE_ROCKSDB) {
+        store_.reset(new RocksDBKvStore(GetStoreDir(config_.dir, kv_engine_), config_.durable,
+                                        config_.create_if_not_exist));
+    } else {
+        store_.reset(new LMDBKvStore(
+            config_.dir, config_.db_size, config_.durable, config_.create_if_not_exist));
+    }
+    if (config_.persist_hot_pages)
+        store_->PrefetchHotPages(config_.dir + "/" + _detail::HOT_PAGES_FILE);
     auto txn = store_->CreateWriteTxn();
     // load meta info
     meta_table_ =
@@ -3109,7 +3480,53 @@ Transaction LightningGraph::CreateReadTxn() {
 
 Transaction LightningGraph::ForkTxn(Transaction& txn) {
     if (!txn.read_only_) THROW_CODE(InvalidFork);
-    return Transaction(this, txn.GetTxn());
+    // txn may read a copy, see CreateSnapshotReadTxn
+    Transaction fork(txn.db_, txn.GetTxn());
+    fork.snapshot_db_ = txn.snapshot_db_;
+    return fork;
+}
+
+Transaction LightningGraph::CreateSnapshotReadTxn(double max_age_seconds) {
+    // the copy is made under the write lock, which a txn of this thread may hold already
+    if (InTransaction()) {
+        THROW_CODE(InternalError,
+                   "Nested transaction is forbidden. "
+                   "CreateSnapshotReadTxn should NOT be used inside a transaction.");
+    }
+    std::shared_ptr<LightningGraph> snapshot;
+    {
+        std::lock_guard<std::mutex> l(read_snapshot_mutex_);
+        auto now = std::chrono::steady_clock::now();
+        snapshot = read_snapshot_.lock();
+        if (!snapshot ||
+            std::chrono::duration<double>(now - read_snapshot_time_).count() > max_age_seconds) {
+            DBConfig config = config_;
+            config.dir = config_.dir + "/" + _detail::READ_SNAPSHOT_DIR + "/" +
+                         std::to_string(n_read_snapshots_++);
+            config.create_if_not_exist = false;
+            config.durable = false;
+            config.load_plugins = false;
+            config.persist_hot_pages = false;
+            config.ft_index_options.enable_fulltext_index = false;
+            std::error_code ec;
+            std::filesystem::remove_all(config.dir, ec);
+            if (!std::filesystem::create_directories(config.dir, ec)) {
+                THROW_CODE(InternalError, "Failed to create dir " + config.dir);
+            }
+            store_->Clone(GetStoreDir(config.dir, kv_engine_));
+            std::string dir = config.dir;
+            snapshot.reset(new LightningGraph(config), [dir](LightningGraph* g) {
+                delete g;
+                std::error_code ec;
+                std::filesystem::remove_all(dir, ec);
+            });
+            read_snapshot_ = snapshot;
+            read_snapshot_time_ = now;
+        }
+    }
+    Transaction txn = snapshot->CreateReadTxn();
+    txn.snapshot_db_ = std::move(snapshot);
+    return txn;
 }
 
 bool LightningGraph::CheckDbSecret(const std::string& expected) {
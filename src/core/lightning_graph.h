@@ -13,6 +13,8 @@
  */
 
 #pragma once
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <memory>
 #include <mutex>
@@ -46,6 +48,8 @@ class LightningGraph {
     friend class import_v2::ImportOnline;
 
     DBConfig config_;
+    // storage engine of the store, see DBConfig::kv_engine
+    std::string kv_engine_;
 
     std::unique_ptr<KvStore> store_ = nullptr;
     std::shared_ptr<KvTable> meta_table_;
@@ -57,6 +61,14 @@ class LightningGraph {
     std::unique_ptr<FullTextIndex> fulltext_index_ = nullptr;
     GCRefCountedPtr<SchemaInfo> schema_;
     KillableRWLock meta_lock_;  // lock to hold when doing meta update, especially when AlterLabel
+    // set by Open(), unique across the dbs of the process, see GetOpenId()
+    uint64_t open_id_ = 0;
+
+    // point-in-time copy read by the txns of CreateSnapshotReadTxn, and when it was made
+    std::mutex read_snapshot_mutex_;
+    std::weak_ptr<LightningGraph> read_snapshot_;
+    std::chrono::steady_clock::time_point read_snapshot_time_;
+    size_t n_read_snapshots_ = 0;
 
     static thread_local bool in_transaction_;
     static inline bool& InTransaction() { return in_transaction_; }
@@ -83,6 +95,24 @@ class LightningGraph {
      */
     Transaction ForkTxn(Transaction& txn);
 
+    /**
+     * Creates a read transaction on a point-in-time copy of the graph, for long analytics. A
+     * long read txn on the graph keeps the pages it sees from being reused, so the data file
+     * grows while others write, a txn on a copy does not. The data file is cloned, which
+     * shares its blocks on file systems with reflinks, or copied otherwise.
+     *
+     * A copy is shared by the txns created while it is at most max_age_seconds old, and is
+     * deleted when the last txn on it ends. The copy has no plugins and no fulltext indexes.
+     *
+     * Making a copy takes the write lock of the store, so this must not be called by a thread
+     * that already has a transaction open, which throws InternalError like any nested txn.
+     *
+     * \param   max_age_seconds (Optional) How old a copy made earlier can be to be read.
+     *
+     * \return  The new read transaction.
+     */
+    Transaction CreateSnapshotReadTxn(double max_age_seconds = 60);
+
     /**
      * @brief  Creates a read-write transaction
      * @param   optimistic  Create an optimistic txn. Multiple optimistic txns can run in parallel.
@@ -113,6 +143,9 @@ class LightningGraph {
      */
     void GetDBStat(size_t& msize, size_t& next_vid);
 
+    /** Gets the space used by the data file of this DB, see KvSpaceStat. */
+    KvSpaceStat GetSpaceStat();
+
     size_t GetNumVertices();
 
     //********************************
@@ -168,6 +201,26 @@ class LightningGraph {
                              size_t* n_modified);
     bool AlterLabelModFields(const std::string& label, const std::vector<FieldSpec>& mod_fields,
                              bool is_vertex, size_t* n_modified);
+
+    /**
+     * Rewrites the records of a fast alter label that were written before its last schema
+     * changes in the current layout, see Schema::UpgradeRecord(). This is optional, since
+     * records are also upgraded on their next write. Each batch visits about batch_size keys,
+     * property records of a detached label or else vertices and edges of any label, in a write
+     * transaction of its own, sleeping interval_ms between two batches, so that other writes
+     * are not held back for long.
+     *
+     * \param           is_vertex   True if label is a vertex label.
+     * \param           label       The label.
+     * \param           batch_size  Number of keys visited in each transaction.
+     * \param           interval_ms Milliseconds to sleep between two transactions.
+     * \param [out]     n_upgraded  If non-null, the number of records upgraded.
+     *
+     * \return  False if the label does not exist.
+     */
+    bool UpgradeLabelRecords(bool is_vertex, const std::string& label, size_t batch_size,
+                             size_t interval_ms, size_t* n_upgraded);
+
     bool AddEdgeConstraints(const std::string& edge_label, const EdgeConstraints& constraints);
     bool ClearEdgeConstraints(const std::string& edge_label);
 
@@ -260,8 +313,41 @@ class LightningGraph {
      */
     bool DeleteIndex(const std::string& label, const std::string& field, bool is_vertex);
 
+    /**
+     * Sets the fields stored along with the vids in the unique vertex index on
+     * 'label:field', so that reads of them are served by the index. Existing
+     * entries are rewritten, an empty list drops the included fields.
+     *
+     * \param   label           The label.
+     * \param   field           The indexed field.
+     * \param   include_fields  The fields to include.
+     *
+     * \return  True if it succeeds, false if the index does not exist. Throws exception on error.
+     */
+    bool AlterVertexIndexInclude(const std::string& label, const std::string& field,
+                                 const std::vector<std::string>& include_fields);
+
     bool DeleteVectorIndex(bool is_vertex, const std::string& label, const std::string& field);
 
+    /**
+     * Adds a column store to the vertex field 'label:field' and fills it with the values of
+     * the existing vertices. The column is then kept up to date by the transactions writing
+     * the vertices, and scans or aggregates of the field can read it instead of the vertices.
+     *
+     * \param   label   The vertex label.
+     * \param   field   The field.
+     *
+     * \return  True if it succeeds, false if the column already exists. Throws exception on
+     *          error.
+     */
+    bool AddVertexColumn(const std::string& label, const std::string& field);
+
+    /** Deletes the column store of 'label:field', returns false if there is none. */
+    bool DeleteVertexColumn(const std::string& label, const std::string& field);
+
+    /** Lists the (label, field) of the vertex column stores. */
+    std::vector<std::pair<std::string, std::string>> ListVertexColumns(KvTransaction& txn);
+
     bool DeleteCompositeIndex(const std::string& label,
                               const std::vector<std::string>& fields, bool is_vertex);
 
@@ -270,8 +356,21 @@ class LightningGraph {
 
     KvStore& GetStore();
 
+    /**
+     * Changes every time the db is opened, e.g. again by Compact or LoadSnapshot, and is not
+     * reused by another db of the process. Tables kept open outside of the db are stale once it
+     * has changed.
+     */
+    uint64_t GetOpenId() const { return open_id_; }
+
     const DBConfig& GetConfig() const;
 
+    /** Gets the storage engine the graph is kept in, lmdb or rocksdb. */
+    const std::string& GetKvEngine() const { return kv_engine_; }
+
+    /** Gets the dir the store of a graph in dir is kept in, given the engine of the graph. */
+    static std::string GetStoreDir(const std::string& dir, const std::string& kv_engine);
+
     /**
      * Backups the current DB to the path specified.
      *
@@ -292,8 +391,33 @@ class LightningGraph {
 
     void LoadSnapshot(const std::string& path);
 
-    /** Warmups this DB */
-    void WarmUp() const;
+    /**
+     * Compacts the data file, so that the space freed by deletes and updates is returned to
+     * the OS. The file is copied while transactions go on. The switch to the copy closes the
+     * store, so no transaction may be open then. Transactions that cannot be replayed on the
+     * copy, such as schema changes or optimistic transactions, make the compaction fail, in
+     * which case the DB is left as it was. A rocksdb store is compacted in place, without a
+     * switch, so the DB is not reopened.
+     *
+     * \param [in,out] switch_lock  If not null, write-locked for the switch, like the reload
+     *                              lock of the galaxy, which every request holds for read.
+     *                              Otherwise the caller makes sure no transaction is open.
+     */
+    void Compact(KillableRWLock* switch_lock = nullptr);
+
+    /**
+     * Warmups this DB. With no label given, the whole DB is loaded. Otherwise the indexes of
+     * the labels are loaded, and unless indexes_only is true, so are the properties of the
+     * labels that store them in their own tables. The properties of other labels are in the
+     * graph table shared by all labels, and are only loaded by a whole-DB warm-up.
+     *
+     * \param   labels          (Optional) Vertex or edge labels to warm up.
+     * \param   indexes_only    (Optional) True to only load indexes. If no label is given,
+     *                          the indexes of all labels are loaded.
+     * \param   n_threads       (Optional) Number of threads, 0 to use one per core.
+     */
+    void WarmUp(const std::vector<std::string>& labels = {}, bool indexes_only = false,
+                size_t n_threads = 0) const;
 
     PluginManager* GetPluginManager() const;
 
@@ -338,5 +462,8 @@ class LightningGraph {
 
     void Open();
     static bool FieldTypeComplatible(FieldType a, FieldType b);
+
+    void _DropStaleIndexIncludes(Transaction& txn, const std::string& label,
+                                 Schema* curr_schema, Schema* new_schema);
 };
 }  // namespace lgraph
@@ -465,6 +465,7 @@ void LMDBKvIterator::SetValue(const Value& value) {
         if (ec != MDB_SUCCESS) THROW_ERR(ec);
         if (txn_->GetWal())
             txn_->GetWal()->WriteKvPut(table_->GetDbi(), tmpk, tmpv);
+        if (txn_->write_set_) txn_->write_set_->Put(table_->name_, tmpk, value);
         THROW_ON_ERR(mdb_cursor_get(cursor_, &key_, &value_, MDB_GET_CURRENT));
         return;
     }
@@ -513,6 +514,7 @@ bool LMDBKvIterator::AddKeyValue(const Value& key, const Value& value, bool over
         if (ec != MDB_SUCCESS && ec != MDB_KEYEXIST) THROW_ERR(ec);
         if (txn_->GetWal())
             txn_->GetWal()->WriteKvPut(table_->GetDbi(), key, tmpv);
+        if (txn_->write_set_ && ec == MDB_SUCCESS) txn_->write_set_->Put(table_->name_, key, value);
         THROW_ON_ERR(mdb_cursor_get(cursor_, &key_, &value_, MDB_GET_CURRENT));
         return ec == MDB_SUCCESS;
     }
@@ -540,6 +542,7 @@ void LMDBKvIterator::DeleteKey() {
         THROW_ON_ERR(mdb_cursor_del(cursor_, 0));
         if (txn_->GetWal())
             txn_->GetWal()->WriteKvDel(table_->GetDbi(), tmpk);
+        if (txn_->write_set_) txn_->write_set_->Delete(table_->name_, tmpk);
         int ec = mdb_cursor_get(cursor_, &key_, &value_, MDB_GET_CURRENT);
         valid_ = (ec == MDB_SUCCESS);
         if (ec == MDB_SUCCESS || ec == MDB_NOTFOUND || ec == EINVAL) return;
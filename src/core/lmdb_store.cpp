@@ -13,9 +13,22 @@
  */
 
 #if (!LGRAPH_USE_MOCK_KV)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif
 #include <chrono>
+#include <cstring>
+#include <exception>
 #include <filesystem>
+#include <fstream>
+#include "fma-common/utils.h"
 #include "core/lmdb_store.h"
+#include "core/parallel_for.h"
 #include "core/wal.h"
 
 using namespace std::chrono_literals;
@@ -23,6 +36,11 @@ using namespace std::chrono_literals;
 namespace lgraph {
 
 static const std::string DATA_FILE_NAME = "data.mdb";  // NOLINT
+static const std::string COMPACTION_DIR_NAME = ".compaction";  // NOLINT
+// StartCompaction returns once at most this many captured writes are left to apply, or after
+// COMPACTION_MAX_ROUNDS rounds of applying them if the store is written faster than that
+static const size_t COMPACTION_CATCH_UP_OPS = 1000;
+static const size_t COMPACTION_MAX_ROUNDS = 16;
 std::atomic<int64_t> LMDBKvStore::last_op_id_(-1);
 
 static auto IsDir = [](const std::string& p) {
@@ -41,6 +59,64 @@ static auto RemoveDir = [](const std::string& p) {
     std::error_code ec;
     return std::filesystem::remove_all(p, ec);
 };
+// a rename is durable only once the directory holding the new name is synced
+static auto SyncDir = [](const std::string& p) {
+    int fd = open(p.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) return false;
+    bool ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+};
+
+// makes dst share the blocks of src, returns false if the file system cannot do it
+static bool CloneFile(const std::string& src, const std::string& dst) {
+#ifdef FICLONE
+    int in = open(src.c_str(), O_RDONLY);
+    if (in < 0) return false;
+    int out = open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0664);
+    if (out < 0) {
+        close(in);
+        return false;
+    }
+    bool ok = ioctl(out, FICLONE, in) == 0;
+    close(in);
+    close(out);
+    if (!ok) unlink(dst.c_str());
+    return ok;
+#else
+    return false;
+#endif
+}
+
+struct LMDBKvStore::Compaction {
+    std::string dir;
+    MDB_env* env = nullptr;
+    // handles of the tables of the copy, by name
+    std::unordered_map<std::string, MDB_dbi> dbis;
+    // writes committed to the store and not applied to the copy yet, guarded by mutex
+    std::mutex mutex;
+    std::vector<KvWriteSet::Op> log;
+    // set if a write was committed that cannot be applied to the copy
+    std::string error;
+
+    ~Compaction() {
+        if (env) mdb_env_close(env);
+        RemoveDir(dir);
+    }
+};
+
+static void OpenEnv(MDB_env** env, const std::string& path, size_t db_size) {
+    THROW_ON_ERR(mdb_env_create(env));
+    THROW_ON_ERR(mdb_env_set_mapsize(*env, db_size));
+    THROW_ON_ERR(mdb_env_set_maxdbs(*env, 10000));  // HENG: former value is 255
+    THROW_ON_ERR(mdb_env_set_maxreaders(*env, 1200));
+#if LGRAPH_SHARE_DIR
+    unsigned int flags = MDB_NOMEMINIT | MDB_NORDAHEAD | MDB_NOTLS | MDB_NOSYNC;
+#else
+    unsigned int flags = MDB_NOMEMINIT | MDB_NORDAHEAD | MDB_NOSYNC;
+#endif
+    THROW_ON_ERR(mdb_env_open(*env, path.c_str(), flags, 0664));
+}
 
 void LMDBKvStore::Open(bool create_if_not_exist) {
     if (create_if_not_exist) {
@@ -53,16 +129,7 @@ void LMDBKvStore::Open(bool create_if_not_exist) {
             THROW_CODE(KvException, "Data directory " + path_ + " does not contain valid data.");
         }
     }
-    THROW_ON_ERR(mdb_env_create(&env_));
-    THROW_ON_ERR(mdb_env_set_mapsize(env_, db_size_));
-    THROW_ON_ERR(mdb_env_set_maxdbs(env_, 10000));  // HENG: former value is 255
-    THROW_ON_ERR(mdb_env_set_maxreaders(env_, 1200));
-#if LGRAPH_SHARE_DIR
-    unsigned int flags = MDB_NOMEMINIT | MDB_NORDAHEAD | MDB_NOTLS | MDB_NOSYNC;
-#else
-    unsigned int flags = MDB_NOMEMINIT | MDB_NORDAHEAD | MDB_NOSYNC;
-#endif
-    THROW_ON_ERR(mdb_env_open(env_, path_.c_str(), flags, 0664));
+    OpenEnv(&env_, path_, db_size_);
     // update last op id of all stores with the value stored in this one
     MDB_txn* txn;
     THROW_ON_ERR(mdb_txn_begin(env_, nullptr, MDB_RDONLY, &txn));
@@ -106,6 +173,7 @@ LMDBKvStore::LMDBKvStore(const std::string& path, size_t db_size, bool durable,
 }
 
 LMDBKvStore::~LMDBKvStore() {
+    if (compaction_) AbortCompaction();
     if (env_) {
         wal_.reset();
         mdb_env_close(env_);
@@ -127,7 +195,17 @@ std::unique_ptr<KvTable> LMDBKvStore::OpenTable(KvTransaction& txn, const std::s
                            bool create_if_not_exist, const ComparatorDesc& desc) {
     std::lock_guard<std::mutex> l(mutex_);
     auto& lmdb_txn = static_cast<LMDBKvTransaction&>(txn);
-    return std::make_unique<LMDBKvTable>(lmdb_txn, table_name, create_if_not_exist, desc);
+    auto t = std::make_unique<LMDBKvTable>(lmdb_txn, table_name, create_if_not_exist, desc);
+    // reopening a table with the default descriptor, as a follower applying a kv delta does,
+    // keeps its comparator in the env, so it is kept here for compaction as well
+    auto comp = GetKeyComparator(desc);
+    auto it = comparators_.find(table_name);
+    if (it == comparators_.end()) {
+        comparators_.emplace(table_name, comp);
+    } else if (comp) {
+        it->second = comp;
+    }
+    return t;
 }
 
 std::unique_ptr<KvTable> LMDBKvStore::_OpenTable_(KvTransaction& txn, const std::string& table_name,
@@ -137,6 +215,7 @@ std::unique_ptr<KvTable> LMDBKvStore::_OpenTable_(KvTransaction& txn, const std:
     auto t = std::make_unique<LMDBKvTable>(lmdb_txn, table_name, create_if_not_exist,
         ComparatorDesc::DefaultComparator());
     if (func) mdb_set_compare(lmdb_txn.GetTxn(), t->dbi_, func);
+    comparators_[table_name] = func;
     return t;
 }
 
@@ -145,6 +224,7 @@ bool LMDBKvStore::DeleteTable(KvTransaction& txn, const std::string& table_name)
     auto& lmdb_txn = static_cast<LMDBKvTransaction&>(txn);
     auto tbl = LMDBKvTable(lmdb_txn, table_name, true, ComparatorDesc::DefaultComparator());
     tbl.Delete(lmdb_txn);
+    comparators_.erase(table_name);
     return true;
 }
 
@@ -194,6 +274,59 @@ void LMDBKvStore::DumpStat(KvTransaction& txn, size_t& memory_size, size_t& heig
     memory_size *= stat.ms_psize;
 }
 
+void LMDBKvStore::DumpStat(KvTransaction& txn, KvSpaceStat& stat) {
+    auto& lmdb_txn = static_cast<LMDBKvTransaction&>(txn);
+    // the free list can only be read in a read txn
+    if (!lmdb_txn.IsReadOnly()) THROW_CODE(KvException, "DumpStat needs a read transaction.");
+    stat = KvSpaceStat();
+    DumpStat(txn, stat.used_size, stat.height);
+    MDB_txn* mdb_txn = lmdb_txn.GetTxn();
+    // dbi 0 is the free list and dbi 1 the table of tables, their pages are in use too
+    MDB_stat s;
+    for (MDB_dbi dbi : {0, 1}) {
+        THROW_ON_ERR(mdb_stat(mdb_txn, dbi, &s));
+        stat.used_size += (s.ms_branch_pages + s.ms_leaf_pages + s.ms_overflow_pages) * s.ms_psize;
+    }
+    // each entry of the free list is the list of pages freed by a txn, led by its length
+    MDB_cursor* cursor;
+    THROW_ON_ERR(mdb_cursor_open(mdb_txn, 0, &cursor));
+    std::unique_ptr<MDB_cursor, decltype(&mdb_cursor_close)> cursor_guard(cursor,
+                                                                         mdb_cursor_close);
+    MDB_val key, value;
+    size_t n_free = 0;
+    int ec = mdb_cursor_get(cursor, &key, &value, MDB_FIRST);
+    while (ec == MDB_SUCCESS) {
+        n_free += *(const mdb_size_t*)value.mv_data;
+        ec = mdb_cursor_get(cursor, &key, &value, MDB_NEXT);
+    }
+    if (ec != MDB_NOTFOUND) THROW_ON_ERR(ec);
+    stat.free_size = n_free * s.ms_psize;
+    int fd;
+    THROW_ON_ERR(mdb_env_get_fd(env_, &fd));
+    struct stat st;
+    if (fstat(fd, &st) == 0) stat.file_size = st.st_size;
+    // txn itself is left out
+    std::lock_guard<std::mutex> l(readers_mutex_);
+    auto it = readers_.begin();
+    if (lmdb_txn.is_reader_ && it != readers_.end() && *it == lmdb_txn.start_) it++;
+    stat.readers = readers_.size() - (lmdb_txn.is_reader_ ? 1 : 0);
+    if (it != readers_.end()) {
+        stat.oldest_reader_age =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - *it).count();
+    }
+}
+
+void LMDBKvStore::AddReader(std::chrono::steady_clock::time_point start) {
+    std::lock_guard<std::mutex> l(readers_mutex_);
+    readers_.insert(start);
+}
+
+void LMDBKvStore::RemoveReader(std::chrono::steady_clock::time_point start) {
+    std::lock_guard<std::mutex> l(readers_mutex_);
+    auto it = readers_.find(start);
+    if (it != readers_.end()) readers_.erase(it);
+}
+
 size_t LMDBKvStore::Backup(const std::string& path, bool compact) {
     size_t last_txn_id = 0;
     THROW_ON_ERR(mdb_env_copy2(env_, path.c_str(), compact ? MDB_CP_COMPACT : 0, &last_txn_id));
@@ -211,21 +344,296 @@ void LMDBKvStore::LoadSnapshot(const std::string& snapshot_path) {
     ReopenFromSnapshot(snapshot_path);
 }
 
-void LMDBKvStore::WarmUp(size_t* size) {
+void LMDBKvStore::Clone(const std::string& path) {
+    if (!IsDir(path) && !MkDir(path)) THROW_CODE(KvException, "Failed to create dir " + path);
+    {
+        // the write lock keeps commits out, so the file holds the state of the last one
+        auto txn = CreateWriteTxn();
+        if (CloneFile(path_ + "/" + DATA_FILE_NAME, path + "/" + DATA_FILE_NAME)) return;
+    }
     auto txn = CreateReadTxn();
-    auto tables = ListAllTables(*txn);
-    size_t s = 0;
-    auto& lmdb_txn = static_cast<LMDBKvTransaction&>(*txn);
-    for (const auto& tbl : tables) {
-        auto t = std::make_unique<LMDBKvTable>(
-            lmdb_txn, tbl, false, ComparatorDesc::DefaultComparator());
-        auto it = t->GetIterator(lmdb_txn);
-        for (it->GotoFirstKey(); it->IsValid(); it->Next()) {
-            s += it->GetKey().Size();
-            s += it->GetValue().Size();
+    Snapshot(*txn, path);
+}
+
+bool LMDBKvStore::CaptureWrites(const KvWriteSet& write_set) {
+    if (!capturing_) return false;
+    std::lock_guard<std::mutex> l(compaction_->mutex);
+    if (!compaction_->error.empty()) return false;
+    if (!write_set.IsReplicable()) {
+        compaction_->error = write_set.UnreplicableReason();
+        compaction_->log.clear();
+        return false;
+    }
+    const auto& ops = write_set.GetOps();
+    compaction_->log.insert(compaction_->log.end(), ops.begin(), ops.end());
+    return true;
+}
+
+void LMDBKvStore::FailCompaction(const std::string& reason) {
+    if (!capturing_) return;
+    std::lock_guard<std::mutex> l(compaction_->mutex);
+    if (compaction_->error.empty()) compaction_->error = reason;
+    compaction_->log.clear();
+}
+
+size_t LMDBKvStore::CatchUp() {
+    Compaction& c = *compaction_;
+    std::vector<KvWriteSet::Op> ops;
+    {
+        std::lock_guard<std::mutex> l(c.mutex);
+        if (!c.error.empty())
+            THROW_CODE(KvException, "Failed to compact " + path_ + ": " + c.error);
+        ops.swap(c.log);
+    }
+    if (ops.empty()) return 0;
+    MDB_txn* txn;
+    THROW_ON_ERR(mdb_txn_begin(c.env, nullptr, 0, &txn));
+    std::unique_ptr<MDB_txn, decltype(&mdb_txn_abort)> txn_guard(txn, mdb_txn_abort);
+    size_t version = mdb_txn_id(txn);
+    std::string value;
+    for (auto& op : ops) {
+        auto it = c.dbis.find(op.table);
+        if (it == c.dbis.end()) {
+            MDB_dbi dbi;
+            THROW_ON_ERR(mdb_dbi_open(txn, op.table.empty() ? nullptr : op.table.c_str(), 0,
+                                      &dbi));
+            KeySortFunc comp = nullptr;
+            {
+                std::lock_guard<std::mutex> l(mutex_);
+                auto cit = comparators_.find(op.table);
+                if (cit != comparators_.end()) comp = cit->second;
+            }
+            if (comp) THROW_ON_ERR(mdb_set_compare(txn, dbi, comp));
+            it = c.dbis.emplace(op.table, dbi).first;
+        }
+        MDB_val key = {op.key.size(), (void*)op.key.data()};
+        if (op.is_delete) {
+            // a key deleted before the copy was made is not in it
+            int ec = mdb_del(txn, it->second, &key, nullptr);
+            if (ec != MDB_NOTFOUND) THROW_ON_ERR(ec);
+        } else {
+            // same layout as LMDBKvTable::SetValue, the value is led by its version
+            value.resize(sizeof(size_t) + op.value.size());
+            memcpy(&value[0], &version, sizeof(size_t));
+            memcpy(&value[sizeof(size_t)], op.value.data(), op.value.size());
+            MDB_val val = {value.size(), &value[0]};
+            THROW_ON_ERR(mdb_put(txn, it->second, &key, &val, 0));
+        }
+    }
+    mdb_txn_set_last_op_id(txn, GetLastOpIdOfAllStores());
+    txn_guard.release();
+    THROW_ON_ERR(mdb_txn_commit(txn));
+    return ops.size();
+}
+
+void LMDBKvStore::StopCapturing() {
+    capturing_ = false;
+    // a write txn captures its writes while holding the write lock, so once we have the lock
+    // no txn is capturing any more
+    MDB_txn* txn;
+    THROW_ON_ERR(mdb_txn_begin(env_, nullptr, 0, &txn));
+    mdb_txn_abort(txn);
+}
+
+void LMDBKvStore::StartCompaction() {
+    if (compaction_) THROW_CODE(KvException, "A compaction of " + path_ + " is running.");
+    compaction_ = std::make_unique<Compaction>();
+    compaction_->dir = path_ + "/" + COMPACTION_DIR_NAME;
+    try {
+        RemoveDir(compaction_->dir);
+        if (!MkDir(compaction_->dir))
+            THROW_CODE(KvException, "Failed to create directory " + compaction_->dir);
+        capturing_ = true;
+        // write txns that began before capturing_ was set are not captured, waiting for the
+        // write lock makes sure they committed before the copy is made
+        MDB_txn* txn;
+        THROW_ON_ERR(mdb_txn_begin(env_, nullptr, 0, &txn));
+        mdb_txn_abort(txn);
+        double t1 = fma_common::GetTime();
+        THROW_ON_ERR(mdb_env_copy2(env_, compaction_->dir.c_str(), MDB_CP_COMPACT, nullptr));
+        double t2 = fma_common::GetTime();
+        LOG_INFO() << "Copied " << path_ << " for compaction in " << t2 - t1 << " seconds";
+        OpenEnv(&compaction_->env, compaction_->dir, db_size_);
+        // the writes made while copying are applied in rounds, each round is shorter than the
+        // one before as long as writes are applied faster than they are made
+        for (size_t i = 0; i < COMPACTION_MAX_ROUNDS; i++) {
+            size_t n = CatchUp();
+            LOG_DEBUG() << "Applied " << n << " writes to the compacted copy of " << path_;
+            if (n <= COMPACTION_CATCH_UP_OPS) break;
+        }
+    } catch (...) {
+        AbortCompaction();
+        throw;
+    }
+}
+
+void LMDBKvStore::FinishCompaction() {
+    if (!compaction_) THROW_CODE(KvException, "No compaction of " + path_ + " is running.");
+    try {
+        StopCapturing();
+        CatchUp();
+        // the copy is opened with MDB_NOSYNC, it must be on disk before it replaces the old file
+        THROW_ON_ERR(mdb_env_sync(compaction_->env, 1));
+    } catch (...) {
+        AbortCompaction();
+        throw;
+    }
+    std::string src = compaction_->dir + "/" + DATA_FILE_NAME;
+    std::string dst = path_ + "/" + DATA_FILE_NAME;
+    mdb_env_close(compaction_->env);
+    compaction_->env = nullptr;
+    // the wal is of the old file, closing it syncs the old file and removes its logs
+    wal_.reset();
+    mdb_env_close(env_);
+    env_ = nullptr;
+    // rename is atomic, a crash leaves either the old file or the compacted one
+    std::error_code ec;
+    std::filesystem::rename(src, dst, ec);
+    if (!ec && !SyncDir(path_)) LOG_WARN() << "Failed to sync directory " << path_;
+    compaction_.reset();
+    if (ec) LOG_ERROR() << "Failed to replace " << dst << " with " << src << ": " << ec.message();
+    Open(false);
+    if (ec) THROW_CODE(KvException, "Failed to replace " + dst + ": " + ec.message());
+}
+
+void LMDBKvStore::AbortCompaction() {
+    if (!compaction_) return;
+    if (capturing_) {
+        try {
+            StopCapturing();
+        } catch (std::exception& e) {
+            LOG_WARN() << "Failed to wait for writers of " << path_ << ": " << e.what();
+        }
+    }
+    compaction_.reset();
+}
+
+void LMDBKvStore::WarmUp(size_t* size, const std::vector<std::string>& tables,
+                         size_t n_threads) {
+    if (n_threads == 0) n_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    if (tables.empty()) {
+        int fd;
+        THROW_ON_ERR(mdb_env_get_fd(env_, &fd));
+        MDB_envinfo info;
+        MDB_stat stat;
+        THROW_ON_ERR(mdb_env_info(env_, &info));
+        THROW_ON_ERR(mdb_env_stat(env_, &stat));
+        size_t file_size = (info.me_last_pgno + 1) * stat.ms_psize;
+        static const size_t block_size = 4 << 20;
+        size_t n_blocks = (file_size + block_size - 1) / block_size;
+        // a range per thread keeps the reads of each thread sequential
+        size_t range_size = (n_blocks + n_threads - 1) / n_threads * block_size;
+        ParallelFor(n_threads, n_threads, [&](size_t i) {
+            size_t begin = i * range_size;
+            size_t end = std::min(file_size, begin + range_size);
+            if (begin >= end) return;
+            posix_fadvise(fd, begin, end - begin, POSIX_FADV_WILLNEED);
+            std::vector<char> buf(block_size);
+            for (size_t off = begin; off < end; off += block_size) {
+                if (pread(fd, buf.data(), std::min(block_size, end - off), off) < 0) {
+                    THROW_CODE(KvException, "Failed to read " + path_ + ": " + strerror(errno));
+                }
+            }
+        });
+        if (!size) return;
+    }
+    std::vector<std::string> names = tables;
+    std::vector<MDB_dbi> dbis;
+    {
+        auto txn = CreateReadTxn();
+        if (names.empty()) names = ListAllTables(*txn);
+        auto& lmdb_txn = static_cast<LMDBKvTransaction&>(*txn);
+        std::lock_guard<std::mutex> l(mutex_);
+        for (const auto& tbl : names) {
+            LMDBKvTable t(lmdb_txn, tbl, false, ComparatorDesc::DefaultComparator());
+            dbis.push_back(t.GetDbi());
+        }
+        // keeps the handles opened here valid for the other threads
+        txn->Commit();
+    }
+    std::vector<size_t> sizes(dbis.size(), 0);
+    ParallelFor(dbis.size(), n_threads, [&](size_t i) {
+        // each thread needs its own read txn
+        MDB_txn* txn;
+        THROW_ON_ERR(mdb_txn_begin(env_, nullptr, MDB_RDONLY, &txn));
+        std::unique_ptr<MDB_txn, decltype(&mdb_txn_abort)> txn_guard(txn, mdb_txn_abort);
+        MDB_cursor* cursor;
+        THROW_ON_ERR(mdb_cursor_open(txn, dbis[i], &cursor));
+        std::unique_ptr<MDB_cursor, decltype(&mdb_cursor_close)> cursor_guard(cursor,
+                                                                             mdb_cursor_close);
+        MDB_val key, value;
+        size_t s = 0;
+        volatile char touched = 0;
+        int ec = mdb_cursor_get(cursor, &key, &value, MDB_FIRST);
+        while (ec == MDB_SUCCESS) {
+            // the value starts with its version, which is not part of the value
+            s += key.mv_size + value.mv_size - sizeof(size_t);
+            // large values are stored in overflow pages, touch each of them
+            for (size_t off = 0; off < value.mv_size; off += 4096) {
+                touched = touched + ((const char*)value.mv_data)[off];
+            }
+            ec = mdb_cursor_get(cursor, &key, &value, MDB_NEXT);
         }
+        if (ec != MDB_NOTFOUND) THROW_ON_ERR(ec);
+        sizes[i] = s;
+    });
+    if (size) {
+        *size = 0;
+        for (auto s : sizes) *size += s;
+    }
+}
+
+void LMDBKvStore::SaveHotPages(const std::string& path) {
+    int fd;
+    THROW_ON_ERR(mdb_env_get_fd(env_, &fd));
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) return;
+    size_t file_size = st.st_size;
+    // a mapping of our own, mincore tells whether its pages are in the page cache
+    void* addr = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        LOG_WARN() << "Failed to map " << path_ << " to find hot pages: " << strerror(errno);
+        return;
+    }
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    std::vector<unsigned char> resident((file_size + page_size - 1) / page_size);
+    int r = mincore(addr, file_size, resident.data());
+    munmap(addr, file_size);
+    if (r != 0) {
+        LOG_WARN() << "Failed to find hot pages of " << path_ << ": " << strerror(errno);
+        return;
+    }
+    // consecutive resident pages are saved as one (offset, length) range
+    std::vector<std::pair<uint64_t, uint64_t>> ranges;
+    for (size_t i = 0; i < resident.size(); i++) {
+        if (!(resident[i] & 1)) continue;
+        if (!ranges.empty() && ranges.back().first + ranges.back().second == i * page_size) {
+            ranges.back().second += page_size;
+        } else {
+            ranges.emplace_back(i * page_size, page_size);
+        }
+    }
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write((const char*)ranges.data(), ranges.size() * sizeof(ranges[0]));
+    if (!out.good()) {
+        LOG_WARN() << "Failed to write hot pages to " << path;
+        return;
+    }
+    LOG_DEBUG() << "Saved " << ranges.size() << " hot page ranges of " << path_;
+}
+
+void LMDBKvStore::PrefetchHotPages(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.good()) return;
+    int fd;
+    THROW_ON_ERR(mdb_env_get_fd(env_, &fd));
+    std::pair<uint64_t, uint64_t> range;
+    size_t n = 0;
+    while (in.read((char*)&range, sizeof(range))) {
+        posix_fadvise(fd, range.first, range.second, POSIX_FADV_WILLNEED);
+        n++;
     }
-    if (size) *size = s;
+    LOG_DEBUG() << "Prefetching " << n << " hot page ranges of " << path_;
 }
 
 void LMDBKvStore::ServeValidation() {
@@ -347,6 +755,8 @@ void LMDBKvStore::ServeValidation() {
                 results.emplace_back(ec);
             }
         }
+        // the writes of optimistic txns are not captured
+        FailCompaction("optimistic txns committed");
         // set last op id
         mdb_txn_set_last_op_id(root_txn, GetLastOpIdOfAllStores());
         std::future<void> future;
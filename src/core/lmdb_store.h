@@ -16,9 +16,12 @@
 
 #include <condition_variable>
 #include <atomic>
+#include <chrono>
 #include <mutex>
 #include <queue>
+#include <set>
 #include <thread>
+#include <unordered_map>
 
 #include "fma-common/file_system.h"
 #include "lmdb/lmdb.h"
@@ -57,12 +60,43 @@ class LMDBKvStore final : public KvStore {
     size_t wal_batch_commit_interval_ms_;
     std::unique_ptr<Wal> wal_;
 
+    // key comparators of the tables opened, guarded by mutex_, so that the tables of a
+    // compacted copy can be opened with the same comparators
+    std::unordered_map<std::string, KeySortFunc> comparators_;
+
+    // state of the running online compaction, see StartCompaction
+    struct Compaction;
+    std::unique_ptr<Compaction> compaction_;
+    // set while the writes of write txns are captured for the compaction
+    std::atomic<bool> capturing_{false};
+
+    // start times of the txns that read a snapshot, see KvSpaceStat::readers
+    std::multiset<std::chrono::steady_clock::time_point> readers_;
+    std::mutex readers_mutex_;
+
+    void AddReader(std::chrono::steady_clock::time_point start);
+
+    void RemoveReader(std::chrono::steady_clock::time_point start);
+
     void Open(bool create_if_not_exist);
 
     void ReopenFromSnapshot(const std::string& snapshot_path);
 
     void ServeValidation();
 
+    // Called by a write txn right before it commits, while it still holds the write lock, so
+    // that writes are captured in commit order. Returns true if the writes were captured.
+    bool CaptureWrites(const KvWriteSet& write_set);
+
+    // Makes the running compaction fail, since writes were made that cannot be replayed.
+    void FailCompaction(const std::string& reason);
+
+    // Applies the writes captured so far to the compacted copy, returns the number applied.
+    size_t CatchUp();
+
+    // Stops capturing writes and waits for the write txn committing, if any.
+    void StopCapturing();
+
     // last op id of all stores, monotonically increasing id so we don't repeatedly apply the same
     // request During initialization, this is updated when any store is opened. Larger id wins. This
     // value is written in HandleRequest with the op id, and When any transaction commits, this is
@@ -170,13 +204,79 @@ class LMDBKvStore final : public KvStore {
 
     void DumpStat(KvTransaction& txn, size_t& memory_size, size_t& height) override;
 
+    /**
+     * Gets the space used by the store. Pages freed by a write txn are not returned to the OS,
+     * they are recorded in the free list of the store and reused by later writes, so the
+     * free_size of a store that had a lot of data deleted can be a large part of its file.
+     *
+     * \param [in,out]  txn     A read transaction, the free list is read with it.
+     * \param [out]     stat    The space used.
+     */
+    void DumpStat(KvTransaction& txn, KvSpaceStat& stat) override;
+
     size_t Backup(const std::string& path, bool compact = false) override;
 
     void Snapshot(KvTransaction& txn, const std::string& path, bool compaction = false) override;
 
     void LoadSnapshot(const std::string& snapshot_path) override;
 
-    void WarmUp(size_t* size) override;
+    /**
+     * Copies the data file to path. The file is cloned while a write txn is held, so no commit
+     * is halfway written, which takes no time and no space on file systems that support
+     * reflinks, such as xfs and btrfs. Elsewhere, the store is copied in a read txn.
+     */
+    void Clone(const std::string& path) override;
+
+    /**
+     * Loads data into memory. If no table is given, the data file is first read into the page
+     * cache, with each thread reading a contiguous range of it, so that the reads are
+     * sequential. This is what makes warm-up fast, since the store is opened with
+     * MDB_NORDAHEAD and walking the b-trees would read one page at a time. The tables are then
+     * walked in parallel, one table per thread, touching every key and value. The walk is
+     * skipped if the whole store was read and size is not wanted.
+     *
+     * \param [out] size        (Optional) Set to the total size of the keys and values walked.
+     * \param       tables      (Optional) Tables to warm up, all tables if empty.
+     * \param       n_threads   (Optional) Number of threads, 0 to use one per core.
+     */
+    void WarmUp(size_t* size, const std::vector<std::string>& tables = {},
+                size_t n_threads = 0) override;
+
+    /**
+     * Records the ranges of the data file that are in the page cache to path. Called when a
+     * store is closed, the ranges approximate the pages that were hot.
+     */
+    void SaveHotPages(const std::string& path) override;
+
+    /**
+     * Asks the OS to read the ranges saved by SaveHotPages into the page cache. The reads are
+     * done in the background, so this returns right away. Ranges beyond the end of the file
+     * are ignored.
+     */
+    void PrefetchHotPages(const std::string& path) override;
+
+    /**
+     * Starts an online compaction. The data file is copied with its pages packed into a new
+     * file next to it, while other transactions go on. The writes committed after the copy
+     * starts are captured and applied to the copy, until few are left. This returns when the
+     * copy has caught up, FinishCompaction or AbortCompaction must be called next.
+     *
+     * A write txn that cannot be replayed from its writes, such as one that creates or drops a
+     * table, or an optimistic txn, makes the compaction fail: FinishCompaction then throws and
+     * the store is left as it was.
+     */
+    void StartCompaction() override;
+
+    bool CompactsInPlace() const override { return false; }
+
+    /**
+     * Applies the remaining writes to the compacted copy and switches the store to it. No
+     * transaction of the store may be open, the caller must keep them out.
+     */
+    void FinishCompaction() override;
+
+    /** Drops the compacted copy, if any, and stops capturing writes. */
+    void AbortCompaction() override;
 
     static int64_t GetLastOpIdOfAllStores() { return last_op_id_.load(std::memory_order_acquire); }
 
@@ -48,9 +48,15 @@ LMDBKvTable::LMDBKvTable(LMDBKvTransaction& txn,
     bool create_if_not_exist,
     const ComparatorDesc& desc) {
     name_ = name;
-    int flags = 0;
-    if (create_if_not_exist) flags |= MDB_CREATE;
-    THROW_ON_ERR(mdb_dbi_open(txn.GetTxn(), name.empty() ? nullptr : name.c_str(), flags, &dbi_));
+    const char* dbi_name = name.empty() ? nullptr : name.c_str();
+    int ec = mdb_dbi_open(txn.GetTxn(), dbi_name, 0, &dbi_);
+    bool created = false;
+    if (ec == MDB_NOTFOUND && create_if_not_exist) {
+        THROW_ON_ERR(mdb_dbi_open(txn.GetTxn(), dbi_name, MDB_CREATE, &dbi_));
+        created = true;
+    } else {
+        THROW_ON_ERR(ec);
+    }
     // may need to set customized comparator
     auto comp = GetKeyComparator(desc);
     if (comp) {
@@ -63,6 +69,9 @@ LMDBKvTable::LMDBKvTable(LMDBKvTransaction& txn,
     if (!txn.IsReadOnly() && txn.GetWal()) {
         txn.GetWal()->WriteTableOpen(dbi_, name, desc);
     }
+    // an existing table is opened by name on a replica or a compacted copy as well, only a new
+    // one changes the schema of the store
+    if (txn.write_set_ && created) txn.write_set_->MarkUnreplicable("table " + name + " created");
 }
 
 bool LMDBKvTable::HasKey(KvTransaction& txn, const Value& key) {
@@ -170,6 +179,7 @@ bool LMDBKvTable::SetValue(KvTransaction& txn, const Value& key, const Value& va
         // write wal
         if (lmdb_txn.GetWal())
             lmdb_txn.GetWal()->WriteKvPut(dbi_, key, tmp);
+        if (lmdb_txn.write_set_) lmdb_txn.write_set_->Put(name_, key, value);
         return true;
     } else if (ec == MDB_KEYEXIST) {
         return false;
@@ -198,6 +208,7 @@ void LMDBKvTable::AppendKv(KvTransaction& txn, const Value& key, const Value& va
     // write wal
     if (lmdb_txn.GetWal())
         lmdb_txn.GetWal()->WriteKvPut(dbi_, key, tmp);
+    if (lmdb_txn.write_set_) lmdb_txn.write_set_->Put(name_, key, value);
 }
 
 bool LMDBKvTable::DeleteKey(KvTransaction& txn, const Value& key) {
@@ -225,6 +236,7 @@ bool LMDBKvTable::DeleteKey(KvTransaction& txn, const Value& key) {
         // write wal
         if (lmdb_txn.GetWal())
             lmdb_txn.GetWal()->WriteKvDel(dbi_, key);
+        if (lmdb_txn.write_set_) lmdb_txn.write_set_->Delete(name_, key);
         return true;
     }
     if (ec == MDB_NOTFOUND) return false;
@@ -260,6 +272,7 @@ void LMDBKvTable::Delete(KvTransaction& txn) {
     // write wal
     if (lmdb_txn.GetWal())
         lmdb_txn.GetWal()->WriteTableDrop(dbi_);
+    if (lmdb_txn.write_set_) lmdb_txn.write_set_->MarkUnreplicable("table " + name_ + " dropped");
 }
 
 void LMDBKvTable::Drop(KvTransaction& txn) {
@@ -268,6 +281,7 @@ void LMDBKvTable::Drop(KvTransaction& txn) {
     // write wal
     if (lmdb_txn.GetWal())
         lmdb_txn.GetWal()->WriteTableDrop(dbi_);
+    if (lmdb_txn.write_set_) lmdb_txn.write_set_->MarkUnreplicable("table " + name_ + " dropped");
 }
 
 }  // namespace lgraph
@@ -99,6 +99,11 @@ LMDBKvTransaction::LMDBKvTransaction(LMDBKvStore& store, bool read_only, bool op
     if (read_only_ || optimistic_) flags |= MDB_RDONLY;
     THROW_ON_ERR(MdbTxnBegin(store.env_, nullptr, flags, &txn_));
     version_ = mdb_txn_id(txn_);
+    if (read_only_ || optimistic_) {
+        start_ = std::chrono::steady_clock::now();
+        store.AddReader(start_);
+        is_reader_ = true;
+    }
     // write wal if this is a write txn and not optimisitc
     // Optimistic txns are actually read-only txns that read from lmdb and write to
     // DeltaStore. The changes are written to lmdb in KvStore::ServerValidation, so
@@ -106,6 +111,13 @@ LMDBKvTransaction::LMDBKvTransaction(LMDBKvStore& store, bool read_only, bool op
     if (!read_only && !optimistic && wal_) {
         wal_->WriteTxnBegin(version_);
     }
+    recorder_ = read_only ? nullptr : KvWriteSetRecorder::Current();
+    // the writes are also captured while the store is being compacted
+    if (recorder_ || (!read_only && store.capturing_)) {
+        write_set_ = std::make_unique<KvWriteSet>(store_);
+        // the writes of optimistic txns are only known to succeed after validation
+        if (optimistic) write_set_->MarkUnreplicable("optimistic transaction");
+    }
 }
 
 LMDBKvTransaction::LMDBKvTransaction(LMDBKvTransaction&& rhs) noexcept {
@@ -116,7 +128,12 @@ LMDBKvTransaction::LMDBKvTransaction(LMDBKvTransaction&& rhs) noexcept {
     if (!read_only_ && optimistic_) deltas_ = std::move(rhs.deltas_);
     store_ = rhs.store_;
     wal_ = rhs.wal_;
+    recorder_ = rhs.recorder_;
+    write_set_ = std::move(rhs.write_set_);
+    is_reader_ = rhs.is_reader_;
+    start_ = rhs.start_;
     rhs.txn_ = nullptr;
+    rhs.is_reader_ = false;
 }
 
 LMDBKvTransaction& LMDBKvTransaction::operator=(LMDBKvTransaction&& rhs) noexcept {
@@ -125,13 +142,24 @@ LMDBKvTransaction& LMDBKvTransaction::operator=(LMDBKvTransaction&& rhs) noexcep
     txn_ = rhs.txn_;
     store_ = rhs.store_;
     wal_ = rhs.wal_;
+    recorder_ = rhs.recorder_;
+    write_set_ = std::move(rhs.write_set_);
     read_only_ = rhs.read_only_;
     optimistic_ = rhs.optimistic_;
     version_ = rhs.version_;
+    is_reader_ = rhs.is_reader_;
+    start_ = rhs.start_;
     rhs.txn_ = nullptr;
+    rhs.is_reader_ = false;
     return *this;
 }
 
+void LMDBKvTransaction::RemoveReader() {
+    if (!is_reader_) return;
+    store_->RemoveReader(start_);
+    is_reader_ = false;
+}
+
 LMDBKvTransaction::~LMDBKvTransaction() { LMDBKvTransaction::Abort(); }
 
 std::unique_ptr<KvTransaction> LMDBKvTransaction::Fork() {
@@ -142,57 +170,73 @@ std::unique_ptr<KvTransaction> LMDBKvTransaction::Fork() {
     txn->read_only_ = true;
     txn->optimistic_ = false;
     THROW_ON_ERR(MdbTxnFork(txn_, &txn->txn_));
+    // the fork reads the same snapshot, so it is as old
+    txn->start_ = start_;
+    store_->AddReader(start_);
+    txn->is_reader_ = true;
     return txn;
 }
 
 void LMDBKvTransaction::Commit() {
     if (txn_) {
-        if (read_only_ || !optimistic_) {
-            if (!read_only_) {
-                mdb_txn_set_last_op_id(txn_, LMDBKvStore::GetLastOpIdOfAllStores());
-                if (wal_) {
+        // may throw, leaving the txn to be aborted
+        if (recorder_) recorder_->OnCommit(*write_set_);
+        try {
+            if (read_only_ || !optimistic_) {
+                if (!read_only_) {
+                    mdb_txn_set_last_op_id(txn_, LMDBKvStore::GetLastOpIdOfAllStores());
+                    // captured while this txn holds the write lock, so in commit order
+                    bool captured = write_set_ && store_->CaptureWrites(*write_set_);
                     std::future<void> future;
                     if (wal_) future = wal_->WriteTxnCommit(version_, false);
                     int r = MdbTxnCommit(txn_);
                     if (wal_) wal_->WaitForWalFlush(future);
-                    if (r != MDB_SUCCESS)
+                    if (r != MDB_SUCCESS) {
+                        if (captured) store_->FailCompaction("a captured txn failed to commit");
                         THROW_ERR(r);
+                    }
                 } else {
-                    THROW_ON_ERR(MdbTxnCommit(txn_));
+                    mdb_txn_abort(txn_);
                 }
+                txn_ = nullptr;
+                RemoveReader();
             } else {
-                mdb_txn_abort(txn_);
-            }
-            txn_ = nullptr;
-        } else {
-            commit_status_ = 0;
-            commit_ec_ = 0;
-            std::unique_lock<std::mutex> queue_lock(store_->queue_mutex_);
-            store_->queue_.push(this);
-            store_->queue_cv_.notify_one();
-            queue_lock.unlock();
-            std::unique_lock<std::mutex> my_lock(mutex_);
-            while (!cv_.wait_for(my_lock, 100ms, [&]() { return commit_status_ != 0; })) {
-            }
-            if (commit_status_ != 1) {
-                if (commit_ec_ == MDB_CONFLICTS)
-                    THROW_CODE(TxnConflict);
-                else
-                    THROW_ERR(commit_ec_);
+                commit_status_ = 0;
+                commit_ec_ = 0;
+                std::unique_lock<std::mutex> queue_lock(store_->queue_mutex_);
+                store_->queue_.push(this);
+                store_->queue_cv_.notify_one();
+                queue_lock.unlock();
+                std::unique_lock<std::mutex> my_lock(mutex_);
+                while (!cv_.wait_for(my_lock, 100ms, [&]() { return commit_status_ != 0; })) {
+                }
+                if (commit_status_ != 1) {
+                    if (commit_ec_ == MDB_CONFLICTS)
+                        THROW_CODE(TxnConflict);
+                    else
+                        THROW_ERR(commit_ec_);
+                }
+                MdbTxnAbort(txn_);
+                txn_ = nullptr;
+                RemoveReader();
             }
-            MdbTxnAbort(txn_);
-            txn_ = nullptr;
+        } catch (...) {
+            if (recorder_) recorder_->OnCommitted(false);
+            throw;
         }
+        if (recorder_) recorder_->OnCommitted(true);
     }
 }
 
 void LMDBKvTransaction::Abort() {
     deltas_.clear();
+    write_set_.reset();
     if (txn_) {
         if (!read_only_ && !optimistic_ && wal_) wal_->WriteTxnAbort(version_);
         MdbTxnAbort(txn_);
         txn_ = nullptr;
     }
+    RemoveReader();
 }
 }  // namespace lgraph
 #endif
@@ -14,6 +14,7 @@
 
 #pragma once
 #if (!LGRAPH_USE_MOCK_KV)
+#include <chrono>
 #include <vector>
 #include <mutex>
 #include <condition_variable>
@@ -21,6 +22,7 @@
 #include "tools/lgraph_log.h"
 #include "fma-common/type_traits.h"
 #include "core/kv_engine.h"
+#include "core/kv_write_set.h"
 #include "core/lmdb_exception.h"
 #include "core/lmdb_table.h"
 #include "core/lmdb_profiler.h"
@@ -80,9 +82,18 @@ class LMDBKvTransaction final : public KvTransaction {
 
     LMDBKvStore* store_ = nullptr;
     Wal* wal_ = nullptr;
+    // set if a KvWriteSetRecorder was installed when this write txn was created
+    KvWriteSetRecorder* recorder_ = nullptr;
+    std::unique_ptr<KvWriteSet> write_set_;
+    // when the snapshot read by this txn was taken, set if it is registered as a reader of
+    // the store, which read txns and optimistic write txns are
+    bool is_reader_ = false;
+    std::chrono::steady_clock::time_point start_;
 
     DeltaStore& GetDelta(LMDBKvTable& table);
 
+    void RemoveReader();
+
     Wal* GetWal() const { return wal_; }
 
  public:
@@ -125,6 +136,8 @@ class LMDBKvTransaction final : public KvTransaction {
     size_t TxnId() override { return mdb_txn_id(txn_); }
 
     int64_t LastOpId() const override { return mdb_txn_last_op_id(txn_); }
+
+    KvWriteSet* GetWriteSet() override { return write_set_.get(); }
 };
 }  // namespace lgraph
 #endif
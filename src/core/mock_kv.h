@@ -22,6 +22,7 @@
 #include "fma-common/type_traits.h"
 
 #include "core/data_type.h"
+#include "core/kv_space_stat.h"
 #include "core/lmdb_exception.h"
 #include "core/value.h"
 
@@ -438,13 +439,18 @@ class MockKvStore {
         height = 0;
     }
 
+    void DumpStat(MockKvTransaction& txn, KvSpaceStat& stat) { stat = KvSpaceStat(); }
+
     size_t Backup(const std::string& path, bool compact = false) { return 0; }
 
     void Snapshot(MockKvTransaction& txn, const std::string& path) {}
 
     void LoadSnapshot(const std::string& snapshot_path) {}
 
-    void WarmUp(size_t* size) {
+    void Clone(const std::string& path) {}
+
+    void WarmUp(size_t* size, const std::vector<std::string>& tables = {},
+                size_t n_threads = 0) {
         if (size) {
             *size = 0;
             MockKvTransaction txn = CreateReadTxn();
@@ -452,6 +458,18 @@ class MockKvStore {
         }
     }
 
+    void SaveHotPages(const std::string& path) {}
+
+    void PrefetchHotPages(const std::string& path) {}
+
+    bool CompactsInPlace() const { return true; }
+
+    void StartCompaction() {}
+
+    void FinishCompaction() {}
+
+    void AbortCompaction() {}
+
     static int64_t GetLastOpIdOfAllStores() { return 0; }
     static void SetLastOpIdOfAllStores(int64_t) {}
 };
@@ -0,0 +1,54 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lgraph {
+/**
+ * Runs f(i) for each i in [0, n) on n_threads threads, or one per core if n_threads is 0. The
+ * items are handed out one at a time, so uneven items are balanced. After the first error no
+ * more items are started, and it is rethrown once all the threads are done.
+ */
+template <typename F>
+void ParallelFor(size_t n, size_t n_threads, const F& f) {
+    if (n_threads == 0) n_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    n_threads = std::min(n, n_threads);
+    std::atomic<size_t> next(0);
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < n_threads; t++) {
+        threads.emplace_back([&]() {
+            for (size_t i = next++; i < n; i = next++) {
+                try {
+                    f(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> l(error_mutex);
+                    if (!error) error = std::current_exception();
+                    next = n;
+                }
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    if (error) std::rethrow_exception(error);
+}
+}  // namespace lgraph
@@ -0,0 +1,194 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#if (!LGRAPH_USE_MOCK_KV)
+#include "lgraph/lgraph_exceptions.h"
+#include "core/rocksdb_iterator.h"
+#include "core/rocksdb_store.h"
+#include "core/task_tracker.h"
+
+namespace lgraph {
+
+RocksDBKvIterator::RocksDBKvIterator(RocksDBKvTransaction& txn, RocksDBKvTable& table)
+    : txn_(&txn), table_(&table) {
+    ThrowIfTaskKilled();
+    Renew();
+}
+
+RocksDBKvIterator::RocksDBKvIterator(RocksDBKvTransaction& txn, RocksDBKvTable& table,
+                                     const Value& key, bool closest)
+    : RocksDBKvIterator(txn, table) {
+    if (key.Empty()) {
+        RocksDBKvIterator::GotoFirstKey();
+    } else if (closest) {
+        RocksDBKvIterator::GotoClosestKey(key);
+    } else {
+        RocksDBKvIterator::GotoKey(key);
+    }
+}
+
+RocksDBKvIterator::~RocksDBKvIterator() { RocksDBKvIterator::Close(); }
+
+void RocksDBKvIterator::Close() {
+    it_.reset();
+    valid_ = false;
+}
+
+bool RocksDBKvIterator::Renew() {
+    if (it_ && n_writes_ == txn_->n_writes_) return false;
+    if (!txn_->IsValid()) THROW_CODE(KvException, "Transaction is already closed.");
+    it_.reset();
+    rocksdb::ReadOptions options = txn_->GetReadOptions();
+    if (txn_->txn_) {
+        it_.reset(txn_->txn_->GetIterator(options, table_->cf_));
+    } else {
+        it_.reset(table_->store_->db_->NewIterator(options, table_->cf_));
+    }
+    n_writes_ = txn_->n_writes_;
+    return true;
+}
+
+bool RocksDBKvIterator::Restore(bool backward) {
+    std::string key = std::move(key_);
+    if (backward) {
+        it_->SeekForPrev(key);
+    } else {
+        it_->Seek(key);
+    }
+    Load();
+    return valid_ && key_ == key;
+}
+
+void RocksDBKvIterator::Load() {
+    valid_ = it_->Valid();
+    if (valid_) {
+        key_.assign(it_->key().data(), it_->key().size());
+    } else {
+        ThrowOnRocksDBError(it_->status());
+    }
+}
+
+std::unique_ptr<KvIterator> RocksDBKvIterator::Fork() {
+    auto it = std::make_unique<RocksDBKvIterator>(*txn_, *table_);
+    if (valid_) it->GotoKey(Value::ConstRef(key_));
+    return it;
+}
+
+bool RocksDBKvIterator::UnderlyingPointerModified() {
+    if (txn_->read_only_) return false;
+    return valid_ && (!it_ || n_writes_ != txn_->n_writes_);
+}
+
+bool RocksDBKvIterator::RefreshAfterModify() {
+    if (txn_->read_only_) return false;
+    if (!valid_ || !Renew()) return valid_;
+    Restore(false);
+    return valid_;
+}
+
+bool RocksDBKvIterator::Next() {
+    ThrowIfTaskKilled();
+    // if the key was deleted, Restore places the iterator at the key after it already
+    if (valid_ && Renew() && !Restore(false)) return valid_;
+    if (!valid_) return false;
+    it_->Next();
+    Load();
+    return valid_;
+}
+
+bool RocksDBKvIterator::Prev() {
+    ThrowIfTaskKilled();
+    if (!valid_) return GotoLastKey();
+    if (Renew() && !Restore(true)) return valid_;
+    if (!valid_) return false;
+    it_->Prev();
+    Load();
+    return valid_;
+}
+
+bool RocksDBKvIterator::GotoKey(const Value& key) {
+    ThrowIfTaskKilled();
+    Renew();
+    it_->Seek(rocksdb::Slice(key.Data(), key.Size()));
+    Load();
+    valid_ = valid_ && table_->cf_->GetComparator()->Compare(
+                           it_->key(), rocksdb::Slice(key.Data(), key.Size())) == 0;
+    return valid_;
+}
+
+bool RocksDBKvIterator::GotoClosestKey(const Value& key) {
+    ThrowIfTaskKilled();
+    Renew();
+    it_->Seek(rocksdb::Slice(key.Data(), key.Size()));
+    Load();
+    return valid_;
+}
+
+bool RocksDBKvIterator::GotoLastKey() {
+    ThrowIfTaskKilled();
+    Renew();
+    it_->SeekToLast();
+    Load();
+    return valid_;
+}
+
+bool RocksDBKvIterator::GotoFirstKey() {
+    ThrowIfTaskKilled();
+    Renew();
+    it_->SeekToFirst();
+    Load();
+    return valid_;
+}
+
+Value RocksDBKvIterator::GetKey() const { return Value(key_); }
+
+Value RocksDBKvIterator::GetValue(bool for_update) {
+    ThrowIfTaskKilled();
+    if (!valid_) THROW_CODE(KvException, "Failed to get value with an invalid iterator");
+    if (for_update && txn_->optimistic_) {
+        return table_->GetValue(*txn_, Value::ConstRef(key_), true);
+    }
+    if (Renew() && !Restore(false)) {
+        THROW_CODE(KvException, "The key of the iterator was deleted");
+    }
+    return Value::MakeCopy(it_->value().data(), it_->value().size());
+}
+
+void RocksDBKvIterator::SetValue(const Value& value) {
+    ThrowIfTaskKilled();
+    if (!valid_) THROW_CODE(KvException, "Failed to set value with an invalid iterator");
+    table_->Put(*txn_, Value::ConstRef(key_), value);
+}
+
+bool RocksDBKvIterator::AddKeyValue(const Value& key, const Value& value, bool overwrite) {
+    ThrowIfTaskKilled();
+    bool added = table_->SetValue(*txn_, key, value, overwrite);
+    // the iterator is placed at the key, whether it was written or not, it_ is created again
+    // and placed there when it is used
+    key_ = key.AsString();
+    valid_ = true;
+    it_.reset();
+    return added;
+}
+
+void RocksDBKvIterator::DeleteKey() {
+    ThrowIfTaskKilled();
+    if (!valid_) THROW_CODE(KvException, "Failed to delete key with an invalid iterator");
+    table_->Del(*txn_, Value::ConstRef(key_));
+    // moves to the key after the deleted one
+    Renew();
+    Restore(false);
+}
+}  // namespace lgraph
+#endif
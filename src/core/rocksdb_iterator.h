@@ -0,0 +1,125 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+#if (!LGRAPH_USE_MOCK_KV)
+#include <memory>
+#include <string>
+
+#include "rocksdb/iterator.h"
+
+#include "core/kv_engine.h"
+#include "core/rocksdb_table.h"
+#include "core/rocksdb_transaction.h"
+
+namespace lgraph {
+
+/**
+ * An iterator over a table of a RocksDBKvStore. It behaves like an LMDBKvIterator: a write
+ * made by its transaction does not move it, and if the key it points to is deleted, it points
+ * to the next key.
+ *
+ * A rocksdb iterator does not see the writes made after it was created, so the current key is
+ * kept, and when the transaction has written since the iterator last moved, a new rocksdb
+ * iterator is created and placed at that key again.
+ */
+class RocksDBKvIterator final : public KvIterator {
+    RocksDBKvTransaction* txn_ = nullptr;
+    RocksDBKvTable* table_ = nullptr;
+    std::unique_ptr<rocksdb::Iterator> it_;
+    // txn_->n_writes_ when it_ was created
+    size_t n_writes_ = 0;
+    bool valid_ = false;
+    std::string key_;
+
+    // creates it_ if it may miss writes of the txn, returns true if it did
+    bool Renew();
+
+    // places it_ at key_ again after Renew, returns false if key_ was deleted, in which case
+    // the iterator is at the key after it, or at the one before it if backward is true
+    bool Restore(bool backward);
+
+    // updates valid_ and key_ from it_
+    void Load();
+
+ public:
+    RocksDBKvIterator(RocksDBKvTransaction& txn, RocksDBKvTable& table);
+
+    /**
+     * Places the iterator at the key. If closest is false, the iterator is invalid if the key
+     * does not exist, otherwise it is placed at the first key not less than key.
+     */
+    RocksDBKvIterator(RocksDBKvTransaction& txn, RocksDBKvTable& table, const Value& key,
+                      bool closest);
+
+    ~RocksDBKvIterator() override;
+
+    void Close() override;
+
+    std::unique_ptr<KvIterator> Fork() override;
+
+    /**
+     * Determines if the transaction wrote since the iterator moved, in which case the content
+     * read through it must be refreshed.
+     */
+    bool UnderlyingPointerModified() override;
+
+    /**
+     * Places the iterator at its key again after the transaction wrote, or at the key after it
+     * if it was deleted.
+     *
+     * @return  True if the iterator is valid.
+     */
+    bool RefreshAfterModify() override;
+
+    bool Next() override;
+
+    bool Prev() override;
+
+    bool GotoKey(const Value& key) override;
+
+    bool GotoClosestKey(const Value& key) override;
+
+    bool GotoLastKey() override;
+
+    bool GotoFirstKey() override;
+
+    /**
+     * Gets the current key. Call only when iterator is valid. The key is copied, it stays
+     * valid after the iterator moves.
+     */
+    Value GetKey() const override;
+
+    /**
+     * Gets the current value. Call only when iterator is valid. The value is copied.
+     */
+    Value GetValue(bool for_update = false) override;
+
+    void SetValue(const Value& value) override;
+
+    bool AddKeyValue(const Value& key, const Value& value, bool overwrite = false) override;
+
+    bool IsValid() const override { return valid_; }
+
+    /**
+     * Deletes the current key, the iterator then points to the next key.
+     */
+    void DeleteKey() override;
+
+    KvTransaction& GetTxn() const override { return *txn_; }
+
+    KvTable& GetTable() const override { return *table_; }
+};
+}  // namespace lgraph
+#endif
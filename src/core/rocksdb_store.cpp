@@ -0,0 +1,357 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#if (!LGRAPH_USE_MOCK_KV)
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+
+#include "rocksdb/filter_policy.h"
+#include "rocksdb/options.h"
+#include "rocksdb/slice_transform.h"
+#include "rocksdb/table.h"
+#include "rocksdb/utilities/checkpoint.h"
+
+#include "lgraph/lgraph_exceptions.h"
+#include "tools/lgraph_log.h"
+#include "core/defs.h"
+#include "core/lmdb_store.h"
+#include "core/parallel_for.h"
+#include "core/rocksdb_store.h"
+
+namespace lgraph {
+
+// separates the name of a table from its comparator in the name of its column family
+static const char TABLE_NAME_SEPARATOR = '\x1f';
+
+RocksDBKvStore::RocksDBKvStore(const std::string& path, bool durable, bool create_if_not_exist,
+                               size_t cache_size)
+    : path_(path), durable_(durable), cache_(rocksdb::NewLRUCache(cache_size)) {
+    Open(create_if_not_exist);
+}
+
+RocksDBKvStore::~RocksDBKvStore() { Close(); }
+
+bool RocksDBKvStore::IsStoreDir(const std::string& path) {
+    std::error_code ec;
+    return std::filesystem::is_regular_file(path + "/CURRENT", ec);
+}
+
+rocksdb::ColumnFamilyOptions RocksDBKvStore::GetTableOptions(const TableInfo& table) const {
+    rocksdb::ColumnFamilyOptions options;
+    options.comparator = table.comparator.get();
+    rocksdb::BlockBasedTableOptions table_options;
+    table_options.block_cache = cache_;
+    // lookups of a single key, such as a vertex or an index entry, skip the files that do
+    // not have it
+    table_options.filter_policy.reset(rocksdb::NewBloomFilterPolicy(10));
+    options.table_factory.reset(rocksdb::NewBlockBasedTableFactory(table_options));
+    options.level_compaction_dynamic_level_bytes = true;
+    if (table.name == _detail::GRAPH_TABLE &&
+        table.comparator->Desc().comp_type == ComparatorDesc::BYTE_SEQ) {
+        // keys of the graph table start with the vid, and are compared byte by byte, so the
+        // filters also hold the vids, and seeking to the edges of a vertex skips the files
+        // without it
+        options.prefix_extractor.reset(rocksdb::NewFixedPrefixTransform(_detail::VID_SIZE));
+        options.memtable_prefix_bloom_size_ratio = 0.1;
+    }
+    return options;
+}
+
+rocksdb::WriteOptions RocksDBKvStore::GetWriteOptions() const {
+    rocksdb::WriteOptions options;
+    options.sync = durable_;
+    return options;
+}
+
+void RocksDBKvStore::Open(bool create_if_not_exist) {
+    bool exists = IsStoreDir(path_);
+    if (!exists) {
+        std::error_code ec;
+        if (!create_if_not_exist) {
+            THROW_CODE(KvException, "Data directory " + path_ + " does not contain valid data.");
+        }
+        if (!std::filesystem::is_directory(path_, ec) &&
+            !std::filesystem::create_directories(path_, ec)) {
+            THROW_CODE(KvException, "Failed to create data directory " + path_);
+        }
+    }
+    rocksdb::DBOptions options;
+    options.create_if_missing = create_if_not_exist;
+    options.IncreaseParallelism();
+    std::vector<std::string> names;
+    if (exists) {
+        ThrowOnRocksDBError(rocksdb::DB::ListColumnFamilies(options, path_, &names));
+    } else {
+        names.push_back(rocksdb::kDefaultColumnFamilyName);
+    }
+    // the comparator of each table is known from the name of its column family
+    std::vector<rocksdb::ColumnFamilyDescriptor> cfs;
+    std::vector<std::unique_ptr<TableInfo>> tables;
+    for (auto& name : names) {
+        if (name == rocksdb::kDefaultColumnFamilyName) {
+            cfs.emplace_back(name, rocksdb::ColumnFamilyOptions());
+            tables.emplace_back();
+            continue;
+        }
+        size_t pos = name.rfind(TABLE_NAME_SEPARATOR);
+        if (pos == std::string::npos) {
+            THROW_CODE(KvException, "Unknown column family " + name + " in " + path_);
+        }
+        auto t = std::make_unique<TableInfo>();
+        t->name = name.substr(0, pos);
+        t->comparator = std::make_unique<RocksDBKeyComparator>(
+            RocksDBKeyComparator::Decode(name.substr(pos + 1)));
+        cfs.emplace_back(name, GetTableOptions(*t));
+        tables.push_back(std::move(t));
+    }
+    std::vector<rocksdb::ColumnFamilyHandle*> handles;
+    ThrowOnRocksDBError(rocksdb::TransactionDB::Open(
+        options, rocksdb::TransactionDBOptions(), path_, cfs, &handles, &db_));
+    for (size_t i = 0; i < handles.size(); i++) {
+        if (!tables[i]) {
+            default_cf_ = handles[i];
+            continue;
+        }
+        tables[i]->cf = handles[i];
+        tables_[tables[i]->name] = std::move(tables[i]);
+    }
+    // update last op id of all stores with the value stored in this one
+    auto txn = CreateReadTxn();
+    LMDBKvStore::UpdateLastOpIdWithStoredValue(txn->LastOpId());
+}
+
+void RocksDBKvStore::Close() {
+    if (!db_) return;
+    for (auto& kv : tables_) db_->DestroyColumnFamilyHandle(kv.second->cf);
+    for (auto& t : dropped_tables_) db_->DestroyColumnFamilyHandle(t->cf);
+    db_->DestroyColumnFamilyHandle(default_cf_);
+    default_cf_ = nullptr;
+    delete db_;
+    db_ = nullptr;
+    // the comparators are used by the db until it is closed
+    tables_.clear();
+    dropped_tables_.clear();
+}
+
+std::unique_ptr<KvTransaction> RocksDBKvStore::CreateReadTxn() {
+    return std::make_unique<RocksDBKvTransaction>(*this, true, false);
+}
+
+std::unique_ptr<KvTransaction> RocksDBKvStore::CreateWriteTxn(bool optimistic) {
+    return std::make_unique<RocksDBKvTransaction>(*this, false, optimistic);
+}
+
+std::unique_ptr<KvTable> RocksDBKvStore::OpenTable(KvTransaction& txn,
+                                                   const std::string& table_name,
+                                                   bool create_if_not_exist,
+                                                   const ComparatorDesc& desc) {
+    auto& rdb_txn = static_cast<RocksDBKvTransaction&>(txn);
+    if (std::find(rdb_txn.deleted_tables_.begin(), rdb_txn.deleted_tables_.end(),
+                  table_name) != rdb_txn.deleted_tables_.end()) {
+        THROW_CODE(KvException, "Table " + table_name + " was deleted in this transaction.");
+    }
+    std::lock_guard<std::mutex> l(mutex_);
+    auto it = tables_.find(table_name);
+    if (it == tables_.end()) {
+        if (!create_if_not_exist) THROW_CODE(KvException, "Table " + table_name + " not found.");
+        rdb_txn.ThrowIfReadOnly();
+        auto t = std::make_unique<TableInfo>();
+        t->name = table_name;
+        t->comparator = std::make_unique<RocksDBKeyComparator>(desc);
+        ThrowOnRocksDBError(db_->CreateColumnFamily(
+            GetTableOptions(*t),
+            table_name + TABLE_NAME_SEPARATOR + RocksDBKeyComparator::Encode(desc), &t->cf));
+        rdb_txn.created_tables_.push_back(table_name);
+        it = tables_.emplace(table_name, std::move(t)).first;
+        if (rdb_txn.write_set_) {
+            rdb_txn.write_set_->MarkUnreplicable("table " + table_name + " created");
+        }
+    }
+    return std::make_unique<RocksDBKvTable>(*this, table_name, it->second->cf);
+}
+
+std::unique_ptr<KvTable> RocksDBKvStore::_OpenTable_(KvTransaction& txn,
+                                                     const std::string& table_name,
+                                                     bool create_if_not_exist,
+                                                     const KeySortFunc& func) {
+    if (func) THROW_CODE(KvException, "Custom key comparators are not supported by rocksdb.");
+    return OpenTable(txn, table_name, create_if_not_exist, ComparatorDesc::DefaultComparator());
+}
+
+bool RocksDBKvStore::DeleteTable(KvTransaction& txn, const std::string& table_name) {
+    auto& rdb_txn = static_cast<RocksDBKvTransaction&>(txn);
+    rdb_txn.ThrowIfReadOnly();
+    {
+        std::lock_guard<std::mutex> l(mutex_);
+        if (tables_.find(table_name) == tables_.end()) return true;
+    }
+    // dropping the column family deletes the keys at once, instead of writing a delete for
+    // each of them, so it is deferred until the txn commits
+    rdb_txn.deleted_tables_.push_back(table_name);
+    if (rdb_txn.write_set_) {
+        rdb_txn.write_set_->MarkUnreplicable("table " + table_name + " dropped");
+    }
+    return true;
+}
+
+void RocksDBKvStore::DropTable(const std::string& table_name) {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto it = tables_.find(table_name);
+    if (it == tables_.end()) return;
+    rocksdb::Status s = db_->DropColumnFamily(it->second->cf);
+    if (!s.ok()) {
+        LOG_WARN() << "Failed to drop table " << table_name << " of " << path_ << ": "
+                   << s.ToString();
+        return;
+    }
+    dropped_tables_.push_back(std::move(it->second));
+    tables_.erase(it);
+}
+
+std::vector<std::string> RocksDBKvStore::ListAllTables(KvTransaction& txn) {
+    std::vector<std::string> tables;
+    {
+        std::lock_guard<std::mutex> l(mutex_);
+        for (auto& kv : tables_) tables.push_back(kv.first);
+    }
+    std::sort(tables.begin(), tables.end());
+    return tables;
+}
+
+void RocksDBKvStore::Flush() {
+    std::vector<rocksdb::ColumnFamilyHandle*> cfs{default_cf_};
+    {
+        std::lock_guard<std::mutex> l(mutex_);
+        for (auto& kv : tables_) cfs.push_back(kv.second->cf);
+    }
+    ThrowOnRocksDBError(db_->Flush(rocksdb::FlushOptions(), cfs));
+    ThrowOnRocksDBError(db_->FlushWAL(true));
+}
+
+void RocksDBKvStore::DropAll(KvTransaction& txn) {
+    for (auto& tbl : ListAllTables(txn)) DeleteTable(txn, tbl);
+}
+
+void RocksDBKvStore::DumpStat(KvTransaction& txn, size_t& memory_size, size_t& height) {
+    KvSpaceStat stat;
+    DumpStat(txn, stat);
+    memory_size = stat.used_size;
+    height = stat.height;
+}
+
+void RocksDBKvStore::DumpStat(KvTransaction& txn, KvSpaceStat& stat) {
+    stat = KvSpaceStat();
+    std::lock_guard<std::mutex> l(mutex_);
+    std::vector<rocksdb::ColumnFamilyHandle*> cfs{default_cf_};
+    for (auto& kv : tables_) cfs.push_back(kv.second->cf);
+    for (auto cf : cfs) {
+        uint64_t v = 0;
+        if (db_->GetIntProperty(cf, rocksdb::DB::Properties::kTotalSstFilesSize, &v))
+            stat.file_size += v;
+        if (db_->GetIntProperty(cf, rocksdb::DB::Properties::kEstimateLiveDataSize, &v))
+            stat.used_size += v;
+        // the height is the number of levels that have files
+        int n_levels = db_->NumberLevels(cf);
+        for (int level = n_levels - 1; level >= 0; level--) {
+            std::string files;
+            if (db_->GetProperty(cf, rocksdb::DB::Properties::kNumFilesAtLevelPrefix +
+                                         std::to_string(level), &files) &&
+                files != "0") {
+                stat.height = std::max<size_t>(stat.height, level + 1);
+                break;
+            }
+        }
+    }
+    stat.free_size = stat.file_size > stat.used_size ? stat.file_size - stat.used_size : 0;
+    // every read txn and optimistic write txn holds a snapshot, the one of txn is left out
+    uint64_t n_snapshots = 0, oldest_time = 0;
+    db_->GetIntProperty(rocksdb::DB::Properties::kNumSnapshots, &n_snapshots);
+    size_t own = static_cast<RocksDBKvTransaction&>(txn).snapshot_ ? 1 : 0;
+    stat.readers = n_snapshots > own ? n_snapshots - own : 0;
+    if (stat.readers > 0 &&
+        db_->GetIntProperty(rocksdb::DB::Properties::kOldestSnapshotTime, &oldest_time)) {
+        int64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+                          std::chrono::system_clock::now().time_since_epoch())
+                          .count();
+        stat.oldest_reader_age = std::max<int64_t>(now - (int64_t)oldest_time, 0);
+    }
+}
+
+size_t RocksDBKvStore::Backup(const std::string& path, bool compact) {
+    // a checkpoint only has the live files, it is as compact as the store already
+    rocksdb::Checkpoint* checkpoint;
+    ThrowOnRocksDBError(rocksdb::Checkpoint::Create(db_, &checkpoint));
+    std::unique_ptr<rocksdb::Checkpoint> checkpoint_guard(checkpoint);
+    // the checkpoint dir must not exist
+    std::error_code ec;
+    std::filesystem::remove_all(path, ec);
+    uint64_t seq = 0;
+    ThrowOnRocksDBError(checkpoint->CreateCheckpoint(path, 0, &seq));
+    return seq;
+}
+
+void RocksDBKvStore::Clone(const std::string& path) { Backup(path); }
+
+void RocksDBKvStore::Snapshot(KvTransaction& txn, const std::string& path, bool compaction) {
+    Backup(path, compaction);
+}
+
+void RocksDBKvStore::LoadSnapshot(const std::string& snapshot_path) {
+    Close();
+    std::error_code ec;
+    std::filesystem::remove_all(path_, ec);
+    std::filesystem::copy(snapshot_path, path_, std::filesystem::copy_options::recursive, ec);
+    if (ec) {
+        THROW_CODE(KvException, "Failed to copy snapshot from " + snapshot_path + " to " +
+                                    path_ + ": " + ec.message());
+    }
+    Open(false);
+}
+
+void RocksDBKvStore::WarmUp(size_t* size, const std::vector<std::string>& tables,
+                            size_t n_threads) {
+    auto txn = CreateReadTxn();
+    std::vector<std::string> names = tables.empty() ? ListAllTables(*txn) : tables;
+    std::vector<std::unique_ptr<KvTable>> kv_tables;
+    for (auto& name : names) {
+        kv_tables.push_back(OpenTable(*txn, name, false, ComparatorDesc::DefaultComparator()));
+    }
+    // a scan reads the blocks of a table into the block cache, the read txn is only read, so
+    // its snapshot can be shared by the threads
+    std::vector<size_t> sizes(kv_tables.size(), 0);
+    ParallelFor(kv_tables.size(), n_threads, [&](size_t i) {
+        auto it = kv_tables[i]->GetIterator(*txn);
+        for (it->GotoFirstKey(); it->IsValid(); it->Next()) {
+            sizes[i] += it->GetKey().Size() + it->GetValue().Size();
+        }
+    });
+    if (size) {
+        *size = 0;
+        for (auto s : sizes) *size += s;
+    }
+}
+
+void RocksDBKvStore::StartCompaction() {
+    std::vector<rocksdb::ColumnFamilyHandle*> cfs{default_cf_};
+    {
+        std::lock_guard<std::mutex> l(mutex_);
+        for (auto& kv : tables_) cfs.push_back(kv.second->cf);
+    }
+    rocksdb::CompactRangeOptions options;
+    options.bottommost_level_compaction = rocksdb::BottommostLevelCompaction::kForce;
+    for (auto cf : cfs) ThrowOnRocksDBError(db_->CompactRange(options, cf, nullptr, nullptr));
+}
+}  // namespace lgraph
+#endif
@@ -0,0 +1,198 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+#if (!LGRAPH_USE_MOCK_KV)
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "rocksdb/cache.h"
+#include "rocksdb/status.h"
+#include "rocksdb/utilities/transaction_db.h"
+
+#include "core/kv_engine.h"
+#include "core/rocksdb_iterator.h"
+#include "core/rocksdb_table.h"
+#include "core/rocksdb_transaction.h"
+
+namespace lgraph {
+
+/**
+ * A KvStore kept in a RocksDB LSM tree, for graphs that are mostly written. Writes are appended
+ * to a log and sorted in the background, instead of rewriting b-tree pages in place, so a
+ * graph that is loaded and updated at a high rate is written faster than with LMDB, at the cost
+ * of slower reads, which may have to look into several levels of the tree.
+ *
+ * Each table is a column family, named after the table and its ComparatorDesc, so the tables
+ * are opened with their comparators when the store is opened. The last op id is kept in the
+ * default column family.
+ */
+class RocksDBKvStore final : public KvStore {
+    friend class RocksDBKvTransaction;
+    friend class RocksDBKvTable;
+    friend class RocksDBKvIterator;
+
+    struct TableInfo {
+        std::string name;
+        std::unique_ptr<RocksDBKeyComparator> comparator;
+        rocksdb::ColumnFamilyHandle* cf = nullptr;
+    };
+
+    // key of the last op id in the default column family
+    static constexpr const char* LAST_OP_ID_KEY = "_last_op_id_";
+
+    std::string path_;
+    bool durable_;
+    std::shared_ptr<rocksdb::Cache> cache_;
+    rocksdb::TransactionDB* db_ = nullptr;
+    rocksdb::ColumnFamilyHandle* default_cf_ = nullptr;
+
+    // guards tables_ and dropped_tables_
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::unique_ptr<TableInfo>> tables_;
+    // tables dropped while the store is open, an open table may still refer to them, so
+    // their handles are destroyed when the store is closed
+    std::vector<std::unique_ptr<TableInfo>> dropped_tables_;
+
+    // held by exclusive write txns, one of them runs at a time
+    std::mutex writer_mutex_;
+
+    void Open(bool create_if_not_exist);
+
+    void Close();
+
+    rocksdb::ColumnFamilyOptions GetTableOptions(const TableInfo& table) const;
+
+    rocksdb::WriteOptions GetWriteOptions() const;
+
+    // drops the column family of the table, called when a txn that deleted it commits, or a
+    // txn that created it aborts
+    void DropTable(const std::string& table_name);
+
+ public:
+    DISABLE_COPY(RocksDBKvStore);
+    DISABLE_MOVE(RocksDBKvStore);
+
+    /**
+     * Constructor
+     *
+     * \param   path                Directory where the rocksdb files are stored.
+     * \param   durable             (Optional) If true, the log is synced when a write
+     *                              transaction commits. Otherwise, the last transactions may
+     *                              be lost if the OS crashes or power is lost.
+     * \param   create_if_not_exist (Optional) True to create the store if it does not exist.
+     * \param   cache_size          (Optional) Size of the block cache shared by the tables.
+     */
+    RocksDBKvStore(const std::string& path, bool durable = false,
+                   bool create_if_not_exist = true, size_t cache_size = (size_t)1 << 30);
+
+    ~RocksDBKvStore() override;
+
+    /** Returns true if path holds a rocksdb store. */
+    static bool IsStoreDir(const std::string& path);
+
+    std::unique_ptr<KvTransaction> CreateReadTxn() override;
+
+    std::unique_ptr<KvTransaction> CreateWriteTxn(bool optimistic = false) override;
+
+    /**
+     * Opens a table. If create_if_not_exist is true, then the table is created if it does not
+     * exist. The column family of a new table is created right away, and dropped again if txn
+     * aborts.
+     */
+    std::unique_ptr<KvTable> OpenTable(KvTransaction& txn,
+                                       const std::string& table_name,
+                                       bool create_if_not_exist,
+                                       const ComparatorDesc& desc) override;
+
+    /**
+     * Just for test. A rocksdb table needs a comparator with a name that is known when the
+     * store is opened, so only the default comparator is supported, func must be empty.
+     */
+    std::unique_ptr<KvTable> _OpenTable_(KvTransaction& txn,
+                                         const std::string& table_name,
+                                         bool create_if_not_exist,
+                                         const KeySortFunc& func) override;
+
+    /**
+     * Deletes a table. Its column family is dropped when txn commits, the table can not be
+     * opened again in txn.
+     */
+    bool DeleteTable(KvTransaction& txn, const std::string& table_name) override;
+
+    std::vector<std::string> ListAllTables(KvTransaction& txn) override;
+
+    /** Flushes the memtables and syncs the log. */
+    void Flush() override;
+
+    void DropAll(KvTransaction& txn) override;
+
+    /** Gets the estimated size of the live data of the tables, height is the number of levels. */
+    void DumpStat(KvTransaction& txn, size_t& memory_size, size_t& height) override;
+
+    /**
+     * Gets the space used by the store. file_size is the size of the sst files, used_size the
+     * estimated size of the live data in them, and free_size the rest, which is taken by
+     * overwritten and deleted keys until they are compacted away.
+     */
+    void DumpStat(KvTransaction& txn, KvSpaceStat& stat) override;
+
+    /**
+     * Creates a checkpoint of the store in path, the sst files are hard linked if path is on
+     * the same file system. Returns the sequence number of the checkpoint.
+     */
+    size_t Backup(const std::string& path, bool compact = false) override;
+
+    /**
+     * Creates a checkpoint of the store in path. A checkpoint holds all the committed data,
+     * txn only tells that a read transaction is open.
+     */
+    void Snapshot(KvTransaction& txn, const std::string& path, bool compaction = false) override;
+
+    /** Replaces the store with the checkpoint in snapshot_path. */
+    void LoadSnapshot(const std::string& snapshot_path) override;
+
+    /** Creates a checkpoint of the store in path, like Backup. */
+    void Clone(const std::string& path) override;
+
+    /**
+     * Loads the tables, or the given tables, into the block cache by scanning them, one table
+     * per thread.
+     */
+    void WarmUp(size_t* size, const std::vector<std::string>& tables = {},
+                size_t n_threads = 0) override;
+
+    // the block cache is not saved, nothing to do
+    void SaveHotPages(const std::string& path) override {}
+
+    void PrefetchHotPages(const std::string& path) override {}
+
+    /**
+     * Compacts all the tables, dropping overwritten and deleted keys. Compaction runs while
+     * other transactions go on, so there is nothing to switch to, FinishCompaction and
+     * AbortCompaction do nothing.
+     */
+    void StartCompaction() override;
+
+    bool CompactsInPlace() const override { return true; }
+
+    void FinishCompaction() override {}
+
+    void AbortCompaction() override {}
+};
+}  // namespace lgraph
+#endif
@@ -0,0 +1,207 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#if (!LGRAPH_USE_MOCK_KV)
+#include <cstring>
+#include <sstream>
+
+#include "lgraph/lgraph_exceptions.h"
+#include "core/rocksdb_iterator.h"
+#include "core/rocksdb_store.h"
+#include "core/rocksdb_table.h"
+#include "core/task_tracker.h"
+
+namespace lgraph {
+
+static rocksdb::Slice ToSlice(const Value& v) { return rocksdb::Slice(v.Data(), v.Size()); }
+
+std::string RocksDBKeyComparator::Encode(const ComparatorDesc& desc) {
+    std::string code = std::to_string((int)desc.comp_type);
+    switch (desc.comp_type) {
+    case ComparatorDesc::BYTE_SEQ:
+    case ComparatorDesc::GRAPH_KEY:
+        break;
+    case ComparatorDesc::COMPOSITE_KEY:
+    case ComparatorDesc::COMPOSITE_KEY_AND_VID:
+        for (auto t : desc.data_types) code += "." + std::to_string((int)t);
+        break;
+    default:
+        code += "." + std::to_string((int)desc.data_type);
+    }
+    return code;
+}
+
+ComparatorDesc RocksDBKeyComparator::Decode(const std::string& code) {
+    std::vector<int> fields;
+    std::istringstream iss(code);
+    std::string f;
+    while (std::getline(iss, f, '.')) fields.push_back(std::stoi(f));
+    if (fields.empty()) THROW_CODE(KvException, "Invalid comparator code: " + code);
+    ComparatorDesc desc;
+    desc.comp_type = (ComparatorDesc::Type)fields[0];
+    if (desc.comp_type == ComparatorDesc::COMPOSITE_KEY ||
+        desc.comp_type == ComparatorDesc::COMPOSITE_KEY_AND_VID) {
+        for (size_t i = 1; i < fields.size(); i++) desc.data_types.push_back((FieldType)fields[i]);
+    } else if (fields.size() > 1) {
+        desc.data_type = (FieldType)fields[1];
+    }
+    return desc;
+}
+
+RocksDBKeyComparator::RocksDBKeyComparator(const ComparatorDesc& desc)
+    : name_("lgraph." + Encode(desc)), desc_(desc) {
+    // the comparator GetKeyComparator returns for a composite key reads shared state, see
+    // CompareCompositeKey
+    if (desc.comp_type != ComparatorDesc::COMPOSITE_KEY &&
+        desc.comp_type != ComparatorDesc::COMPOSITE_KEY_AND_VID) {
+        func_ = GetKeyComparator(desc);
+    }
+}
+
+int RocksDBKeyComparator::Compare(const rocksdb::Slice& a, const rocksdb::Slice& b) const {
+    MDB_val va{a.size(), const_cast<char*>(a.data())};
+    MDB_val vb{b.size(), const_cast<char*>(b.data())};
+    switch (desc_.comp_type) {
+    case ComparatorDesc::COMPOSITE_KEY:
+        return CompareCompositeKey(desc_.data_types, false, &va, &vb);
+    case ComparatorDesc::COMPOSITE_KEY_AND_VID:
+        return CompareCompositeKey(desc_.data_types, true, &va, &vb);
+    default:
+        if (func_) return func_(&va, &vb);
+        return a.compare(b);
+    }
+}
+
+RocksDBKvTable::RocksDBKvTable(RocksDBKvStore& store, const std::string& name,
+                               rocksdb::ColumnFamilyHandle* cf)
+    : store_(&store), name_(name), cf_(cf) {}
+
+bool RocksDBKvTable::Get(RocksDBKvTransaction& txn, const Value& key, bool for_update,
+                         std::string* value) {
+    if (!txn.valid_) THROW_CODE(KvException, "Transaction is already closed.");
+    rocksdb::Status s;
+    if (txn.txn_) {
+        // GetForUpdate makes the commit of an optimistic txn fail if the key was written
+        // after its snapshot
+        if (for_update && txn.optimistic_) {
+            s = txn.txn_->GetForUpdate(txn.GetReadOptions(), cf_, ToSlice(key), value);
+        } else {
+            s = txn.txn_->Get(txn.GetReadOptions(), cf_, ToSlice(key), value);
+        }
+    } else {
+        s = store_->db_->Get(txn.GetReadOptions(), cf_, ToSlice(key), value);
+    }
+    if (s.IsNotFound()) return false;
+    ThrowOnRocksDBError(s);
+    return true;
+}
+
+void RocksDBKvTable::Put(RocksDBKvTransaction& txn, const Value& key, const Value& value) {
+    txn.ThrowIfReadOnly();
+    ThrowOnRocksDBError(txn.txn_->Put(cf_, ToSlice(key), ToSlice(value)));
+    txn.n_writes_++;
+    if (txn.write_set_) txn.write_set_->Put(name_, key, value);
+}
+
+void RocksDBKvTable::Del(RocksDBKvTransaction& txn, const Value& key) {
+    txn.ThrowIfReadOnly();
+    ThrowOnRocksDBError(txn.txn_->Delete(cf_, ToSlice(key)));
+    txn.n_writes_++;
+    if (txn.write_set_) txn.write_set_->Delete(name_, key);
+}
+
+bool RocksDBKvTable::HasKey(KvTransaction& txn, const Value& key) {
+    ThrowIfTaskKilled();
+    std::string value;
+    return Get(static_cast<RocksDBKvTransaction&>(txn), key, false, &value);
+}
+
+Value RocksDBKvTable::GetValue(KvTransaction& txn, const Value& key, bool for_update) {
+    ThrowIfTaskKilled();
+    std::string value;
+    if (!Get(static_cast<RocksDBKvTransaction&>(txn), key, for_update, &value)) return Value();
+    return Value(value);
+}
+
+bool RocksDBKvTable::GetValue(KvTransaction& txn, const Value& key, Value& val) {
+    ThrowIfTaskKilled();
+    std::string value;
+    if (!Get(static_cast<RocksDBKvTransaction&>(txn), key, false, &value)) return false;
+    val.Copy(value);
+    return true;
+}
+
+size_t RocksDBKvTable::GetKeyCount(KvTransaction& txn) {
+    size_t n = 0;
+    auto it = GetIterator(txn);
+    for (it->GotoFirstKey(); it->IsValid(); it->Next()) n++;
+    return n;
+}
+
+bool RocksDBKvTable::SetValue(KvTransaction& txn, const Value& key, const Value& value,
+                              bool overwrite_if_exist) {
+    ThrowIfTaskKilled();
+    auto& rdb_txn = static_cast<RocksDBKvTransaction&>(txn);
+    if (!overwrite_if_exist && HasKey(txn, key)) return false;
+    Put(rdb_txn, key, value);
+    return true;
+}
+
+bool RocksDBKvTable::AddKV(KvTransaction& txn, const Value& key, const Value& value) {
+    return RocksDBKvTable::SetValue(txn, key, value, false);
+}
+
+void RocksDBKvTable::AppendKv(KvTransaction& txn, const Value& key, const Value& value) {
+    ThrowIfTaskKilled();
+    // keys are sorted when they are flushed, appending is just a put
+    Put(static_cast<RocksDBKvTransaction&>(txn), key, value);
+}
+
+bool RocksDBKvTable::DeleteKey(KvTransaction& txn, const Value& key) {
+    ThrowIfTaskKilled();
+    if (!HasKey(txn, key)) return false;
+    Del(static_cast<RocksDBKvTransaction&>(txn), key);
+    return true;
+}
+
+std::unique_ptr<KvIterator> RocksDBKvTable::GetIterator(KvTransaction& txn) {
+    return std::make_unique<RocksDBKvIterator>(static_cast<RocksDBKvTransaction&>(txn), *this);
+}
+
+std::unique_ptr<KvIterator> RocksDBKvTable::GetIterator(KvTransaction& txn, const Value& key) {
+    return std::make_unique<RocksDBKvIterator>(static_cast<RocksDBKvTransaction&>(txn), *this,
+                                               key, false);
+}
+
+std::unique_ptr<KvIterator> RocksDBKvTable::GetClosestIterator(KvTransaction& txn,
+                                                               const Value& key) {
+    return std::make_unique<RocksDBKvIterator>(static_cast<RocksDBKvTransaction&>(txn), *this,
+                                               key, true);
+}
+
+int RocksDBKvTable::CompareKey(KvTransaction& txn, const Value& k1, const Value& k2) const {
+    return cf_->GetComparator()->Compare(ToSlice(k1), ToSlice(k2));
+}
+
+void RocksDBKvTable::Drop(KvTransaction& txn) {
+    auto& rdb_txn = static_cast<RocksDBKvTransaction&>(txn);
+    rdb_txn.ThrowIfReadOnly();
+    // the keys are deleted one by one, so unlike in LMDB the write set still replays it
+    auto it = GetIterator(txn);
+    for (it->GotoFirstKey(); it->IsValid();) it->DeleteKey();
+}
+
+void RocksDBKvTable::Delete(KvTransaction& txn) { store_->DeleteTable(txn, name_); }
+}  // namespace lgraph
+#endif
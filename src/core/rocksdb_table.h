@@ -0,0 +1,126 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+#if (!LGRAPH_USE_MOCK_KV)
+#include <memory>
+#include <string>
+
+#include "rocksdb/comparator.h"
+#include "rocksdb/db.h"
+
+#include "core/kv_engine.h"
+#include "core/kv_table_comparators.h"
+#include "core/rocksdb_transaction.h"
+#include "core/value.h"
+
+namespace lgraph {
+
+/**
+ * Orders the keys of a table with the comparator of its ComparatorDesc. The name of the
+ * comparator is made from the desc, rocksdb checks that a table is always opened with the same
+ * comparator.
+ */
+class RocksDBKeyComparator final : public rocksdb::Comparator {
+    std::string name_;
+    ComparatorDesc desc_;
+    KeySortFunc func_ = nullptr;
+
+ public:
+    explicit RocksDBKeyComparator(const ComparatorDesc& desc);
+
+    // encodes the desc into a string of printable characters, and back
+    static std::string Encode(const ComparatorDesc& desc);
+
+    static ComparatorDesc Decode(const std::string& code);
+
+    const ComparatorDesc& Desc() const { return desc_; }
+
+    const char* Name() const override { return name_.c_str(); }
+
+    int Compare(const rocksdb::Slice& a, const rocksdb::Slice& b) const override;
+
+    // keys are compared field by field, so a shortened key may not sort the same way
+    void FindShortestSeparator(std::string*, const rocksdb::Slice&) const override {}
+
+    void FindShortSuccessor(std::string*) const override {}
+};
+
+class RocksDBKvTable final : public KvTable {
+    friend class RocksDBKvStore;
+    friend class RocksDBKvIterator;
+
+    RocksDBKvStore* store_ = nullptr;
+    std::string name_;
+    rocksdb::ColumnFamilyHandle* cf_ = nullptr;
+
+    bool Get(RocksDBKvTransaction& txn, const Value& key, bool for_update, std::string* value);
+
+    void Put(RocksDBKvTransaction& txn, const Value& key, const Value& value);
+
+    void Del(RocksDBKvTransaction& txn, const Value& key);
+
+ public:
+    RocksDBKvTable(RocksDBKvStore& store, const std::string& name,
+                   rocksdb::ColumnFamilyHandle* cf);
+
+    ~RocksDBKvTable() override = default;
+
+    bool HasKey(KvTransaction& txn, const Value& key) override;
+
+    /**
+     * Gets a value corresponding to the key
+     *
+     * \param [in,out]  txn         The transaction.
+     * \param           key         The key.
+     * \param           for_update  Whether to check conflicts upon commit.
+     *
+     * \return  The value. An empty value is returned if the key does not exist.
+     */
+    Value GetValue(KvTransaction& txn, const Value& key, bool for_update = false) override;
+
+    bool GetValue(KvTransaction& txn, const Value& key, Value& val) override;
+
+    /**
+     * Gets number of k-v pairs in the table. An LSM tree does not keep the count, so the
+     * table is scanned.
+     */
+    size_t GetKeyCount(KvTransaction& txn) override;
+
+    bool SetValue(KvTransaction& txn, const Value& key, const Value& value,
+                  bool overwrite_if_exist = true) override;
+
+    bool AddKV(KvTransaction& txn, const Value& key, const Value& value) override;
+
+    void AppendKv(KvTransaction& txn, const Value& key, const Value& value) override;
+
+    bool DeleteKey(KvTransaction& txn, const Value& key) override;
+
+    std::unique_ptr<KvIterator> GetIterator(KvTransaction& txn) override;
+
+    std::unique_ptr<KvIterator> GetIterator(KvTransaction& txn, const Value& key) override;
+
+    std::unique_ptr<KvIterator> GetClosestIterator(KvTransaction& txn,
+                                                   const Value& key) override;
+
+    int CompareKey(KvTransaction& txn, const Value& k1, const Value& k2) const override;
+
+    void Drop(KvTransaction& txn) override;
+
+    void Delete(KvTransaction& txn) override;
+
+    const std::string& Name() const override { return name_; }
+};
+}  // namespace lgraph
+#endif
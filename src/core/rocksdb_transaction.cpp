@@ -0,0 +1,150 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#if (!LGRAPH_USE_MOCK_KV)
+#include <cstring>
+
+#include "core/lmdb_store.h"
+#include "core/rocksdb_store.h"
+#include "core/rocksdb_transaction.h"
+
+namespace lgraph {
+
+void ThrowOnRocksDBError(const rocksdb::Status& s) {
+    if (s.ok()) return;
+    // a write of an optimistic txn that conflicts with a write made after its snapshot gets
+    // Busy, and a write to a key locked by another txn gets TimedOut once it has waited for
+    // the lock timeout
+    if (s.IsBusy() || s.IsTimedOut() || s.IsTryAgain()) THROW_CODE(TxnConflict);
+    THROW_CODE(KvException, s.ToString());
+}
+
+RocksDBKvTransaction::RocksDBKvTransaction(RocksDBKvStore& store, bool read_only,
+                                           bool optimistic) {
+    store_ = &store;
+    read_only_ = read_only;
+    optimistic_ = optimistic;
+    rocksdb::TransactionDB* db = store.db_;
+    if (read_only_) {
+        snapshot_.reset(db->GetSnapshot(),
+                        [db](const rocksdb::Snapshot* s) { db->ReleaseSnapshot(s); });
+        version_ = snapshot_->GetSequenceNumber();
+    } else {
+        if (!optimistic_) writer_lock_ = std::unique_lock<std::mutex>(store.writer_mutex_);
+        rocksdb::TransactionOptions options;
+        // writes to keys written by others after the snapshot then fail with Busy
+        options.set_snapshot = optimistic_;
+        txn_.reset(db->BeginTransaction(store.GetWriteOptions(), options));
+        version_ = optimistic_ ? txn_->GetSnapshot()->GetSequenceNumber()
+                               : db->GetLatestSequenceNumber();
+        recorder_ = KvWriteSetRecorder::Current();
+        if (recorder_) {
+            write_set_ = std::make_unique<KvWriteSet>(store_);
+            if (optimistic_) write_set_->MarkUnreplicable("optimistic transaction");
+        }
+    }
+    valid_ = true;
+}
+
+RocksDBKvTransaction::~RocksDBKvTransaction() { RocksDBKvTransaction::Abort(); }
+
+rocksdb::ReadOptions RocksDBKvTransaction::GetReadOptions() const {
+    rocksdb::ReadOptions options;
+    // the prefix filters are used only where they give the same result as a total order seek
+    options.auto_prefix_mode = true;
+    if (snapshot_) {
+        options.snapshot = snapshot_.get();
+    } else if (txn_ && optimistic_) {
+        options.snapshot = txn_->GetSnapshot();
+    }
+    return options;
+}
+
+void RocksDBKvTransaction::ThrowIfReadOnly() const {
+    if (!valid_) THROW_CODE(KvException, "Transaction is already closed.");
+    if (read_only_) THROW_CODE(KvException, "Write operation in a read transaction.");
+}
+
+std::unique_ptr<KvTransaction> RocksDBKvTransaction::Fork() {
+    if (!read_only_) THROW_CODE(KvException, "Write transactions cannot be forked.");
+    std::unique_ptr<RocksDBKvTransaction> txn(new RocksDBKvTransaction());
+    txn->store_ = store_;
+    txn->read_only_ = true;
+    txn->optimistic_ = false;
+    txn->snapshot_ = snapshot_;
+    txn->version_ = version_;
+    txn->valid_ = valid_;
+    return txn;
+}
+
+void RocksDBKvTransaction::Commit() {
+    if (!valid_) return;
+    if (read_only_) {
+        Abort();
+        return;
+    }
+    // may throw, leaving the txn to be aborted
+    if (recorder_) recorder_->OnCommit(*write_set_);
+    try {
+        // not tracked, so that concurrent optimistic txns do not conflict on it
+        int64_t last_op_id = LMDBKvStore::GetLastOpIdOfAllStores();
+        ThrowOnRocksDBError(txn_->PutUntracked(
+            store_->default_cf_, RocksDBKvStore::LAST_OP_ID_KEY,
+            rocksdb::Slice((const char*)&last_op_id, sizeof(last_op_id))));
+        ThrowOnRocksDBError(txn_->Commit());
+    } catch (...) {
+        if (recorder_) recorder_->OnCommitted(false);
+        throw;
+    }
+    if (recorder_) recorder_->OnCommitted(true);
+    txn_.reset();
+    for (auto& t : deleted_tables_) store_->DropTable(t);
+    deleted_tables_.clear();
+    created_tables_.clear();
+    if (writer_lock_.owns_lock()) writer_lock_.unlock();
+    valid_ = false;
+}
+
+void RocksDBKvTransaction::Abort() {
+    write_set_.reset();
+    if (!valid_) return;
+    if (txn_) {
+        txn_->Rollback();
+        txn_.reset();
+    }
+    for (auto& t : created_tables_) store_->DropTable(t);
+    created_tables_.clear();
+    deleted_tables_.clear();
+    snapshot_.reset();
+    if (writer_lock_.owns_lock()) writer_lock_.unlock();
+    valid_ = false;
+}
+
+size_t RocksDBKvTransaction::TxnId() { return version_; }
+
+int64_t RocksDBKvTransaction::LastOpId() const {
+    std::string value;
+    rocksdb::Status s =
+        txn_ ? txn_->Get(GetReadOptions(), store_->default_cf_, RocksDBKvStore::LAST_OP_ID_KEY,
+                         &value)
+             : store_->db_->Get(GetReadOptions(), store_->default_cf_,
+                                RocksDBKvStore::LAST_OP_ID_KEY, &value);
+    if (s.IsNotFound()) return -1;
+    ThrowOnRocksDBError(s);
+    int64_t id;
+    memcpy(&id, value.data(), sizeof(id));
+    return id;
+}
+}  // namespace lgraph
+#endif
@@ -0,0 +1,123 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+#if (!LGRAPH_USE_MOCK_KV)
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "rocksdb/utilities/transaction.h"
+
+#include "fma-common/type_traits.h"
+#include "core/kv_engine.h"
+#include "core/kv_write_set.h"
+
+namespace lgraph {
+
+class RocksDBKvStore;
+
+class RocksDBKvTable;
+
+class RocksDBKvIterator;
+
+// Throws TxnConflict if s tells that a write conflicts with another transaction, and
+// KvException if it is another error.
+void ThrowOnRocksDBError(const rocksdb::Status& s);
+
+/**
+ * A transaction of a RocksDBKvStore.
+ *
+ * A read transaction reads from a snapshot of the store taken when it begins. An exclusive
+ * write transaction holds the writer lock of the store until it ends, so like in LMDB there is
+ * one at a time, and reads the latest committed data along with its own writes. An optimistic
+ * write transaction does not take the writer lock. It reads from a snapshot, and a write to a
+ * key that was written by another transaction since the snapshot throws TxnConflict.
+ */
+class RocksDBKvTransaction final : public KvTransaction {
+    friend class RocksDBKvStore;
+    friend class RocksDBKvTable;
+    friend class RocksDBKvIterator;
+
+    RocksDBKvStore* store_ = nullptr;
+    bool read_only_ = true;
+    bool optimistic_ = false;
+    bool valid_ = false;
+    // sequence number of the store when the txn began
+    size_t version_ = 0;
+
+    // snapshot read by a read txn, shared with its forks
+    std::shared_ptr<const rocksdb::Snapshot> snapshot_;
+    // the rocksdb transaction of a write txn
+    std::unique_ptr<rocksdb::Transaction> txn_;
+    // held by an exclusive write txn until it ends
+    std::unique_lock<std::mutex> writer_lock_;
+    // number of writes made so far, an iterator seeks again if it changed since it moved
+    size_t n_writes_ = 0;
+    // tables created by this txn, dropped if it aborts, since creating a column family is not
+    // part of a rocksdb transaction
+    std::vector<std::string> created_tables_;
+    // tables deleted by this txn, their column families are dropped when it commits
+    std::vector<std::string> deleted_tables_;
+
+    // set if a KvWriteSetRecorder was installed when this write txn was created
+    KvWriteSetRecorder* recorder_ = nullptr;
+    std::unique_ptr<KvWriteSet> write_set_;
+
+    RocksDBKvTransaction() = default;
+
+    // options to read with, from the snapshot of the txn if it has one
+    rocksdb::ReadOptions GetReadOptions() const;
+
+    void ThrowIfReadOnly() const;
+
+ public:
+    DISABLE_COPY(RocksDBKvTransaction);
+
+    RocksDBKvTransaction(RocksDBKvStore& store, bool read_only, bool optimistic);
+
+    ~RocksDBKvTransaction() override;
+
+    /**
+     * Gets a fork of this transaction, which reads from the same snapshot. Can only be used in
+     * read transactions.
+     */
+    std::unique_ptr<KvTransaction> Fork() override;
+
+    bool IsReadOnly() const { return read_only_; }
+
+    bool IsOptimistic() const override { return optimistic_; }
+
+    /**
+     * Commits the transaction. Throws TxnConflict if a write of an optimistic transaction
+     * conflicts with another transaction. All KvIterators will be invalidated.
+     */
+    void Commit() override;
+
+    /**
+     * Aborts the transaction. All KvIterators will be invalidated.
+     */
+    void Abort() override;
+
+    bool IsValid() const override { return valid_; }
+
+    size_t TxnId() override;
+
+    int64_t LastOpId() const override;
+
+    KvWriteSet* GetWriteSet() override { return write_set_.get(); }
+};
+}  // namespace lgraph
+#endif
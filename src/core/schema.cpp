@@ -50,6 +50,7 @@ Schema::Schema(const Schema& rhs) {
     property_table_ = rhs.property_table_;
     composite_index_map = rhs.composite_index_map;
     vector_index_fields_ = rhs.vector_index_fields_;
+    column_fields_ = rhs.column_fields_;
 }
 
 Schema& Schema::operator=(const Schema& rhs) {
@@ -83,6 +84,7 @@ Schema& Schema::operator=(const Schema& rhs) {
     property_table_ = rhs.property_table_;
     composite_index_map = rhs.composite_index_map;
     vector_index_fields_ = rhs.vector_index_fields_;
+    column_fields_ = rhs.column_fields_;
     return *this;
 }
 
@@ -233,7 +235,7 @@ void Schema::AddVertexToIndex(KvTransaction& txn, VertexId vid, const Value& rec
             VertexIndex* index = fe->GetVertexIndex();
             FMA_ASSERT(index);
             // update field index
-            if (!index->Add(txn, prop, vid)) {
+            if (!index->Add(txn, prop, vid, GetVertexIndexIncluded(*index, record))) {
                 THROW_CODE(InputError,
                 "Failed to index vertex [{}] with field value [{}:{}]: index value already exists.",
                 vid, fe->Name(), fe->FieldToString(record));
@@ -243,6 +245,42 @@ void Schema::AddVertexToIndex(KvTransaction& txn, VertexId vid, const Value& rec
     }
 }
 
+Value Schema::GetVertexIndexIncluded(const VertexIndex& index, const Value& record) const {
+    if (index.GetIncludeFields().empty()) return Value();
+    std::string buf;
+    for (auto& name : index.GetIncludeFields()) {
+        auto* fe = TryGetFieldExtractor(name);
+        // blobs are never included
+        FieldData fd = GetField(record, name, [](const BlobManager::BlobKey&) { return Value(); });
+        if (!fe || fd.IsNull()) {
+            VertexIndex::AppendIncludedField(buf, FieldType::NUL, Value());
+        } else {
+            VertexIndex::AppendIncludedField(
+                buf, fe->Type(), field_data_helper::FieldDataToValueOfFieldType(fd, fe->Type()));
+        }
+    }
+    return Value(buf);
+}
+
+void Schema::UpdateVertexIndexIncluded(KvTransaction& txn, VertexId vid, const Value& old_record,
+                                       const Value& new_record) {
+    for (auto& idx : indexed_fields_) {
+        auto& fe = fields_[idx];
+        if (fe->Type() == FieldType::FLOAT_VECTOR) continue;
+        VertexIndex* index = fe->GetVertexIndex();
+        if (!index || !index->IsUnique() || index->GetIncludeFields().empty()) continue;
+        auto key = fe->GetConstRef(new_record);
+        if (key.Empty()) continue;
+        Value included = GetVertexIndexIncluded(*index, new_record);
+        // a moved key was added without the included fields
+        if (key == fe->GetConstRef(old_record) &&
+            included == GetVertexIndexIncluded(*index, old_record)) {
+            continue;
+        }
+        index->SetIncluded(txn, key, vid, included);
+    }
+}
+
 void Schema::AddVertexToCompositeIndex(lgraph::KvTransaction& txn, lgraph::VertexId vid,
                                        const lgraph::Value& record,
                                        std::vector<std::string>& created) {
@@ -403,6 +441,39 @@ void Schema::DeleteVectorIndex(KvTransaction& txn, VertexId vid, const Value& re
     }
 }
 
+void Schema::AddVertexToColumns(KvTransaction& txn, ColumnWriteBuffer& buffer, VertexId vid,
+                                const Value& record) {
+    for (auto& idx : column_fields_) {
+        auto& fe = fields_[idx];
+        if (fe->GetIsNull(record)) continue;
+        fe->GetColumnStore()->SetValue(txn, buffer, vid, fe->GetConstRef(record));
+    }
+}
+
+void Schema::UpdateVertexColumns(KvTransaction& txn, ColumnWriteBuffer& buffer, VertexId vid,
+                                 const Value& old_record, const Value& new_record) {
+    for (auto& idx : column_fields_) {
+        auto& fe = fields_[idx];
+        bool old_null = fe->GetIsNull(old_record);
+        if (fe->GetIsNull(new_record)) {
+            if (!old_null) fe->GetColumnStore()->DeleteValue(txn, buffer, vid);
+            continue;
+        }
+        Value v = fe->GetConstRef(new_record);
+        if (!old_null && v == fe->GetConstRef(old_record)) continue;
+        fe->GetColumnStore()->SetValue(txn, buffer, vid, v);
+    }
+}
+
+void Schema::DeleteVertexFromColumns(KvTransaction& txn, ColumnWriteBuffer& buffer, VertexId vid,
+                                     const Value& record) {
+    for (auto& idx : column_fields_) {
+        auto& fe = fields_[idx];
+        if (fe->GetIsNull(record)) continue;
+        fe->GetColumnStore()->DeleteValue(txn, buffer, vid);
+    }
+}
+
 FieldData Schema::GetFieldDataFromField(const _detail::FieldExtractorBase* extractor,
                                         const Value& record) const {
 #define _GET_COPY_AND_RETURN_FD(ft)                                                    \
@@ -516,54 +587,8 @@ void Schema::ParseAndSet(Value& record, const FieldData& data,
         GetFieldExtractorV1(extractor)->ParseAndSet(record, data);
         return;
     }
-    FieldId count = GetFieldExtractorV2(extractor)->GetRecordCount(record);
-    if (!extractor->DataInRecord(record)) {
-        Value new_prop = CreateEmptyRecord();
-        for (const auto& field : name_to_idx_) {
-            _detail::FieldExtractorV2* extr = GetFieldExtractorV2(GetFieldExtractor(field.first));
-            extr->SetIsNull(new_prop, extr->GetIsNull(record));
-            if (extr->IsFixedType()) {
-                if (extr->GetFieldId() >= count && extr->HasDefaultValue()) {
-                    if (extr->GetDefaultFieldData() == FieldData()) {
-                        extr->SetIsNull(new_prop, true);
-                        continue;
-                    }
-                    SetFixedSizeValue(new_prop,
-                                      field_data_helper::FieldDataToValueOfFieldType(
-                                          extr->GetDefaultFieldData(), extr->Type()),
-                                      extr);
-                    extr->SetIsNull(new_prop, false);
-                } else if (extr->GetFieldId() < count) {
-                    if (extr->GetIsNull(record)) {
-                        extr->SetIsNull(new_prop, true);
-                        continue;
-                    }
-                    SetFixedSizeValue(new_prop, extr->GetConstRef(record), extr);
-                    extr->SetIsNull(new_prop, false);
-                }
-            } else {
-                if (extr->GetFieldId() >= count && extr->HasDefaultValue()) {
-                    if (extr->GetDefaultFieldData() == FieldData()) {
-                        extr->SetIsNull(new_prop, true);
-                        continue;
-                    }
-                    _SetVariableLengthValue(new_prop,
-                                            field_data_helper::FieldDataToValueOfFieldType(
-                                                extr->GetDefaultFieldData(), extr->Type()),
-                                            extr);
-                    extr->SetIsNull(new_prop, false);
-                } else if (extr->GetFieldId() < count) {
-                    if (extr->GetIsNull(record)) {
-                        extr->SetIsNull(new_prop, true);
-                        continue;
-                    }
-                    _SetVariableLengthValue(new_prop, extr->GetConstRef(record), extr);
-                    extr->SetIsNull(new_prop, false);
-                }
-            }
-        }
-        record = new_prop;
-    }
+    // the field was added after the record was written, bring the record up to date first
+    if (!extractor->DataInRecord(record)) record = UpgradeRecord(record);
 
     bool data_is_null = data.type == FieldType::NUL;
     extractor->SetIsNull(record, data_is_null);
@@ -679,6 +704,51 @@ void Schema::ParseAndSet(Value& record, const FieldData& data,
     }
 }
 
+bool Schema::RecordNeedsUpgrade(const Value& record) const {
+    if (!fast_alter_schema || name_to_idx_.empty()) return false;
+    // any live extractor knows where the count and offsets are
+    auto* extr = GetFieldExtractorV2(fields_[name_to_idx_.begin()->second].get());
+    if (extr->GetRecordCount(record) != fields_.size()) return true;
+    // a field deleted or modified after the record was written still takes its old size
+    for (auto& f : fields_) {
+        size_t expected = f->IsDeleted()     ? 0
+                          : f->IsFixedType() ? f->TypeSize()
+                                             : sizeof(DataOffset);
+        if (extr->GetFixedAreaSize(record, f->GetFieldId()) != expected) return true;
+    }
+    return false;
+}
+
+Value Schema::UpgradeRecord(const Value& record) const {
+    FMA_DBG_ASSERT(fast_alter_schema);
+    Value new_prop = CreateEmptyRecord(record.Size());
+    for (const auto& field : name_to_idx_) {
+        _detail::FieldExtractorV2* extr = GetFieldExtractorV2(fields_[field.second].get());
+        if (!extr->DataInRecord(record)) {
+            // added after the record was written, use the default value if there is one
+            if (!extr->HasDefaultValue() || extr->GetDefaultFieldData() == FieldData()) continue;
+            Value v = field_data_helper::FieldDataToValueOfFieldType(extr->GetDefaultFieldData(),
+                                                                     extr->Type());
+            if (extr->IsFixedType()) {
+                SetFixedSizeValue(new_prop, v, extr);
+            } else {
+                _SetVariableLengthValue(new_prop, v, extr);
+            }
+            extr->SetIsNull(new_prop, false);
+            continue;
+        }
+        if (extr->GetIsNull(record)) continue;
+        // fixed-length data of a modified field is converted to its new type here
+        if (extr->IsFixedType()) {
+            SetFixedSizeValue(new_prop, extr->GetConstRef(record), extr);
+        } else {
+            _SetVariableLengthValue(new_prop, extr->GetConstRef(record), extr);
+        }
+        extr->SetIsNull(new_prop, false);
+    }
+    return new_prop;
+}
+
 template <FieldType FT>
 void Schema::_ParseStringAndSet(Value& record, const std::string& data,
                                 ::lgraph::_detail::FieldExtractorBase* extractor) const {
@@ -790,6 +860,7 @@ void Schema::ParseAndSet(Value& record, const std::string& data,
         GetFieldExtractorV1(extractor)->ParseAndSet(record, data);
         return;
     }
+    if (!extractor->DataInRecord(record)) record = UpgradeRecord(record);
     if (data.empty() &&
         (extractor->IsFixedType() || extractor->Type() == FieldType::LINESTRING ||
          extractor->Type() == FieldType::POLYGON || extractor->Type() == FieldType::SPATIAL ||
@@ -919,7 +990,7 @@ void Schema::SetFixedSizeValue(Value& record, const Value& data,
 #define _SET_FIXED_FIELD(ft)                                                       \
     do {                                                                           \
         typename field_data_helper::FieldType2StorageType<FieldType::ft>::type sd; \
-        extractor->ConvertData(&sd, data.Data(), sizeof(sd));                      \
+        extractor->ConvertData(&sd, data.Data(), data.Size());                     \
         memcpy(ptr, &sd, sizeof(sd));                                              \
     } while (0)
     FMA_DBG_ASSERT(extractor->IsFixedType());
@@ -1026,6 +1097,12 @@ void Schema::RefreshLayout() {
         if (!f->FullTextIndexed()) continue;
         fulltext_fields_.emplace(f->GetFieldId());
     }
+
+    column_fields_.clear();
+    for (auto& f : fields_) {
+        if (!f->GetColumnStore() || f->IsDeleted()) continue;
+        column_fields_.emplace(f->GetFieldId());
+    }
 }
 
 void Schema::RefreshLayoutForFastSchema() {
@@ -1063,6 +1140,12 @@ void Schema::RefreshLayoutForFastSchema() {
         if (!f->FullTextIndexed()) continue;
         fulltext_fields_.emplace(f->GetFieldId());
     }
+
+    column_fields_.clear();
+    for (auto& f : fields_) {
+        if (!f->GetColumnStore() || f->IsDeleted()) continue;
+        column_fields_.emplace(f->GetFieldId());
+    }
 }
 
 /**
@@ -1147,8 +1230,10 @@ Value Schema::CreateEmptyRecord(size_t size_hint) const {
         }
 
         // the latest offset marks the end of the fixed-area.
-        data_offset += fields_[num_fields - 1]->IsFixedType() ? fields_[num_fields - 1]->TypeSize()
-                                                              : sizeof(DataOffset);
+        const auto& last_field = fields_[num_fields - 1];
+        data_offset += last_field->IsDeleted()     ? 0
+                       : last_field->IsFixedType() ? last_field->TypeSize()
+                                                   : sizeof(DataOffset);
         ::lgraph::_detail::UnalignedSet<DataOffset>(offset_ptr, data_offset);
 
         // 5. Set variable fields offset. They are stored at fixed-area, and their sizes are all
@@ -1260,6 +1345,7 @@ void Schema::ClearFields() {
     n_nullable_ = 0;
     v_offset_start_ = 0;
     indexed_fields_.clear();
+    column_fields_.clear();
     blob_fields_.clear();
     primary_field_.clear();
     edge_constraints_.clear();
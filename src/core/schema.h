@@ -122,6 +122,7 @@ class Schema {
     std::shared_ptr<KvTable> property_table_;
     std::unordered_map<std::string, std::shared_ptr<CompositeIndex>> composite_index_map;
     std::unordered_set<size_t> vector_index_fields_;
+    std::unordered_set<size_t> column_fields_;
 
     void SetStoreLabelInRecord(bool b) { label_in_record_ = b; }
 
@@ -466,6 +467,18 @@ class Schema {
         return prop;
     }
 
+    // Records of a fast alter schema are not rewritten when the schema changes. They keep the
+    // field count, field sizes and deleted fields they were written with and are decoded
+    // against the current schema, see FieldExtractorV2.
+    // Returns whether the record is laid out differently from the records created now, so it
+    // should be rewritten with UpgradeRecord(). Always false if fast_alter_schema is false.
+    bool RecordNeedsUpgrade(const Value& record) const;
+
+    // Rewrites the record in the current layout: fields added since it was written get their
+    // default values, modified fields are converted to their new types and the data of deleted
+    // fields is dropped.
+    Value UpgradeRecord(const Value& record) const;
+
     // --------------------
     void ParseAndSet(Value& record, const FieldData& data,
                               _detail::FieldExtractorBase* extractor) const;
@@ -479,6 +492,7 @@ class Schema {
         if (!fast_alter_schema) {
             return GetFieldExtractorV1(extr)->ParseAndSetBlob(record, data, store_blob);
         }
+        if (!extr->DataInRecord(record)) record = UpgradeRecord(record);
         bool is_null;
         Value v = extr->ParseBlob(data, is_null);
         extr->SetIsNull(record, is_null);
@@ -597,6 +611,22 @@ class Schema {
         return fields_[field_idx]->GetVectorIndex() == nullptr;
     }
 
+    bool HasVectorIndex() const { return !vector_index_fields_.empty(); }
+
+    void MarkColumnStored(size_t field_idx, ColumnStore* column_store) {
+        FMA_DBG_ASSERT(field_idx < fields_.size());
+        column_fields_.insert(field_idx);
+        fields_[field_idx]->SetColumnStore(column_store);
+    }
+
+    void UnColumnStore(size_t field_idx) {
+        FMA_DBG_ASSERT(field_idx < fields_.size());
+        column_fields_.erase(field_idx);
+        fields_[field_idx]->SetColumnStore(nullptr);
+    }
+
+    const std::unordered_set<size_t>& GetColumnFields() const { return column_fields_; }
+
     void UnVertexIndex(size_t field_idx) {
         FMA_DBG_ASSERT(field_idx < fields_.size());
         indexed_fields_.erase(field_idx);
@@ -658,6 +688,16 @@ class Schema {
     void AddVertexToIndex(KvTransaction& txn, VertexId vid, const Value& record,
                           std::vector<size_t>& created);
 
+    /** Gets the fields of record included in a unique vertex index. */
+    Value GetVertexIndexIncluded(const VertexIndex& index, const Value& record) const;
+
+    /**
+     * Rewrites the included fields of the unique vertex indexes after the vertex
+     * at `vid` changed from old_record to new_record.
+     */
+    void UpdateVertexIndexIncluded(KvTransaction& txn, VertexId vid, const Value& old_record,
+                                   const Value& new_record);
+
     void AddVertexToCompositeIndex(KvTransaction& txn, VertexId vid, const Value& record,
                           std::vector<std::string >& created);
     bool VertexUniqueIndexConflict(KvTransaction& txn, const Value& record);
@@ -669,6 +709,16 @@ class Schema {
 
     void DeleteVectorIndex(KvTransaction& txn, VertexId vid, const Value& record);
 
+    void AddVertexToColumns(KvTransaction& txn, ColumnWriteBuffer& buffer, VertexId vid,
+                            const Value& record);
+
+    /** Writes the columns whose values changed from old_record to new_record. */
+    void UpdateVertexColumns(KvTransaction& txn, ColumnWriteBuffer& buffer, VertexId vid,
+                             const Value& old_record, const Value& new_record);
+
+    void DeleteVertexFromColumns(KvTransaction& txn, ColumnWriteBuffer& buffer, VertexId vid,
+                                 const Value& record);
+
     void AddVertexToFullTextIndex(VertexId vid, const Value& record,
                                   std::vector<FTIndexEntry>& buffers);
     void AddEdgeToFullTextIndex(EdgeUid euid, const Value& record,
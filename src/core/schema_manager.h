@@ -131,6 +131,13 @@ class SchemaManager {
 
     size_t GetNumLabels() const { return name_to_idx_.size(); }
 
+    bool HasVectorIndex() const {
+        for (auto& s : schemas_) {
+            if (s.HasVectorIndex()) return true;
+        }
+        return false;
+    }
+
     std::vector<const std::string*> GetAllLabelPtrs() const {
         std::vector<const std::string*> lbs;
         lbs.reserve(schemas_.size());
@@ -377,6 +384,17 @@ class SchemaManager {
         return indexes;
     }
 
+    /** Lists the (label, field) of the vertex fields kept in a column store. */
+    std::vector<std::pair<std::string, std::string>> ListVertexColumns() const {
+        std::vector<std::pair<std::string, std::string>> columns;
+        for (auto& schema : schemas_) {
+            for (auto& fid : schema.GetColumnFields()) {
+                columns.emplace_back(schema.GetLabel(), schema.GetFieldExtractor(fid)->Name());
+            }
+        }
+        return columns;
+    }
+
     std::vector<CompositeIndexSpec> ListVertexCompositeIndexes() const {
         std::vector<CompositeIndexSpec> indexes;
         for (auto& schema : schemas_) {
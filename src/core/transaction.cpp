@@ -16,6 +16,7 @@
 #include "core/data_type.h"
 #include "core/field_data_helper.h"
 #include "core/index_manager.h"
+#include "core/kv_write_set.h"
 #include "core/lightning_graph.h"
 #include "core/transaction.h"
 
@@ -34,6 +35,10 @@ std::vector<CompositeIndexSpec> Transaction::ListVertexCompositeIndexes() {
     return curr_schema_->v_schema_manager.ListVertexCompositeIndexes();
 }
 
+std::vector<std::pair<std::string, std::string>> Transaction::ListVertexColumns() {
+    return curr_schema_->v_schema_manager.ListVertexColumns();
+}
+
 std::vector<IndexSpec> Transaction::ListVertexIndexByLabel(const std::string& label) {
     return curr_schema_->v_schema_manager.ListIndexByLabel(label);
 }
@@ -98,6 +103,21 @@ VectorIndex* Transaction::GetVertexVectorIndex(const std::string& label, const s
     return ret;
 }
 
+ColumnStore* Transaction::GetVertexColumnStore(const std::string& label,
+                                               const std::string& field) {
+    auto s = curr_schema_->v_schema_manager.GetSchema(label);
+    if (!s) {
+        THROW_CODE(LabelNotExist, "No such vertex label:{}", label);
+    }
+    auto ret = s->GetFieldExtractor(field)->GetColumnStore();
+    if (!ret) {
+        THROW_CODE(InputError, "No such vertex column, {}:{}", label, field);
+    }
+    // the column is read through the kv txn, which must see the writes of this txn
+    if (!column_buffer_.Empty()) column_buffer_.Flush(*txn_);
+    return ret;
+}
+
 /**
  * Check if index is ready.
  *
@@ -146,6 +166,11 @@ Transaction::Transaction(bool read_only, bool optimistic, LightningGraph* db)
         txn_ = db->store_->CreateWriteTxn(optimistic);
     }
     curr_schema_ = managed_schema_ptr_.Get();
+    // fulltext and vector indexes are updated outside of the kv store
+    auto write_set = txn_->GetWriteSet();
+    if (write_set && (fulltext_index_ || curr_schema_->v_schema_manager.HasVectorIndex())) {
+        write_set->MarkUnreplicable("graph has fulltext or vector indexes");
+    }
 }
 
 Transaction::Transaction(LightningGraph* db, KvTransaction& txn)
@@ -184,7 +209,8 @@ void DeleteBlobs(const Value& prop, Schema* schema, BlobManager* bm, KvTransacti
 }
 
 Transaction::Transaction(Transaction&& rhs)
-    : txn_(std::move(rhs.txn_)),
+    : snapshot_db_(std::move(rhs.snapshot_db_)),
+      txn_(std::move(rhs.txn_)),
       read_only_(rhs.read_only_),
       db_(rhs.db_),
       managed_schema_ptr_(std::move(rhs.managed_schema_ptr_)),
@@ -194,6 +220,7 @@ Transaction::Transaction(Transaction&& rhs)
       blob_manager_(rhs.blob_manager_),
       fulltext_index_(rhs.fulltext_index_),
       fulltext_buffers_(std::move(rhs.fulltext_buffers_)),
+      column_buffer_(std::move(rhs.column_buffer_)),
       vertex_delta_count_(std::move(rhs.vertex_delta_count_)),
       edge_delta_count_(std::move(rhs.edge_delta_count_)) {
     // Non-empty transactions should not be moved.
@@ -218,8 +245,11 @@ Transaction& Transaction::operator=(Transaction&& rhs) {
     blob_manager_ = rhs.blob_manager_;
     fulltext_index_ = rhs.fulltext_index_;
     fulltext_buffers_ = std::move(rhs.fulltext_buffers_);
+    column_buffer_ = std::move(rhs.column_buffer_);
     vertex_delta_count_ = std::move(rhs.vertex_delta_count_);
     edge_delta_count_ = std::move(rhs.edge_delta_count_);
+    // released after the txn it was read by
+    snapshot_db_ = std::move(rhs.snapshot_db_);
     return *this;
 }
 
@@ -362,6 +392,7 @@ void Transaction::CommitFullTextIndex() {
 void Transaction::Commit() {
     if (!IsValid()) return;
     CloseAllIterators();
+    column_buffer_.Flush(*txn_);
     if (db_->GetConfig().enable_realtime_count && !txn_->IsOptimistic()) {
         for (const auto& pair : vertex_delta_count_) {
             graph_->IncreaseCount(*txn_, true, pair.first, pair.second);
@@ -395,6 +426,7 @@ void Transaction::Commit() {
 void Transaction::Abort() {
     if (!IsValid()) return;
     CloseAllIterators();
+    column_buffer_.Clear();
     txn_->Abort();
     txn_.reset();
     managed_schema_ptr_.Release();
@@ -419,6 +451,7 @@ void Transaction::DeleteVertex(graph::VertexIterator& it, size_t* n_in, size_t*
     schema->DeleteVertexIndex(*txn_, vid, prop);
     schema->DeleteVertexCompositeIndex(*txn_, vid, prop);
     schema->DeleteVectorIndex(*txn_, vid, prop);
+    schema->DeleteVertexFromColumns(*txn_, column_buffer_, vid, prop);
     auto on_edge_deleted = [&](bool is_out_edge, const graph::EdgeValue& edge_value){
         if (is_out_edge) {
             if (n_out) {
@@ -593,7 +626,8 @@ CompositeIndex* Transaction::GetVertexCompositeIndex(const size_t& label,
 VertexIndexIterator Transaction::GetVertexIndexIterator(const std::string& label,
                                                         const std::string& field,
                                                         const FieldData& key_start,
-                                                        const FieldData& key_end) {
+                                                        const FieldData& key_end,
+                                                        bool reverse) {
     VertexIndex* index = GetVertexIndex(label, field);
     if (!index || !index->IsReady()) {
         THROW_CODE(InputError, "VertexIndex is not created for {}:{}", label, field);
@@ -605,12 +639,13 @@ VertexIndexIterator Transaction::GetVertexIndexIterator(const std::string& label
     if (!key_end.IsNull()) {
         ke = field_data_helper::FieldDataToValueOfFieldType(key_end, index->KeyType());
     }
-    return index->GetIterator(this, std::move(ks), std::move(ke), 0);
+    return index->GetIterator(this, std::move(ks), std::move(ke), 0, reverse);
 }
 
 VertexIndexIterator Transaction::GetVertexIndexIterator(size_t label_id, size_t field_id,
                                                         const FieldData& key_start,
-                                                        const FieldData& key_end) {
+                                                        const FieldData& key_end,
+                                                        bool reverse) {
     VertexIndex* index = GetVertexIndex(label_id, field_id);
     if (!index || !index->IsReady()) {
         THROW_CODE(InputError, "VertexIndex is not created for this field");
@@ -622,7 +657,7 @@ VertexIndexIterator Transaction::GetVertexIndexIterator(size_t label_id, size_t
     if (!key_end.IsNull()) {
         ke = field_data_helper::FieldDataToValueOfFieldType(key_end, index->KeyType());
     }
-    return index->GetIterator(this, std::move(ks), std::move(ke), 0);
+    return index->GetIterator(this, std::move(ks), std::move(ke), 0, reverse);
 }
 
 VertexIndexIterator Transaction::GetVertexIndexIterator(const std::string& label,
@@ -867,6 +902,7 @@ std::string Transaction::_OnlineImportBatchAddVertexes(
         // do index
         std::vector<size_t> created_index;
         schema->AddVertexToIndex(*txn_, newvid, v, created_index);
+        schema->AddVertexToColumns(*txn_, column_buffer_, newvid, v);
         count++;
         // add fulltext index
         if (fulltext_index_) {
@@ -944,6 +980,8 @@ Transaction::SetVertexProperty(VertexIterator& it, size_t n_fields, const FieldT
     }
     Value new_prop;
     new_prop.Copy(old_prop);
+    // records left behind by fast alters are brought up to date on their next write
+    if (schema->RecordNeedsUpgrade(new_prop)) new_prop = schema->UpgradeRecord(new_prop);
     for (size_t i = 0; i < n_fields; i++) {
         // TODO: use SetField like SetEdgeProperty // NOLINT
         _detail::FieldExtractorBase* fe = schema->GetFieldExtractor(fields[i]);
@@ -1030,6 +1068,8 @@ Transaction::SetVertexProperty(VertexIterator& it, size_t n_fields, const FieldT
             }
         }
     }
+    schema->UpdateVertexIndexIncluded(*txn_, vid, old_prop, new_prop);
+    schema->UpdateVertexColumns(*txn_, column_buffer_, vid, old_prop, new_prop);
     if (fulltext_index_) {
         // fulltext
         schema->DeleteVertexFullTextIndex(vid, fulltext_buffers_);
@@ -1175,6 +1215,8 @@ Transaction::SetEdgeProperty(EIT& it, size_t n_fields, const FieldT* fields, con
     }
     Value new_prop;
     new_prop.Copy(old_prop);
+    // records left behind by fast alters are brought up to date on their next write
+    if (schema->RecordNeedsUpgrade(new_prop)) new_prop = schema->UpgradeRecord(new_prop);
     for (size_t i = 0; i < n_fields; i++) {
         auto fe = schema->GetFieldExtractor(fields[i]);
         if (fe->Type() == FieldType::BLOB) {
@@ -1360,6 +1402,7 @@ Transaction::AddVertex(const LabelT& label, size_t n_fields, const FieldT* field
     schema->AddVertexToIndex(*txn_, newvid, prop, created_index);
     schema->AddVertexToCompositeIndex(*txn_, newvid, prop, created_composite_index);
     schema->AddVectorToVectorIndex(*txn_, newvid, prop);
+    schema->AddVertexToColumns(*txn_, column_buffer_, newvid, prop);
     if (schema->DetachProperty()) {
         schema->AddDetachedVertexProperty(*txn_, newvid, prop);
     }
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "fma-common/type_traits.h"
 
 #include "core/blob_manager.h"
@@ -45,9 +47,32 @@ namespace import_v3 {
 class Importer;
 }  // namespace import_v3
 
+/**
+ * A number no other SchemaVersion of the process had. Copies get a new
+ * number too, since a schema is changed by copying and modifying it.
+ */
+struct SchemaVersion {
+    uint64_t value = Next();
+
+    SchemaVersion() = default;
+    SchemaVersion(const SchemaVersion&) {}
+    SchemaVersion& operator=(const SchemaVersion&) {
+        value = Next();
+        return *this;
+    }
+
+ private:
+    static uint64_t Next() {
+        static std::atomic<uint64_t> next(1);
+        return next++;
+    }
+};
+
 struct SchemaInfo {
     SchemaManager v_schema_manager;
     SchemaManager e_schema_manager;
+    // changes whenever the schema, the indexes included, may have changed
+    SchemaVersion version;
 };
 
 #define ENABLE_IF_EIT(EIT, RT)                                                   \
@@ -68,6 +93,9 @@ class Transaction {
     friend class ::lgraph::import_v2::ImportOnline;
     friend class ::lgraph::import_v3::Importer;
 
+    // set if db_ is a point-in-time copy, which lives as long as the txns reading it, declared
+    // first so that it is released after everything else
+    std::shared_ptr<LightningGraph> snapshot_db_;
     std::unique_ptr<KvTransaction> txn_;
     bool read_only_ = false;
 
@@ -82,6 +110,7 @@ class Transaction {
     FullTextIndex* fulltext_index_;
     std::vector<FTIndexEntry> fulltext_buffers_;
     std::vector<VectorIndexEntry> vector_buffers_;
+    ColumnWriteBuffer column_buffer_;
     std::unordered_map<LabelId, int64_t> vertex_delta_count_;
     std::unordered_map<LabelId, int64_t> edge_delta_count_;
     std::set<LabelId> vertex_label_delete_;
@@ -886,6 +915,12 @@ class Transaction {
 
     VectorIndex* GetVertexVectorIndex(const std::string& label, const std::string& field);
 
+    /** Lists the (label, field) of the vertex fields kept in a column store. */
+    std::vector<std::pair<std::string, std::string>> ListVertexColumns();
+
+    /** Gets the column store of the vertex field 'label:field', throws if there is none. */
+    ColumnStore* GetVertexColumnStore(const std::string& label, const std::string& field);
+
     /**
      * Check if index is ready.
      *
@@ -905,16 +940,19 @@ class Transaction {
      * \param   field       The field.
      * \param   key_start   The key start.
      * \param   key_end     The key end, inclusive.
+     * \param   reverse     Iterate from key_end down to key_start.
      *
      * \return  The index iterator.
      */
     VertexIndexIterator GetVertexIndexIterator(const std::string& label, const std::string& field,
                                                const FieldData& key_start = FieldData(),
-                                               const FieldData& key_end = FieldData());
+                                               const FieldData& key_end = FieldData(),
+                                               bool reverse = false);
 
     VertexIndexIterator GetVertexIndexIterator(size_t label_id, size_t field_id,
                                                const FieldData& key_start = FieldData(),
-                                               const FieldData& key_end = FieldData());
+                                               const FieldData& key_end = FieldData(),
+                                               bool reverse = false);
 
     /**
      * Gets index iterator. The iterator has field value [key_start, key_end].
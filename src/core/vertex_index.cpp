@@ -12,6 +12,8 @@
  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
  */
 
+#include <algorithm>
+
 #include "core/vertex_index.h"
 #include "core/transaction.h"
 
@@ -136,7 +138,7 @@ Value VertexIndexValue::CreateKey(const Value& key) const {
 
 VertexIndexIterator::VertexIndexIterator(VertexIndex* idx, Transaction* txn, KvTable& table,
                                          const Value& key_start, const Value& key_end, VertexId vid,
-                                         IndexType type)
+                                         IndexType type, bool reverse)
     : IteratorBase(txn),
       index_(idx),
       it_(table.GetClosestIterator(txn->GetTxn(), type == IndexType::GlobalUniqueIndex
@@ -147,10 +149,17 @@ VertexIndexIterator::VertexIndexIterator(VertexIndex* idx, Transaction* txn, KvT
       iv_(),
       valid_(false),
       pos_(0),
-      type_(type) {
+      type_(type),
+      reverse_(reverse) {
     if (type == IndexType::PairUniqueIndex) {
         return;
     }
+    if (reverse_) {
+        key_start_ = type == IndexType::GlobalUniqueIndex ? Value::MakeCopy(key_start)
+                                                          : _detail::PatchKeyWithVid(key_start, 0);
+        SeekLast();
+        return;
+    }
     if (!it_->IsValid() || KeyOutOfRange()) {
         return;
     }
@@ -170,7 +179,8 @@ VertexIndexIterator::VertexIndexIterator(VertexIndex* idx, KvTransaction* txn, K
       iv_(),
       valid_(false),
       pos_(0),
-      type_(type) {
+      type_(type),
+      reverse_(false) {
     if (type == IndexType::PairUniqueIndex) {
         return;
     }
@@ -185,13 +195,16 @@ VertexIndexIterator::VertexIndexIterator(VertexIndexIterator&& rhs)
     : IteratorBase(std::move(rhs)),
       index_(rhs.index_),
       it_(std::move(rhs.it_)),
+      key_start_(std::move(rhs.key_start_)),
       key_end_(std::move(rhs.key_end_)),
       curr_key_(std::move(rhs.curr_key_)),
       iv_(std::move(rhs.iv_)),
       valid_(rhs.valid_),
       pos_(rhs.pos_),
       vid_(rhs.vid_),
-      type_(rhs.type_) {
+      type_(rhs.type_),
+      reverse_(rhs.reverse_),
+      included_(std::move(rhs.included_)) {
     rhs.valid_ = false;
 }
 
@@ -202,6 +215,28 @@ bool VertexIndexIterator::KeyOutOfRange() {
     return it_->GetTable().CompareKey(it_->GetTxn(), it_->GetKey(), key_end_) > 0;
 }
 
+bool VertexIndexIterator::KeyBeforeStart() {
+    if (key_start_.Empty() ||
+        (type_ != IndexType::GlobalUniqueIndex && key_start_.Size() == _detail::VID_SIZE))
+        return false;
+    return it_->GetTable().CompareKey(it_->GetTxn(), it_->GetKey(), key_start_) < 0;
+}
+
+void VertexIndexIterator::SeekLast() {
+    valid_ = false;
+    if (key_end_.Empty() ||
+        (type_ != IndexType::GlobalUniqueIndex && key_end_.Size() == _detail::VID_SIZE)) {
+        if (!it_->GotoLastKey()) return;
+    } else if (!it_->GotoClosestKey(key_end_)) {
+        // every key is smaller than key_end
+        if (!it_->GotoLastKey()) return;
+    } else if (KeyOutOfRange() && !it_->Prev()) {
+        return;
+    }
+    if (KeyBeforeStart()) return;
+    LoadContentFromIt();
+}
+
 bool VertexIndexIterator::PrevKV() {
     if (!it_->Prev()) {
         return false;
@@ -231,12 +266,21 @@ void VertexIndexIterator::LoadContentFromIt() {
     switch (type_) {
     case IndexType::GlobalUniqueIndex:
         {
-            vid_ = _detail::GetVid(it_->GetValue().Data());
+            Value v = it_->GetValue();
+            vid_ = _detail::GetVid(v.Data());
+            included_.Clear();
+            // entries written for another list of included fields are ignored
+            const size_t header = sizeof(int64_t) + sizeof(uint32_t);
+            if (!index_->include_fields_.empty() && v.Size() >= header &&
+                memcmp(v.Data() + sizeof(int64_t), &index_->include_sig_, sizeof(uint32_t)) == 0) {
+                included_.Copy(v.Data() + header, v.Size() - header);
+            }
             break;
         }
     case IndexType::NonuniqueIndex:
         {
             iv_ = VertexIndexValue(it_->GetValue());
+            if (reverse_) pos_ = iv_.GetVidCount() - 1;
             vid_ = iv_.GetNthVid(pos_);
             break;
         }
@@ -253,6 +297,19 @@ void VertexIndexIterator::CloseImpl() {
 }
 
 bool VertexIndexIterator::Next() {
+    if (reverse_) {
+        if (type_ != IndexType::GlobalUniqueIndex && pos_ > 0) {
+            pos_ -= 1;
+            vid_ = iv_.GetNthVid(pos_);
+            return true;
+        }
+        valid_ = false;
+        if (!it_->Prev() || KeyBeforeStart()) {
+            return false;
+        }
+        LoadContentFromIt();
+        return true;
+    }
     // if we haven't reach the end of the current VertexIndexValue,
     // just move forward
     if (type_ != IndexType::GlobalUniqueIndex && pos_ < iv_.GetVidCount() - 1) {
@@ -299,6 +356,52 @@ Value VertexIndexIterator::GetKey() const {
 
 FieldType VertexIndexIterator::KeyType() const { return index_->KeyType(); }
 
+bool VertexIndexIterator::Seek(const Value& k) {
+    FMA_DBG_ASSERT(!reverse_ && type_ != IndexType::PairUniqueIndex);
+    valid_ = false;
+    Value key = index_->CutKeyIfLongOnlyForNonUniqueIndex(k);
+    bool found;
+    if (type_ == IndexType::GlobalUniqueIndex) {
+        key_end_.Copy(key);
+        found = it_->GotoClosestKey(key);
+    } else {
+        key_end_ = _detail::PatchKeyWithVid(key, -1);
+        found = it_->GotoClosestKey(_detail::PatchKeyWithVid(key, 0));
+    }
+    if (!found || KeyOutOfRange()) return false;
+    LoadContentFromIt();
+    return true;
+}
+
+bool VertexIndexIterator::KeyIsComplete() const {
+    return type_ == IndexType::GlobalUniqueIndex || index_->KeyType() != FieldType::STRING ||
+           curr_key_.Size() < index_->GetMaxVertexIndexKeySize();
+}
+
+bool VertexIndexIterator::GetIncludedField(const std::string& field, FieldData& fd) const {
+    auto& fields = index_->include_fields_;
+    if (included_.Empty()) return false;
+    auto fit = std::find(fields.begin(), fields.end(), field);
+    if (fit == fields.end()) return false;
+    const char* p = included_.Data();
+    const char* end = p + included_.Size();
+    for (size_t i = 0;; i++) {
+        if (end - p < (ptrdiff_t)(sizeof(uint8_t) + sizeof(uint32_t))) return false;
+        auto ft = static_cast<FieldType>(*(const uint8_t*)p);
+        uint32_t size;
+        memcpy(&size, p + sizeof(uint8_t), sizeof(uint32_t));
+        p += sizeof(uint8_t) + sizeof(uint32_t);
+        if (end - p < (ptrdiff_t)size) return false;
+        if (i == (size_t)(fit - fields.begin())) {
+            fd = ft == FieldType::NUL
+                     ? FieldData()
+                     : field_data_helper::ValueToFieldData(Value(p, size), ft);
+            return true;
+        }
+        p += size;
+    }
+}
+
 void VertexIndexIterator::RefreshContentIfKvIteratorModified() {
     if (IsValid() && it_->IsValid() && it_->UnderlyingPointerModified()) {
         valid_ = false;
@@ -340,7 +443,51 @@ VertexIndex::VertexIndex(const VertexIndex& rhs)
       key_type_(rhs.key_type_),
       ready_(rhs.ready_.load()),
       disabled_(rhs.disabled_.load()),
-      type_(rhs.type_) {}
+      type_(rhs.type_),
+      include_fields_(rhs.include_fields_),
+      include_sig_(rhs.include_sig_) {}
+
+void VertexIndex::AppendIncludedField(std::string& buf, FieldType ft, const Value& v) {
+    uint32_t size = ft == FieldType::NUL ? 0 : static_cast<uint32_t>(v.Size());
+    buf.push_back(static_cast<char>(ft));
+    buf.append((const char*)&size, sizeof(size));
+    buf.append(v.Data(), size);
+}
+
+void VertexIndex::SetIncludeFields(std::vector<std::string> fields) {
+    include_fields_ = std::move(fields);
+    // FNV-1a of the field names
+    include_sig_ = 2166136261u;
+    for (auto& f : include_fields_) {
+        for (char c : f + '\0') include_sig_ = (include_sig_ ^ (uint8_t)c) * 16777619u;
+    }
+}
+
+Value VertexIndex::UniqueIndexValue(int64_t vid, const Value& included) const {
+    if (included.Empty()) return Value::MakeCopy(Value::ConstRef(vid));
+    Value v(sizeof(vid) + sizeof(include_sig_) + included.Size());
+    memcpy(v.Data(), &vid, sizeof(vid));
+    memcpy(v.Data() + sizeof(vid), &include_sig_, sizeof(include_sig_));
+    memcpy(v.Data() + sizeof(vid) + sizeof(include_sig_), included.Data(), included.Size());
+    return v;
+}
+
+bool VertexIndex::SetIncluded(KvTransaction& txn, const Value& k, int64_t vid,
+                              const Value& included) {
+    FMA_DBG_ASSERT(type_ == IndexType::GlobalUniqueIndex);
+    if (!table_->HasKey(txn, k)) return false;
+    return table_->SetValue(txn, k, UniqueIndexValue(vid, included), true);
+}
+
+void VertexIndex::RewriteIncluded(KvTransaction& txn,
+                                  const std::function<Value(VertexId)>& get_included) {
+    FMA_DBG_ASSERT(type_ == IndexType::GlobalUniqueIndex);
+    auto it = table_->GetIterator(txn);
+    for (it->GotoFirstKey(); it->IsValid(); it->Next()) {
+        VertexId vid = _detail::GetVid(it->GetValue().Data());
+        it->SetValue(UniqueIndexValue(vid, get_included(vid)));
+    }
+}
 
 std::unique_ptr<KvTable> VertexIndex::OpenTable(KvTransaction& txn, KvStore& store,
                                                 const std::string& name, FieldType dt,
@@ -460,11 +607,11 @@ bool VertexIndex::Delete(KvTransaction& txn, const Value& k, int64_t vid) {
 }
 
 bool VertexIndex::Update(KvTransaction& txn, const Value& old_key, const Value& new_key,
-                         int64_t vid) {
+                         int64_t vid, const Value& included) {
     if (!Delete(txn, old_key, vid)) {
         return false;
     }
-    return Add(txn, new_key, vid);
+    return Add(txn, new_key, vid, included);
 }
 
 bool VertexIndex::UniqueIndexConflict(KvTransaction& txn, const Value& k) {
@@ -478,13 +625,16 @@ bool VertexIndex::UniqueIndexConflict(KvTransaction& txn, const Value& k) {
     return table_->GetValue(txn, k, v);
 }
 
-bool VertexIndex::Add(KvTransaction& txn, const Value& k, int64_t vid) {
+bool VertexIndex::Add(KvTransaction& txn, const Value& k, int64_t vid, const Value& included) {
     switch (type_) {
     case IndexType::GlobalUniqueIndex:
         {
             if (k.Size() > GetMaxVertexIndexKeySize())
                 THROW_CODE(InputError, "Vertex unique index value [{}] is too long.", k.AsString());
-            return table_->AddKV(txn, Value::ConstRef(k), Value::ConstRef(vid));
+            if (included.Empty()) {
+                return table_->AddKV(txn, Value::ConstRef(k), Value::ConstRef(vid));
+            }
+            return table_->AddKV(txn, Value::ConstRef(k), UniqueIndexValue(vid, included));
         }
     case IndexType::NonuniqueIndex:
         {
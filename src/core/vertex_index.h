@@ -16,7 +16,10 @@
 
 #include <atomic>
 #include <exception>
+#include <functional>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "core/field_data_helper.h"
 #include "core/data_type.h"
@@ -29,6 +32,7 @@
 int TestVertexIndexImpl();
 int CURDVertexWithTooLongKey();
 int TestVRefreshContentIfKvIteratorModified();
+int TestVertexIndexSeek();
 
 namespace lgraph {
 class Transaction;
@@ -143,6 +147,7 @@ class VertexIndexIterator : public ::lgraph::IteratorBase {
 
     VertexIndex* index_;
     std::unique_ptr<KvIterator> it_;
+    Value key_start_;  // only kept by reverse iterators
     Value key_end_;
     Value curr_key_;  // current indexed key, excluding vid
     VertexIndexValue iv_;   // VertexIndexValue, if this is non-unique index
@@ -150,6 +155,8 @@ class VertexIndexIterator : public ::lgraph::IteratorBase {
     int pos_;
     VertexId vid_;  // current vid
     IndexType type_;
+    bool reverse_;  // iterate from key_end down to key_start
+    Value included_;  // included fields of the current entry, unique index only
 
     /**
      * The constructor for VertexIndexIterator
@@ -161,11 +168,13 @@ class VertexIndexIterator : public ::lgraph::IteratorBase {
      * \param           key_end     The end key.
      * \param           vid         The vid from which to start searching.
      * \param           type        The index type.
+     * \param           reverse     Iterate from key_end down to key_start, vid is
+     *                              ignored then.
      */
     VertexIndexIterator(VertexIndex* idx, Transaction* txn, KvTable& table,
                         const Value& key_start,
                         const Value& key_end,
-                        VertexId vid, IndexType type);
+                        VertexId vid, IndexType type, bool reverse = false);
 
     VertexIndexIterator(VertexIndex* idx, KvTransaction* txn, KvTable& table,
                         const Value& key_start,
@@ -174,6 +183,11 @@ class VertexIndexIterator : public ::lgraph::IteratorBase {
 
     bool KeyOutOfRange();
 
+    bool KeyBeforeStart();
+
+    /** Positions a reverse iterator at the last entry not greater than key_end. */
+    void SeekLast();
+
     /**
      * Traverse to the previous key/value pair. Used when an inserted vid is
      * greater than all existing vids. Should be used together with KeyEquals.
@@ -212,7 +226,8 @@ class VertexIndexIterator : public ::lgraph::IteratorBase {
 
     /**
      * Move to the next vertex id in the list, which consists of all the valid
-     * vertex ids of the iterator and is sorted from small to large.
+     * vertex ids of the iterator and is sorted from small to large, or from
+     * large to small for a reverse iterator.
      *
      * \return  True if it succeeds, otherwise false.
      */
@@ -220,6 +235,18 @@ class VertexIndexIterator : public ::lgraph::IteratorBase {
 
     bool Goto(VertexId vid);
 
+    /**
+     * Moves to the first vid under key, reusing the cursor of this iterator.
+     * Seeking the keys in ascending order keeps the cursor close to its last
+     * position, which makes a batch of lookups much cheaper than opening an
+     * iterator per key. Not supported by reverse iterators.
+     *
+     * \param   key     The key, raw format.
+     *
+     * \return  True if the key is found.
+     */
+    bool Seek(const Value& key);
+
     /**
      * Gets the current key.
      *
@@ -241,6 +268,21 @@ class VertexIndexIterator : public ::lgraph::IteratorBase {
 
     FieldType KeyType() const;
 
+    /**
+     * Whether the current key holds the whole field value. Long keys of a
+     * non-unique index are cut, and the vertex has to be read for them.
+     */
+    bool KeyIsComplete() const;
+
+    /**
+     * Gets a field included in the current entry of a unique index.
+     *
+     * \param       field   The field name.
+     * \param [out] fd      The field value.
+     * \return  False if the field is not included in this entry.
+     */
+    bool GetIncludedField(const std::string& field, FieldData& fd) const;
+
     /**
      * Determines if we can refresh content if kv iterator modified
      *
@@ -253,6 +295,7 @@ class VertexIndexIterator : public ::lgraph::IteratorBase {
  * The indices
  */
 class VertexIndex {
+    friend class VertexIndexIterator;
     friend class Schema;
     friend class IndexManager;
     friend class LightningGraph;
@@ -260,12 +303,17 @@ class VertexIndex {
     friend int ::TestVertexIndexImpl();
     friend int ::CURDVertexWithTooLongKey();
     friend int ::TestVRefreshContentIfKvIteratorModified();
+    friend int ::TestVertexIndexSeek();
 
     std::shared_ptr<KvTable> table_;
     FieldType key_type_;
     std::atomic<bool> ready_;
     std::atomic<bool> disabled_;
     IndexType type_;
+    // fields stored along with the vid, so that they can be read from the index
+    std::vector<std::string> include_fields_;
+    // hash of include_fields_, stored before the included fields of each entry
+    uint32_t include_sig_ = 0;
 
  public:
     VertexIndex(std::shared_ptr<KvTable> table, FieldType key_type, IndexType type);
@@ -361,12 +409,23 @@ class VertexIndex {
         auto d = field_data_helper::MinStoreValue<FieldType::ft>();         \
         return VertexIndexIterator(this, txn, *table_, Value::ConstRef(d),   \
                                    std::forward<V2>(key_end),               \
-                                   vid, type_);                           \
+                                   vid, type_, reverse);                  \
     } while (0)
 
+    /**
+     * Get an Vertex index iterator.
+     *
+     * \param [in,out]  txn         The transaction.
+     * \param           key_start   The start key.
+     * \param           key_end     The end key.
+     * \param           vid         The vid to start from.
+     * \param           reverse     Iterate from key_end down to key_start.
+     *
+     * \return  The index iterator.
+     */
     template <typename V1, typename V2>
     VertexIndexIterator GetIterator(Transaction* txn, V1&& key_start,
-                                    V2&& key_end, VertexId vid = 0) {
+                                    V2&& key_end, VertexId vid = 0, bool reverse = false) {
         if (key_start.Empty()) {
             switch (key_type_) {
             case FieldType::BOOL:
@@ -391,20 +450,20 @@ class VertexIndex {
                 {
                     return VertexIndexIterator(this, txn, *table_, std::forward<V1>(key_start),
                            CutKeyIfLongOnlyForNonUniqueIndex(std::forward<V2>(key_end)),
-                                               vid, type_);
+                                               vid, type_, reverse);
                 }
             case FieldType::BLOB:
                 FMA_ASSERT(false) << "Blob fields must not be indexed.";
             default:
                 FMA_ASSERT(false);
                 return VertexIndexIterator(this, txn, *table_, std::forward<V1>(key_start),
-                                     std::forward<V2>(key_end), vid, type_);
+                                     std::forward<V2>(key_end), vid, type_, reverse);
             }
         } else {
             return VertexIndexIterator(this, txn, *table_,
                    CutKeyIfLongOnlyForNonUniqueIndex(std::forward<V1>(key_start)),
                    CutKeyIfLongOnlyForNonUniqueIndex(std::forward<V2>(key_end)),
-                   vid, type_);
+                   vid, type_, reverse);
         }
     }
 
@@ -418,6 +477,16 @@ class VertexIndex {
 
     FieldType KeyType() { return key_type_; }
 
+    const std::vector<std::string>& GetIncludeFields() const { return include_fields_; }
+
+    /**
+     * Appends a field to the included fields of a unique index entry, which are
+     * stored as [int64 vid][uint32 signature of the field list][fields]. Each
+     * field is [uint8 type][uint32 size][data], with FieldType::NUL as the type
+     * of a null field.
+     */
+    static void AppendIncludedField(std::string& buf, FieldType ft, const Value& v);
+
     void Dump(KvTransaction& txn,
               const std::function<std::string(const char* p, size_t s)>& key_to_string);
 
@@ -434,6 +503,25 @@ class VertexIndex {
 
     bool IsDisabled() const { return disabled_.load(std::memory_order_acquire); }
 
+    void SetIncludeFields(std::vector<std::string> fields);
+
+    Value UniqueIndexValue(int64_t vid, const Value& included) const;
+
+    /**
+     * Replaces the included fields stored with the vid under a unique key.
+     *
+     * \param [in,out]  txn         The transaction.
+     * \param           k           The key.
+     * \param           vid         The vid.
+     * \param           included    The included fields, see AppendIncludedField.
+     *
+     * \return  False if the key is not in the index.
+     */
+    bool SetIncluded(KvTransaction& txn, const Value& k, int64_t vid, const Value& included);
+
+    /** Rewrites the included fields of all the entries of a unique index. */
+    void RewriteIncluded(KvTransaction& txn, const std::function<Value(VertexId)>& get_included);
+
     /**
      * Delete a specified vertex under a specified key.
      *
@@ -450,27 +538,30 @@ class VertexIndex {
      *
      * \exception   IndexException  Thrown when an VertexIndex error condition occurs.
      *
-     * \param [in,out]  txn     The transaction.
-     * \param           old_key The old key.
-     * \param           new_key The new key.
-     * \param           vid     The vid.
+     * \param [in,out]  txn         The transaction.
+     * \param           old_key     The old key.
+     * \param           new_key     The new key.
+     * \param           vid         The vid.
+     * \param           included    The included fields, unique index only.
      *
      * \return  Whether the operation succeeds or not.
      */
-    bool Update(KvTransaction& txn, const Value& old_key, const Value& new_key, int64_t vid);
+    bool Update(KvTransaction& txn, const Value& old_key, const Value& new_key, int64_t vid,
+                const Value& included = Value());
 
     /**
      * Add a specified vertex under a specified key.
      *
      * \exception   IndexException  Thrown when an VertexIndex error condition occurs.
      *
-     * \param [in,out]  txn The transaction.
-     * \param           k   The key.
-     * \param           vid The vid.
+     * \param [in,out]  txn         The transaction.
+     * \param           k           The key.
+     * \param           vid         The vid.
+     * \param           included    The included fields, unique index only.
      *
      * \return  Whether the operation succeeds or not.
      */
-    bool Add(KvTransaction& txn, const Value& k, int64_t vid);
+    bool Add(KvTransaction& txn, const Value& k, int64_t vid, const Value& included = Value());
 
     bool UniqueIndexConflict(KvTransaction& txn, const Value& k);
 
@@ -50,6 +50,8 @@ class AstExprEvaluator : public geax::frontend::AstExprNodeVisitorImpl {
 
     ~AstExprEvaluator() = default;
 
+    const SymbolTable* GetSymbolTable() const { return sym_tab_; }
+
     std::vector<geax::frontend::Expr*> agg_exprs_;
     std::vector<std::shared_ptr<AggCtx>> agg_ctxs_;
     size_t agg_pos_;
@@ -18,6 +18,8 @@
 
 #include <memory>
 #include <stack>
+#include <unordered_map>
+#include <unordered_set>
 #include "arithmetic/arithmetic_expression.h"
 #include "db/galaxy.h"
 
@@ -27,6 +29,7 @@
 #include "cypher/cypher_exception.h"
 #include "ops/ops.h"
 #include "monitor/memory_monitor_allocator.h"
+#include "optimization/cost_model.h"
 #include "optimization/pass_manager.h"
 #include "procedure/procedure.h"
 #include "cypher/execution_plan/validation/graph_name_checker.h"
@@ -503,6 +506,30 @@ static bool _SkipHangingArgumentOp(const PatternGraph &graph, const SymbolTable
     return false;
 }
 
+/* The relationships of the pattern the DFS does not expand close cycles, e.g. c-->a of
+ * (a)-->(b)-->(c)-->(a). Collects them by the step binding their later endpoint.  */
+static std::vector<std::vector<Relationship *>> _CollectClosingRelationships(
+    PatternGraph &pattern_graph, const EXPAND_STEPS &stream) {
+    std::vector<std::vector<Relationship *>> closing(stream.size());
+    std::unordered_map<NodeID, size_t> rank;  // 0 for the start node, i + 1 for step i
+    std::unordered_set<RelpID> expanded;
+    rank.emplace(std::get<0>(stream[0]), 0);
+    for (size_t i = 0; i < stream.size(); i++) {
+        if (std::get<1>(stream[i]) < 0) continue;
+        expanded.emplace(std::get<1>(stream[i]));
+        rank.emplace(std::get<2>(stream[i]), i + 1);
+    }
+    for (auto &relp : pattern_graph.GetRelationships()) {
+        if (relp.derivation_ != Relationship::MATCHED || expanded.count(relp.ID())) continue;
+        auto lhs = rank.find(relp.Lhs());
+        auto rhs = rank.find(relp.Rhs());
+        if (lhs == rank.end() || rhs == rank.end()) continue;
+        auto later = std::max(lhs->second, rhs->second);
+        if (later > 0) closing[later - 1].emplace_back(&relp);
+    }
+    return closing;
+}
+
 // Build expand ops in DFS traversal order
 void ExecutionPlan::_BuildExpandOps(const parser::QueryPart &part, PatternGraph &pattern_graph,
                                     OpBase *&root) {
@@ -542,6 +569,7 @@ void ExecutionPlan::_BuildExpandOps(const parser::QueryPart &part, PatternGraph
     }
     for (auto &a : args_ordered) start_nodes.emplace_back(a.second);
     for (auto &s : start_hints) start_nodes.emplace_back(pattern_graph.GetNode(s).ID());
+    size_t n_fixed = start_nodes.size();
     for (auto &n : pattern_graph.GetNodes()) {
         if (n.derivation_ == Node::MATCHED && !n.Label().empty() &&
             n.Prop().type == Property::VALUE) {
@@ -557,6 +585,12 @@ void ExecutionPlan::_BuildExpandOps(const parser::QueryPart &part, PatternGraph
         if (n.derivation_ != Node::CREATED && n.derivation_ != Node::MERGED)
             start_nodes.emplace_back(n.ID());
     }
+    /* The heuristics above do not know the data, e.g. a labeled node with millions of
+     * vertices is preferred to an unlabeled one reached by an index seek. Let the cost
+     * model move a much cheaper start node in front of each traversal.  */
+    std::shared_ptr<const GraphStatistics> statistics;
+    if (!pattern_graph.GetRelationships().empty()) statistics = GraphStatistics::Get(_ctx);
+    if (statistics) CostModel(*statistics, pattern_graph).ReorderStartNodes(start_nodes, n_fixed);
     bool skip_hanging_argument_op =
         _SkipHangingArgumentOp(pattern_graph, pattern_graph.symbol_table);
     auto expand_streams = pattern_graph.CollectExpandStreams(start_nodes, true);
@@ -565,8 +599,12 @@ void ExecutionPlan::_BuildExpandOps(const parser::QueryPart &part, PatternGraph
     OpBase *traversal_root = nullptr;
     for (auto &stream : expand_streams) {
         std::vector<OpBase *> expand_ops;
+        std::vector<CostModel::StepEstimate> estimates;
+        if (statistics) estimates = CostModel(*statistics, pattern_graph).EstimateStream(stream);
         bool hanging = false;  // if the stream is a hanging node
-        for (auto &step : stream) {
+        auto closing = _CollectClosingRelationships(pattern_graph, stream);
+        for (size_t i = 0; i < stream.size(); i++) {
+            auto &step = stream[i];
             auto &start = pattern_graph.GetNode(std::get<0>(step));
             auto &relp = pattern_graph.GetRelationship(std::get<1>(step));
             auto &neighbor = pattern_graph.GetNode(std::get<2>(step));
@@ -590,9 +628,30 @@ void ExecutionPlan::_BuildExpandOps(const parser::QueryPart &part, PatternGraph
             } else if (relp.VarLen()) {
                 // expand when neighbor is not null
                 OpBase *expand_op = new VarLenExpand(&pattern_graph, &start, &neighbor, &relp);
+                if (i + 1 < estimates.size())
+                    expand_op->stats.estimatedRecordCount = estimates[i + 1].expand_rows;
                 expand_ops.emplace_back(expand_op);
             } else {
-                OpBase *expand_op = new ExpandAll(&pattern_graph, &start, &neighbor, &relp);
+                /* Bind a neighbor closing cycles to the intersection of the neighbors of
+                 * its bound endpoints, rather than expanding every path first.  */
+                std::vector<std::pair<Node *, Relationship *>> adjs{{&start, &relp}};
+                auto nit = pattern_graph.symbol_table.symbols.find(neighbor.Alias());
+                if (nit != pattern_graph.symbol_table.symbols.end() &&
+                    nit->second.scope != SymbolNode::ARGUMENT) {
+                    for (auto r : closing[i]) {
+                        if (r->VarLen()) continue;
+                        auto other = r->Lhs() == neighbor.ID() ? r->Rhs() : r->Lhs();
+                        adjs.emplace_back(&pattern_graph.GetNode(other), r);
+                    }
+                }
+                OpBase *expand_op;
+                if (adjs.size() > 1) {
+                    expand_op = new ExpandIntersect(&pattern_graph, &neighbor, adjs);
+                } else {
+                    expand_op = new ExpandAll(&pattern_graph, &start, &neighbor, &relp);
+                }
+                if (i + 1 < estimates.size())
+                    expand_op->stats.estimatedRecordCount = estimates[i + 1].expand_rows;
                 expand_ops.emplace_back(expand_op);
             }
             // add property filter op
@@ -616,6 +675,8 @@ void ExecutionPlan::_BuildExpandOps(const parser::QueryPart &part, PatternGraph
                     std::make_shared<lgraph::RangeFilter>(lgraph::CompareOp::LBR_EQ, ae1, ae2,
                                                         &pattern_graph.symbol_table);
                 OpBase *filter_op = new OpFilter(filter);
+                if (i + 1 < estimates.size())
+                    filter_op->stats.estimatedRecordCount = estimates[i + 1].filtered_rows;
                 expand_ops.emplace_back(filter_op);
             }
         }  // end for steps
@@ -635,6 +696,8 @@ void ExecutionPlan::_BuildExpandOps(const parser::QueryPart &part, PatternGraph
             std::vector<OpBase *> scan_ops;
             auto &start_node = pattern_graph.GetNode(std::get<0>(stream[0]));
             _AddScanOp(part, &pattern_graph.symbol_table, &start_node, scan_ops, false);
+            if (!estimates.empty() && !scan_ops.empty())
+                scan_ops.back()->stats.estimatedRecordCount = estimates[0].filtered_rows;
             for (auto it = scan_ops.rbegin(); it != scan_ops.rend(); it++) {
                 expand_ops.emplace_back(*it);
             }
@@ -1103,6 +1166,7 @@ static void _RealignAliasId(OpBase *root, const SymbolTable &sym_tab) {
             dynamic_cast<OpFilter *>(op)->Filter()->RealignAliasId(sym_tab);
             break;
         case OpType::CARTESIAN_PRODUCT:
+        case OpType::HASH_JOIN:
         case OpType::APPLY:
             return;
         case OpType::DISTINCT:
@@ -1287,6 +1351,7 @@ void ExecutionPlan::Build(const std::vector<parser::SglQuery> &stmt, parser::Cmd
             "All sub queries in an UNION must have the same column names.");
     }
     _cmd_type = cmd;
+    _ctx = ctx;
     /* read_only = AND(parts read_only)
      * so the initial value should be true.  */
     _read_only = true;
@@ -1477,11 +1542,11 @@ int ExecutionPlan::Execute(RTContext *ctx) {
 
 const ResultInfo &ExecutionPlan::GetResultInfo() const { return _result_info; }
 
-std::string ExecutionPlan::DumpPlan(int indent, bool statistics) const {
+std::string ExecutionPlan::DumpPlan(int indent, bool statistics, bool estimates) const {
     std::string s;
     s.append(FMA_FMT("ReadOnly:{}\n", ReadOnly()));
     s.append(statistics ? "Profile statistics:\n" : "Execution Plan:\n");
-    OpBase::DumpStream(_root, indent, statistics, s);
+    OpBase::DumpStream(_root, indent, statistics, s, estimates);
     return s;
 }
 
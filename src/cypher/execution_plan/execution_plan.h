@@ -40,6 +40,8 @@ class ExecutionPlan {
     ResultInfo _result_info;
     // query parts local member
     std::vector<PatternGraph> _pattern_graphs;
+    // context of the plan being built, used to collect graph statistics
+    RTContext *_ctx = nullptr;
 
     void _AddScanOp(const parser::QueryPart &part, const SymbolTable *sym_tab, Node *node,
                     std::vector<OpBase *> &ops, bool skip_arg_op);
@@ -119,7 +121,7 @@ class ExecutionPlan {
 
     int Execute(RTContext *ctx);
 
-    std::string DumpPlan(int indent, bool statistics) const;
+    std::string DumpPlan(int indent, bool statistics, bool estimates = false) const;
 
     std::string DumpGraph() const;  // dump pattern graph
 };
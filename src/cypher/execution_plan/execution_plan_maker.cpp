@@ -15,6 +15,7 @@
 #include "cypher/utils/geax_util.h"
 #include "cypher/execution_plan/clause_guard.h"
 #include "cypher/execution_plan/ops/ops.h"
+#include "cypher/execution_plan/optimization/cost_model.h"
 #include "cypher/execution_plan/execution_plan_maker.h"
 
 namespace cypher {
@@ -322,6 +323,7 @@ std::any ExecutionPlanMaker::visit(geax::frontend::PathChain* node) {
 
     // select the starting Node and end Node according to the pattern graph
     std::vector<NodeID> start_nodes;
+    size_t n_fixed = 0;
     {
         std::vector<Node*> nodes;
         nodes.push_back(&pattern_graph.GetNode(head->filler()->v().value()));
@@ -341,6 +343,7 @@ std::any ExecutionPlanMaker::visit(geax::frontend::PathChain* node) {
                 start_nodes.emplace_back(n->ID());
             }
         }
+        n_fixed = start_nodes.size();
         for (const auto &n : nodes) {
             if (n->derivation_ == Node::MATCHED &&
                 !n->Label().empty() &&
@@ -368,7 +371,20 @@ std::any ExecutionPlanMaker::visit(geax::frontend::PathChain* node) {
                                        pattern_graph.GetNode(node_kv.first).Visited());
         pattern_graph.GetNode(node_kv.first).Visited() = false;
     }
+    // let the cost model move a much cheaper start node in front of the heuristic one,
+    // unless the chain shares a node with a chain built before
+    std::shared_ptr<const GraphStatistics> statistics;
+    if (!tails.empty()) statistics = GraphStatistics::Get(ctx_);
+    bool shares_node = std::any_of(graph_node_visited_map.begin(), graph_node_visited_map.end(),
+                                   [](const auto& kv) { return kv.second; });
+    if (statistics && !shares_node) {
+        CostModel(*statistics, pattern_graph).ReorderStartNodes(start_nodes, n_fixed);
+    }
     auto expand_stream = pattern_graph.CollectExpandStreams(start_nodes, true)[0];
+    std::vector<CostModel::StepEstimate> estimates;
+    if (statistics) {
+        estimates = CostModel(*statistics, pattern_graph).EstimateStream(expand_stream);
+    }
     // reset pattern_graph node visited after generate dfs path
     for (const auto& node_kv : geax_nodes_map) {
         pattern_graph.GetNode(node_kv.first).Visited() = graph_node_visited_map[node_kv.first];
@@ -382,7 +398,8 @@ std::any ExecutionPlanMaker::visit(geax::frontend::PathChain* node) {
     }
 
     ClauseGuard cg(node->type(), cur_types_);
-    for (auto &step : expand_stream) {
+    for (size_t i = 0; i < expand_stream.size(); i++) {
+        auto &step = expand_stream[i];
         auto &start = pattern_graph.GetNode(std::get<0>(step));
         auto &relp = pattern_graph.GetRelationship(std::get<1>(step));
         auto &neighbor = pattern_graph.GetNode(std::get<2>(step));
@@ -402,6 +419,9 @@ std::any ExecutionPlanMaker::visit(geax::frontend::PathChain* node) {
         } else {
             expand_op = new ExpandAll(&pattern_graph, &start, &neighbor, &relp);
         }
+        if (i + 1 < estimates.size()) {
+            expand_op->stats.estimatedRecordCount = estimates[i + 1].expand_rows;
+        }
         expand_ops.emplace_back(expand_op);
         if (has_filter_per_level_[filter_level_]) {
             OpFilter* filter = new OpFilter(std::make_shared<lgraph::GeaxExprFilter>(
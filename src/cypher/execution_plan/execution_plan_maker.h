@@ -25,9 +25,10 @@ namespace cypher {
 class ExecutionPlanMaker : public geax::frontend::AstNodeVisitor {
  public:
     ExecutionPlanMaker(std::vector<PatternGraph>& pattern_graphs,
-      geax::common::ObjectArenaAllocator& alloc)
+      geax::common::ObjectArenaAllocator& alloc, RTContext* ctx = nullptr)
         : pattern_graphs_(pattern_graphs)
-        , objAlloc_(alloc) {}
+        , objAlloc_(alloc)
+        , ctx_(ctx) {}
     ~ExecutionPlanMaker() = default;
     geax::frontend::GEAXErrorCode Build(geax::frontend::AstNode* astNode, OpBase*& root);
     std::string ErrorMsg() { return error_msg_; }
@@ -51,6 +52,8 @@ class ExecutionPlanMaker : public geax::frontend::AstNodeVisitor {
     std::shared_ptr<Relationship> relp_t_;
     OpFilter* op_filter_ = nullptr;
     geax::common::ObjectArenaAllocator& objAlloc_;
+    // context of the plan being built, used to collect graph statistics
+    RTContext* ctx_ = nullptr;
     std::vector<geax::frontend::BEqual*> equal_filter_;
     std::vector<bool> has_filter_per_level_;
     uint32_t filter_level_ = 0;
@@ -37,7 +37,7 @@ geax::frontend::GEAXErrorCode ExecutionPlanV2::Build(geax::frontend::AstNode* as
     }
     LOG_DEBUG() << DumpGraph();
     // build execution plan
-    ExecutionPlanMaker execution_plan_maker(pattern_graphs_, obj_alloc_);
+    ExecutionPlanMaker execution_plan_maker(pattern_graphs_, obj_alloc_, ctx);
     ret = execution_plan_maker.Build(astNode, root_);
     if (ret != geax::frontend::GEAXErrorCode::GEAX_SUCCEED) {
         error_msg_ = execution_plan_maker.ErrorMsg();
@@ -142,11 +142,11 @@ int ExecutionPlanV2::Execute(RTContext* ctx) {
     return 0;
 }
 
-std::string ExecutionPlanV2::DumpPlan(int indent, bool statistics) const {
+std::string ExecutionPlanV2::DumpPlan(int indent, bool statistics, bool estimates) const {
     std::string s;
     s.append(FMA_FMT("ReadOnly:{}\n", ReadOnly()));
     s.append(statistics ? "Profile statistics:\n" : "Execution Plan:\n");
-    OpBase::DumpStream(root_, indent, statistics, s);
+    OpBase::DumpStream(root_, indent, statistics, s, estimates);
     return s;
 }
 
@@ -25,7 +25,7 @@ class ExecutionPlanV2 {
     ~ExecutionPlanV2();
     geax::frontend::GEAXErrorCode Build(geax::frontend::AstNode* astNode, RTContext* ctx);
     int Execute(RTContext* ctx);
-    std::string DumpPlan(int indent, bool statistics) const;
+    std::string DumpPlan(int indent, bool statistics, bool estimates = false) const;
     std::string DumpGraph() const;
     std::string ErrorMsg();
     OpBase* Root();
@@ -17,6 +17,7 @@
 //
 #pragma once
 
+#include <algorithm>
 #include <string>
 #include <vector>
 #include "core/lightning_graph.h"
@@ -67,6 +68,9 @@ enum OpType {
     TOPN,
     UNION,
     NODE_BY_ID_SEEK,
+    HASH_JOIN,
+    EXPAND_INTERSECT,
+    NODE_INDEX_SCAN,
     // TODO(lingsu): the operator and ast will be decoupled in the future, and ast will generate
     // symbolic information and expression, then the operator will complete the calculation through
     // the symbolic information and expression. and then the operator will be unified, without
@@ -84,6 +88,7 @@ enum OpType {
 struct OpStats {
     size_t profileRecordCount = 0;  // Number of records generated.
     double profileExecTime = .0;    // Operation total execution time in ms.
+    double estimatedRecordCount = -1;  // Records estimated by the cost model, -1 if unknown.
 };
 
 struct OpBase {
@@ -194,7 +199,7 @@ struct OpBase {
 
     bool IsTap() const {
         return type == OpType::ALL_NODE_SCAN || type == OpType::NODE_BY_LABEL_SCAN ||
-               type == OpType::NODE_INDEX_SEEK ||
+               type == OpType::NODE_INDEX_SEEK || type == OpType::NODE_INDEX_SCAN ||
                type == OpType::CREATE
                //|| type == OpType::UNWIND
                || type == OpType::STANDALONE_CALL;
@@ -202,7 +207,8 @@ struct OpBase {
 
     bool IsScan() const {
         return type == OpType::ALL_NODE_SCAN || type == OpType::NODE_BY_LABEL_SCAN ||
-               type == OpType::NODE_INDEX_SEEK || type == OpType::ARGUMENT;
+               type == OpType::NODE_INDEX_SEEK || type == OpType::NODE_INDEX_SCAN ||
+               type == OpType::ARGUMENT;
     }
 
     bool IsDynamicScan() const {
@@ -229,6 +235,36 @@ struct OpBase {
         }
     }
 
+    // Rows estimated for the stream rooted at op, -1 if unknown.
+    static double EstimatedRows(const OpBase *op) {
+        while (op->stats.estimatedRecordCount < 0 && !op->children.empty()) {
+            op = op->children[0];
+        }
+        return op->stats.estimatedRecordCount;
+    }
+
+    /* Whether the stream rooted at op binds relationships. Each expansion
+     * keeps the relationships of the current row in the visited edges of the
+     * pattern graph, so that a row never binds the same one twice.  */
+    static bool BindsEdges(const OpBase *op) {
+        switch (op->type) {
+        case OpType::EXPAND_ALL:
+        case OpType::EXPAND_INTO:
+        case OpType::REVERSED_EXPAND_ALL:
+        case OpType::VAR_LEN_EXPAND:
+        case OpType::VAR_LEN_EXPAND_INTO:
+        case OpType::VAR_LEN_REV_EXPAND:
+        case OpType::EXPAND_INTERSECT:
+            return true;
+        default:
+            break;
+        }
+        for (auto child : op->children) {
+            if (BindsEdges(child)) return true;
+        }
+        return false;
+    }
+
     static void FreeStream(OpBase *op) {
         if (!op) return;
         // Free child ops
@@ -239,19 +275,44 @@ struct OpBase {
         delete op;
     }
 
-    static void DumpStream(OpBase *op, int indent, bool statistics, std::string &s) {
+    /* Dumps the op tree. With statistics, each op is followed by the rows it
+     * produced, its estimated rows and its runtime note. With estimates only,
+     * each op that has an estimate is followed by it.  */
+    static void DumpStream(OpBase *op, int indent, bool statistics, std::string &s,
+                           bool estimates = false) {
         if (!op) return;
         for (int i = 0; i < indent; i++) s.append(" ");
         s.append(op->ToString());
-        if (statistics) {
-            s.append(" (").append(std::to_string(op->stats.profileRecordCount)).append(" rows)");
+        if (!statistics && estimates && op->stats.estimatedRecordCount >= 0) {
+            s.append(" (")
+                .append(std::to_string(static_cast<int64_t>(
+                    std::min(op->stats.estimatedRecordCount, 1e18) + 0.5)))
+                .append(" estimated)");
+        } else if (statistics) {
+            s.append(" (").append(std::to_string(op->stats.profileRecordCount)).append(" rows");
+            if (op->stats.estimatedRecordCount >= 0) {
+                s.append(", ")
+                    .append(std::to_string(static_cast<int64_t>(
+                        std::min(op->stats.estimatedRecordCount, 1e18) + 0.5)))
+                    .append(" estimated");
+            }
+            auto note = op->RuntimeNote();
+            if (!note.empty()) s.append(", ").append(note);
+            s.append(")");
         }
         s.append("\n");
         for (auto child : op->children) {
-            DumpStream(child, indent + 4, statistics, s);
+            DumpStream(child, indent + 4, statistics, s, estimates);
         }
     }
 
+    /* What the op changed in its own plan at runtime, from the cardinalities it
+     * observed. Shown by PROFILE, empty if nothing was changed.
+     * Only Cartesian Product and Expand(Into) adapt, and only their own strategy:
+     * nothing re-plans the rest of the pipeline at Sort, Aggregate or Apply, and
+     * a Cartesian Product is not turned into a Hash Join at runtime.  */
+    virtual std::string RuntimeNote() const { return std::string(); }
+
     virtual void Accept(Visitor *visitor) = 0;
 
     virtual void Accept(Visitor *visitor) const = 0;
@@ -17,13 +17,88 @@
 //
 #pragma once
 
+#include <algorithm>
+#include <string>
+#include <vector>
 #include "cypher/execution_plan/ops/op.h"
+#include "cypher/execution_plan/ops/saved_record.h"
 
 namespace cypher {
 
 class CartesianProduct : public OpBase {
+    /* The 1st stream is run again for every row of the others. When it is run
+     * far more times than the rows estimated for the others, e.g. the others
+     * expand a hub vertex, its rows are saved on the next run and replayed for
+     * the following rows instead of being produced again. It stays a nested
+     * loop: it is only replaced with a Hash Join when planning, see
+     * ReplaceCartesianProductWithHashJoin.  */
+    static constexpr size_t MIN_RERUNS_TO_SAVE = 16;
+    static constexpr size_t RERUNS_PER_ESTIMATED_ROW = 10;
+    static constexpr size_t MAX_SAVED_ROWS = 1 << 16;
+
+    enum SaveState {
+        NotSaving,  /* streams the 1st child */
+        Saving,     /* streams the 1st child and saves its rows */
+        Replaying,  /* replays the saved rows */
+        SaveFailed, /* too many rows to save */
+    } save_state_ = NotSaving;
+    std::vector<SavedRecord> saved_;
+    size_t replay_idx_ = 0;
+    size_t reruns_ = 0;
+    size_t reruns_to_save_ = 0;  // 0 if the rows of the 1st child can not be saved
+    std::string note_;
     bool init;
 
+    /* The replayed rows are not checked against the edges visited by the other
+     * streams, so they are saved only if one side holds no edge.  */
+    void _InitializeSaving() {
+        reruns_to_save_ = 0;
+        if (children.size() != 2 || !SavedRecord::Supported(children[0]) ||
+            (BindsEdges(children[0]) && BindsEdges(children[1]))) {
+            return;
+        }
+        auto reruns = EstimatedRows(children[1]) * RERUNS_PER_ESTIMATED_ROW;
+        if (reruns > 1e18) return;
+        reruns_to_save_ = std::max(MIN_RERUNS_TO_SAVE, static_cast<size_t>(std::max(reruns, .0)));
+    }
+
+    OpResult ConsumeFirst(RTContext *ctx) {
+        if (save_state_ == Replaying) {
+            if (replay_idx_ == saved_.size()) return OP_DEPLETED;
+            record->Merge(saved_[replay_idx_++].Restore(ctx));
+            return OP_OK;
+        }
+        auto child = children[0];
+        auto res = child->Consume(ctx);
+        if (save_state_ == Saving) {
+            if (res == OP_OK && saved_.size() < MAX_SAVED_ROWS) {
+                saved_.emplace_back(*child->record);
+            } else if (res == OP_DEPLETED) {
+                save_state_ = Replaying;
+                replay_idx_ = saved_.size();
+                note_ = fma_common::StringFormatter::Format(
+                    "{} rows replayed after {} runs", saved_.size(), reruns_ + 1);
+            } else {
+                save_state_ = SaveFailed;
+                saved_.clear();
+                saved_.shrink_to_fit();
+            }
+        }
+        if (res == OP_OK) record->Merge(*child->record);
+        return res;
+    }
+
+    void ResetFirst() {
+        if (save_state_ == Replaying) {
+            replay_idx_ = 0;
+            return;
+        }
+        ResetStream(children[0]);
+        if (save_state_ == NotSaving && reruns_to_save_ > 0 && ++reruns_ >= reruns_to_save_) {
+            save_state_ = Saving;
+        }
+    }
+
     // TODO(anyone) optimize, such as expand
     void ResetStream(OpBase *root) {
         root->Reset();
@@ -38,9 +113,11 @@ class CartesianProduct : public OpBase {
                 record->Merge(*child->record);
                 /* Managed to get new data.
                  * Reset streams [0-i] */
-                for (int ii = 0; ii < i; ii++) ResetStream(children[ii]);
+                ResetFirst();
+                for (int ii = 1; ii < i; ii++) ResetStream(children[ii]);
                 // Pull from resetted streams.
-                for (int j = 0; j < i; j++) {
+                if (ConsumeFirst(ctx) != OP_OK) return OP_ERR;
+                for (int j = 1; j < i; j++) {
                     auto c = children[j];
                     if (c->Consume(ctx) == OP_OK) {
                         record->Merge(*c->record);
@@ -74,6 +151,7 @@ class CartesianProduct : public OpBase {
         }
         if (!sym_tab) throw lgraph::CypherException("CartesianProduct initialize failed");
         record = std::make_shared<Record>(sym_tab->symbols.size(), sym_tab, ctx->param_tab_);
+        _InitializeSaving();
         return OP_OK;
     }
 
@@ -88,11 +166,7 @@ class CartesianProduct : public OpBase {
             return OP_OK;
         }
         // Pull from first stream.
-        auto child = children[0];
-        if (child->Consume(ctx) == OP_OK) {
-            // Managed to get data from first stream.
-            record->Merge(*child->record);
-        } else {
+        if (ConsumeFirst(ctx) != OP_OK) {
             // Failed to get data from first stream,
             // try pulling other streams for data.
             auto res = PullFromStreams(ctx);
@@ -106,11 +180,16 @@ class CartesianProduct : public OpBase {
             record = nullptr;
         }
         init = true;
+        save_state_ = NotSaving;
+        saved_.clear();
+        reruns_ = 0;
         return OP_OK;
     }
 
     std::string ToString() const override { return name; }
 
+    std::string RuntimeNote() const override { return note_; }
+
     CYPHER_DEFINE_VISITABLE()
 
     CYPHER_DEFINE_CONST_VISITABLE()
@@ -64,8 +64,16 @@ class ExpandAll : public OpBase {
             prop.value = std::move(value.constant.scalar);
             props.emplace_back(std::move(prop));
         }
+        auto vid = start_->PullVid();
+        auto iter_direction = expand_direction_;
+        from_neighbor_ = expand_into_ && _ExpandFromNeighbor(ctx);
+        if (from_neighbor_) {
+            vid = neighbor_->PullVid();
+            iter_direction = expand_direction_ == FORWARD ? REVERSED : FORWARD;
+            rows_from_neighbor_++;
+        }
         auto iter_type = lgraph::EIter::NA;
-        switch (expand_direction_) {
+        switch (iter_direction) {
         case ExpandTowards::FORWARD:
             iter_type = types.empty() ? lgraph::EIter::OUT_EDGE : lgraph::EIter::TYPE_OUT_EDGE;
             break;
@@ -76,8 +84,27 @@ class ExpandAll : public OpBase {
             iter_type = types.empty() ? lgraph::EIter::BI_EDGE : lgraph::EIter::BI_TYPE_EDGE;
             break;
         }
-        eit_->Initialize(ctx->txn_->GetTxn().get(), iter_type,
-                         start_->PullVid(), types, std::move(props));
+        eit_->Initialize(ctx->txn_->GetTxn().get(), iter_type, vid, types, std::move(props));
+    }
+
+    /* When both ends are bound, the edges between them are found from either
+     * end, and the end with fewer edges is cheaper to expand. Only a start with
+     * many edges is worth counting the edges of the neighbor for, e.g. a hub
+     * vertex, and the counts stop at the edges of the start.  */
+    bool _ExpandFromNeighbor(RTContext *ctx) const {
+        if (expand_direction_ == BIDIRECTIONAL || neighbor_->PullVid() < 0) return false;
+        auto txn = ctx->txn_->GetTxn();
+        auto start_it = txn->GetVertexIterator(start_->PullVid());
+        if (!start_it.IsValid()) return false;
+        bool out = expand_direction_ == FORWARD;
+        auto start_degree = out ? start_it.GetNumOutEdges(MAX_COUNTED_DEGREE)
+                                : start_it.GetNumInEdges(MAX_COUNTED_DEGREE);
+        if (start_degree < MIN_DEGREE_TO_FLIP) return false;
+        auto nbr_it = txn->GetVertexIterator(neighbor_->PullVid());
+        if (!nbr_it.IsValid()) return false;
+        auto nbr_degree =
+            out ? nbr_it.GetNumInEdges(start_degree) : nbr_it.GetNumOutEdges(start_degree);
+        return nbr_degree < start_degree;
     }
 
     bool _CheckToSkipEdgeFilter(RTContext *ctx) const {
@@ -88,7 +115,14 @@ class ExpandAll : public OpBase {
     bool _CheckToSkipEdge(RTContext *ctx) const {
         return eit_->IsValid() &&
                (pattern_graph_->VisitedEdges().Contains(*eit_) || _CheckToSkipEdgeFilter(ctx) ||
-                (expand_into_ && eit_->GetNbr(expand_direction_) != neighbor_->PullVid()));
+                (expand_into_ && !_ReachesBoundEnd()));
+    }
+
+    // whether the edge joins the start and the bound neighbor
+    bool _ReachesBoundEnd() const {
+        if (!from_neighbor_) return eit_->GetNbr(expand_direction_) == neighbor_->PullVid();
+        auto reversed = expand_direction_ == FORWARD ? REVERSED : FORWARD;
+        return eit_->GetNbr(reversed) == start_->PullVid();
     }
 
     bool _FilterNeighborLabel(RTContext *ctx) {
@@ -155,6 +189,11 @@ class ExpandAll : public OpBase {
     ExpandTowards expand_direction_;
     std::shared_ptr<lgraph::Filter> edge_filter_ = nullptr;
 
+    static constexpr size_t MIN_DEGREE_TO_FLIP = 64;
+    static constexpr size_t MAX_COUNTED_DEGREE = 4096;
+    bool from_neighbor_ = false;     // whether the edges are expanded from the neighbor
+    size_t rows_from_neighbor_ = 0;  // rows whose edges are expanded from the neighbor
+
     /* ExpandAllStates
      * Different states in which ExpandAll can be at. */
     enum ExpandAllState {
@@ -256,6 +295,12 @@ class ExpandAll : public OpBase {
                          : "");
     }
 
+    std::string RuntimeNote() const override {
+        if (rows_from_neighbor_ == 0) return std::string();
+        return fma_common::StringFormatter::Format("{} rows expanded from {}",
+                                                   rows_from_neighbor_, neighbor_->Alias());
+    }
+
     Node* GetStartNode() const { return start_; }
     Node* GetNeighborNode() const { return neighbor_; }
     Relationship* GetRelationship() const { return relp_; }
@@ -0,0 +1,284 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include <algorithm>
+#include "cypher/execution_plan/ops/op_expand_intersect.h"
+#include "cypher/arithmetic/arithmetic_expression.h"
+#include "fma-common/string_formatter.h"
+
+namespace cypher {
+
+ExpandIntersect::ExpandIntersect(PatternGraph *pattern_graph, Node *neighbor,
+                                 const std::vector<std::pair<Node *, Relationship *>> &adjs)
+    : OpBase(OpType::EXPAND_INTERSECT, "Expand(Intersect)"),
+      pattern_graph_(pattern_graph),
+      neighbor_(neighbor) {
+    CYPHER_THROW_ASSERT(neighbor && adjs.size() > 1);
+    auto &sym_tab = pattern_graph->symbol_table;
+    auto nit = sym_tab.symbols.find(neighbor_->Alias());
+    CYPHER_THROW_ASSERT(nit != sym_tab.symbols.end());
+    nbr_rec_idx_ = nit->second.id;
+    modifies.emplace_back(neighbor_->Alias());
+    for (auto &a : adjs) {
+        Adjacency adj;
+        adj.start = a.first;
+        adj.relp = a.second;
+        adj.direction = adj.relp->Undirected()                 ? BIDIRECTIONAL
+                        : adj.relp->Dst() == neighbor_->ID() ? FORWARD
+                                                               : REVERSED;
+        auto rit = sym_tab.symbols.find(adj.relp->Alias());
+        CYPHER_THROW_ASSERT(rit != sym_tab.symbols.end());
+        relp_rec_idx_.emplace_back(rit->second.id, adj.relp);
+        modifies.emplace_back(adj.relp->Alias());
+        adjs_.emplace_back(std::move(adj));
+    }
+}
+
+void ExpandIntersect::_LoadEdges(RTContext *ctx, Adjacency &adj) {
+    adj.pos = adj.begin = adj.end = adj.curr = 0;
+    auto vid = adj.start->PullVid();
+    // a write txn may change the edges between rows
+    bool cacheable = ctx->txn_->IsReadOnly();
+    if (cacheable) {
+        auto it = adj.cache.find(vid);
+        if (it != adj.cache.end()) {
+            adj.edges = &it->second;
+            return;
+        }
+    }
+    auto &types = adj.relp->Types();
+    std::vector<Property> props;
+    auto &properties = adj.relp->Properties();
+    if (properties.type == parser::Expression::MAP) {
+        SymbolTable dummy_st;
+        Record dummy_rd;
+        for (auto &m : properties.Map()) {
+            Property prop;
+            prop.field = m.first;
+            prop.type = Property::VALUE;
+            ArithExprNode ae(m.second, dummy_st);
+            auto value = ae.Evaluate(ctx, dummy_rd);
+            if (!value.IsScalar()) CYPHER_TODO();
+            prop.value = std::move(value.constant.scalar);
+            props.emplace_back(std::move(prop));
+        }
+    }
+    for (auto &kv : adj.relp->GeaxProperties()) {
+        SymbolTable dummy_st;
+        Record dummy_rd;
+        Property prop;
+        prop.field = std::get<0>(kv);
+        prop.type = Property::VALUE;
+        ArithExprNode ae(std::get<1>(kv), dummy_st);
+        auto value = ae.Evaluate(ctx, dummy_rd);
+        if (!value.IsScalar()) CYPHER_TODO();
+        prop.value = std::move(value.constant.scalar);
+        props.emplace_back(std::move(prop));
+    }
+    auto iter_type = lgraph::EIter::NA;
+    switch (adj.direction) {
+    case ExpandTowards::FORWARD:
+        iter_type = types.empty() ? lgraph::EIter::OUT_EDGE : lgraph::EIter::TYPE_OUT_EDGE;
+        break;
+    case ExpandTowards::REVERSED:
+        iter_type = types.empty() ? lgraph::EIter::IN_EDGE : lgraph::EIter::TYPE_IN_EDGE;
+        break;
+    case ExpandTowards::BIDIRECTIONAL:
+        iter_type = types.empty() ? lgraph::EIter::BI_EDGE : lgraph::EIter::BI_TYPE_EDGE;
+        break;
+    }
+    EdgeList edges;
+    lgraph::EIter eit;
+    eit.Initialize(ctx->txn_->GetTxn().get(), iter_type, vid, types, std::move(props));
+    for (; eit.IsValid(); eit.Next()) {
+        edges.emplace_back(eit.GetNbr(adj.direction), eit.GetUid());
+    }
+    std::sort(edges.begin(), edges.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.first < rhs.first;
+    });
+    if (!cacheable || edges.size() > MAX_CACHED_EDGES) {
+        adj.loaded = std::move(edges);
+        adj.edges = &adj.loaded;
+        return;
+    }
+    if (adj.cached_edges + edges.size() > MAX_CACHED_EDGES) {
+        adj.cache.clear();
+        adj.cached_edges = 0;
+    }
+    adj.cached_edges += edges.size();
+    adj.edges = &adj.cache.emplace(vid, std::move(edges)).first->second;
+}
+
+/* Moves every cursor to the next neighbor shared by all the adjacencies and
+ * sets the edges to it as [begin, end).  */
+bool ExpandIntersect::_Leapfrog(RTContext *ctx) {
+    auto less = [](const std::pair<lgraph::VertexId, lgraph::EdgeUid> &e, lgraph::VertexId v) {
+        return e.first < v;
+    };
+    while (true) {
+        lgraph::VertexId vid = -1;
+        for (auto &adj : adjs_) {
+            if (adj.pos >= adj.edges->size()) return false;
+            vid = std::max(vid, (*adj.edges)[adj.pos].first);
+        }
+        bool agreed = true;
+        for (auto &adj : adjs_) {
+            auto &edges = *adj.edges;
+            auto it = std::lower_bound(edges.begin() + adj.pos, edges.end(), vid, less);
+            adj.pos = it - edges.begin();
+            if (it == edges.end()) return false;
+            if (it->first != vid) agreed = false;
+        }
+        if (!agreed) continue;
+        for (auto &adj : adjs_) {
+            adj.begin = adj.curr = adj.pos;
+            adj.end = adj.pos;
+            while (adj.end < adj.edges->size() && (*adj.edges)[adj.end].first == vid) adj.end++;
+            adj.pos = adj.end;
+        }
+        if (neighbor_->Label().empty()) return true;
+        auto nbr_it = ctx->txn_->GetTxn()->GetVertexIterator(vid);
+        if (nbr_it.IsValid() && ctx->txn_->GetTxn()->GetVertexLabel(nbr_it) == neighbor_->Label()) {
+            return true;
+        }
+    }
+}
+
+// Advances to the next combination of edges to the current neighbor.
+bool ExpandIntersect::_NextEdges() {
+    for (auto &adj : adjs_) {
+        if (++adj.curr < adj.end) return true;
+        adj.curr = adj.begin;
+    }
+    return false;
+}
+
+// Relationships of a pattern never match the same edge.
+bool ExpandIntersect::_DistinctEdges() const {
+    auto &visited = pattern_graph_->VisitedEdges().euid_hash_set;
+    for (size_t i = 0; i < adjs_.size(); i++) {
+        auto &euid = (*adjs_[i].edges)[adjs_[i].curr].second;
+        if (visited.find(euid) != visited.end()) return false;
+        for (size_t j = 0; j < i; j++) {
+            if ((*adjs_[j].edges)[adjs_[j].curr].second == euid) return false;
+        }
+    }
+    return true;
+}
+
+void ExpandIntersect::_Bind(RTContext *ctx) {
+    neighbor_->PushVid((*adjs_[0].edges)[adjs_[0].curr].first);
+    for (auto &adj : adjs_) {
+        auto eit = adj.relp->ItRef();
+        eit->Initialize(ctx->txn_->GetTxn().get(), (*adj.edges)[adj.curr].second);
+        pattern_graph_->VisitedEdges().Add(*eit);
+    }
+}
+
+void ExpandIntersect::_Unbind() {
+    for (auto &adj : adjs_) pattern_graph_->VisitedEdges().Erase(*adj.relp->ItRef());
+}
+
+OpBase::OpResult ExpandIntersect::Next(RTContext *ctx) {
+    if (state_ == Resetted) {
+        for (auto &adj : adjs_) {
+            /* Start node may be invalid, such as when it is an argument
+             * produced by OPTIONAL MATCH.  */
+            if (adj.start->PullVid() < 0) return OP_REFRESH;
+        }
+        for (auto &adj : adjs_) _LoadEdges(ctx, adj);
+        state_ = Consuming;
+        if (!_Leapfrog(ctx)) return OP_REFRESH;
+    } else {
+        _Unbind();
+        if (!_NextEdges() && !_Leapfrog(ctx)) return OP_REFRESH;
+    }
+    while (!_DistinctEdges()) {
+        if (!_NextEdges() && !_Leapfrog(ctx)) return OP_REFRESH;
+    }
+    _Bind(ctx);
+    return OP_OK;
+}
+
+void ExpandIntersect::AddCopy(const std::string &alias, Node *node) {
+    copies_.emplace_back(alias, node);
+    modifies.emplace_back(alias);
+}
+
+OpBase::OpResult ExpandIntersect::Initialize(RTContext *ctx) {
+    CYPHER_THROW_ASSERT(!children.empty());
+    auto child = children[0];
+    auto res = child->Initialize(ctx);
+    if (res != OP_OK) return res;
+    record = child->record;
+    record->values[nbr_rec_idx_].type = Entry::NODE;
+    record->values[nbr_rec_idx_].node = neighbor_;
+    for (auto &r : relp_rec_idx_) {
+        record->values[r.first].type = Entry::RELATIONSHIP;
+        record->values[r.first].relationship = r.second;
+    }
+    auto &sym_tab = pattern_graph_->symbol_table;
+    for (auto &c : copies_) {
+        auto it = sym_tab.symbols.find(c.first);
+        CYPHER_THROW_ASSERT(it != sym_tab.symbols.end());
+        record->values[it->second.id].type = Entry::NODE;
+        record->values[it->second.id].node = c.second;
+    }
+    return OP_OK;
+}
+
+OpBase::OpResult ExpandIntersect::RealConsume(RTContext *ctx) {
+    CYPHER_THROW_ASSERT(!children.empty());
+    auto child = children[0];
+    while (state_ == Uninitialized || Next(ctx) == OP_REFRESH) {
+        auto res = child->Consume(ctx);
+        state_ = Resetted;
+        if (res != OP_OK) {
+            state_ = Uninitialized;
+            return res;
+        }
+    }
+    return OP_OK;
+}
+
+OpBase::OpResult ExpandIntersect::ResetImpl(bool complete) {
+    _Unbind();
+    for (auto &adj : adjs_) {
+        adj.relp->ItRef()->FreeIter();
+        adj.edges = nullptr;
+        adj.loaded.clear();
+        if (complete) {
+            adj.cache.clear();
+            adj.cached_edges = 0;
+        }
+        adj.pos = adj.begin = adj.end = adj.curr = 0;
+    }
+    neighbor_->PushVid(-1);
+    state_ = Uninitialized;
+    return OP_OK;
+}
+
+std::string ExpandIntersect::ToString() const {
+    std::string str;
+    for (auto &adj : adjs_) {
+        auto towards = adj.direction == FORWARD    ? "-->"
+                       : adj.direction == REVERSED ? "<--"
+                                                   : "--";
+        if (!str.empty()) str.append(", ");
+        str.append(adj.start->Alias()).append(" ").append(towards).append(" ").append(
+            neighbor_->Alias());
+    }
+    return fma_common::StringFormatter::Format("{} [{}]", name, str);
+}
+}  // namespace cypher
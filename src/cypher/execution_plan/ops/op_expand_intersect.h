@@ -0,0 +1,113 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "cypher/execution_plan/ops/op.h"
+
+namespace cypher {
+
+/* Expand(Intersect)
+ * Binds a node adjacent to several bound nodes of a cyclic pattern, e.g. c of
+ *   MATCH (a)-->(b)-->(c)-->(a)
+ * once a and b are bound. The edges of b and of a are loaded, sorted by
+ * neighbor and intersected by leapfrogging, so c only takes the vertices
+ * adjacent to both, instead of every neighbor of b followed by a check of
+ * c-->a. Loading and sorting reads every edge of each bound node, the
+ * intersection then skips through the lists by binary search. In read only
+ * transactions the sorted lists are kept for the rows that bind the same node
+ * again, up to MAX_CACHED_EDGES edges per adjacency.  */
+class ExpandIntersect : public OpBase {
+ public:
+    // <neighbor vid, edge uid> of the edges of a node, sorted by neighbor
+    typedef std::vector<std::pair<lgraph::VertexId, lgraph::EdgeUid>> EdgeList;
+
+    static const size_t MAX_CACHED_EDGES = 1 << 20;
+
+    struct Adjacency {
+        Node *start;                // bound node
+        Relationship *relp;         // relationship from start to the neighbor
+        ExpandTowards direction;
+        const EdgeList *edges = nullptr;  // of start, in loaded or in cache
+        EdgeList loaded;
+        // sorted edges by start vid, and the number of edges in them
+        std::unordered_map<lgraph::VertexId, EdgeList> cache;
+        size_t cached_edges = 0;
+        size_t pos = 0;             // leapfrog cursor
+        size_t begin = 0, end = 0;  // edges to the current neighbor
+        size_t curr = 0;            // edge bound to relp
+    };
+
+ private:
+    PatternGraph *pattern_graph_;
+    Node *neighbor_;
+    std::vector<Adjacency> adjs_;
+    int nbr_rec_idx_;
+    std::vector<std::pair<int, Relationship *>> relp_rec_idx_;
+    // aliases standing for a bound node
+    std::vector<std::pair<std::string, Node *>> copies_;
+
+    enum State {
+        Uninitialized, /* ExpandIntersect wasn't initialized it. */
+        Resetted,      /* ExpandIntersect was just restarted. */
+        Consuming,     /* ExpandIntersect consuming data. */
+    } state_ = Uninitialized;
+
+    void _LoadEdges(RTContext *ctx, Adjacency &adj);
+
+    bool _Leapfrog(RTContext *ctx);
+
+    bool _NextEdges();
+
+    bool _DistinctEdges() const;
+
+    void _Bind(RTContext *ctx);
+
+    void _Unbind();
+
+    OpResult Next(RTContext *ctx);
+
+ public:
+    /* adjs: the relationship the stream expands plus the relationships
+     * closing cycles on neighbor, each with its bound endpoint.  */
+    ExpandIntersect(PatternGraph *pattern_graph, Node *neighbor,
+                    const std::vector<std::pair<Node *, Relationship *>> &adjs);
+
+    /* Sets the entry of alias to node, for the copies of a repeated node the
+     * closing relationship used to lead to.  */
+    void AddCopy(const std::string &alias, Node *node);
+
+    OpResult Initialize(RTContext *ctx) override;
+
+    OpResult RealConsume(RTContext *ctx) override;
+
+    OpResult ResetImpl(bool complete) override;
+
+    std::string ToString() const override;
+
+    Node *GetNeighborNode() const { return neighbor_; }
+
+    const std::vector<Adjacency> &GetAdjacencies() const { return adjs_; }
+
+    const std::vector<std::pair<std::string, Node *>> &GetCopies() const { return copies_; }
+
+    CYPHER_DEFINE_VISITABLE()
+
+    CYPHER_DEFINE_CONST_VISITABLE()
+};
+}  // namespace cypher
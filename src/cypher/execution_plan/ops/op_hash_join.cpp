@@ -0,0 +1,130 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "cypher/execution_plan/ops/op_hash_join.h"
+#include "fma-common/string_formatter.h"
+
+namespace cypher {
+
+/* Keys of values that compare equal are equal. Numbers are keyed on their
+ * double value since 1 = 1.0, so distinct large integers may share a key;
+ * the filter above the join drops such false matches.  */
+HashJoin::KeyType HashJoin::MakeKey(Entry &&e, std::string &key) {
+    switch (e.type) {
+    case Entry::CONSTANT:
+        {
+            if (e.constant.IsNull()) return KEY_NULL;
+            if (e.constant.type != cypher::FieldData::SCALAR) return KEY_UNHASHABLE;
+            auto &s = e.constant.scalar;
+            if (s.IsInteger() || s.IsReal()) {
+                double d = s.IsInteger() ? static_cast<double>(s.integer()) : s.real();
+                if (d == 0) d = 0;  // -0.0 = 0.0
+                key.assign("n").append(reinterpret_cast<const char *>(&d), sizeof(d));
+            } else if (s.IsString()) {
+                key.assign("s").append(s.string());
+            } else {
+                key.assign(std::to_string(static_cast<int>(s.type))).append(":").append(
+                    s.ToString());
+            }
+            return KEY_HASHABLE;
+        }
+    case Entry::NODE:
+        {
+            if (!e.node || e.node->PullVid() < 0) return KEY_NULL;
+            key.assign("v").append(std::to_string(e.node->PullVid()));
+            return KEY_HASHABLE;
+        }
+    case Entry::RELATIONSHIP:
+        {
+            if (!e.relationship || !e.relationship->ItRef()->IsValid()) return KEY_NULL;
+            key.assign("e").append(e.relationship->ItRef()->GetUid().ToString());
+            return KEY_HASHABLE;
+        }
+    default:
+        return KEY_UNHASHABLE;
+    }
+}
+
+void HashJoin::Build(RTContext *ctx) {
+    auto build = children[0];
+    std::string key;
+    while (build->Consume(ctx) == OP_OK) {
+        auto type = MakeKey(build_key_.Evaluate(ctx, *build->record), key);
+        if (type == KEY_NULL) continue;
+        if (type == KEY_HASHABLE) {
+            table_.emplace(key, build_rows_.size());
+        } else {
+            unhashable_rows_.emplace_back(build_rows_.size());
+        }
+        build_rows_.emplace_back(*build->record);
+    }
+    built_ = true;
+}
+
+OpBase::OpResult HashJoin::Emit(RTContext *ctx, const SavedRecord &row) {
+    record->values = row.Restore(ctx).values;
+    record->Merge(*children[1]->record);
+    return OP_OK;
+}
+
+OpBase::OpResult HashJoin::Initialize(RTContext *ctx) {
+    CYPHER_THROW_ASSERT(children.size() == 2);
+    const SymbolTable *sym_tab = nullptr;
+    for (auto child : children) {
+        auto res = child->Initialize(ctx);
+        if (res != OP_OK) return res;
+        if (!sym_tab && child->record->symbol_table) sym_tab = child->record->symbol_table;
+    }
+    if (!sym_tab) throw lgraph::CypherException("HashJoin initialize failed");
+    record = std::make_shared<Record>(sym_tab->symbols.size(), sym_tab, ctx->param_tab_);
+    return OP_OK;
+}
+
+OpBase::OpResult HashJoin::RealConsume(RTContext *ctx) {
+    if (!built_) Build(ctx);
+    auto probe = children[1];
+    std::string key;
+    while (true) {
+        if (match_pos_ < matches_.size()) return Emit(ctx, build_rows_[matches_[match_pos_++]]);
+        if (build_rows_.empty() || probe->Consume(ctx) != OP_OK) return OP_DEPLETED;
+        matches_.clear();
+        match_pos_ = 0;
+        auto type = MakeKey(probe_key_.Evaluate(ctx, *probe->record), key);
+        if (type == KEY_NULL) continue;
+        if (type == KEY_HASHABLE) {
+            auto range = table_.equal_range(key);
+            for (auto it = range.first; it != range.second; ++it) matches_.push_back(it->second);
+            matches_.insert(matches_.end(), unhashable_rows_.begin(), unhashable_rows_.end());
+        } else {
+            for (size_t i = 0; i < build_rows_.size(); i++) matches_.push_back(i);
+        }
+    }
+}
+
+OpBase::OpResult HashJoin::ResetImpl(bool complete) {
+    if (complete) record = nullptr;
+    build_rows_.clear();
+    table_.clear();
+    unhashable_rows_.clear();
+    matches_.clear();
+    match_pos_ = 0;
+    built_ = false;
+    return OP_OK;
+}
+
+std::string HashJoin::ToString() const {
+    return fma_common::StringFormatter::Format("{} [{} = {}]", name, build_key_.ToString(),
+                                               probe_key_.ToString());
+}
+}  // namespace cypher
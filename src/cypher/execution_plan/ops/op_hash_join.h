@@ -0,0 +1,72 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "cypher/arithmetic/arithmetic_expression.h"
+#include "cypher/execution_plan/ops/op.h"
+#include "cypher/execution_plan/ops/saved_record.h"
+
+namespace cypher {
+
+/* Equi-join of two independent streams, e.g.
+ *   MATCH (a:Person), (b:City) WHERE a.born = b.founded RETURN a, b
+ * The build side (children[0]) is consumed once into a hash table keyed on
+ * build_key, then every record of the probe side (children[1]) is matched
+ * against the table with probe_key. This replaces the Cartesian Product
+ * under the equality filter, which is kept on top as the exact check.  */
+class HashJoin : public OpBase {
+    enum KeyType { KEY_NULL, KEY_HASHABLE, KEY_UNHASHABLE };
+
+    typedef std::unordered_multimap<
+        std::string, size_t, std::hash<std::string>, std::equal_to<std::string>,
+        MemoryMonitorAllocator<std::pair<const std::string, size_t>>>
+        Table;
+
+    ArithExprNode build_key_;
+    ArithExprNode probe_key_;
+    std::vector<SavedRecord, MemoryMonitorAllocator<SavedRecord>> build_rows_;
+    Table table_;
+    // build rows whose key cannot be hashed (lists, maps...), checked against every probe row
+    std::vector<size_t> unhashable_rows_;
+    std::vector<size_t> matches_;  // build rows matching the current probe record
+    size_t match_pos_ = 0;
+    bool built_ = false;
+
+    static KeyType MakeKey(Entry &&e, std::string &key);
+
+    void Build(RTContext *ctx);
+
+    OpResult Emit(RTContext *ctx, const SavedRecord &row);
+
+ public:
+    HashJoin(const ArithExprNode &build_key, const ArithExprNode &probe_key)
+        : OpBase(OpType::HASH_JOIN, "Hash Join"), build_key_(build_key), probe_key_(probe_key) {}
+
+    OpResult Initialize(RTContext *ctx) override;
+
+    OpResult RealConsume(RTContext *ctx) override;
+
+    OpResult ResetImpl(bool complete) override;
+
+    std::string ToString() const override;
+
+    CYPHER_DEFINE_VISITABLE()
+
+    CYPHER_DEFINE_CONST_VISITABLE()
+};
+}  // namespace cypher
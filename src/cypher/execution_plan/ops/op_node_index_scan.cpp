@@ -0,0 +1,81 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "cypher/execution_plan/ops/op_node_index_scan.h"
+
+namespace cypher {
+
+NodeIndexScan::NodeIndexScan(Node *node, const SymbolTable *sym_tab, std::string field,
+                             std::pair<lgraph::FieldData, lgraph::FieldData> bounds,
+                             bool descending)
+    : OpBase(OpType::NODE_INDEX_SCAN, "Node Index Scan"),
+      node_(node),
+      sym_tab_(sym_tab),
+      field_(std::move(field)),
+      bounds_(std::move(bounds)),
+      descending_(descending) {
+    CYPHER_THROW_ASSERT(node);
+    it_ = node->ItRef();
+    alias_ = node->Alias();
+    label_ = node->Label();
+    modifies.emplace_back(alias_);
+    auto it = sym_tab->symbols.find(alias_);
+    CYPHER_THROW_ASSERT(it != sym_tab->symbols.end());
+    node_rec_idx_ = it->second.id;
+    rec_length_ = sym_tab->symbols.size();
+}
+
+OpBase::OpResult NodeIndexScan::Initialize(RTContext *ctx) {
+    // allocate a new record
+    record = std::make_shared<Record>(rec_length_, sym_tab_, ctx->param_tab_);
+    record->values[node_rec_idx_].type = Entry::NODE;
+    record->values[node_rec_idx_].node = node_;
+    it_->Initialize(ctx->txn_->GetTxn().get(), lgraph::VIter::INDEX_ITER, label_, field_,
+                    bounds_.first, bounds_.second, descending_);
+    return OP_OK;
+}
+
+OpBase::OpResult NodeIndexScan::RealConsume(RTContext *ctx) {
+    node_->SetVid(-1);
+    if (!it_ || !it_->IsValid()) return OP_DEPLETED;
+    if (!consuming_) {
+        consuming_ = true;
+    } else {
+        it_->Next();
+        if (!it_->IsValid()) return OP_DEPLETED;
+    }
+    return OP_OK;
+}
+
+OpBase::OpResult NodeIndexScan::ResetImpl(bool complete) {
+    consuming_ = false;
+    if (complete) {
+        // undo method initialize()
+        record = nullptr;
+        if (it_ && it_->Initialized()) it_->FreeIter();
+    } else {
+        if (it_ && it_->Initialized()) it_->Reset();
+    }
+    return OP_OK;
+}
+
+std::string NodeIndexScan::ToString() const {
+    std::string str(name);
+    str.append(" [").append(alias_).append(":").append(label_).append("] ");
+    str.append(alias_).append(".").append(field_).append("[");
+    str.append(bounds_.first.ToString()).append(",").append(bounds_.second.ToString());
+    str.append("] ").append(descending_ ? "DESC" : "ASC");
+    return str;
+}
+}  // namespace cypher
@@ -0,0 +1,65 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include "cypher/execution_plan/ops/op.h"
+
+namespace cypher {
+
+/* Node Index Scan
+ * Scans the nodes of a label through the index on one of its fields, so the
+ * nodes come in the order of the field, ascending or descending. Used in
+ * place of a Sort when the rows are ordered by the indexed field, the scan
+ * then stops as soon as the Limit above is reached. Nodes without the field
+ * are not in the index.  */
+class NodeIndexScan : public OpBase {
+    Node *node_ = nullptr;
+    lgraph::VIter *it_ = nullptr;           // also can be derived from node
+    std::string alias_;                     // also can be derived from node
+    std::string label_;                     // also can be derived from node
+    int node_rec_idx_;                      // index of node in record
+    int rec_length_;                        // number of entries in a record.
+    const SymbolTable *sym_tab_ = nullptr;  // build time context
+    bool consuming_ = false;                // whether begin consuming
+    std::string field_;
+    // inclusive bounds of the field, null if unbounded
+    std::pair<lgraph::FieldData, lgraph::FieldData> bounds_;
+    bool descending_;
+
+ public:
+    NodeIndexScan(Node *node, const SymbolTable *sym_tab, std::string field,
+                  std::pair<lgraph::FieldData, lgraph::FieldData> bounds, bool descending);
+
+    OpResult Initialize(RTContext *ctx) override;
+
+    OpResult RealConsume(RTContext *ctx) override;
+
+    OpResult ResetImpl(bool complete) override;
+
+    std::string ToString() const override;
+
+    Node *GetNode() const { return node_; }
+
+    const std::string &GetField() const { return field_; }
+
+    bool Descending() const { return descending_; }
+
+    CYPHER_DEFINE_VISITABLE()
+
+    CYPHER_DEFINE_CONST_VISITABLE()
+};
+}  // namespace cypher
@@ -33,6 +33,21 @@ class NodeIndexSeek : public OpBase {
     std::string field_;
     int value_rec_idx_;
     std::vector<lgraph::FieldData> target_values_;
+    bool indexed_ = false;  // whether field_ is indexed in the label of node_
+
+    /* Positions it_ at the nodes of value, reusing the index cursor if possible.
+     * The values are sought in the order of the list, so are the rows.  */
+    void SeekValue(RTContext *ctx, const lgraph::FieldData &value) {
+        if (indexed_ && it_->IsIndexIterOf(node_->Label(), field_)) {
+            it_->Seek(value);
+        } else if (indexed_) {
+            it_->Initialize(ctx->txn_->GetTxn().get(), lgraph::VIter::INDEX_ITER, node_->Label(),
+                            field_, value, value);
+        } else {
+            // Weak index iterator
+            it_->Initialize(ctx->txn_->GetTxn().get(), node_->Label(), field_, value);
+        }
+    }
 
     OpResult HandOff() {
         if (!it_ || !it_->IsValid()) return OP_REFRESH;
@@ -84,14 +99,11 @@ class NodeIndexSeek : public OpBase {
             CYPHER_TODO();
         }
         CYPHER_THROW_ASSERT(!target_values_.empty());
-        auto value = target_values_[0];
-        if (!node_->Label().empty() && ctx->txn_->GetTxn()->IsIndexed(node_->Label(), field_)) {
-            it_->Initialize(ctx->txn_->GetTxn().get(), lgraph::VIter::INDEX_ITER, node_->Label(),
-                            field_, value, value);
-        } else {
-            // Weak index iterator]
-            it_->Initialize(ctx->txn_->GetTxn().get(), node_->Label(), field_, value);
-        }
+        indexed_ =
+            !node_->Label().empty() && ctx->txn_->GetTxn()->IsIndexed(node_->Label(), field_);
+        // a new iterator, the one of a former run may belong to another txn
+        if (it_->Initialized()) it_->FreeIter();
+        SeekValue(ctx, target_values_[0]);
         consuming_ = false;
         return OP_OK;
     }
@@ -107,14 +119,7 @@ class NodeIndexSeek : public OpBase {
         if (HandOff() == OP_OK) return OP_OK;
         while ((size_t)value_rec_idx_ < target_values_.size() - 1) {
             value_rec_idx_++;
-            auto value = target_values_[value_rec_idx_];
-            if (!node_->Label().empty() && ctx->txn_->GetTxn()->IsIndexed(node_->Label(), field_)) {
-                it_->Initialize(ctx->txn_->GetTxn().get(), lgraph::VIter::INDEX_ITER,
-                                node_->Label(), field_, value, value);
-            } else {
-                // Weak index iterator
-                it_->Initialize(ctx->txn_->GetTxn().get(), node_->Label(), field_, value);
-            }
+            SeekValue(ctx, target_values_[value_rec_idx_]);
             if (it_->IsValid()) {
                 return OP_OK;
             }
@@ -75,6 +75,8 @@ class NodeIndexSeekDynamic : public OpBase {
         auto &pf = node_->Prop();
         field_ = pf.field;
         value_rec_idx_ = -1;
+        // the iterator of a former run may belong to another txn
+        if (it_->Initialized()) it_->FreeIter();
         switch (pf.type) {
         case Property::VALUE:
             value_ = pf.value;
@@ -132,7 +134,11 @@ class NodeIndexSeekDynamic : public OpBase {
                     value = record->values[value_rec_idx_].constant.scalar;
                 }
             }
-            if (!node_->Label().empty() && ctx->txn_->GetTxn()->IsIndexed(node_->Label(), field_)) {
+            if (it_->IsIndexIterOf(node_->Label(), field_)) {
+                // reuse the cursor of the last row, see Unwind::SetSortForSeek
+                it_->Seek(value);
+            } else if (!node_->Label().empty() &&
+                       ctx->txn_->GetTxn()->IsIndexed(node_->Label(), field_)) {
                 it_->Initialize(ctx->txn_->GetTxn().get(), lgraph::VIter::INDEX_ITER,
                                 node_->Label(), field_, value, value);
             } else {
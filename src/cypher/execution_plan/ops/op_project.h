@@ -25,6 +25,7 @@ namespace cypher {
 
 class Project : public OpBase {
     friend class LazyProjectTopN;
+    friend class ReplaceSortWithIndexScan;
     const SymbolTable &sym_tab_;
     std::vector<ArithExprNode> return_elements_;
     std::vector<std::string> return_alias_;
@@ -23,6 +23,7 @@ namespace cypher {
 
 class Sort : public OpBase {
     friend class LazyProjectTopN;
+    friend class ReplaceSortWithIndexScan;
     std::vector<Record, MemoryMonitorAllocator<Record>> buffer_;
     std::vector<std::pair<int, bool>> sort_items_;
     size_t limit_ = 0;
@@ -17,6 +17,7 @@
 //
 #pragma once
 
+#include <algorithm>
 #include "parser/clause.h"
 #include "cypher/execution_plan/ops/op.h"
 #include "cypher/arithmetic/arithmetic_expression.h"
@@ -31,6 +32,20 @@ class Unwind : public OpBase {
     unsigned int list_idx_ = 0;  // Current list index.
     const SymbolTable *sym_tab_ = nullptr;
     static const unsigned int INDEX_NOT_SET = std::numeric_limits<unsigned int>::max();
+    // shorter lists are not worth reordering the rows
+    static const size_t SORT_FOR_SEEK_MIN_SIZE = 64;
+    bool sort_for_seek_ = false;
+
+    void SortForSeek() {
+        if (!sort_for_seek_ || list_.size() < SORT_FOR_SEEK_MIN_SIZE) return;
+        for (auto &v : list_) {
+            if (v.type != cypher::FieldData::SCALAR) return;
+        }
+        std::stable_sort(list_.begin(), list_.end(),
+                         [](const cypher::FieldData &a, const cypher::FieldData &b) {
+                             return lgraph::VIter::SeekOrderLess(a.scalar, b.scalar);
+                         });
+    }
 
     OpResult HandOff() {
         if (list_idx_ < list_.size()) {
@@ -67,6 +82,7 @@ class Unwind : public OpBase {
             if (list.IsArray()) {
                 list_ = *list.constant.array;
                 list_idx_ = 0;
+                SortForSeek();
             } else {
                 /* Attempting to use UNWIND on an expression that does not return a list --
                  *  such as UNWIND 5  will cause an error. The exception to this is when the
@@ -103,6 +119,7 @@ class Unwind : public OpBase {
             if (list.IsArray()) {
                 list_ = *list.constant.array;
                 list_idx_ = 0;
+                SortForSeek();
             } else {
                 if (!list.IsNull()) throw lgraph::CypherException("List expected in UNWIND");
                 list_idx_ = INDEX_NOT_SET;
@@ -119,11 +136,18 @@ class Unwind : public OpBase {
     std::string ToString() const override {
         std::string str(name);
         str.append(" [").append(exp_.ToString()).append(",").append(resolved_name_).append("]");
+        if (sort_for_seek_) str.append(" sorted");
         return str;
     }
 
     std::string ResolvedName() const { return resolved_name_; }
 
+    /* Sorts long lists in index order, so that the index seeks of the
+     * elements above walk the index with one cursor instead of descending
+     * from the root for each element. Only for rows whose order is lost
+     * above, see SortUnwindForIndexSeek.  */
+    void SetSortForSeek() { sort_for_seek_ = true; }
+
     CYPHER_DEFINE_VISITABLE()
 
     CYPHER_DEFINE_CONST_VISITABLE()
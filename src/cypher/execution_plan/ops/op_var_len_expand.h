@@ -18,6 +18,7 @@
 #pragma once
 
 #include "cypher/execution_plan/ops/op.h"
+#include "cypher/utils/frontier_expander.h"
 
 #ifndef NDEBUG
 #define VAR_LEN_EXP_DUMP_FOR_DEBUG()                                                         \
@@ -35,6 +36,10 @@ namespace cypher {
 /* Variable Length Expand */
 class VarLenExpand : public OpBase {
     void _InitializeEdgeIter(RTContext *ctx, int64_t vid, lgraph::EIter &eit) {
+        _InitializeEdgeIter(ctx->txn_->GetTxn().get(), vid, eit);
+    }
+
+    void _InitializeEdgeIter(lgraph::Transaction *txn, int64_t vid, lgraph::EIter &eit) {
         auto &types = relp_->Types();
         auto iter_type = lgraph::EIter::NA;
         switch (expand_direction_) {
@@ -48,7 +53,7 @@ class VarLenExpand : public OpBase {
             iter_type = types.empty() ? lgraph::EIter::BI_EDGE : lgraph::EIter::BI_TYPE_EDGE;
             break;
         }
-        eit.Initialize(ctx->txn_->GetTxn().get(), iter_type, vid, types, {});
+        eit.Initialize(txn, iter_type, vid, types, {});
     }
 
 #if 0  // 20210704
@@ -280,9 +285,68 @@ class VarLenExpand : public OpBase {
         }
     }
 
+    /* Collects the distinct vertices reachable from start in min_hop_..max_hop_ hops,
+     * breadth-first and one frontier at a time. A vertex is kept at the first hop it
+     * is reached, the frontier mode is only set when min_hop_ <= 1 (see
+     * VarLenExpandByFrontier), where this is exactly the set of endpoints of the
+     * edge-unique paths.  */
+    void _CollectReachable(RTContext *ctx, lgraph::VertexId start) {
+        if (!expander_) {
+            expander_ =
+                std::make_unique<FrontierExpander>(ctx->ac_db_.get(), *ctx->txn_->GetTxn());
+        }
+        reached_.clear();
+        reached_idx_ = 0;
+        visited_.Clear();
+        if (min_hop_ == 0) {
+            visited_.Add(start);
+            reached_.push_back(start);
+        }
+        std::vector<lgraph::VertexId> frontier{start}, next;
+        std::vector<std::vector<lgraph::VertexId>> outs;
+        for (int hop = 1; hop <= max_hop_ && !frontier.empty(); hop++) {
+            size_t n = expander_->Expand(
+                frontier,
+                [this](lgraph::Transaction &txn, lgraph::VertexId vid,
+                       std::vector<lgraph::VertexId> &out) {
+                    lgraph::EIter eit;
+                    _InitializeEdgeIter(&txn, vid, eit);
+                    for (; eit.IsValid(); eit.Next()) {
+                        out.push_back(eit.GetNbr(expand_direction_));
+                    }
+                    return true;
+                },
+                outs);
+            next.clear();
+            for (size_t i = 0; i < n; i++) {
+                for (auto vid : outs[i]) {
+                    if (!visited_.Add(vid)) continue;
+                    next.push_back(vid);
+                    reached_.push_back(vid);
+                }
+            }
+            frontier.swap(next);
+        }
+    }
+
+    OpResult NextFromFrontier(RTContext *ctx) {
+        if (state_ == Uninitialized) return OP_REFRESH;
+        if (state_ == Resetted) {
+            auto start_id = start_->PullVid();
+            if (start_id < 0) return OP_REFRESH;
+            relp_->path_.SetStart(start_id);
+            _CollectReachable(ctx, start_id);
+            state_ = Consuming;
+        }
+        if (reached_idx_ == reached_.size()) return OP_REFRESH;
+        neighbor_->PushVid(reached_[reached_idx_++]);
+        return OP_OK;
+    }
+
     OpResult Next(RTContext *ctx) {
         do {
-            if (NextWithoutLabelFilter(ctx) != OP_OK) return OP_REFRESH;
+            auto res = frontier_mode_ ? NextFromFrontier(ctx) : NextWithoutLabelFilter(ctx);
+            if (res != OP_OK) return OP_REFRESH;
         } while (!neighbor_->Label().empty() && neighbor_->IsValidAfterMaterialize(ctx) &&
                  neighbor_->ItRef()->GetLabel() != neighbor_->Label());
         return OP_OK;
@@ -302,6 +366,12 @@ class VarLenExpand : public OpBase {
     bool collect_all_;
     ExpandTowards expand_direction_;
     std::vector<lgraph::EIter> &eits_;
+    /* frontier mode, see SetFrontierMode() */
+    bool frontier_mode_ = false;
+    std::unique_ptr<FrontierExpander> expander_;
+    VidBitmap visited_;
+    std::vector<lgraph::VertexId> reached_;
+    size_t reached_idx_ = 0;
     enum State {
         Uninitialized, /* ExpandAll wasn't initialized it. */
         Resetted,      /* ExpandAll was just restarted. */
@@ -363,6 +433,8 @@ class VarLenExpand : public OpBase {
                 /* When consume after the stream is DEPLETED, make sure
                  * the result always be DEPLETED.  */
                 state_ = Uninitialized;
+                // the forked transactions must not outlive the query's one
+                expander_.reset();
                 return res;
             }
             /* Most of the time, the start_it is definitely valid after child's Consume
@@ -376,6 +448,9 @@ class VarLenExpand : public OpBase {
         // std::queue<lgraph::VertexId>().swap(frontier_buffer_);
         // std::queue<Path>().swap(path_buffer_);
         hop_ = 0;
+        reached_.clear();
+        reached_idx_ = 0;
+        if (complete) expander_.reset();
         // TODO(anyone) reset modifies
         return OP_OK;
     }
@@ -385,10 +460,18 @@ class VarLenExpand : public OpBase {
                        : expand_direction_ == REVERSED ? "<--"
                                                        : "--";
         return fma_common::StringFormatter::Format(
-            "{}({}) [{} {}*{}..{} {}]", name, "All", start_->Alias(), towards,
-            std::to_string(min_hop_), std::to_string(max_hop_), neighbor_->Alias());
+            "{}({}) [{} {}*{}..{} {}]", name, frontier_mode_ ? "Frontier" : "All",
+            start_->Alias(), towards, std::to_string(min_hop_), std::to_string(max_hop_),
+            neighbor_->Alias());
     }
 
+    /* Expands breadth-first and yields every reachable neighbor once, instead of
+     * once per path. Only for plans that keep the distinct neighbors alone, the
+     * relationship and its path are left empty.  */
+    void SetFrontierMode() { frontier_mode_ = true; }
+
+    bool FrontierMode() const { return frontier_mode_; }
+
     Node *GetStartNode() const { return start_; }
     Node *GetNeighborNode() const { return neighbor_; }
     Relationship *GetRelationship() const { return relp_; }
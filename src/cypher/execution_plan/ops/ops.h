@@ -37,6 +37,9 @@
 #include "cypher/execution_plan/ops/op_sort.h"
 #include "cypher/execution_plan/ops/op_limit.h"
 #include "cypher/execution_plan/ops/op_cartesian_product.h"
+#include "cypher/execution_plan/ops/op_hash_join.h"
+#include "cypher/execution_plan/ops/op_expand_intersect.h"
+#include "cypher/execution_plan/ops/op_node_index_scan.h"
 #include "cypher/execution_plan/ops/op_set.h"
 #include "cypher/execution_plan/ops/op_gql_set.h"
 #include "cypher/execution_plan/ops/op_delete.h"
@@ -0,0 +1,79 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include <vector>
+#include "cypher/execution_plan/ops/op.h"
+
+namespace cypher {
+
+/* A record kept to be emitted again later, by the Hash Join build side or a
+ * materialized Cartesian Product stream.
+ *
+ * Nodes and relationships live in the pattern graph, not in the records, so
+ * the vids and euids of the record are saved alongside it and pushed back into
+ * the pattern graph by Restore().  */
+struct SavedRecord {
+    Record record;
+    std::vector<lgraph::VertexId> vids;  // of the NODE entries, in order
+    std::vector<lgraph::EdgeUid> euids;  // of the RELATIONSHIP entries, in order
+
+    explicit SavedRecord(const Record &r) : record(r) {
+        for (auto &entry : record.values) {
+            if (entry.type == Entry::NODE && entry.node) {
+                vids.emplace_back(entry.node->PullVid());
+            } else if (entry.type == Entry::RELATIONSHIP && entry.relationship) {
+                auto it = entry.relationship->ItRef();
+                euids.emplace_back(it->IsValid() ? it->GetUid()
+                                                 : lgraph::EdgeUid(-1, -1, 0, 0, -1));
+            } else if (entry.type == Entry::VAR_LEN_RELP) {
+                CYPHER_TODO();
+            }
+        }
+    }
+
+    /* Whether the records of the stream rooted at op can be saved, the path of
+     * a variable length relationship is not, and neither is an argument fed by
+     * another stream.  */
+    static bool Supported(const OpBase *op) {
+        if (op->type == OpType::VAR_LEN_EXPAND || op->type == OpType::VAR_LEN_EXPAND_INTO ||
+            op->type == OpType::ARGUMENT) {
+            return false;
+        }
+        for (auto child : op->children) {
+            if (!Supported(child)) return false;
+        }
+        return true;
+    }
+
+    // Points the nodes and relationships back to the saved ones.
+    const Record &Restore(RTContext *ctx) const {
+        size_t v = 0, e = 0;
+        for (auto &entry : record.values) {
+            if (entry.type == Entry::NODE && entry.node) {
+                entry.node->PushVid(vids[v++]);
+            } else if (entry.type == Entry::RELATIONSHIP && entry.relationship) {
+                auto &euid = euids[e++];
+                if (euid.src < 0) {
+                    entry.relationship->ItRef()->FreeIter();
+                } else {
+                    entry.relationship->ItRef()->Initialize(ctx->txn_->GetTxn().get(), euid);
+                }
+            }
+        }
+        return record;
+    }
+};
+}  // namespace cypher
@@ -0,0 +1,555 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "tools/lgraph_log.h"
+#include "db/galaxy.h"
+#include "lgraph/lgraph_db.h"
+#include "cypher/execution_plan/runtime_context.h"
+#include "cypher/graph/graph.h"
+
+namespace cypher {
+
+/**
+ * Log2 histogram of the degrees of one (vertex label, edge label, direction).
+ * Bucket b counts the sampled vertices whose degree d satisfies
+ * floor(log2(d + 1)) == b.
+ */
+struct DegreeHistogram {
+    static constexpr size_t N_BUCKETS = 32;
+
+    size_t buckets[N_BUCKETS] = {0};
+    size_t samples = 0;
+    double sum = 0;
+
+    void Add(size_t degree) {
+        size_t b = 0;
+        while (b + 1 < N_BUCKETS && (degree + 1) >> (b + 1)) b++;
+        buckets[b]++;
+        samples++;
+        sum += degree;
+    }
+
+    /** Average degree of a vertex picked uniformly, e.g. by a scan. */
+    double Mean() const { return samples == 0 ? 0 : sum / samples; }
+
+    /**
+     * Average degree of a vertex reached through an edge. High degree vertices
+     * are reached more often, so this is the size-biased mean E[d^2] / E[d],
+     * computed from the bucket midpoints.
+     */
+    double ReachedMean() const {
+        double s1 = 0, s2 = 0;
+        for (size_t b = 0; b < N_BUCKETS; b++) {
+            if (buckets[b] == 0) continue;
+            double mid = std::sqrt(std::ldexp(1.0, b) * std::ldexp(1.0, b + 1)) - 1;
+            s1 += buckets[b] * mid;
+            s2 += buckets[b] * mid * mid;
+        }
+        return s1 == 0 ? 0 : std::max(Mean(), s2 / s1);
+    }
+};
+
+/**
+ * Statistics of a graph used by the cost model: vertex and edge counts per
+ * label, taken from the persisted counters (see dbms.meta.countDetail), plus
+ * degree histograms and index selectivity estimated from a sample of the
+ * vertices of each label.
+ *
+ * Labels of at most SAMPLE_SIZE * MAX_SAMPLE_STRIDE vertices are sampled by
+ * striding through their primary index. Larger labels are sampled at vids
+ * spread evenly over the whole vid range, so that the sample is not made of
+ * the oldest vertices only.
+ *
+ * The statistics are cached per graph. They are reused as long as the data
+ * version (the kv txn id) is unchanged, and rebuilt when the schema or the
+ * indexes change, when the persisted counts drift by more than REBUILD_DRIFT,
+ * or when dbms.meta.refreshCount is called.
+ */
+class GraphStatistics {
+ public:
+    static constexpr size_t SAMPLE_SIZE = 256;
+    // at most SAMPLE_SIZE * MAX_SAMPLE_STRIDE index entries or vids are visited per label
+    static constexpr size_t MAX_SAMPLE_STRIDE = 16;
+    // edges beyond this are not counted when sampling the degree of a vertex
+    static constexpr size_t MAX_SAMPLE_DEGREE = 1 << 16;
+    static constexpr double REBUILD_DRIFT = 0.1;
+
+    struct LabelStatistics {
+        int64_t count = 0;
+        // edge label -> degree histograms, [0] for out edges and [1] for in edges
+        std::map<std::string, std::array<DegreeHistogram, 2>> degrees;
+        // indexed field -> average number of vertices sharing one key
+        std::unordered_map<std::string, double> rows_per_key;
+    };
+
+ private:
+    uint64_t schema_version_ = 0;
+    size_t data_version_ = 0;
+    int64_t num_vertices_ = 0;
+    int64_t num_edges_ = 0;
+    std::unordered_map<std::string, int64_t> edge_counts_;
+    std::unordered_map<std::string, LabelStatistics> labels_;
+
+    struct Cache {
+        std::mutex mutex;
+        std::unordered_map<std::string, std::shared_ptr<const GraphStatistics>> graphs;
+    };
+
+    static Cache& GetCache() {
+        static Cache cache;
+        return cache;
+    }
+
+    static bool Drifted(int64_t cached, int64_t current) {
+        return std::abs(current - cached) > REBUILD_DRIFT * std::max<int64_t>(cached, 1);
+    }
+
+    struct LabelSample {
+        // the non-unique indexed fields and the keys sampled for each
+        std::vector<std::string> fields;
+        std::vector<std::set<lgraph_api::FieldData>> keys;
+        size_t n = 0;
+    };
+
+    void Sample(lgraph_api::VertexIterator& vit, LabelStatistics& ls, LabelSample& sample) {
+        sample.n++;
+        std::map<std::string, size_t> out, in;
+        size_t n = 0;
+        for (auto eit = vit.GetOutEdgeIterator(); eit.IsValid() && n < MAX_SAMPLE_DEGREE;
+             eit.Next(), n++) {
+            out[eit.GetLabel()]++;
+        }
+        n = 0;
+        for (auto eit = vit.GetInEdgeIterator(); eit.IsValid() && n < MAX_SAMPLE_DEGREE;
+             eit.Next(), n++) {
+            in[eit.GetLabel()]++;
+        }
+        for (auto& e : edge_counts_) {
+            auto& h = ls.degrees[e.first];
+            auto out_it = out.find(e.first);
+            h[0].Add(out_it == out.end() ? 0 : out_it->second);
+            auto in_it = in.find(e.first);
+            h[1].Add(in_it == in.end() ? 0 : in_it->second);
+        }
+        for (size_t f = 0; f < sample.fields.size(); f++) {
+            sample.keys[f].insert(vit.GetField(sample.fields[f]));
+        }
+    }
+
+    void Collect(lgraph_api::Transaction& txn,
+                 const std::vector<std::tuple<bool, std::string, int64_t>>& counts,
+                 const std::vector<lgraph_api::IndexSpec>& indexes) {
+        for (auto& c : counts) {
+            if (std::get<0>(c)) {
+                labels_[std::get<1>(c)].count = std::get<2>(c);
+                num_vertices_ += std::get<2>(c);
+            } else {
+                edge_counts_[std::get<1>(c)] = std::get<2>(c);
+                num_edges_ += std::get<2>(c);
+            }
+        }
+        std::unordered_map<std::string, LabelSample> samples;
+        for (auto& index : indexes) {
+            auto it = labels_.find(index.label);
+            if (it == labels_.end()) continue;
+            if (index.type == lgraph_api::IndexType::NonuniqueIndex) {
+                samples[index.label].fields.push_back(index.field);
+            } else {
+                it->second.rows_per_key[index.field] = 1;
+            }
+        }
+        for (auto& kv : samples) kv.second.keys.resize(kv.second.fields.size());
+        const size_t max_visits = SAMPLE_SIZE * MAX_SAMPLE_STRIDE;
+        // large labels: probe evenly spaced vids, and take the first vertex of a label still
+        // short of samples within MAX_SAMPLE_STRIDE vertices of each probe
+        std::unordered_set<std::string> large;
+        for (auto& kv : labels_) {
+            if (static_cast<size_t>(kv.second.count) > max_visits) large.insert(kv.first);
+        }
+        if (!large.empty()) {
+            const int64_t n_vids = static_cast<int64_t>(txn.GetNumVertices());
+            const int64_t n_probes = static_cast<int64_t>(max_visits);
+            int64_t next = 0;  // vertices before next were visited by the previous probe
+            for (int64_t p = 0; p < n_probes; p++) {
+                int64_t vid = std::max(n_vids * p / n_probes, next);
+                if (vid >= n_vids) break;
+                auto vit = txn.GetVertexIterator(vid, true);
+                for (size_t i = 0; vit.IsValid() && i < MAX_SAMPLE_STRIDE; vit.Next(), i++) {
+                    next = vit.GetId() + 1;
+                    auto label = vit.GetLabel();
+                    auto& sample = samples[label];
+                    if (!large.count(label) || sample.n >= SAMPLE_SIZE) continue;
+                    Sample(vit, labels_[label], sample);
+                    break;
+                }
+            }
+        }
+        for (auto& kv : labels_) {
+            auto& label = kv.first;
+            auto& ls = kv.second;
+            if (ls.count == 0) continue;
+            auto& sample = samples[label];
+            // small labels, and large labels too rare for the probes to find, stride through
+            // their primary index
+            if (sample.n < SAMPLE_SIZE / 4) {
+                size_t stride = std::min<size_t>(
+                    std::max<size_t>(ls.count / SAMPLE_SIZE, 1), MAX_SAMPLE_STRIDE);
+                auto iit = txn.GetVertexIndexIterator(label, txn.GetVertexPrimaryField(label),
+                                                      lgraph_api::FieldData(),
+                                                      lgraph_api::FieldData());
+                for (size_t i = 0; iit.IsValid() && sample.n < SAMPLE_SIZE; iit.Next(), i++) {
+                    if (i % stride != 0) continue;
+                    auto vit = txn.GetVertexIterator(iit.GetVid());
+                    if (!vit.IsValid()) continue;
+                    Sample(vit, ls, sample);
+                }
+            }
+            for (size_t f = 0; f < sample.fields.size(); f++) {
+                ls.rows_per_key[sample.fields[f]] =
+                    sample.keys[f].empty() ? 1
+                                           : static_cast<double>(sample.n) / sample.keys[f].size();
+            }
+        }
+    }
+
+ public:
+    /**
+     * Gets the statistics of the graph of the context, collecting them if
+     * they are not cached or are out of date. The transaction of the context
+     * is used if there is one, so that no transaction is nested in it.
+     *
+     * @returns The statistics, or nullptr if there is no current graph or
+     *          the statistics cannot be collected.
+     */
+    static std::shared_ptr<const GraphStatistics> Get(RTContext* ctx) {
+        if (!ctx || !ctx->galaxy_ || ctx->graph_.empty()) return nullptr;
+        try {
+            std::unique_ptr<lgraph_api::Transaction> own_txn;
+            lgraph_api::Transaction* txn = ctx->txn_.get();
+            if (!txn) {
+                if (!ctx->ac_db_) {
+                    ctx->ac_db_ = std::make_unique<lgraph::AccessControlledDB>(
+                        ctx->galaxy_->OpenGraph(ctx->user_, ctx->graph_));
+                }
+                lgraph_api::GraphDB db(ctx->ac_db_.get(), true);
+                own_txn = std::make_unique<lgraph_api::Transaction>(db.CreateReadTxn());
+                txn = own_txn.get();
+            }
+            uint64_t schema_version = txn->GetTxn()->GetSchemaInfo().version.value;
+            size_t data_version = txn->GetTxn()->GetTxnId();
+            auto& cache = GetCache();
+            std::shared_ptr<const GraphStatistics> cached;
+            {
+                std::lock_guard<std::mutex> l(cache.mutex);
+                auto it = cache.graphs.find(ctx->graph_);
+                if (it != cache.graphs.end() && it->second->schema_version_ == schema_version) {
+                    cached = it->second;
+                }
+            }
+            if (cached && cached->data_version_ == data_version) return cached;
+            auto counts = txn->CountDetail();
+            int64_t num_vertices = 0, num_edges = 0;
+            for (auto& c : counts) (std::get<0>(c) ? num_vertices : num_edges) += std::get<2>(c);
+            if (cached && !Drifted(cached->num_vertices_, num_vertices) &&
+                !Drifted(cached->num_edges_, num_edges)) {
+                return cached;
+            }
+            auto stats = std::make_shared<GraphStatistics>();
+            stats->schema_version_ = schema_version;
+            stats->data_version_ = data_version;
+            stats->Collect(*txn, counts, txn->ListVertexIndexes());
+            if (own_txn) own_txn->Abort();
+            std::lock_guard<std::mutex> l(cache.mutex);
+            cache.graphs[ctx->graph_] = stats;
+            return stats;
+        } catch (std::exception& e) {
+            LOG_DEBUG() << "Failed to collect statistics of graph " << ctx->graph_ << ": "
+                        << e.what();
+            return nullptr;
+        }
+    }
+
+    /** Drops the cached statistics of a graph, so that the next query rebuilds them. */
+    static void Invalidate(const std::string& graph) {
+        auto& cache = GetCache();
+        std::lock_guard<std::mutex> l(cache.mutex);
+        cache.graphs.erase(graph);
+    }
+
+    double NumVertices() const { return static_cast<double>(num_vertices_); }
+
+    /** Number of vertices of a label, or of the whole graph if label is empty. */
+    double VertexCount(const std::string& label) const {
+        if (label.empty()) return NumVertices();
+        auto it = labels_.find(label);
+        return it == labels_.end() ? 0 : static_cast<double>(it->second.count);
+    }
+
+    /**
+     * Average number of edges of the given types (all types if empty) of a
+     * vertex of the given label (any label if empty).
+     *
+     * @param   out     Count out edges if true, in edges otherwise.
+     * @param   reached Whether the vertex is reached through an edge rather than scanned.
+     */
+    double AverageDegree(const std::string& label, const std::set<std::string>& types, bool out,
+                         bool reached) const {
+        auto degree = [&](const LabelStatistics& ls) {
+            double d = 0;
+            for (auto& kv : ls.degrees) {
+                if (!types.empty() && !types.count(kv.first)) continue;
+                auto& h = kv.second[out ? 0 : 1];
+                d += reached ? h.ReachedMean() : h.Mean();
+            }
+            return d;
+        };
+        if (!label.empty()) {
+            auto it = labels_.find(label);
+            return it == labels_.end() ? 0 : degree(it->second);
+        }
+        if (num_vertices_ == 0) return 0;
+        double d = 0;
+        for (auto& kv : labels_) d += degree(kv.second) * kv.second.count;
+        return d / num_vertices_;
+    }
+
+    /**
+     * Average number of vertices of a label sharing one value of an indexed
+     * field, or a negative value if the field is not indexed.
+     */
+    double RowsPerKey(const std::string& label, const std::string& field) const {
+        auto it = labels_.find(label);
+        if (it == labels_.end()) return -1;
+        auto fit = it->second.rows_per_key.find(field);
+        return fit == it->second.rows_per_key.end() ? -1 : fit->second;
+    }
+};
+
+/**
+ * Estimates the number of rows produced while matching a pattern graph, and
+ * uses the estimates to pick the node each traversal starts from.
+ *
+ * A traversal is the same DFS as PatternGraph::CollectExpandStreams. Its cost
+ * is the rows read by the start scan plus the rows produced by each expand.
+ * Relationships closing a cycle are not accounted for, they filter the final
+ * result the same whatever the start node.
+ */
+class CostModel {
+ public:
+    // selectivity of an equality filter that cannot be estimated from an index
+    static constexpr double DEFAULT_EQUALITY_SELECTIVITY = 0.1;
+    // unbounded variable length relationships are costed up to this many hops
+    static constexpr int MAX_ESTIMATED_HOPS = 5;
+    // the heuristic start is only replaced when it costs at least MIN_REORDER_COST
+    // and REORDER_FACTOR times the best start
+    static constexpr double MIN_REORDER_COST = 10000;
+    static constexpr double REORDER_FACTOR = 4;
+    static constexpr double MAX_ROWS = 1e30;
+
+    struct StepEstimate {
+        double expand_rows = 0;    // rows after the scan or expand
+        double filtered_rows = 0;  // rows after the property filter of the reached node
+    };
+
+ private:
+    const GraphStatistics& stats_;
+    PatternGraph& graph_;
+
+    double PropertySelectivity(const Node& node) const {
+        auto& prop = node.Prop();
+        if (prop.type == Property::NUL || prop.field.empty()) return 1;
+        if (!node.Label().empty()) {
+            double rpk = stats_.RowsPerKey(node.Label(), prop.field);
+            double count = stats_.VertexCount(node.Label());
+            if (rpk > 0 && count > 0) return std::min(rpk / count, 1.0);
+        }
+        return DEFAULT_EQUALITY_SELECTIVITY;
+    }
+
+    double LabelSelectivity(const Node& node) const {
+        if (node.Label().empty() || stats_.NumVertices() == 0) return 1;
+        return stats_.VertexCount(node.Label()) / stats_.NumVertices();
+    }
+
+    double Fanout(const Node& from, const Relationship& relp, bool reached) const {
+        bool from_lhs = relp.Lhs() == from.ID();
+        double degree = 0;
+        if (relp.direction_ == parser::LinkDirection::LEFT_TO_RIGHT ||
+            relp.direction_ == parser::LinkDirection::RIGHT_TO_LEFT) {
+            bool out = (relp.direction_ == parser::LinkDirection::LEFT_TO_RIGHT) == from_lhs;
+            degree = stats_.AverageDegree(from.Label(), relp.Types(), out, reached);
+        } else {
+            degree = stats_.AverageDegree(from.Label(), relp.Types(), true, reached) +
+                     stats_.AverageDegree(from.Label(), relp.Types(), false, reached);
+        }
+        if (!relp.VarLen()) return degree;
+        int min_hop = std::max(relp.MinHop(), 0);
+        int max_hop = relp.MaxHop() < 0 ? min_hop + MAX_ESTIMATED_HOPS
+                                        : std::min(relp.MaxHop(), min_hop + MAX_ESTIMATED_HOPS);
+        double fanout = 0;
+        for (int h = min_hop; h <= max_hop; h++) fanout += std::pow(degree, h);
+        return fanout;
+    }
+
+    // the DFS of PatternGraph::_CollectExpandStepsByDFS, restricted to nodes
+    EXPAND_STEPS Traverse(NodeID start, const std::unordered_set<NodeID>& nodes) const {
+        EXPAND_STEPS steps;
+        std::unordered_set<NodeID> visited{start};
+        std::vector<NodeID> stack{start};
+        while (!stack.empty()) {
+            auto& curr = graph_.GetNode(stack.back());
+            RelpID relp = -1;
+            NodeID neighbor = -1;
+            for (auto rr : curr.RhsRelps()) {
+                auto& r = graph_.GetRelationship(rr);
+                if (nodes.count(r.Rhs()) && !visited.count(r.Rhs())) {
+                    relp = r.ID();
+                    neighbor = r.Rhs();
+                    break;
+                }
+            }
+            for (auto lr : curr.LhsRelps()) {
+                auto& r = graph_.GetRelationship(lr);
+                if (nodes.count(r.Lhs()) && !visited.count(r.Lhs()) &&
+                    (relp < 0 || r.ID() < relp)) {
+                    relp = r.ID();
+                    neighbor = r.Lhs();
+                    break;
+                }
+            }
+            if (relp < 0) {
+                stack.pop_back();
+                continue;
+            }
+            steps.emplace_back(curr.ID(), relp, neighbor);
+            visited.insert(neighbor);
+            stack.push_back(neighbor);
+        }
+        return steps;
+    }
+
+    double Cost(NodeID start, const std::unordered_set<NodeID>& nodes) const {
+        auto& node = graph_.GetNode(start);
+        auto steps = Traverse(start, nodes);
+        double cost = steps.empty() ? StartRows(node) : 0;
+        if (!node.Prop().field.empty() &&
+            (node.Label().empty() || stats_.RowsPerKey(node.Label(), node.Prop().field) < 0)) {
+            // no index seek, the whole label is scanned and filtered
+            cost += stats_.VertexCount(node.Label());
+        }
+        for (auto& e : EstimateStream(steps)) cost += e.expand_rows;
+        return std::min(cost, MAX_ROWS);
+    }
+
+ public:
+    CostModel(const GraphStatistics& stats, PatternGraph& graph) : stats_(stats), graph_(graph) {}
+
+    /** Rows produced by scanning for a node, before any expand. */
+    double StartRows(const Node& node) const {
+        auto& prop = node.Prop();
+        if (node.derivation_ == Node::ARGUMENT || prop.type == Property::VARIABLE) return 1;
+        return stats_.VertexCount(node.Label()) * PropertySelectivity(node);
+    }
+
+    /**
+     * Estimates the rows of an expand stream. The first estimate is the start
+     * scan, followed by one estimate per expand step.
+     */
+    std::vector<StepEstimate> EstimateStream(const EXPAND_STEPS& stream) const {
+        std::vector<StepEstimate> estimates;
+        if (stream.empty()) return estimates;
+        NodeID start = std::get<0>(stream[0]);
+        double rows = StartRows(graph_.GetNode(start));
+        estimates.push_back({rows, rows});
+        for (auto& step : stream) {
+            if (std::get<1>(step) < 0) continue;
+            auto& from = graph_.GetNode(std::get<0>(step));
+            auto& relp = graph_.GetRelationship(std::get<1>(step));
+            auto& to = graph_.GetNode(std::get<2>(step));
+            StepEstimate e;
+            e.expand_rows = std::min(
+                rows * Fanout(from, relp, from.ID() != start) * LabelSelectivity(to), MAX_ROWS);
+            e.filtered_rows = e.expand_rows * PropertySelectivity(to);
+            rows = e.filtered_rows;
+            estimates.push_back(e);
+        }
+        return estimates;
+    }
+
+    /**
+     * Moves the cheapest start node of each connected component in front of
+     * the start node the heuristics picked for it, when the latter is much
+     * more expensive. CollectExpandStreams starts a component from its first
+     * node in start_nodes, so the order of the components is kept.
+     *
+     * @param   n_fixed     Number of leading start nodes which are bound
+     *                      already or required by hints. Components holding
+     *                      one of them are not reordered.
+     */
+    void ReorderStartNodes(std::vector<NodeID>& start_nodes, size_t n_fixed) const {
+        std::unordered_set<NodeID> nodes(start_nodes.begin(), start_nodes.end());
+        std::unordered_set<NodeID> done;
+        for (size_t i = 0; i < n_fixed && i < start_nodes.size(); i++) {
+            auto steps = Traverse(start_nodes[i], nodes);
+            done.insert(start_nodes[i]);
+            for (auto& s : steps) done.insert(std::get<2>(s));
+        }
+        for (size_t i = n_fixed; i < start_nodes.size(); i++) {
+            NodeID start = start_nodes[i];
+            if (done.count(start)) continue;
+            auto steps = Traverse(start, nodes);
+            done.insert(start);
+            for (auto& s : steps) done.insert(std::get<2>(s));
+            if (steps.empty()) continue;
+            double cost = Cost(start, nodes);
+            if (cost < MIN_REORDER_COST) continue;
+            NodeID best = start;
+            double best_cost = cost;
+            for (auto& s : steps) {
+                auto& n = graph_.GetNode(std::get<2>(s));
+                if (n.derivation_ != Node::MATCHED) continue;
+                double c = Cost(n.ID(), nodes);
+                if (c < best_cost) {
+                    best = n.ID();
+                    best_cost = c;
+                }
+            }
+            if (best != start && cost >= REORDER_FACTOR * best_cost) {
+                LOG_DEBUG() << "Start traversal from " << graph_.GetNode(best).Alias()
+                            << " (estimated cost " << best_cost << ") instead of "
+                            << graph_.GetNode(start).Alias() << " (estimated cost " << cost
+                            << ")";
+                start_nodes.insert(start_nodes.begin() + i, best);
+                i++;
+            }
+        }
+    }
+};
+
+}  // namespace cypher
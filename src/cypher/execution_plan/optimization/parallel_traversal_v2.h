@@ -85,6 +85,9 @@ class ParallelTraversalV2 : public OptPass {
                 return false;
             }
             leaf_op = leaf_op->children[0];
+            if (leaf_op->type == OpType::EXPAND_INTERSECT) {
+                return false;
+            }
             if (leaf_op->type == OpType::EXPAND_ALL) {
                 // do not filter on expand currently
                 if (leaf_op->parent->type == OpType::FILTER) {
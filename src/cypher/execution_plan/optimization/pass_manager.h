@@ -30,6 +30,11 @@
 #include "execution_plan/optimization/locate_node_by_prop_range_filter.h"
 #include "execution_plan/optimization/parallel_traversal_v2.h"
 #include "execution_plan/optimization/rewrite_label_scan.h"
+#include "execution_plan/optimization/rewrite_cartesian_product.h"
+#include "execution_plan/optimization/rewrite_cyclic_expand.h"
+#include "execution_plan/optimization/rewrite_sort.h"
+#include "execution_plan/optimization/sort_unwind_for_index_seek.h"
+#include "execution_plan/optimization/var_len_expand_by_frontier.h"
 
 namespace cypher {
 
@@ -42,16 +47,21 @@ class PassManager {
         // all_passes_.emplace_back(new OptRewriteWithSchemaInference(ctx));
         // all_passes_.emplace_back(new PassReduceCount());
         // all_passes_.emplace_back(new EdgeFilterPushdownExpand());
+        all_passes_.emplace_back(new ReplaceSortWithIndexScan(ctx));
         all_passes_.emplace_back(new LazyProjectTopN());
         all_passes_.emplace_back(new PassVarLenExpandWithLimit());
         all_passes_.emplace_back(new LocateNodeByVid());
         all_passes_.emplace_back(new LocateNodeByIndexedProp());
+        all_passes_.emplace_back(new RewriteCyclicExpand());
         all_passes_.emplace_back(new ParallelTraversal());
         all_passes_.emplace_back(new ParallelTraversalV2());
         all_passes_.emplace_back(new LocateNodeByVidV2());
         // all_passes_.emplace_back(new LocateNodeByIndexedPropV2());
         all_passes_.emplace_back(new ReplaceNodeScanWithIndexSeek(ctx));
         all_passes_.emplace_back(new LocateNodeByPropRangeFilter());
+        all_passes_.emplace_back(new ReplaceCartesianProductWithHashJoin());
+        all_passes_.emplace_back(new SortUnwindForIndexSeek(ctx));
+        all_passes_.emplace_back(new VarLenExpandByFrontier());
     }
 
     ~PassManager() {
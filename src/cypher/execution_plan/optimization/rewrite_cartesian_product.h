@@ -0,0 +1,252 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include <set>
+#include <string>
+#include <vector>
+#include "cypher/execution_plan/ops/op_cartesian_product.h"
+#include "cypher/execution_plan/ops/op_filter.h"
+#include "cypher/execution_plan/ops/op_hash_join.h"
+#include "cypher/execution_plan/optimization/opt_pass.h"
+#include "cypher/filter/filter.h"
+#include "geax-front-end/ast/Ast.h"
+
+namespace cypher {
+
+/*
+ * Replace the Cartesian Product under an equality filter, whose sides each
+ * depend on one branch only, with a Hash Join:
+ * MATCH (a:Person), (b:City) WHERE a.born = b.founded RETURN a, b
+ *
+ * Plan before optimization:
+ * Produce Results
+ *     Project [a,b]
+ *         Filter [{a.born = b.founded}]
+ *             Cartesian Product
+ *                 Node By Label Scan [a:Person]
+ *                 Node By Label Scan [b:City]
+ *
+ * Plan after optimization:
+ * Produce Results
+ *     Project [a,b]
+ *         Filter [{a.born = b.founded}]
+ *             Hash Join [b.founded = a.born]
+ *                 Node By Label Scan [b:City]
+ *                 Node By Label Scan [a:Person]
+ *
+ * The branch estimated to produce fewer rows is the build side. The filter
+ * is kept to check the join exactly. Equalities are taken from the range
+ * filters of Cypher v1 and from the AST filters of v2. Branches that both
+ * bind relationships are left alone: the build side is read before the
+ * probe, so its relationships could be bound again by the probe side.
+ */
+class ReplaceCartesianProductWithHashJoin : public OptPass {
+    static void CollectModifies(OpBase *op, std::set<std::string> &aliases) {
+        aliases.insert(op->modifies.begin(), op->modifies.end());
+        for (auto child : op->children) CollectModifies(child, aliases);
+    }
+
+    /* Collects the aliases a join key depends on. Returns false if the key
+     * may depend on something else, e.g. a variable of a previous part.  */
+    static bool KeyAliases(const ArithExprNode &ae, std::set<std::string> &aliases) {
+        if (ae.type == ArithExprNode::AR_EXP_OPERAND) {
+            if (ae.operand.type != ArithOperandNode::AR_OPERAND_VARIADIC) return false;
+            aliases.emplace(ae.operand.variadic.alias);
+            return true;
+        }
+        if (ae.type != ArithExprNode::AR_EXP_OP || ae.op.type != ArithOpNode::AR_OP_FUNC) {
+            return false;
+        }
+        for (auto &c : ae.op.children) {
+            if (c.type == ArithExprNode::AR_EXP_OPERAND &&
+                c.operand.type == ArithOperandNode::AR_OPERAND_CONSTANT) {
+                continue;
+            }
+            if (!KeyAliases(c, aliases)) return false;
+        }
+        return !aliases.empty();
+    }
+
+    // Same as KeyAliases, for an AST expression.
+    static bool ExprAliases(geax::frontend::Expr *expr, std::set<std::string> &aliases) {
+        switch (expr->type()) {
+        case geax::frontend::AstNodeType::kRef:
+            aliases.emplace(static_cast<geax::frontend::Ref *>(expr)->name());
+            return true;
+        case geax::frontend::AstNodeType::kGetField:
+            return ExprAliases(static_cast<geax::frontend::GetField *>(expr)->expr(), aliases);
+        case geax::frontend::AstNodeType::kFunc:
+            for (auto arg : static_cast<geax::frontend::Function *>(expr)->args()) {
+                if (!ExprAliases(arg, aliases)) return false;
+            }
+            return !aliases.empty();
+        case geax::frontend::AstNodeType::kVInt:
+        case geax::frontend::AstNodeType::kVDouble:
+        case geax::frontend::AstNodeType::kVString:
+        case geax::frontend::AstNodeType::kVBool:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    static bool Covers(const std::set<std::string> &modifies,
+                       const std::set<std::string> &aliases) {
+        for (auto &a : aliases) {
+            if (!modifies.count(a)) return false;
+        }
+        return true;
+    }
+
+    static bool FindJoinKeys(geax::frontend::Expr *expr, const SymbolTable &sym_tab,
+                             const std::set<std::string> &lhs, const std::set<std::string> &rhs,
+                             ArithExprNode &lhs_key, ArithExprNode &rhs_key) {
+        if (expr->type() == geax::frontend::AstNodeType::kBAnd) {
+            auto band = static_cast<geax::frontend::BAnd *>(expr);
+            return FindJoinKeys(band->left(), sym_tab, lhs, rhs, lhs_key, rhs_key) ||
+                   FindJoinKeys(band->right(), sym_tab, lhs, rhs, lhs_key, rhs_key);
+        }
+        if (expr->type() != geax::frontend::AstNodeType::kBEqual) return false;
+        auto equal = static_cast<geax::frontend::BEqual *>(expr);
+        std::set<std::string> left, right;
+        if (!ExprAliases(equal->left(), left) || left.empty() ||
+            !ExprAliases(equal->right(), right) || right.empty()) {
+            return false;
+        }
+        if (Covers(lhs, left) && Covers(rhs, right)) {
+            lhs_key.SetAstExp(equal->left(), sym_tab);
+            rhs_key.SetAstExp(equal->right(), sym_tab);
+            return true;
+        }
+        if (Covers(lhs, right) && Covers(rhs, left)) {
+            lhs_key.SetAstExp(equal->right(), sym_tab);
+            rhs_key.SetAstExp(equal->left(), sym_tab);
+            return true;
+        }
+        return false;
+    }
+
+    // Finds an equality of f joining branches lhs and rhs, as <lhs key, rhs key>.
+    static bool FindJoinKeys(const std::shared_ptr<lgraph::Filter> &f,
+                             const std::set<std::string> &lhs, const std::set<std::string> &rhs,
+                             ArithExprNode &lhs_key, ArithExprNode &rhs_key) {
+        if (!f) return false;
+        if (f->Type() == lgraph::Filter::GEAX_EXPR_FILTER) {
+            auto &ae = static_cast<lgraph::GeaxExprFilter *>(f.get())->GetArithExpr();
+            if (!ae.expr_ || !ae.evaluator) return false;
+            return FindJoinKeys(ae.expr_, *ae.evaluator->GetSymbolTable(), lhs, rhs, lhs_key,
+                                rhs_key);
+        }
+        if (f->Type() == lgraph::Filter::BINARY && f->LogicalOp() == lgraph::LogicalOp::LBR_AND) {
+            return FindJoinKeys(f->Left(), lhs, rhs, lhs_key, rhs_key) ||
+                   FindJoinKeys(f->Right(), lhs, rhs, lhs_key, rhs_key);
+        }
+        if (f->Type() != lgraph::Filter::RANGE_FILTER) return false;
+        auto range = std::static_pointer_cast<lgraph::RangeFilter>(f);
+        if (range->GetCompareOp() != lgraph::CompareOp::LBR_EQ) return false;
+        std::set<std::string> left, right;
+        if (!KeyAliases(range->GetAeLeft(), left) || !KeyAliases(range->GetAeRight(), right)) {
+            return false;
+        }
+        if (Covers(lhs, left) && Covers(rhs, right)) {
+            lhs_key = range->GetAeLeft();
+            rhs_key = range->GetAeRight();
+            return true;
+        }
+        if (Covers(lhs, right) && Covers(rhs, left)) {
+            lhs_key = range->GetAeRight();
+            rhs_key = range->GetAeLeft();
+            return true;
+        }
+        return false;
+    }
+
+    static bool Rewrite(const std::shared_ptr<lgraph::Filter> &f, OpBase *cartesian) {
+        auto &children = cartesian->children;
+        std::vector<std::set<std::string>> modifies(children.size());
+        for (size_t i = 0; i < children.size(); i++) CollectModifies(children[i], modifies[i]);
+        for (size_t i = 0; i < children.size(); i++) {
+            for (size_t j = i + 1; j < children.size(); j++) {
+                ArithExprNode key_i, key_j;
+                if (!FindJoinKeys(f, modifies[i], modifies[j], key_i, key_j)) continue;
+                auto lhs = children[i], rhs = children[j];
+                // the build side is read up front, its relationships are no more visited
+                if (OpBase::BindsEdges(lhs) && OpBase::BindsEdges(rhs)) continue;
+                bool build_lhs = SavedRecord::Supported(lhs);
+                bool build_rhs = SavedRecord::Supported(rhs);
+                if (!build_lhs && !build_rhs) continue;
+                double lhs_rows = OpBase::EstimatedRows(lhs), rhs_rows = OpBase::EstimatedRows(rhs);
+                if (build_lhs && build_rhs && lhs_rows >= 0 && rhs_rows >= 0) {
+                    build_rhs = rhs_rows <= lhs_rows;
+                }
+                auto hash_join =
+                    build_rhs ? new HashJoin(key_j, key_i) : new HashJoin(key_i, key_j);
+                cartesian->RemoveChild(rhs);
+                cartesian->InsertChild(children.begin() + i, hash_join);
+                cartesian->RemoveChild(lhs);
+                hash_join->AddChild(build_rhs ? rhs : lhs);
+                hash_join->AddChild(build_rhs ? lhs : rhs);
+                if (children.size() == 1) {
+                    // the hash join replaces the cartesian product
+                    auto parent = cartesian->parent;
+                    cartesian->RemoveChild(hash_join);
+                    parent->RemoveChild(cartesian);
+                    parent->AddChild(hash_join);
+                    delete cartesian;
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Impl(OpBase *root) {
+        if (root->type == OpType::FILTER &&
+            (!root->parent || root->parent->type != OpType::FILTER)) {
+            // the filters placed above a cartesian product, AND-ed conditions may be split
+            std::vector<OpFilter *> filters;
+            OpBase *op = root;
+            while (op->type == OpType::FILTER && op->children.size() == 1) {
+                filters.emplace_back(dynamic_cast<OpFilter *>(op));
+                op = op->children[0];
+            }
+            // each equality may turn a pair of branches into a hash join
+            bool rewritten = true;
+            while (rewritten && filters.back()->children[0]->type == OpType::CARTESIAN_PRODUCT) {
+                rewritten = false;
+                for (auto f : filters) {
+                    if (Rewrite(f->Filter(), filters.back()->children[0])) {
+                        rewritten = true;
+                        break;
+                    }
+                }
+            }
+        }
+        for (auto child : root->children) Impl(child);
+    }
+
+ public:
+    ReplaceCartesianProductWithHashJoin()
+        : OptPass(typeid(ReplaceCartesianProductWithHashJoin).name()) {}
+
+    bool Gate() override { return true; }
+
+    int Execute(OpBase *root) override {
+        Impl(root);
+        return 0;
+    }
+};
+}  // namespace cypher
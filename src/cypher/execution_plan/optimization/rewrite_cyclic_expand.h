@@ -0,0 +1,205 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "cypher/execution_plan/ops/op_expand_all.h"
+#include "cypher/execution_plan/ops/op_expand_intersect.h"
+#include "cypher/execution_plan/ops/op_filter.h"
+#include "cypher/execution_plan/optimization/opt_pass.h"
+#include "cypher/filter/filter.h"
+#include "utils/geax_expr_util.h"
+
+namespace cypher {
+
+/*
+ * MultiPathPatternRewriter breaks the cycles of a pattern by renaming the
+ * repeated nodes, MATCH (a)-->(b)-->(c)-->(a) RETURN a,b,c is planned as
+ *
+ * Plan before optimization:
+ * Produce Results
+ *     Project [a,b,c]
+ *         Filter [(a = @ANON_MULTI_0)]
+ *             Expand(All) [c --> @ANON_MULTI_0 ]
+ *                 Expand(All) [b --> c ]
+ *                     Expand(All) [a --> b ]
+ *                         All Node Scan [a]
+ *
+ * which enumerates every path before closing it. The relationship back to a
+ * is moved to the expand binding c, which then intersects the neighbors of
+ * b and a:
+ *
+ * Plan after optimization:
+ * Produce Results
+ *     Project [a,b,c]
+ *         Filter [(a = @ANON_MULTI_0)]
+ *             Expand(Intersect) [b --> c, a <-- c]
+ *                 Expand(All) [a --> b ]
+ *                     All Node Scan [a]
+ *
+ * @ANON_MULTI_0 stands for a afterwards, so the filter always holds.
+ */
+class RewriteCyclicExpand : public OptPass {
+    static void CollectModifies(OpBase *op, std::set<std::string> &aliases) {
+        aliases.insert(op->modifies.begin(), op->modifies.end());
+        for (auto child : op->children) CollectModifies(child, aliases);
+    }
+
+    static void CollectCopies(geax::frontend::Expr *expr,
+                              std::vector<std::pair<std::string, std::string>> &copies) {
+        if (expr->type() == geax::frontend::AstNodeType::kBAnd) {
+            geax::frontend::BAnd *band;
+            checkedCast(expr, band);
+            CollectCopies(band->left(), copies);
+            CollectCopies(band->right(), copies);
+        } else if (expr->type() == geax::frontend::AstNodeType::kBEqual) {
+            geax::frontend::BEqual *equal;
+            checkedCast(expr, equal);
+            if (equal->left()->type() != geax::frontend::AstNodeType::kRef ||
+                equal->right()->type() != geax::frontend::AstNodeType::kRef) {
+                return;
+            }
+            geax::frontend::Ref *lhs, *rhs;
+            checkedCast(equal->left(), lhs);
+            checkedCast(equal->right(), rhs);
+            static const std::string prefix = std::string(parser::ANONYMOUS) + "MULTI_";
+            if (rhs->name().compare(0, prefix.size(), prefix) == 0) {
+                copies.emplace_back(lhs->name(), rhs->name());
+            }
+        }
+    }
+
+    // ops a chain of expands may contain
+    static bool InChain(OpBase *op) {
+        return op->type == OpType::EXPAND_ALL || op->type == OpType::EXPAND_INTERSECT ||
+               op->type == OpType::FILTER;
+    }
+
+    static Node *Neighbor(OpBase *op) {
+        if (op->type == OpType::EXPAND_ALL) {
+            auto expand = dynamic_cast<ExpandAll *>(op);
+            return expand->expand_into_ || expand->edge_filter_ ? nullptr : expand->neighbor_;
+        }
+        if (op->type == OpType::EXPAND_INTERSECT) {
+            return dynamic_cast<ExpandIntersect *>(op)->GetNeighborNode();
+        }
+        return nullptr;
+    }
+
+    /* Moves the relationship leading to copy, which stands for node, to the op binding
+     * the other end of the relationship.  */
+    static bool Rewrite(OpBase *op_filter, const std::string &node, const std::string &copy) {
+        // the chain of expands under the filter, top down
+        std::vector<OpBase *> chain;
+        for (auto op = op_filter; op->children.size() == 1 && InChain(op->children[0]);
+             op = op->children[0]) {
+            chain.emplace_back(op->children[0]);
+        }
+        size_t close = 0;
+        while (close < chain.size() &&
+               (chain[close]->type != OpType::EXPAND_ALL ||
+                dynamic_cast<ExpandAll *>(chain[close])->neighbor_->Alias() != copy)) {
+            close++;
+        }
+        if (close == chain.size()) return false;
+        auto expand_close = dynamic_cast<ExpandAll *>(chain[close]);
+        auto start = expand_close->start_;
+        auto pattern_graph = expand_close->pattern_graph_;
+        auto &copy_node = *expand_close->neighbor_;
+        auto &node_node = pattern_graph->GetNode(node);
+        if (expand_close->expand_into_ || expand_close->edge_filter_ || node_node.Empty() ||
+            &node_node == start ||
+            (!copy_node.Label().empty() && copy_node.Label() != node_node.Label())) {
+            return false;
+        }
+        // the copy must not be expanded from
+        for (size_t i = 0; i < close; i++) {
+            if (chain[i]->type == OpType::EXPAND_ALL &&
+                dynamic_cast<ExpandAll *>(chain[i])->start_ == &copy_node) {
+                return false;
+            }
+        }
+        size_t bind = close + 1;
+        while (bind < chain.size() && Neighbor(chain[bind]) != start) bind++;
+        if (bind == chain.size()) return false;
+        std::set<std::string> bound;
+        for (auto child : chain[bind]->children) CollectModifies(child, bound);
+        if (!bound.count(node)) return false;
+
+        std::vector<std::pair<Node *, Relationship *>> adjs;
+        if (chain[bind]->type == OpType::EXPAND_ALL) {
+            auto expand = dynamic_cast<ExpandAll *>(chain[bind]);
+            adjs.emplace_back(expand->start_, expand->relp_);
+        } else {
+            for (auto &adj : dynamic_cast<ExpandIntersect *>(chain[bind])->GetAdjacencies()) {
+                adjs.emplace_back(adj.start, adj.relp);
+            }
+        }
+        adjs.emplace_back(&node_node, expand_close->relp_);
+        auto expand_intersect = new ExpandIntersect(pattern_graph, start, adjs);
+        expand_intersect->AddCopy(copy, &node_node);
+        if (chain[bind]->type == OpType::EXPAND_INTERSECT) {
+            for (auto &c : dynamic_cast<ExpandIntersect *>(chain[bind])->GetCopies()) {
+                expand_intersect->AddCopy(c.first, c.second);
+            }
+        }
+        expand_intersect->stats.estimatedRecordCount = chain[bind]->stats.estimatedRecordCount;
+
+        // drop the closing expand
+        auto parent = expand_close->parent, child = expand_close->children[0];
+        expand_close->RemoveChild(child);
+        parent->RemoveChild(expand_close);
+        parent->AddChild(child);
+        delete expand_close;
+        // replace the expand binding start
+        auto bind_op = chain[bind];
+        parent = bind_op->parent;
+        child = bind_op->children[0];
+        bind_op->RemoveChild(child);
+        parent->RemoveChild(bind_op);
+        parent->AddChild(expand_intersect);
+        expand_intersect->AddChild(child);
+        delete bind_op;
+        return true;
+    }
+
+    void Impl(OpBase *root) {
+        if (root->type == OpType::FILTER) {
+            auto filter = dynamic_cast<OpFilter *>(root)->Filter();
+            if (filter->Type() == lgraph::Filter::GEAX_EXPR_FILTER) {
+                auto expr =
+                    static_cast<lgraph::GeaxExprFilter *>(filter.get())->GetArithExpr().expr_;
+                std::vector<std::pair<std::string, std::string>> copies;
+                CollectCopies(expr, copies);
+                for (auto &c : copies) Rewrite(root, c.first, c.second);
+            }
+        }
+        for (auto child : root->children) Impl(child);
+    }
+
+ public:
+    RewriteCyclicExpand() : OptPass(typeid(RewriteCyclicExpand).name()) {}
+
+    bool Gate() override { return true; }
+
+    int Execute(OpBase *root) override {
+        Impl(root);
+        return 0;
+    }
+};
+}  // namespace cypher
@@ -0,0 +1,208 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "core/data_type.h"
+#include "cypher/execution_plan/ops/op_filter.h"
+#include "cypher/execution_plan/ops/op_node_by_label_scan.h"
+#include "cypher/execution_plan/ops/op_node_index_scan.h"
+#include "cypher/execution_plan/ops/op_project.h"
+#include "cypher/execution_plan/ops/op_sort.h"
+#include "cypher/execution_plan/optimization/opt_pass.h"
+#include "cypher/execution_plan/optimization/property_filter_detector.h"
+#include "cypher/execution_plan/optimization/property_range_filter_detector.h"
+
+namespace cypher {
+
+/*
+ * Serve ORDER BY ... LIMIT on an indexed field from the index:
+ * MATCH (n:Person) WHERE n.name > 'L' RETURN n.name ORDER BY n.name DESC LIMIT 3
+ *
+ * Plan before optimization:
+ * Produce Results
+ *     Limit [3]
+ *         Sort [{0:0}]
+ *             Project [n.name]
+ *                 Filter [(n.name>"L")]
+ *                     Node By Label Scan [n:Person]
+ *
+ * Plan after optimization:
+ * Produce Results
+ *     Limit [3]
+ *         Project [n.name]
+ *             Filter [(n.name>"L")]
+ *                 Node Index Scan [n:Person] n.name[L,NUL] DESC
+ *
+ * The index yields the nodes already in order, so nothing is sorted and the
+ * scan stops once the limit is reached. Range predicates on the field become
+ * the bounds of the scan, the filter is kept for the exclusive ones. Nulls are
+ * not in the index, so an optional field is only scanned when bounded.
+ */
+class ReplaceSortWithIndexScan : public OptPass {
+    RTContext *ctx_ = nullptr;
+    const lgraph::SchemaInfo *si_ = nullptr;
+
+    // ops between the project and the scan, which keep the order of the scan
+    static bool KeepsOrder(OpBase *op) {
+        return op->type == OpType::FILTER || op->type == OpType::EXPAND_ALL;
+    }
+
+    static std::shared_ptr<lgraph::Filter> GeaxFilter(OpBase *op) {
+        if (op->type != OpType::FILTER) return nullptr;
+        auto filter = dynamic_cast<OpFilter *>(op)->Filter();
+        return filter && filter->Type() == lgraph::Filter::GEAX_EXPR_FILTER ? filter : nullptr;
+    }
+
+    // Gets alias and field of a n.field expression.
+    static bool PropertyOf(const ArithExprNode &ae, std::string &alias, std::string &field) {
+        if (ae.type != ArithExprNode::AR_AST_EXP || !ae.expr_) return false;
+        auto get_field = dynamic_cast<geax::frontend::GetField *>(ae.expr_);
+        if (!get_field) return false;
+        auto ref = dynamic_cast<geax::frontend::Ref *>(get_field->expr());
+        if (!ref) return false;
+        alias = ref->name();
+        field = get_field->fieldName();
+        return true;
+    }
+
+    // whether an index seek would be planned for the filters
+    bool HasIndexedEquality(const std::vector<OpBase *> &ops, const std::string &alias,
+                            const lgraph::Schema *schema) {
+        for (auto op : ops) {
+            auto filter = GeaxFilter(op);
+            if (!filter) continue;
+            PropertyFilterDetector detector;
+            if (!detector.Build(
+                    static_cast<lgraph::GeaxExprFilter *>(filter.get())->GetArithExpr().expr_)) {
+                continue;
+            }
+            auto it = detector.GetProperties().find(alias);
+            if (it == detector.GetProperties().end()) continue;
+            for (auto &p : it->second) {
+                if (p.first == schema->GetPrimaryField()) return true;
+                auto fe = schema->TryGetFieldExtractor(p.first);
+                if (fe && fe->GetVertexIndex()) return true;
+            }
+        }
+        return false;
+    }
+
+    static std::pair<lgraph::FieldData, lgraph::FieldData> Bounds(
+        const std::vector<OpBase *> &ops, const std::string &alias, const std::string &field) {
+        std::pair<lgraph::FieldData, lgraph::FieldData> bounds;
+        for (auto op : ops) {
+            auto filter = GeaxFilter(op);
+            if (!filter) continue;
+            PropertyRangeFilterDetector detector;
+            if (!detector.Build(
+                    static_cast<lgraph::GeaxExprFilter *>(filter.get())->GetArithExpr().expr_)) {
+                continue;
+            }
+            auto ait = detector.GetProperties().find(alias);
+            if (ait == detector.GetProperties().end()) continue;
+            auto fit = ait->second.find(field);
+            if (fit == ait->second.end()) continue;
+            auto &b = fit->second;
+            if (!b.first.is_null() && (bounds.first.is_null() || bounds.first < b.first)) {
+                bounds.first = b.first;
+            }
+            if (!b.second.is_null() && (bounds.second.is_null() || b.second < bounds.second)) {
+                bounds.second = b.second;
+            }
+        }
+        return bounds;
+    }
+
+    bool Rewrite(OpBase *op_sort) {
+        auto sort = dynamic_cast<Sort *>(op_sort);
+        if (sort->sort_items_.size() != 1 || sort->children.size() != 1 ||
+            sort->children[0]->type != OpType::PROJECT) {
+            return false;
+        }
+        auto project = dynamic_cast<Project *>(sort->children[0]);
+        auto idx = sort->sort_items_[0].first;
+        bool descending = !sort->sort_items_[0].second;
+        if (idx < 0 || (size_t)idx >= project->return_elements_.size()) return false;
+        std::string alias, field;
+        if (!PropertyOf(project->return_elements_[idx], alias, field)) return false;
+        // ops down to the scan of alias
+        std::vector<OpBase *> ops;
+        OpBase *op = project;
+        while (op->children.size() == 1 && KeepsOrder(op->children[0])) {
+            op = op->children[0];
+            ops.emplace_back(op);
+        }
+        if (op->children.size() != 1 || op->children[0]->type != OpType::NODE_BY_LABEL_SCAN) {
+            return false;
+        }
+        auto scan = dynamic_cast<NodeByLabelScan *>(op->children[0]);
+        if (scan->GetNode()->Alias() != alias) return false;
+        auto schema = si_->v_schema_manager.GetSchema(scan->GetLabel());
+        if (!schema) return false;
+        auto fe = schema->TryGetFieldExtractor(field);
+        if (!fe || !fe->GetVertexIndex() || !fe->GetVertexIndex()->IsReady()) return false;
+        if (HasIndexedEquality(ops, alias, schema)) return false;
+        auto bounds = Bounds(ops, alias, field);
+        if (fe->IsOptional() && bounds.first.is_null() && bounds.second.is_null()) return false;
+
+        auto index_scan =
+            new NodeIndexScan(scan->GetNode(), scan->GetSymtab(), field, bounds, descending);
+        index_scan->stats.estimatedRecordCount = scan->stats.estimatedRecordCount;
+        op->RemoveChild(scan);
+        OpBase::FreeStream(scan);
+        op->AddChild(index_scan);
+        // drop the sort
+        auto parent = sort->parent;
+        sort->RemoveChild(project);
+        parent->RemoveChild(sort);
+        parent->AddChild(project);
+        delete sort;
+        return true;
+    }
+
+    void Impl(OpBase *root) {
+        if (root->type == OpType::LIMIT && root->children.size() == 1) {
+            auto op = root->children[0];
+            if (op->type == OpType::SKIP && op->children.size() == 1) op = op->children[0];
+            if (op->type == OpType::SORT) Rewrite(op);
+        }
+        for (auto child : root->children) Impl(child);
+    }
+
+ public:
+    explicit ReplaceSortWithIndexScan(RTContext *ctx)
+        : OptPass(typeid(ReplaceSortWithIndexScan).name()), ctx_(ctx) {}
+
+    bool Gate() override { return true; }
+
+    int Execute(OpBase *root) override {
+        if (ctx_->graph_.empty()) {
+            return 0;
+        }
+        ctx_->ac_db_ = std::make_unique<lgraph::AccessControlledDB>(
+            ctx_->galaxy_->OpenGraph(ctx_->user_, ctx_->graph_));
+        lgraph_api::GraphDB db(ctx_->ac_db_.get(), true);
+        auto txn = db.CreateReadTxn();
+        si_ = &txn.GetTxn()->GetSchemaInfo();
+        Impl(root);
+        txn.Abort();
+        return 0;
+    }
+};
+}  // namespace cypher
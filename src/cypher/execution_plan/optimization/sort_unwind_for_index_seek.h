@@ -0,0 +1,132 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+#include "cypher/execution_plan/ops/op_aggregate.h"
+#include "cypher/execution_plan/ops/op_node_index_seek_dynamic.h"
+#include "cypher/execution_plan/ops/op_unwind.h"
+#include "cypher/execution_plan/optimization/opt_pass.h"
+
+namespace cypher {
+
+/*
+ * Batch the index lookups of an unwound list.
+ *
+ * The seek reuses one index cursor for all the rows, in any order. Once the
+ * list is sorted, each seek starts close to the last one and the whole batch
+ * walks the index in one pass instead of descending from the root for every
+ * key. Sorting changes the order of the rows, so it is only done when nothing
+ * above can tell, i.e. the rows are aggregated into a single one by functions
+ * that ignore their order:
+ * UNWIND $names AS x MATCH (n:Person {name:x}) RETURN count(n)
+ *
+ * Plan after optimization:
+ * Produce Results
+ *     Aggregate [count(n)]
+ *         Node VertexIndex Seek (Dynamic) [n]
+ *             Unwind [$names,x] sorted
+ *
+ * Only lists of 64 elements or more are sorted at runtime.
+ */
+class SortUnwindForIndexSeek : public OptPass {
+    RTContext *ctx_ = nullptr;
+    const lgraph::SchemaInfo *si_ = nullptr;
+
+    bool Indexed(const std::string &label, const std::string &field) const {
+        auto schema = si_->v_schema_manager.GetSchema(label);
+        if (!schema) return false;
+        auto fe = schema->TryGetFieldExtractor(field);
+        return fe && fe->GetVertexIndex() && fe->GetVertexIndex()->IsReady();
+    }
+
+    static bool OrderFreeAggregation(const ArithExprNode &ae) {
+        if (ae.type != ArithExprNode::AR_EXP_OP) return true;
+        if (ae.op.type == ArithOpNode::AR_OP_AGGREGATE) {
+            // sums of doubles depend on the order as well
+            static const std::set<std::string> funcs = {"count", "count(*)", "min", "max"};
+            if (!funcs.count(ae.op.func_name)) return false;
+        }
+        for (auto &c : ae.op.children) {
+            if (!OrderFreeAggregation(c)) return false;
+        }
+        return true;
+    }
+
+    /* Whether the result of the ops above op does not depend on the order of
+     * its rows. The groups of an aggregation come out in hash order, which
+     * depends on the order they were met in, so only a single group will do. */
+    static bool IgnoresRowOrder(const OpBase *op) {
+        for (op = op->parent; op; op = op->parent) {
+            switch (op->type) {
+            case OpType::FILTER:
+            case OpType::PROJECT:
+            case OpType::EXPAND_ALL:
+            case OpType::EXPAND_INTO:
+                continue;
+            case OpType::AGGREGATE:
+                {
+                    auto agg = dynamic_cast<const Aggregate *>(op);
+                    if (!agg->NoneAggregatedExpressions().empty()) return false;
+                    for (auto &ae : agg->AggregatedExpressions()) {
+                        if (!OrderFreeAggregation(ae)) return false;
+                    }
+                    return true;
+                }
+            default:
+                return false;
+            }
+        }
+        return false;
+    }
+
+    void Impl(OpBase *root) {
+        if (root->type == OpType::NODE_INDEX_SEEK_DYNAMIC && root->children.size() == 1 &&
+            root->children[0]->type == OpType::UNWIND) {
+            auto node = dynamic_cast<NodeIndexSeekDynamic *>(root)->GetNode();
+            auto unwind = dynamic_cast<Unwind *>(root->children[0]);
+            auto &pf = node->Prop();
+            if (pf.type == Property::VARIABLE && !pf.hasMapFieldName &&
+                pf.value_alias == unwind->ResolvedName() && !node->Label().empty() &&
+                Indexed(node->Label(), pf.field) && IgnoresRowOrder(root)) {
+                unwind->SetSortForSeek();
+            }
+        }
+        for (auto child : root->children) Impl(child);
+    }
+
+ public:
+    explicit SortUnwindForIndexSeek(RTContext *ctx)
+        : OptPass(typeid(SortUnwindForIndexSeek).name()), ctx_(ctx) {}
+
+    bool Gate() override { return true; }
+
+    int Execute(OpBase *root) override {
+        if (ctx_->graph_.empty()) {
+            return 0;
+        }
+        ctx_->ac_db_ = std::make_unique<lgraph::AccessControlledDB>(
+            ctx_->galaxy_->OpenGraph(ctx_->user_, ctx_->graph_));
+        lgraph_api::GraphDB db(ctx_->ac_db_.get(), true);
+        auto txn = db.CreateReadTxn();
+        si_ = &txn.GetTxn()->GetSchemaInfo();
+        Impl(root);
+        txn.Abort();
+        return 0;
+    }
+};
+}  // namespace cypher
@@ -0,0 +1,132 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include <cctype>
+#include <string>
+#include "cypher/execution_plan/ops/op_aggregate.h"
+#include "cypher/execution_plan/ops/op_filter.h"
+#include "cypher/execution_plan/ops/op_var_len_expand.h"
+#include "cypher/execution_plan/optimization/opt_pass.h"
+
+namespace cypher {
+
+/*
+ * Expand by frontiers when only the distinct neighbors are kept:
+ * MATCH (n:Person {name:'Rachel Kempson'})-[*1..3]->(m) RETURN DISTINCT m
+ * MATCH (n:Person {name:'Rachel Kempson'})-[*..3]->(m) RETURN count(DISTINCT m)
+ *
+ * Plan before optimization:
+ * Produce Results
+ *     Distinct
+ *         Project [m]
+ *             Variable Length Expand(All) [n -->*1..3 m]
+ *                 Node Index Seek [n]  IN []
+ *
+ * Plan after optimization:
+ * Produce Results
+ *     Distinct
+ *         Project [m]
+ *             Variable Length Expand(Frontier) [n -->*1..3 m]
+ *                 Node Index Seek [n]  IN []
+ *
+ * The depth-first expansion enumerates every path, which grows exponentially
+ * with the hops while the neighbors do not. A breadth-first search over the
+ * frontiers gives each neighbor once. Under edge uniqueness that is the same
+ * set only when the search starts from the first hop, the edges are directed
+ * and no other relationship in the pattern holds edges, so the pass checks
+ * all of these.
+ */
+class VarLenExpandByFrontier : public OptPass {
+    // whether text refers to alias, and not to another alias starting with it
+    static bool Mentions(const std::string &text, const std::string &alias) {
+        for (auto pos = text.find(alias); pos != std::string::npos;
+             pos = text.find(alias, pos + 1)) {
+            auto end = pos + alias.size();
+            if (end == text.size() || (!std::isalnum(text[end]) && text[end] != '_')) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // whether the aggregations give the same with duplicated rows
+    static bool IgnoresDuplicates(Aggregate *aggregate) {
+        for (auto &ae : aggregate->GetAggregatedExpressions()) {
+            if (ae.type != ArithExprNode::AR_AST_EXP || !ae.expr_) return false;
+            auto func = dynamic_cast<geax::frontend::AggFunc *>(ae.expr_);
+            if (!func) return false;
+            if (!func->isDistinct() &&
+                func->funcName() != geax::frontend::GeneralSetFunction::kMin &&
+                func->funcName() != geax::frontend::GeneralSetFunction::kMax) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool Qualifies(VarLenExpand *expand) {
+        if (expand->min_hop_ > 1 || expand->expand_direction_ == ExpandTowards::BIDIRECTIONAL) {
+            return false;
+        }
+        auto &alias = expand->GetRelationship()->Alias();
+        if (alias.rfind(parser::ANONYMOUS, 0) != 0) return false;
+        auto pattern_graph = expand->pattern_graph_;
+        if (!pattern_graph->symbol_table.anot_collection.path_elements.empty()) return false;
+        size_t n_relps = 0;
+        for (auto &relp : pattern_graph->GetRelationships()) {
+            if (!relp.Empty()) n_relps++;
+        }
+        if (n_relps != 1) return false;
+        for (auto op = expand->parent; op; op = op->parent) {
+            switch (op->type) {
+            case OpType::PROJECT:
+                break;
+            case OpType::FILTER:
+                {
+                    auto filter = dynamic_cast<OpFilter *>(op)->Filter();
+                    if (!filter || Mentions(filter->ToString(), alias)) return false;
+                    break;
+                }
+            case OpType::DISTINCT:
+                return true;
+            case OpType::AGGREGATE:
+                return IgnoresDuplicates(dynamic_cast<Aggregate *>(op));
+            default:
+                return false;
+            }
+        }
+        return false;
+    }
+
+    void Impl(OpBase *root) {
+        if (root->type == OpType::VAR_LEN_EXPAND) {
+            auto expand = dynamic_cast<VarLenExpand *>(root);
+            if (Qualifies(expand)) expand->SetFrontierMode();
+        }
+        for (auto child : root->children) Impl(child);
+    }
+
+ public:
+    VarLenExpandByFrontier() : OptPass(typeid(VarLenExpandByFrontier).name()) {}
+
+    bool Gate() override { return true; }
+
+    int Execute(OpBase *root) override {
+        Impl(root);
+        return 0;
+    }
+};
+}  // namespace cypher
@@ -52,6 +52,7 @@ class PassVarLenExpandWithLimit : public OptPass {
         case OpType::FILTER:  // TODO(anyone) ignore irrelevant filters
         case OpType::AGGREGATE:
         case OpType::CARTESIAN_PRODUCT:
+        case OpType::HASH_JOIN:
         case OpType::APPLY:
             return nullptr;
         default:
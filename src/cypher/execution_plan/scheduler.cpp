@@ -43,6 +43,31 @@
 
 namespace cypher {
 
+namespace {
+// Runs the plan of a PROFILE query for its statistics. Its rows are not sent
+// to the bolt client, which gets the dumped plan in their place.
+template <typename Plan>
+void ProfilePlan(RTContext *ctx, Plan *plan) {
+    auto bolt_conn = ctx->bolt_conn_;
+    ctx->bolt_conn_ = nullptr;
+    try {
+        while (1) {
+            try {
+                plan->Execute(ctx);
+                break;
+            } catch (lgraph::TxnCommitException &e) {
+                if (plan->ReadOnly() || !ctx->optimistic_) throw;
+                LOG_DEBUG() << e.what();
+            }
+        }
+    } catch (...) {
+        ctx->bolt_conn_ = bolt_conn;
+        throw;
+    }
+    ctx->bolt_conn_ = bolt_conn;
+}
+}  // namespace
+
 void Scheduler::Eval(RTContext *ctx, const lgraph_api::GraphQueryType &type,
                      const std::string &script, ElapsedTime &elapsed) {
     if (type == lgraph_api::GraphQueryType::CYPHER) {
@@ -92,16 +117,17 @@ void Scheduler::EvalCypher(RTContext *ctx, const std::string &script, ElapsedTim
         plan->Build(visitor.GetQuery(), visitor.CommandType(), ctx);
         plan->Validate(ctx);
         if (plan->CommandType() != parser::CmdType::QUERY) {
-            ctx->result_info_ = std::make_unique<ResultInfo>();
-            ctx->result_ = std::make_unique<lgraph::Result>();
             std::string header, data;
             if (plan->CommandType() == parser::CmdType::EXPLAIN) {
                 header = "@plan";
-                data = plan->DumpPlan(0, false);
+                data = plan->DumpPlan(0, false, true);
             } else {
                 header = "@profile";
-                data = plan->DumpGraph();
+                ProfilePlan(ctx, plan.get());
+                data = plan->DumpPlan(0, true);
             }
+            ctx->result_info_ = std::make_unique<ResultInfo>();
+            ctx->result_ = std::make_unique<lgraph::Result>();
             ctx->result_->ResetHeader({{header, lgraph_api::LGraphType::STRING}});
             auto r = ctx->result_->MutableRecord();
             r->Insert(header, lgraph::FieldData(data));
@@ -146,6 +172,8 @@ void Scheduler::EvalCypher(RTContext *ctx, const std::string &script, ElapsedTim
     } else {
         plan->Execute(ctx);
     }
+    // actual versus estimated rows of each operation
+    LOG_DEBUG() << plan->DumpPlan(0, true);
     elapsed.t_total = fma_common::GetTime() - t0;
     elapsed.t_exec = elapsed.t_total - elapsed.t_compile;
 }
@@ -206,16 +234,17 @@ void Scheduler::EvalCypher2(RTContext *ctx, const std::string &script, ElapsedTi
         }
         plan->Validate(ctx);
         if (visitor.CommandType() != parser::CmdType::QUERY) {
-            ctx->result_info_ = std::make_unique<cypher::ResultInfo>();
-            ctx->result_ = std::make_unique<lgraph::Result>();
             std::string header, data;
             if (visitor.CommandType() == parser::CmdType::EXPLAIN) {
                 header = "@plan";
-                data = plan->DumpPlan(0, false);
+                data = plan->DumpPlan(0, false, true);
             } else {
                 header = "@profile";
-                data = plan->DumpGraph();
+                ProfilePlan(ctx, plan.get());
+                data = plan->DumpPlan(0, true);
             }
+            ctx->result_info_ = std::make_unique<cypher::ResultInfo>();
+            ctx->result_ = std::make_unique<lgraph::Result>();
             ctx->result_->ResetHeader({{header, lgraph_api::LGraphType::STRING}});
             auto r = ctx->result_->MutableRecord();
             r->Insert(header, lgraph::FieldData(data));
@@ -263,6 +292,7 @@ void Scheduler::EvalCypher2(RTContext *ctx, const std::string &script, ElapsedTi
     }
     LOG_DEBUG() << "-----result-----";
     LOG_DEBUG() << ctx->result_->Dump(false);
+    LOG_DEBUG() << plan->DumpPlan(0, true);
     elapsed.t_total = fma_common::GetTime() - t0;
     elapsed.t_exec = elapsed.t_total - elapsed.t_compile;
 }
@@ -42,6 +42,9 @@ class GraphNameCheckerVisitor : public Visitor {
     void Visit(const Apply &op) override{};
     void Visit(const Argument &op) override{};
     void Visit(const CartesianProduct &op) override{};
+    void Visit(const HashJoin &op) override{};
+    void Visit(const ExpandIntersect &op) override{};
+    void Visit(const NodeIndexScan &op) override{};
     void Visit(const OpCreate &op) override{};
     void Visit(const OpDelete &op) override{};
     void Visit(const Distinct &op) override{};
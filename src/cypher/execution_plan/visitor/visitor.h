@@ -22,6 +22,9 @@ class AllNodeScanDynamic;
 class Apply;
 class Argument;
 class CartesianProduct;
+class HashJoin;
+class ExpandIntersect;
+class NodeIndexScan;
 class OpCreate;
 class OpGqlCreate;
 class OpDelete;
@@ -75,6 +78,9 @@ class Visitor {
     virtual void Visit(const Apply &op) = 0;
     virtual void Visit(const Argument &op) = 0;
     virtual void Visit(const CartesianProduct &op) = 0;
+    virtual void Visit(const HashJoin &op) = 0;
+    virtual void Visit(const ExpandIntersect &op) = 0;
+    virtual void Visit(const NodeIndexScan &op) = 0;
     virtual void Visit(const OpCreate &op) = 0;
     virtual void Visit(const OpDelete &op) = 0;
     virtual void Visit(const Distinct &op) = 0;
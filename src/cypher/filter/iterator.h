@@ -256,8 +256,9 @@ class VIter {
     }
 
     VIter(lgraph::Transaction *txn, IteratorType type, const std::string &label,
-          const std::string &field, const FieldData &key_start, const FieldData &key_end) {
-        Initialize(txn, type, label, field, key_start, key_end);
+          const std::string &field, const FieldData &key_start, const FieldData &key_end,
+          bool reverse = false) {
+        Initialize(txn, type, label, field, key_start, key_end, reverse);
     }
 
     VIter(lgraph::Transaction *txn, IteratorType type, const std::string &label) {
@@ -312,13 +313,13 @@ class VIter {
 
     void Initialize(lgraph::Transaction *txn, IteratorType type, const std::string &label,
                     const std::string &field, const FieldData &key_start,
-                    const FieldData &key_end) {
+                    const FieldData &key_end, bool reverse = false) {
         FreeIter();
         _txn = txn;
         _type = type;
         if (_type == INDEX_ITER) {
             _iit = new lgraph::VertexIndexIterator(
-                _txn->GetVertexIndexIterator(label, field, key_start, key_end));
+                _txn->GetVertexIndexIterator(label, field, key_start, key_end, reverse));
         } else {
             throw lgraph::CypherException("VIter constructor type error.");
         }
@@ -326,6 +327,7 @@ class VIter {
         _field = field;
         _key_start = key_start;
         _key_end = key_end;
+        _reverse = reverse;
     }
 
     void Initialize(lgraph::Transaction *txn, const std::string &label, const std::string &field,
@@ -362,12 +364,33 @@ class VIter {
         _field = std::move(rhs._field);
         _key_start = std::move(rhs._key_start);
         _key_end = std::move(rhs._key_end);
+        _reverse = rhs._reverse;
     }
 
     VIter &operator=(VIter &&rhs) = delete;
 
     bool Initialized() const { return _vit != nullptr; }
 
+    /* Whether this is an index iterator over label:field, which can Seek.  */
+    bool IsIndexIterOf(const std::string &label, const std::string &field) const {
+        return _type == INDEX_ITER && _iit && _label == label && _field == field;
+    }
+
+    /* Order in which a batch of keys is sought, keys of one type are in index
+     * order then, so that each seek starts close to the last one.  */
+    static bool SeekOrderLess(const FieldData &a, const FieldData &b) {
+        return a.type != b.type ? a.type < b.type : a < b;
+    }
+
+    /* Moves an index iterator to the nodes of key, reusing its cursor.  */
+    bool Seek(const FieldData &key) {
+        if (_type != INDEX_ITER || !_iit) throw lgraph::CypherException("VIter seek type error.");
+        _key_start = key;
+        _key_end = key;
+        return _iit->Seek(
+            lgraph::field_data_helper::FieldDataToValueOfFieldType(key, _iit->KeyType()));
+    }
+
     bool IsValid() const {
         switch (_type) {
         case VERTEX_ITER:
@@ -436,7 +459,16 @@ class VIter {
         case VERTEX_ITER:
             return _txn->GetVertexField(*_vit, fd);
         case INDEX_ITER:
-            return _txn->GetVertexField(_iit->GetVid(), fd);
+            {
+                // index-only read of the key or a field included in the index,
+                // writes may have changed the vertex since the entry was read
+                if (_txn->IsReadOnly()) {
+                    FieldData included;
+                    if (fd == _field && _iit->KeyIsComplete()) return _iit->GetKeyData();
+                    if (_iit->GetIncludedField(fd, included)) return included;
+                }
+                return _txn->GetVertexField(_iit->GetVid(), fd);
+            }
         case WEAK_INDEX_ITER:
             return _txn->GetVertexField(_wit->GetId(), fd);
         case LABEL_VERTEX_ITER:
@@ -514,7 +546,7 @@ class VIter {
             // TODO(anyone): use goto method
             delete _iit;
             _iit = new lgraph::VertexIndexIterator(
-                _txn->GetVertexIndexIterator(_label, _field, _key_start, _key_end));
+                _txn->GetVertexIndexIterator(_label, _field, _key_start, _key_end, _reverse));
             break;
         case WEAK_INDEX_ITER:
             delete _wit;
@@ -541,6 +573,7 @@ class VIter {
     std::string _field;
     FieldData _key_start;
     FieldData _key_end;
+    bool _reverse = false;  // index iterated in descending order
 
     std::string Properties(const lgraph::graph::VertexIterator &it) const {
         std::string p;
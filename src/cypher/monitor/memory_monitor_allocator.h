@@ -34,6 +34,11 @@ class MemoryMonitorAllocator {
     };
 
     MemoryMonitorAllocator() { allocCount = 0; }
+    // node-based containers rebind the allocator to their node types
+    template <class U>
+    explicit MemoryMonitorAllocator(const MemoryMonitorAllocator<U> &) {
+        allocCount = 0;
+    }
     ~MemoryMonitorAllocator() = default;
 
     pointer allocate(size_type numObjects) {
@@ -60,3 +65,13 @@ class MemoryMonitorAllocator {
  private:
     size_type allocCount;
 };
+
+template <class T, class U>
+bool operator==(const MemoryMonitorAllocator<T> &, const MemoryMonitorAllocator<U> &) {
+    return true;
+}
+
+template <class T, class U>
+bool operator!=(const MemoryMonitorAllocator<T> &, const MemoryMonitorAllocator<U> &) {
+    return false;
+}
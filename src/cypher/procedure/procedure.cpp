@@ -16,6 +16,9 @@
 // Created by wt on 19-1-10.
 //
 
+#include <atomic>
+#include <mutex>
+#include <queue>
 #include <regex>
 #include <tuple>
 
@@ -28,8 +31,11 @@
 #include "server/state_machine.h"
 #include "restful/server/json_convert.h"
 #include "cypher/graph/common.h"
+#include "cypher/execution_plan/optimization/cost_model.h"
 #include "cypher/procedure/procedure.h"
 #include "cypher/procedure/utils.h"
+#include "cypher/utils/frontier_expander.h"
+#include "lgraph/lgraph_traversal.h"
 #include "butil/endpoint.h"
 #include "cypher/monitor/memory_monitor_allocator.h"
 #include "fma-common/encrypt.h"
@@ -357,6 +363,74 @@ void BuiltinProcedure::DbWarmUp(RTContext *ctx, const Record *record, const VEC_
     FillProcedureYieldItem("db.warmup", yield_items, records);
 }
 
+void BuiltinProcedure::DbWarmUpLabels(RTContext *ctx, const Record *record, const VEC_EXPR &args,
+                                      const VEC_STR &yield_items,
+                                      std::vector<cypher::Record> *records) {
+    CYPHER_ARG_CHECK(args.size() == 2, FMA_FMT("Function requires 2 arguments, but {} are "
+                                               "given. Usage: db.warmupLabels(labels, "
+                                               "indexes_only)",
+                                               args.size()))
+    CYPHER_ARG_CHECK(args[0].IsArray(), "db.warmupLabels: `labels` must be list")
+    CYPHER_ARG_CHECK(args[1].IsBool(), "db.warmupLabels: `indexes_only` must be boolean")
+    CYPHER_DB_PROCEDURE_GRAPH_CHECK();
+    CheckProcedureYieldItem("db.warmupLabels", yield_items);
+    std::vector<std::string> labels;
+    for (auto &label : *args[0].constant.array) {
+        CYPHER_ARG_CHECK(label.IsString(), "db.warmupLabels: `labels` must be strings")
+        labels.emplace_back(label.AsString());
+    }
+    double t1 = fma_common::GetTime();
+    ctx->txn_.reset();
+    ctx->ac_db_->WarmUp(labels, args[1].constant.scalar.AsBool());
+    double t2 = fma_common::GetTime();
+    Record r;
+    r.AddConstant(
+        lgraph::FieldData("Warm up successful in " + std::to_string(t2 - t1) + " seconds."));
+    records->emplace_back(r.Snapshot());
+    FillProcedureYieldItem("db.warmupLabels", yield_items, records);
+}
+
+void BuiltinProcedure::DbSpaceStat(RTContext *ctx, const Record *record, const VEC_EXPR &args,
+                                   const VEC_STR &yield_items,
+                                   std::vector<cypher::Record> *records) {
+    CYPHER_ARG_CHECK(args.empty(), FMA_FMT("Function requires 0 arguments, but {} are "
+                                           "given. Usage: db.spaceStat()",
+                                           args.size()))
+    CYPHER_DB_PROCEDURE_GRAPH_CHECK();
+    CheckProcedureYieldItem("db.spaceStat", yield_items);
+    ctx->txn_.reset();
+    auto stat = ctx->ac_db_->GetSpaceStat();
+    Record r;
+    r.AddConstant(lgraph::FieldData::Int64(static_cast<int64_t>(stat.file_size)));
+    r.AddConstant(lgraph::FieldData::Int64(static_cast<int64_t>(stat.used_size)));
+    r.AddConstant(lgraph::FieldData::Int64(static_cast<int64_t>(stat.free_size)));
+    r.AddConstant(lgraph::FieldData::Int64(static_cast<int64_t>(stat.readers)));
+    r.AddConstant(lgraph::FieldData::Double(stat.oldest_reader_age));
+    records->emplace_back(r.Snapshot());
+    FillProcedureYieldItem("db.spaceStat", yield_items, records);
+}
+
+void BuiltinProcedure::DbCompact(RTContext *ctx, const Record *record, const VEC_EXPR &args,
+                                 const VEC_STR &yield_items,
+                                 std::vector<cypher::Record> *records) {
+    CYPHER_ARG_CHECK(args.empty(), FMA_FMT("Function requires 0 arguments, but {} are "
+                                           "given. Usage: db.compact()",
+                                           args.size()))
+    CYPHER_DB_PROCEDURE_GRAPH_CHECK();
+    CheckProcedureYieldItem("db.compact", yield_items);
+    // the copy is made with no txn of this thread open
+    ctx->txn_.reset();
+    size_t size_before = ctx->ac_db_->GetSpaceStat().file_size;
+    // the switch waits for the other requests to finish, as a snapshot load does
+    ctx->ac_db_->Compact(&ctx->galaxy_->GetReloadLock());
+    size_t size_after = ctx->ac_db_->GetSpaceStat().file_size;
+    Record r;
+    r.AddConstant(lgraph::FieldData::Int64(static_cast<int64_t>(size_before)));
+    r.AddConstant(lgraph::FieldData::Int64(static_cast<int64_t>(size_after)));
+    records->emplace_back(r.Snapshot());
+    FillProcedureYieldItem("db.compact", yield_items, records);
+}
+
 void BuiltinProcedure::DbmsProcedures(RTContext *ctx, const Record *record,
                                       const VEC_EXPR &args, const VEC_STR &yield_items,
                                       std::vector<cypher::Record> *records) {
@@ -1505,6 +1579,38 @@ void BuiltinProcedure::DbAlterLabelModFields(RTContext *ctx, const Record *recor
     FillProcedureYieldItem("db.alterLabelModFields", yield_items, records);
 }
 
+// params: vertex/edge, label, batch_size, interval_ms
+void BuiltinProcedure::DbUpgradeLabelRecords(RTContext *ctx, const Record *record,
+                                             const VEC_EXPR &args,
+                                             const VEC_STR &yield_items,
+                                             std::vector<Record> *records) {
+    CYPHER_DB_PROCEDURE_GRAPH_CHECK();
+    CheckProcedureYieldItem("db.upgradeLabelRecords", yield_items);
+    /* close the previous txn first, in case of nested transaction */
+    if (ctx->txn_) ctx->txn_->Abort();
+    CYPHER_ARG_CHECK(args.size() == 4,
+                     "This function takes 4 arguments. e.g. db.upgradeLabelRecords(label_type, "
+                     "label_name, batch_size, interval_ms)")
+    CYPHER_ARG_CHECK(args[2].IsInteger() && args[2].constant.scalar.integer() > 0,
+                     "db.upgradeLabelRecords: `batch_size` must be a positive integer")
+    CYPHER_ARG_CHECK(args[3].IsInteger() && args[3].constant.scalar.integer() >= 0,
+                     "db.upgradeLabelRecords: `interval_ms` must be a non-negative integer")
+    bool is_vertex = ParseIsVertex(args[0].constant.scalar.AsString());
+    std::string label = ParseStringArg(args[1], "label_name");
+    auto ac_db = ctx->galaxy_->OpenGraph(ctx->user_, ctx->graph_);
+    size_t affected = 0;
+    auto ret = ac_db.UpgradeLabelRecords(is_vertex, label, args[2].constant.scalar.integer(),
+                                         args[3].constant.scalar.integer(), &affected);
+    if (ret) {
+        Record r;
+        r.AddConstant(lgraph::FieldData::Int64(static_cast<int64_t>(affected)));
+        records->emplace_back(r.Snapshot());
+    } else {
+        throw lgraph::LabelNotExistException(label);
+    }
+    FillProcedureYieldItem("db.upgradeLabelRecords", yield_items, records);
+}
+
 void BuiltinProcedure::DbCreateEdgeLabel(RTContext *ctx, const Record *record,
                                          const VEC_EXPR &args, const VEC_STR &yield_items,
                                          std::vector<Record> *records) {
@@ -1559,6 +1665,114 @@ void BuiltinProcedure::DbAddVertexIndex(RTContext *ctx, const Record *record,
     FillProcedureYieldItem("db.addIndex", yield_items, records);
 }
 
+void BuiltinProcedure::DbAlterVertexIndexInclude(RTContext *ctx, const Record *record,
+                                                 const VEC_EXPR &args,
+                                                 const VEC_STR &yield_items,
+                                                 std::vector<Record> *records) {
+    CYPHER_ARG_CHECK(args.size() == 3,
+                     "need 3 parameters, e.g. db.alterVertexIndexInclude(label_name, field_name, "
+                     "include_fields)")
+    CYPHER_ARG_CHECK(args[0].IsString(), "label_name type should be string")
+    CYPHER_ARG_CHECK(args[1].IsString(), "field_name type should be string")
+    CYPHER_ARG_CHECK(args[2].IsArray(), "include_fields type should be list")
+    CYPHER_DB_PROCEDURE_GRAPH_CHECK();
+    CheckProcedureYieldItem("db.alterVertexIndexInclude", yield_items);
+    /* close the previous txn first, in case of nested transaction */
+    if (ctx->txn_) ctx->txn_->Abort();
+    auto label = args[0].constant.AsString();
+    auto field = args[1].constant.AsString();
+    std::vector<std::string> include_fields;
+    for (auto &arg : *args[2].constant.array) {
+        include_fields.push_back(arg.AsString());
+    }
+    auto ac_db = ctx->galaxy_->OpenGraph(ctx->user_, ctx->graph_);
+    bool success = ac_db.AlterVertexIndexInclude(label, field, include_fields);
+    if (!success) {
+        THROW_CODE(InputError, "VertexIndex [{}:{}] does not exist.", label, field);
+    }
+    FillProcedureYieldItem("db.alterVertexIndexInclude", yield_items, records);
+}
+
+void BuiltinProcedure::DbAddVertexColumn(RTContext *ctx, const Record *record,
+                                         const VEC_EXPR &args, const VEC_STR &yield_items,
+                                         std::vector<Record> *records) {
+    CheckProcedureYieldItem("db.addVertexColumn", yield_items);
+    CYPHER_ARG_CHECK(args.size() == 2,
+                     "need two parameters, e.g. db.addVertexColumn(label_name, field_name)")
+    CYPHER_ARG_CHECK(args[0].IsString(), "label_name type should be string")
+    CYPHER_ARG_CHECK(args[1].IsString(), "field_name type should be string")
+    CYPHER_DB_PROCEDURE_GRAPH_CHECK();
+    /* close the previous txn first, in case of nested transaction */
+    if (ctx->txn_) ctx->txn_->Abort();
+    auto label = args[0].constant.scalar.AsString();
+    auto field = args[1].constant.scalar.AsString();
+    bool success = ctx->ac_db_->AddVertexColumn(label, field);
+    if (!success) {
+        THROW_CODE(InputError, "VertexColumn [{}:{}] already exists.", label, field);
+    }
+    FillProcedureYieldItem("db.addVertexColumn", yield_items, records);
+}
+
+void BuiltinProcedure::DbDeleteVertexColumn(RTContext *ctx, const Record *record,
+                                            const VEC_EXPR &args, const VEC_STR &yield_items,
+                                            std::vector<Record> *records) {
+    CheckProcedureYieldItem("db.deleteVertexColumn", yield_items);
+    CYPHER_ARG_CHECK(args.size() == 2,
+                     "need two parameters, e.g. db.deleteVertexColumn(label_name, field_name)")
+    CYPHER_ARG_CHECK(args[0].IsString(), "label_name type should be string")
+    CYPHER_ARG_CHECK(args[1].IsString(), "field_name type should be string")
+    CYPHER_DB_PROCEDURE_GRAPH_CHECK();
+    if (ctx->txn_) ctx->txn_->Abort();
+    auto label = args[0].constant.scalar.AsString();
+    auto field = args[1].constant.scalar.AsString();
+    bool success = ctx->ac_db_->DeleteVertexColumn(label, field);
+    if (!success) {
+        THROW_CODE(InputError, "VertexColumn [{}:{}] does not exist.", label, field);
+    }
+    FillProcedureYieldItem("db.deleteVertexColumn", yield_items, records);
+}
+
+void BuiltinProcedure::DbListVertexColumns(RTContext *ctx, const Record *record,
+                                           const VEC_EXPR &args, const VEC_STR &yield_items,
+                                           std::vector<Record> *records) {
+    CYPHER_ARG_CHECK(args.empty(), FMA_FMT("Function requires 0 arguments, but {} are "
+                                           "given. Usage: db.listVertexColumns()",
+                                           args.size()))
+    CYPHER_DB_PROCEDURE_GRAPH_CHECK();
+    CheckProcedureYieldItem("db.listVertexColumns", yield_items);
+    for (auto &c : ctx->txn_->GetTxn()->ListVertexColumns()) {
+        Record r;
+        r.AddConstant(lgraph::FieldData(c.first));
+        r.AddConstant(lgraph::FieldData(c.second));
+        records->emplace_back(r.Snapshot());
+    }
+    FillProcedureYieldItem("db.listVertexColumns", yield_items, records);
+}
+
+void BuiltinProcedure::DbVertexColumnStat(RTContext *ctx, const Record *record,
+                                          const VEC_EXPR &args, const VEC_STR &yield_items,
+                                          std::vector<Record> *records) {
+    CYPHER_ARG_CHECK(args.size() == 2,
+                     "need two parameters, e.g. db.vertexColumnStat(label_name, field_name)")
+    CYPHER_ARG_CHECK(args[0].IsString(), "label_name type should be string")
+    CYPHER_ARG_CHECK(args[1].IsString(), "field_name type should be string")
+    CYPHER_DB_PROCEDURE_GRAPH_CHECK();
+    CheckProcedureYieldItem("db.vertexColumnStat", yield_items);
+    auto txn = ctx->txn_->GetTxn();
+    lgraph::ColumnStore *store = txn->GetVertexColumnStore(args[0].constant.scalar.AsString(),
+                                                           args[1].constant.scalar.AsString());
+    lgraph::ColumnStat stat = store->GetStat(txn->GetTxn());
+    Record r;
+    r.AddConstant(lgraph::FieldData::Int64(static_cast<int64_t>(stat.count)));
+    r.AddConstant(stat.min);
+    r.AddConstant(stat.max);
+    r.AddConstant(lgraph::FieldData::Double(stat.sum));
+    r.AddConstant(lgraph::FieldData::Int64(static_cast<int64_t>(stat.n_blocks)));
+    r.AddConstant(lgraph::FieldData::Int64(static_cast<int64_t>(stat.bytes)));
+    records->emplace_back(r.Snapshot());
+    FillProcedureYieldItem("db.vertexColumnStat", yield_items, records);
+}
+
 void BuiltinProcedure::DbAddVertexCompositeIndex(cypher::RTContext *ctx,
                                                  const cypher::Record *record,
                                                  const cypher::VEC_EXPR &args,
@@ -1832,6 +2046,7 @@ void BuiltinProcedure::DbmsMetaRefreshCount(RTContext *ctx, const Record *record
     if (ctx->txn_) ctx->txn_->Abort();
     auto ac_db = ctx->galaxy_->OpenGraph(ctx->user_, ctx->graph_);
     ac_db.RefreshCount();
+    GraphStatistics::Invalidate(ctx->graph_);
     FillProcedureYieldItem("dbms.meta.refreshCount", yield_items, records);
 }
 
@@ -2055,6 +2270,13 @@ void BuiltinProcedure::DbmsGraphCreateGraph(RTContext *ctx, const cypher::Record
         CYPHER_ARG_CHECK(args[2].IsInteger(), "Max_size_GB must be an integer");
         config.db_size = ((size_t)args[2].constant.scalar.integer()) << 30;
     }
+    if (args.size() >= 4) {
+        CYPHER_ARG_CHECK(args[3].IsString(), "kv_engine must be string");
+        config.kv_engine = args[3].constant.scalar.AsString();
+        CYPHER_ARG_CHECK(config.kv_engine == lgraph::_detail::KV_ENGINE_LMDB ||
+                             config.kv_engine == lgraph::_detail::KV_ENGINE_ROCKSDB,
+                         "kv_engine must be lmdb or rocksdb");
+    }
     bool success =
         ctx->galaxy_->CreateGraph(ctx->user_, args[0].constant.scalar.AsString(), config);
     if (!success) {
@@ -3551,29 +3773,97 @@ void BuiltinProcedure::DbBoltGetRaftStatus(RTContext *ctx, const Record *record,
     nlohmann::json obj = nlohmann::json::parse(status.s.String());
     obj["raftlog"]["first"] = status.first_log;
     obj["raftlog"]["last"] = status.last_log;
+    obj["apply"]["committed"] = status.committed_index;
+    obj["apply"]["applied"] = status.applied_index;
+    obj["apply"]["batches"] = status.apply_batches;
+    obj["apply"]["last_lag_us"] = status.last_apply_lag_us;
+    obj["apply"]["max_lag_us"] = status.max_apply_lag_us;
     Record r;
     r.AddConstant(lgraph::FieldData::String(obj.dump(4)));
     records->emplace_back(r.Snapshot());
     FillProcedureYieldItem("db.bolt.getRaftStatus", yield_items, records);
 }
 
+/* Open addressing hash map from vertex ids to T, holding the visited vertices of the
+ * shortest path searches. Entries are never erased, and Find may be called concurrently
+ * as long as nothing is emplaced.  */
+template <typename T>
+class VidMap {
+    std::vector<lgraph::VertexId> keys_;
+    std::vector<T> values_;
+    size_t size_ = 0;
+
+    size_t Slot(lgraph::VertexId vid) const {
+        size_t mask = keys_.size() - 1;
+        uint64_t h = static_cast<uint64_t>(vid) * 0x9E3779B97F4A7C15ULL;
+        size_t i = (h ^ (h >> 32)) & mask;
+        while (keys_[i] != vid && keys_[i] != -1) i = (i + 1) & mask;
+        return i;
+    }
+
+    void Rehash(size_t capacity) {
+        std::vector<lgraph::VertexId> keys(capacity, -1);
+        std::vector<T> values(capacity);
+        keys_.swap(keys);
+        values_.swap(values);
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (keys[i] == -1) continue;
+            auto s = Slot(keys[i]);
+            keys_[s] = keys[i];
+            values_[s] = std::move(values[i]);
+        }
+    }
+
+ public:
+    VidMap() : keys_(64, -1), values_(64) {}
+
+    T *Find(lgraph::VertexId vid) {
+        auto s = Slot(vid);
+        return keys_[s] == vid ? &values_[s] : nullptr;
+    }
+
+    const T *Find(lgraph::VertexId vid) const {
+        auto s = Slot(vid);
+        return keys_[s] == vid ? &values_[s] : nullptr;
+    }
+
+    bool Contains(lgraph::VertexId vid) const { return Find(vid) != nullptr; }
+
+    const T &At(lgraph::VertexId vid) const {
+        auto v = Find(vid);
+        CYPHER_THROW_ASSERT(v);
+        return *v;
+    }
+
+    // Returns false if vid is already in the map.
+    bool Emplace(lgraph::VertexId vid, const T &value) {
+        if ((size_ + 1) * 2 > keys_.size()) Rehash(keys_.size() * 2);
+        auto s = Slot(vid);
+        if (keys_[s] == vid) return false;
+        keys_[s] = vid;
+        values_[s] = value;
+        size_++;
+        return true;
+    }
+};
+
 static void _FetchPath(lgraph::Transaction &txn, size_t hops,
-                       std::unordered_map<lgraph::VertexId, lgraph::VertexId> &parent,
-                       std::unordered_map<lgraph::VertexId, lgraph::VertexId> &child,
+                       const VidMap<lgraph::VertexId> &parent,
+                       const VidMap<lgraph::VertexId> &child,
                        lgraph::VertexId vid_from, lgraph::VertexId vid_a, lgraph::VertexId vid_b,
                        lgraph::VertexId vid_to, cypher::Path &path) {
     std::vector<lgraph::VertexId> vids;
     auto vid = vid_a;
     while (vid != vid_from) {
         vids.push_back(vid);
-        vid = parent[vid];
+        vid = parent.At(vid);
     }
     vids.push_back(vid);
     std::reverse(vids.begin(), vids.end());
     vid = vid_b;
     while (vid != vid_to) {
         vids.push_back(vid);
-        vid = child[vid];
+        vid = child.At(vid);
     }
     vids.push_back(vid);
     if (hops != 0 && vids.size() != hops + 1) {
@@ -3605,13 +3895,15 @@ struct EdgeFilter {
     EDGE_PROPERTY_FILTER_T property_filter;
 };
 
-static std::vector<lgraph::VertexId> _GetNeighbors(lgraph::Transaction &txn, lgraph::VertexId vid,
-                                                   const std::vector<EdgeFilter>& edge_filters,
-                                                   const parser::LinkDirection &direction,
-                                                   std::optional<size_t> per_node_limit) {
+// Lists the neighbors of vid into neighbors, which is reused across the vertices of a search.
+static void _GetNeighbors(lgraph::Transaction &txn, lgraph::VertexId vid,
+                          const std::vector<EdgeFilter>& edge_filters,
+                          const parser::LinkDirection &direction,
+                          std::optional<size_t> per_node_limit,
+                          std::vector<lgraph::VertexId> &neighbors) {
     auto vit = txn.GetVertexIterator(vid);
     CYPHER_THROW_ASSERT(vit.IsValid());
-    std::vector<lgraph::VertexId> neighbors;
+    neighbors.clear();
     if (edge_filters.empty()) {
         bool out_edge_left = false, in_edge_left = false;
         neighbors = vit.ListDstVids(nullptr, nullptr,
@@ -3668,7 +3960,49 @@ static std::vector<lgraph::VertexId> _GetNeighbors(lgraph::Transaction &txn, lgr
             }
         }
     }
-    return neighbors;
+}
+
+// Calls visit(eit, nbr) on the edges of vid towards direction that pass edge_filters.
+template <typename Visit>
+static void _ForEachEdge(lgraph::Transaction &txn, lgraph::VertexId vid,
+                         const std::vector<EdgeFilter> &edge_filters,
+                         const parser::LinkDirection &direction, const Visit &visit) {
+    bool out = direction != parser::LinkDirection::RIGHT_TO_LEFT;
+    bool in = direction != parser::LinkDirection::LEFT_TO_RIGHT;
+    if (edge_filters.empty()) {
+        if (out) {
+            for (auto eit = txn.GetOutEdgeIterator(vid); eit.IsValid(); eit.Next()) {
+                visit(eit, eit.GetDst());
+            }
+        }
+        if (in) {
+            for (auto eit = txn.GetInEdgeIterator(vid); eit.IsValid(); eit.Next()) {
+                visit(eit, eit.GetSrc());
+            }
+        }
+        return;
+    }
+    for (auto &edge_filter : edge_filters) {
+        auto edge_lid = txn.GetLabelId(false, edge_filter.label);
+        if (out) {
+            for (auto eit = txn.GetOutEdgeIterator(lgraph::EdgeUid(vid, 0, edge_lid, 0, 0), true);
+                 eit.IsValid() && eit.GetLabelId() == edge_lid; eit.Next()) {
+                if (_Filter(txn, eit, edge_filter.property_filter)) visit(eit, eit.GetDst());
+            }
+        }
+        if (in) {
+            for (auto eit = txn.GetInEdgeIterator(lgraph::EdgeUid(0, vid, edge_lid, 0, 0), true);
+                 eit.IsValid() && eit.GetLabelId() == edge_lid; eit.Next()) {
+                if (_Filter(txn, eit, edge_filter.property_filter)) visit(eit, eit.GetSrc());
+            }
+        }
+    }
+}
+
+static parser::LinkDirection _ReverseDirection(parser::LinkDirection dir) {
+    return dir == parser::LinkDirection::RIGHT_TO_LEFT   ? parser::LinkDirection::LEFT_TO_RIGHT
+           : dir == parser::LinkDirection::LEFT_TO_RIGHT ? parser::LinkDirection::RIGHT_TO_LEFT
+                                                         : parser::LinkDirection::DIR_NOT_SPECIFIED;
 }
 
 /* All the shortestPath procedures assume that they are being executed on undirected graphs.
@@ -3678,7 +4012,7 @@ static std::vector<lgraph::VertexId> _GetNeighbors(lgraph::Transaction &txn, lgr
  * running these algorithms on a graph where the direction is important, you can use the direction
  * parameter. For example, direction:"INCOMING" or direction:"OUTGOING".
  */
-static void _P2PUnweightedShortestPath(lgraph::Transaction &txn, lgraph::VertexId start_vid,
+static void _P2PUnweightedShortestPath(FrontierExpander &expander, lgraph::VertexId start_vid,
                                        lgraph::VertexId end_vid,
                                        const std::vector<EdgeFilter> &edge_filters,
                                        size_t max_hops, cypher::Path &path,
@@ -3687,69 +4021,173 @@ static void _P2PUnweightedShortestPath(lgraph::Transaction &txn, lgraph::VertexI
     path.Clear();
     path.SetStart(start_vid);
     if (start_vid == end_vid) return;
-    std::unordered_map<lgraph::VertexId, lgraph::VertexId> parent{{start_vid, start_vid}};
-    std::unordered_map<lgraph::VertexId, lgraph::VertexId> child{{end_vid, end_vid}};
+    VidMap<lgraph::VertexId> parent, child;
+    parent.Emplace(start_vid, start_vid);
+    child.Emplace(end_vid, end_vid);
     std::vector<lgraph::VertexId> forward_q{start_vid};
     std::vector<lgraph::VertexId> backward_q{end_vid};
     size_t hops = 0;
     parser::LinkDirection forward_dir = dir;
-    parser::LinkDirection backward_dir =
-        dir == parser::LinkDirection::RIGHT_TO_LEFT   ? parser::LinkDirection::LEFT_TO_RIGHT
-        : dir == parser::LinkDirection::LEFT_TO_RIGHT ? parser::LinkDirection::RIGHT_TO_LEFT
-                                                      : parser::LinkDirection::DIR_NOT_SPECIFIED;
+    parser::LinkDirection backward_dir = _ReverseDirection(dir);
+    // what a block of the frontier reaches
+    struct Reached {
+        std::vector<lgraph::VertexId> nbrs;
+        // <neighbor, vertex of the frontier> not visited before this level
+        std::vector<std::pair<lgraph::VertexId, lgraph::VertexId>> unvisited;
+        // the vertex meeting the other search, and its neighbor visited by that search
+        lgraph::VertexId meet = -1, meet_nbr = -1;
+    };
+    std::vector<Reached> reached;
     while (hops++ < max_hops) {
-        std::vector<lgraph::VertexId> next_q;
         // decide which way to search first
-        if (forward_q.size() <= backward_q.size()) {
-            // search forward
-            for (auto vid : forward_q) {
-                auto nbrs =
-                    _GetNeighbors(txn, vid, edge_filters, forward_dir, per_node_limit);
-                for (auto nbr : nbrs) {
-                    if (child.find(nbr) != child.end()) {
-                        // found the path
-                        _FetchPath(txn, hops, parent, child, start_vid, vid, nbr, end_vid, path);
-                        return;
-                    }
-                    auto it = parent.find(nbr);
-                    if (it == parent.end()) {
-                        parent.emplace_hint(it, nbr, vid);
-                        next_q.push_back(nbr);
+        bool forward = forward_q.size() <= backward_q.size();
+        auto &q = forward ? forward_q : backward_q;
+        auto &visited = forward ? parent : child;
+        auto &other = forward ? child : parent;
+        auto nbr_dir = forward ? forward_dir : backward_dir;
+        size_t n = expander.Expand(
+            q,
+            [&](lgraph::Transaction &txn, lgraph::VertexId vid, Reached &r) {
+                _GetNeighbors(txn, vid, edge_filters, nbr_dir, per_node_limit, r.nbrs);
+                for (auto nbr : r.nbrs) {
+                    if (other.Contains(nbr)) {
+                        r.meet = vid;
+                        r.meet_nbr = nbr;
+                        return false;
                     }
+                    if (!visited.Contains(nbr)) r.unvisited.emplace_back(nbr, vid);
                 }
+                return true;
+            },
+            reached);
+        if (reached[n - 1].meet != -1) {
+            // found the path
+            auto vid = reached[n - 1].meet, nbr = reached[n - 1].meet_nbr;
+            if (forward) {
+                _FetchPath(expander.Txn(), hops, parent, child, start_vid, vid, nbr, end_vid,
+                           path);
+            } else {
+                _FetchPath(expander.Txn(), hops, parent, child, start_vid, nbr, vid, end_vid,
+                           path);
             }
-            if (next_q.empty()) break;
-            forward_q = std::move(next_q);
-        } else {
-            for (auto vid : backward_q) {
-                auto nbrs =
-                    _GetNeighbors(txn, vid, edge_filters, backward_dir, per_node_limit);
-                for (auto nbr : nbrs) {
-                    if (parent.find(nbr) != parent.end()) {
-                        // found the path
-                        _FetchPath(txn, hops, parent, child, start_vid, nbr, vid, end_vid, path);
-                        return;
-                    }
-                    auto it = child.find(nbr);
-                    if (it == child.end()) {
-                        child.emplace_hint(it, nbr, vid);
-                        next_q.push_back(nbr);
-                    }
-                }
+            return;
+        }
+        std::vector<lgraph::VertexId> next_q;
+        for (size_t b = 0; b < n; b++) {
+            for (auto &u : reached[b].unvisited) {
+                if (visited.Emplace(u.first, u.second)) next_q.push_back(u.first);
             }
-            if (next_q.empty()) break;
-            backward_q = std::move(next_q);
         }
+        if (next_q.empty()) break;
+        q = std::move(next_q);
     }
 }
 
+/* Bidirectional Dijkstra. The searches from both ends take turns to settle the vertex
+ * nearest to their end, until the distances at the tops of the two heaps add up to no
+ * less than the shortest path met so far. Weights are read from the weight property of
+ * the edges and must not be negative. Returns the cost of the path, or -1 if there is
+ * no path.  */
+static double _P2PWeightedShortestPath(lgraph::Transaction &txn, lgraph::VertexId start_vid,
+                                       lgraph::VertexId end_vid,
+                                       const std::vector<EdgeFilter> &edge_filters,
+                                       const std::string &weight, cypher::Path &path,
+                                       parser::LinkDirection dir) {
+    path.Clear();
+    path.SetStart(start_vid);
+    if (start_vid == end_vid) return 0;
+    struct Label {
+        double dist = 0;
+        // the edge the vertex is reached by, and the vertex on its other end
+        lgraph::EdgeUid edge;
+        lgraph::VertexId prev = -1;
+        bool settled = false;
+    };
+    typedef std::pair<double, lgraph::VertexId> HeapItem;
+    std::priority_queue<HeapItem, std::vector<HeapItem>, std::greater<HeapItem>> heaps[2];
+    VidMap<Label> labels[2];
+    parser::LinkDirection dirs[2] = {dir, _ReverseDirection(dir)};
+    lgraph::VertexId ends[2] = {start_vid, end_vid};
+    for (int side = 0; side < 2; side++) {
+        labels[side].Emplace(ends[side], Label());
+        heaps[side].emplace(0, ends[side]);
+    }
+    double best = std::numeric_limits<double>::infinity();
+    lgraph::VertexId meet = -1;
+    auto task_ctx = lgraph_api::GetThreadContext();
+    size_t n_settled = 0;
+    while (!heaps[0].empty() && !heaps[1].empty() &&
+           heaps[0].top().first + heaps[1].top().first < best) {
+        if (++n_settled % 1024 == 0 && lgraph_api::ShouldKillThisTask(task_ctx)) {
+            THROW_CODE(TaskKilled);
+        }
+        int side = heaps[0].top().first <= heaps[1].top().first ? 0 : 1;
+        auto dist = heaps[side].top().first;
+        auto vid = heaps[side].top().second;
+        heaps[side].pop();
+        auto label = labels[side].Find(vid);
+        if (label->settled || dist > label->dist) continue;
+        label->settled = true;
+        auto relax = [&](const auto &eit, lgraph::VertexId nbr) {
+            auto w = txn.GetEdgeField(eit, weight);
+            if (!w.IsInteger() && !w.IsReal()) {
+                throw lgraph::CypherException(FMA_FMT("Edge {} has no numeric {}",
+                                                      eit.GetUid().ToString(), weight));
+            }
+            double nbr_dist = dist + (w.IsInteger() ? w.integer() : w.real());
+            if (nbr_dist < dist) {
+                throw lgraph::CypherException(
+                    FMA_FMT("Edge {} has a negative {}", eit.GetUid().ToString(), weight));
+            }
+            auto nbr_label = labels[side].Find(nbr);
+            if (!nbr_label) {
+                labels[side].Emplace(nbr, Label{nbr_dist, eit.GetUid(), vid, false});
+            } else if (!nbr_label->settled && nbr_dist < nbr_label->dist) {
+                *nbr_label = Label{nbr_dist, eit.GetUid(), vid, false};
+            } else {
+                return;
+            }
+            heaps[side].emplace(nbr_dist, nbr);
+            auto other = labels[1 - side].Find(nbr);
+            if (other && nbr_dist + other->dist < best) {
+                best = nbr_dist + other->dist;
+                meet = nbr;
+            }
+        };
+        _ForEachEdge(txn, vid, edge_filters, dirs[side], relax);
+    }
+    if (meet == -1) return -1;
+    std::vector<lgraph::EdgeUid> edges;
+    for (auto vid = meet; vid != start_vid;) {
+        auto &label = labels[0].At(vid);
+        edges.push_back(label.edge);
+        vid = label.prev;
+    }
+    std::reverse(edges.begin(), edges.end());
+    for (auto vid = meet; vid != end_vid;) {
+        auto &label = labels[1].At(vid);
+        edges.push_back(label.edge);
+        vid = label.prev;
+    }
+    for (auto &edge : edges) path.Append(edge);
+    return best;
+}
+
+// <fvid, bvid, lid, eid, direction>
+typedef std::vector<
+    std::tuple<lgraph::VertexId, lgraph::VertexId, lgraph::LabelId, lgraph::EdgeId, bool>>
+    PATH_HITS_T;
+
+// what a block of the frontier of allShortestPaths reaches
+struct AllPathsReached {
+    PATH_HITS_T hits;
+    // neighbors not visited before this level
+    std::vector<lgraph::VertexId> unvisited;
+};
+
 template <typename EIT>
-static void _EmplaceForwardNeighbor(
-    const EIT &eit, const int fhop, const std::unordered_map<lgraph::VertexId, int> &child,
-    std::unordered_map<lgraph::VertexId, int> &parent,
-    std::vector<std::tuple<lgraph::VertexId, lgraph::VertexId, lgraph::LabelId, lgraph::EdgeId,
-                           bool>> &hits,
-    std::vector<lgraph::VertexId> &next_q) {
+static void _EmplaceForwardNeighbor(const EIT &eit, const VidMap<int> &child,
+                                    const VidMap<int> &parent, AllPathsReached &reached) {
     lgraph::VertexId vid, nbr;
     bool direction;
     if (std::is_same<EIT, ::lgraph::graph::OutEdgeIterator>::value) {
@@ -3761,24 +4199,16 @@ static void _EmplaceForwardNeighbor(
         nbr = eit.GetSrc();
         direction = false;
     }
-    if (child.find(nbr) != child.end()) {
-        hits.emplace_back(vid, nbr, eit.GetLabelId(), eit.GetEdgeId(), direction);
-    } else {
-        auto it = parent.find(nbr);
-        if (it == parent.end()) {
-            parent.emplace_hint(it, nbr, fhop);
-            next_q.emplace_back(nbr);
-        }
+    if (child.Contains(nbr)) {
+        reached.hits.emplace_back(vid, nbr, eit.GetLabelId(), eit.GetEdgeId(), direction);
+    } else if (!parent.Contains(nbr)) {
+        reached.unvisited.emplace_back(nbr);
     }
 }
 
 template <typename EIT>
-static void _EmplaceBackwardNeighbor(
-    const EIT &eit, const int bhop, const std::unordered_map<lgraph::VertexId, int> &parent,
-    std::unordered_map<lgraph::VertexId, int> &child,
-    std::vector<std::tuple<lgraph::VertexId, lgraph::VertexId, lgraph::LabelId, lgraph::EdgeId,
-                           bool>> &hits,
-    std::vector<lgraph::VertexId> &next_q) {
+static void _EmplaceBackwardNeighbor(const EIT &eit, const VidMap<int> &parent,
+                                     const VidMap<int> &child, AllPathsReached &reached) {
     lgraph::VertexId vid, nbr;
     bool direction;
     if (std::is_same<EIT, ::lgraph::graph::OutEdgeIterator>::value) {
@@ -3790,19 +4220,15 @@ static void _EmplaceBackwardNeighbor(
         nbr = eit.GetSrc();
         direction = true;
     }
-    if (parent.find(nbr) != parent.end()) {
-        hits.emplace_back(nbr, vid, eit.GetLabelId(), eit.GetEdgeId(), direction);
-    } else {
-        auto it = child.find(nbr);
-        if (it == child.end()) {
-            child.emplace_hint(it, nbr, bhop);
-            next_q.emplace_back(nbr);
-        }
+    if (parent.Contains(nbr)) {
+        reached.hits.emplace_back(nbr, vid, eit.GetLabelId(), eit.GetEdgeId(), direction);
+    } else if (!child.Contains(nbr)) {
+        reached.unvisited.emplace_back(nbr);
     }
 }
 
 void _EnumeratePartialPaths(lgraph::Transaction &txn,
-                            const std::unordered_map<int64_t, int> &hop_info, const int64_t vid,
+                            const VidMap<int> &hop_info, const int64_t vid,
                             const int depth, const std::vector<std::string> &edge_labels,
                             cypher::Path &path,
                             std::vector<cypher::Path> &paths) {
@@ -3810,8 +4236,8 @@ void _EnumeratePartialPaths(lgraph::Transaction &txn,
         if (edge_labels.empty()) {
             for (auto eit = txn.GetOutEdgeIterator(vid); eit.IsValid(); eit.Next()) {
                 int64_t nbr = eit.GetDst();
-                auto it = hop_info.find(nbr);
-                if (it != hop_info.end() && it->second == depth - 1) {
+                auto hop = hop_info.Find(nbr);
+                if (hop && *hop == depth - 1) {
                     path.Append(eit.GetUid());
                     _EnumeratePartialPaths(txn, hop_info, nbr, depth - 1, edge_labels,
                                               path, paths);
@@ -3820,8 +4246,8 @@ void _EnumeratePartialPaths(lgraph::Transaction &txn,
             }
             for (auto eit = txn.GetInEdgeIterator(vid); eit.IsValid(); eit.Next()) {
                 int64_t nbr = eit.GetSrc();
-                auto it = hop_info.find(nbr);
-                if (it != hop_info.end() && it->second == depth - 1) {
+                auto hop = hop_info.Find(nbr);
+                if (hop && *hop == depth - 1) {
                     path.Append(eit.GetUid());
                     _EnumeratePartialPaths(txn, hop_info, nbr, depth - 1, edge_labels,
                                               path, paths);
@@ -3836,8 +4262,8 @@ void _EnumeratePartialPaths(lgraph::Transaction &txn,
                      eit.IsValid(); eit.Next()) {
                     if (eit.GetLabelId() != edge_lid) break;
                     int64_t nbr = eit.GetDst();
-                    auto it = hop_info.find(nbr);
-                    if (it != hop_info.end() && it->second == depth - 1) {
+                    auto hop = hop_info.Find(nbr);
+                    if (hop && *hop == depth - 1) {
                         path.Append(eit.GetUid());
                         _EnumeratePartialPaths(txn, hop_info, nbr, depth - 1, edge_labels, path,
                                                paths);
@@ -3849,8 +4275,8 @@ void _EnumeratePartialPaths(lgraph::Transaction &txn,
                      eit.IsValid(); eit.Next()) {
                     if (eit.GetLabelId() != edge_lid) break;
                     int64_t nbr = eit.GetSrc();
-                    auto it = hop_info.find(nbr);
-                    if (it != hop_info.end() && it->second == depth - 1) {
+                    auto hop = hop_info.Find(nbr);
+                    if (hop && *hop == depth - 1) {
                         path.Append(eit.GetUid());
                         _EnumeratePartialPaths(txn, hop_info, nbr, depth - 1, edge_labels, path,
                                                   paths);
@@ -3864,8 +4290,33 @@ void _EnumeratePartialPaths(lgraph::Transaction &txn,
     }
 }
 
-static void _P2PUnweightedAllShortestPaths(lgraph::Transaction &txn, lgraph::VertexId start_vid,
-                                           lgraph::VertexId end_vid,
+// Calls emplace(eit) on the edges of vid with one of edge_labels, in either direction.
+template <typename Emplace>
+static void _ForEachLabeledEdge(lgraph::Transaction &txn, lgraph::VertexId vid,
+                                const std::vector<std::string> &edge_labels,
+                                const Emplace &emplace) {
+    if (edge_labels.empty()) {
+        for (auto eit = txn.GetOutEdgeIterator(vid); eit.IsValid(); eit.Next()) emplace(eit);
+        for (auto eit = txn.GetInEdgeIterator(vid); eit.IsValid(); eit.Next()) emplace(eit);
+        return;
+    }
+    for (auto &edge_label : edge_labels) {
+        auto edge_lid = txn.GetLabelId(false, edge_label);
+        for (auto eit = txn.GetOutEdgeIterator(lgraph::EdgeUid(vid, 0, edge_lid, 0, 0), true);
+             eit.IsValid(); eit.Next()) {
+            if (eit.GetLabelId() != edge_lid) break;
+            emplace(eit);
+        }
+        for (auto eit = txn.GetInEdgeIterator(lgraph::EdgeUid(0, vid, edge_lid, 0, 0), true);
+             eit.IsValid(); eit.Next()) {
+            if (eit.GetLabelId() != edge_lid) break;
+            emplace(eit);
+        }
+    }
+}
+
+static void _P2PUnweightedAllShortestPaths(FrontierExpander &expander,
+                                           lgraph::VertexId start_vid, lgraph::VertexId end_vid,
                                            const std::vector<std::string> &edge_labels,
                                            std::vector<cypher::Path> &paths) {
     // TODO(heng): fix PrimaryId
@@ -3874,79 +4325,43 @@ static void _P2PUnweightedAllShortestPaths(lgraph::Transaction &txn, lgraph::Ver
         paths.back().SetStart(start_vid);
         return;
     }
-    std::unordered_map<lgraph::VertexId, int> parent{{start_vid, 0}};
-    std::unordered_map<lgraph::VertexId, int> child{{end_vid, 0}};
+    auto &txn = expander.Txn();
+    VidMap<int> parent, child;
+    parent.Emplace(start_vid, 0);
+    child.Emplace(end_vid, 0);
     std::vector<lgraph::VertexId> forward_q{start_vid};
     std::vector<lgraph::VertexId> backward_q{end_vid};
     int fhop = 0;
     int bhop = 0;
-    // <fvid, bvid, lid, eid, direction>
-    std::vector<
-        std::tuple<lgraph::VertexId, lgraph::VertexId, lgraph::LabelId, lgraph::EdgeId, bool>>
-        hits;
+    PATH_HITS_T hits;
+    std::vector<AllPathsReached> reached;
     for (int hop = 0; !forward_q.empty() && !backward_q.empty() && hits.empty(); hop++) {
-        std::vector<lgraph::VertexId> next_q;
-        if (forward_q.size() <= backward_q.size()) {
-            fhop++;
-            for (auto vid : forward_q) {
-                if (edge_labels.empty()) {
-                    for (auto eit = txn.GetOutEdgeIterator(vid); eit.IsValid(); eit.Next()) {
-                        _EmplaceForwardNeighbor(eit, fhop, child, parent, hits, next_q);
-                    }
-                    for (auto eit = txn.GetInEdgeIterator(vid); eit.IsValid(); eit.Next()) {
-                        _EmplaceForwardNeighbor(eit, fhop, child, parent, hits, next_q);
-                    }
-                } else {
-                    for (auto& edge_label : edge_labels) {
-                        auto edge_lid = txn.GetLabelId(false, edge_label);
-                        for (auto eit = txn.GetOutEdgeIterator(
-                                 lgraph::EdgeUid(vid, 0, edge_lid, 0, 0), true);
-                             eit.IsValid(); eit.Next()) {
-                            if (eit.GetLabelId() != edge_lid) break;
-                            _EmplaceForwardNeighbor(eit, fhop, child, parent, hits, next_q);
-                        }
-                        for (auto eit = txn.GetInEdgeIterator(
-                                 lgraph::EdgeUid(0, vid, edge_lid, 0, 0), true);
-                             eit.IsValid(); eit.Next()) {
-                            if (eit.GetLabelId() != edge_lid) break;
-                            _EmplaceForwardNeighbor(eit, fhop, child, parent, hits, next_q);
-                        }
-                    }
-                }
-            }
-            std::sort(next_q.begin(), next_q.end());
-            forward_q.swap(next_q);
-        } else {
-            bhop++;
-            for (auto vid : backward_q) {
-                if (edge_labels.empty()) {
-                    for (auto eit = txn.GetOutEdgeIterator(vid); eit.IsValid(); eit.Next()) {
-                        _EmplaceBackwardNeighbor(eit, bhop, parent, child, hits, next_q);
-                    }
-                    for (auto eit = txn.GetInEdgeIterator(vid); eit.IsValid(); eit.Next()) {
-                        _EmplaceBackwardNeighbor(eit, bhop, parent, child, hits, next_q);
-                    }
-                } else {
-                    for (auto& edge_label : edge_labels) {
-                        auto edge_lid = txn.GetLabelId(false, edge_label);
-                        for (auto eit = txn.GetOutEdgeIterator(
-                                 lgraph::EdgeUid(vid, 0, edge_lid, 0, 0), true);
-                             eit.IsValid(); eit.Next()) {
-                            if (eit.GetLabelId() != edge_lid) break;
-                            _EmplaceBackwardNeighbor(eit, bhop, parent, child, hits, next_q);
-                        }
-                        for (auto eit = txn.GetInEdgeIterator(
-                                 lgraph::EdgeUid(0, vid, edge_lid, 0, 0), true);
-                             eit.IsValid(); eit.Next()) {
-                            if (eit.GetLabelId() != edge_lid) break;
-                            _EmplaceBackwardNeighbor(eit, bhop, parent, child, hits, next_q);
-                        }
+        bool forward = forward_q.size() <= backward_q.size();
+        auto &q = forward ? forward_q : backward_q;
+        auto &visited = forward ? parent : child;
+        int next_hop = forward ? ++fhop : ++bhop;
+        size_t n = expander.Expand(
+            q,
+            [&](lgraph::Transaction &t, lgraph::VertexId vid, AllPathsReached &r) {
+                _ForEachLabeledEdge(t, vid, edge_labels, [&](const auto &eit) {
+                    if (forward) {
+                        _EmplaceForwardNeighbor(eit, child, parent, r);
+                    } else {
+                        _EmplaceBackwardNeighbor(eit, parent, child, r);
                     }
-                }
+                });
+                return true;
+            },
+            reached);
+        std::vector<lgraph::VertexId> next_q;
+        for (size_t b = 0; b < n; b++) {
+            hits.insert(hits.end(), reached[b].hits.begin(), reached[b].hits.end());
+            for (auto nbr : reached[b].unvisited) {
+                if (visited.Emplace(nbr, next_hop)) next_q.push_back(nbr);
             }
-            std::sort(next_q.begin(), next_q.end());
-            backward_q.swap(next_q);
         }
+        std::sort(next_q.begin(), next_q.end());
+        q.swap(next_q);
     }
     for (auto &hit : hits) {
         std::vector<cypher::Path> fpaths;
@@ -3955,10 +4370,10 @@ static void _P2PUnweightedAllShortestPaths(lgraph::Transaction &txn, lgraph::Ver
         auto bvid = std::get<1>(hit);
         cypher::Path path;
         path.SetStart(fvid);
-        _EnumeratePartialPaths(txn, parent, fvid, parent[fvid], edge_labels, path, fpaths);
+        _EnumeratePartialPaths(txn, parent, fvid, parent.At(fvid), edge_labels, path, fpaths);
         path.Clear();
         path.SetStart(bvid);
-        _EnumeratePartialPaths(txn, child, bvid, child[bvid], edge_labels, path, bpaths);
+        _EnumeratePartialPaths(txn, child, bvid, child.At(bvid), edge_labels, path, bpaths);
         for (auto &fpath : fpaths) {
             fpath.Reverse();
             fpath.Append(std::get<4>(hit)
@@ -3973,6 +4388,216 @@ static void _P2PUnweightedAllShortestPaths(lgraph::Transaction &txn, lgraph::Ver
     }
 }
 
+// The options of the procedures running on lgraph_api::traversal::FrontierTraversal.
+struct TraversalConfig {
+    std::vector<bool> edge_labels;    // by label id, all labels if empty
+    std::vector<bool> vertex_labels;  // of the reached vertices, all labels if empty
+    parser::LinkDirection direction = parser::LinkDirection::DIR_NOT_SPECIFIED;
+    size_t max_hops = 20;
+    bool parallel = true;
+
+    size_t Flags() const { return parallel ? lgraph_api::traversal::TRAVERSAL_PARALLEL : 0; }
+
+    bool HasEdgeLabel(size_t lid) const {
+        return edge_labels.empty() || (lid < edge_labels.size() && edge_labels[lid]);
+    }
+
+    bool HasVertexLabel(size_t lid) const {
+        return vertex_labels.empty() || (lid < vertex_labels.size() && vertex_labels[lid]);
+    }
+};
+
+// Gets the labels of a config entry, given as a label, a list of labels or of {label:...} maps.
+static std::vector<std::string> _ConfigLabels(const cypher::FieldData &value,
+                                              const std::string &key) {
+    std::vector<std::string> labels;
+    if (value.IsString()) {
+        labels.emplace_back(value.AsString());
+        return labels;
+    }
+    if (value.IsArray()) {
+        for (auto &item : *value.array) {
+            if (item.IsString()) {
+                labels.emplace_back(item.AsString());
+                continue;
+            }
+            if (item.IsMap()) {
+                auto it = item.map->find("label");
+                if (it != item.map->end() && it->second.IsString()) {
+                    labels.emplace_back(it->second.AsString());
+                    continue;
+                }
+            }
+            THROW_CODE(InputError,
+                       "Illegal value for config [{}]: must be a label or a list of labels.", key);
+        }
+        return labels;
+    }
+    THROW_CODE(InputError, "Illegal value for config [{}]: must be a label or a list of labels.",
+               key);
+}
+
+static std::vector<bool> _LabelMask(lgraph_api::Transaction &txn, bool is_vertex,
+                                    const std::vector<std::string> &labels) {
+    std::vector<bool> mask;
+    for (auto &label : labels) {
+        auto lid = is_vertex ? txn.GetVertexLabelId(label) : txn.GetEdgeLabelId(label);
+        if (lid >= mask.size()) mask.resize(lid + 1, false);
+        mask[lid] = true;
+    }
+    return mask;
+}
+
+static TraversalConfig _ParseTraversalConfig(lgraph_api::Transaction &txn, const VEC_EXPR &args,
+                                             size_t config_idx) {
+    TraversalConfig config;
+    if (args.size() <= config_idx) return config;
+    auto &map = *args[config_idx].constant.map;
+    auto it = map.find("relationshipQuery");
+    if (it != map.end()) {
+        config.edge_labels = _LabelMask(txn, false, _ConfigLabels(it->second, it->first));
+    }
+    it = map.find("nodeLabels");
+    if (it != map.end()) {
+        config.vertex_labels = _LabelMask(txn, true, _ConfigLabels(it->second, it->first));
+    }
+    it = map.find("direction");
+    if (it != map.end()) {
+        if (!it->second.IsString()) CYPHER_TODO();
+        if (it->second.AsString() == "PointingLeft") {
+            config.direction = parser::LinkDirection::RIGHT_TO_LEFT;
+        } else if (it->second.AsString() == "PointingRight") {
+            config.direction = parser::LinkDirection::LEFT_TO_RIGHT;
+        } else if (it->second.AsString() == "AnyDirection") {
+            config.direction = parser::LinkDirection::DIR_NOT_SPECIFIED;
+        } else {
+            CYPHER_TODO();
+        }
+    }
+    it = map.find("maxHops");
+    if (it != map.end()) {
+        if (!it->second.IsInteger() || it->second.scalar.integer() < 0) CYPHER_TODO();
+        config.max_hops = it->second.scalar.integer();
+    }
+    it = map.find("parallel");
+    if (it != map.end()) {
+        if (!it->second.IsBool()) CYPHER_TODO();
+        config.parallel = it->second.AsBool();
+    }
+    return config;
+}
+
+/* Expands the frontier of traversal by one hop. The vertex end is reached
+ * whatever its label, so that a search can end at it.  */
+static void _ExpandFrontier(lgraph_api::traversal::FrontierTraversal &traversal,
+                            const TraversalConfig &config, int64_t end = -1) {
+    std::function<bool(lgraph_api::OutEdgeIterator &)> out_edge_filter;
+    std::function<bool(lgraph_api::InEdgeIterator &)> in_edge_filter;
+    std::function<bool(lgraph_api::VertexIterator &)> vertex_filter;
+    if (!config.edge_labels.empty()) {
+        out_edge_filter = [&](lgraph_api::OutEdgeIterator &eit) {
+            return config.HasEdgeLabel(eit.GetLabelId());
+        };
+        in_edge_filter = [&](lgraph_api::InEdgeIterator &eit) {
+            return config.HasEdgeLabel(eit.GetLabelId());
+        };
+    }
+    if (!config.vertex_labels.empty()) {
+        vertex_filter = [&](lgraph_api::VertexIterator &vit) {
+            return vit.GetId() == end || config.HasVertexLabel(vit.GetLabelId());
+        };
+    }
+    switch (config.direction) {
+    case parser::LinkDirection::LEFT_TO_RIGHT:
+        traversal.ExpandOutEdges(out_edge_filter, vertex_filter);
+        break;
+    case parser::LinkDirection::RIGHT_TO_LEFT:
+        traversal.ExpandInEdges(in_edge_filter, vertex_filter);
+        break;
+    default:
+        traversal.ExpandEdges(out_edge_filter, in_edge_filter, vertex_filter, vertex_filter);
+        break;
+    }
+}
+
+/* Single source shortest paths by frontiers, the vertices whose costs dropped
+ * in a hop are expanded in the next one until no cost drops. The edges of a
+ * frontier are relaxed in parallel, by atomic minimums on the costs. Nothing
+ * may throw inside the parallel expansion, so the weight field is resolved for
+ * each edge label beforehand, and a bad weight is recorded and reported after
+ * the traversal. The edges of labels without the weight field are skipped,
+ * unless the label is asked for in relationshipQuery.  */
+static std::vector<double> _FrontierSSSP(lgraph_api::GraphDB &db, lgraph_api::Transaction &txn,
+                                         lgraph::VertexId start_vid, const std::string &weight,
+                                         const TraversalConfig &config) {
+    static const size_t NO_FIELD = std::numeric_limits<size_t>::max();
+    // weight field id by edge label id, NO_FIELD for the labels not traversed
+    std::vector<size_t> weight_fids;
+    for (auto &label : txn.ListEdgeLabels()) {
+        size_t lid = txn.GetEdgeLabelId(label);
+        if (lid >= weight_fids.size()) weight_fids.resize(lid + 1, NO_FIELD);
+        if (!config.HasEdgeLabel(lid)) continue;
+        try {
+            weight_fids[lid] = txn.GetEdgeFieldId(lid, weight);
+        } catch (std::exception &) {
+            if (!config.edge_labels.empty()) {
+                throw lgraph::CypherException(
+                    FMA_FMT("Edge label {} has no field {}", label, weight));
+            }
+        }
+    }
+    auto num_vertices = txn.GetNumVertices();
+    std::vector<double> costs(num_vertices, std::numeric_limits<double>::infinity());
+    // the last hop each vertex joined the frontier in, which it joins once per hop
+    std::vector<size_t> joined(num_vertices, 0);
+    costs[start_vid] = 0;
+    std::atomic<bool> bad_weight(false);
+    std::mutex mu;
+    std::string bad_edge;
+    size_t hop = 0;
+    auto relax = [&](const auto &eit, int64_t vid, int64_t nbr) {
+        size_t lid = eit.GetLabelId();
+        if (lid >= weight_fids.size() || weight_fids[lid] == NO_FIELD) return false;
+        auto w = eit.GetField(weight_fids[lid]);
+        double d = w.IsInteger() ? w.integer() : w.IsReal() ? w.real() : -1;
+        if (d < 0) {
+            if (!bad_weight.exchange(true)) {
+                std::lock_guard<std::mutex> l(mu);
+                bad_edge = eit.GetUid().ToString();
+            }
+            return false;
+        }
+        return lgraph_api::write_min(&costs[nbr], costs[vid] + d) &&
+               lgraph_api::write_max(&joined[nbr], hop);
+    };
+    std::function<bool(lgraph_api::OutEdgeIterator &)> out_edge_filter =
+        [&](lgraph_api::OutEdgeIterator &eit) { return relax(eit, eit.GetSrc(), eit.GetDst()); };
+    std::function<bool(lgraph_api::InEdgeIterator &)> in_edge_filter =
+        [&](lgraph_api::InEdgeIterator &eit) { return relax(eit, eit.GetDst(), eit.GetSrc()); };
+    lgraph_api::traversal::FrontierTraversal traversal(
+        db, txn, config.Flags() | lgraph_api::traversal::TRAVERSAL_ALLOW_REVISITS, num_vertices);
+    traversal.SetFrontier(start_vid);
+    while (traversal.GetFrontier().Size() != 0 && !bad_weight) {
+        hop++;
+        switch (config.direction) {
+        case parser::LinkDirection::LEFT_TO_RIGHT:
+            traversal.ExpandOutEdges(out_edge_filter);
+            break;
+        case parser::LinkDirection::RIGHT_TO_LEFT:
+            traversal.ExpandInEdges(in_edge_filter);
+            break;
+        default:
+            traversal.ExpandEdges(out_edge_filter, in_edge_filter);
+            break;
+        }
+    }
+    if (bad_weight) {
+        throw lgraph::CypherException(
+            FMA_FMT("Edge {} has no numeric or has a negative {}", bad_edge, weight));
+    }
+    return costs;
+}
+
 void AlgoFunc::ShortestPath(RTContext *ctx, const Record *record, const cypher::VEC_EXPR &args,
                             const cypher::VEC_STR &yield_items,
                             std::vector<cypher::Record> *records) {
@@ -3984,6 +4609,7 @@ void AlgoFunc::ShortestPath(RTContext *ctx, const Record *record, const cypher::
     std::vector<EdgeFilter> edge_filters;
     parser::LinkDirection direction = parser::LinkDirection::DIR_NOT_SPECIFIED;
     size_t max_hops = 20;
+    std::string weight;
     if (args.size() == 3) {
         auto &map = *args[2].constant.map;
         // edgeFilter
@@ -4023,6 +4649,12 @@ void AlgoFunc::ShortestPath(RTContext *ctx, const Record *record, const cypher::
             if (!max->second.IsInteger()) CYPHER_TODO();
             max_hops = max->second.scalar.integer();
         }
+        // weighted by the property, searched by bidirectional Dijkstra
+        auto it_weight = map.find("weightProperty");
+        if (it_weight != map.end()) {
+            if (!it_weight->second.IsString()) CYPHER_TODO();
+            weight = it_weight->second.AsString();
+        }
         // direction
         auto it_dir = map.find("direction");
         if (it_dir != map.end()) {
@@ -4042,10 +4674,17 @@ void AlgoFunc::ShortestPath(RTContext *ctx, const Record *record, const cypher::
     auto start_vid = args[0].node->PullVid();
     auto end_vid = args[1].node->PullVid();
     cypher::Path path;
+    float cost = 0;
     auto ac_db = ctx->galaxy_->OpenGraph(ctx->user_, ctx->graph_);
-    _P2PUnweightedShortestPath(*ctx->txn_->GetTxn(), start_vid, end_vid,
-                               edge_filters, max_hops, path,
-                                direction, std::nullopt);
+    if (weight.empty()) {
+        FrontierExpander expander(&ac_db, *ctx->txn_->GetTxn());
+        _P2PUnweightedShortestPath(expander, start_vid, end_vid, edge_filters, max_hops, path,
+                                   direction, std::nullopt);
+        cost = path.Length();
+    } else {
+        cost = std::max(0.0, _P2PWeightedShortestPath(*ctx->txn_->GetTxn(), start_vid, end_vid,
+                                                      edge_filters, weight, path, direction));
+    }
 
     auto pp = global_ptable.GetProcedure("algo.shortestPath");
     CYPHER_THROW_ASSERT(pp && pp->ContainsYieldItem("nodeCount") &&
@@ -4053,7 +4692,7 @@ void AlgoFunc::ShortestPath(RTContext *ctx, const Record *record, const cypher::
     Record r;
     r.AddConstant(lgraph::FieldData(static_cast<int32_t>(path.Length()
                                                                  == 0 ? 0 : path.Length() + 1)));
-    r.AddConstant(lgraph::FieldData(static_cast<float>(path.Length())));
+    r.AddConstant(lgraph::FieldData(cost));
     r.AddConstant(lgraph::FieldData(path.ToString()));
     records->emplace_back(r.Snapshot());
     FillProcedureYieldItem("algo.shortestPath", yield_items, records);
@@ -4092,7 +4731,8 @@ void AlgoFunc::AllShortestPaths(RTContext *ctx, const Record *record,
     auto end_vid = args[1].node->PullVid();
     std::vector<cypher::Path> paths;
     auto ac_db = ctx->galaxy_->OpenGraph(ctx->user_, ctx->graph_);
-    _P2PUnweightedAllShortestPaths(*ctx->txn_->GetTxn(), start_vid, end_vid, edge_labels, paths);
+    FrontierExpander expander(&ac_db, *ctx->txn_->GetTxn());
+    _P2PUnweightedAllShortestPaths(expander, start_vid, end_vid, edge_labels, paths);
 
     auto pp = global_ptable.GetProcedure("algo.allShortestPaths");
     CYPHER_THROW_ASSERT(pp && pp->ContainsYieldItem("nodeIds") &&
@@ -4162,6 +4802,114 @@ void AlgoFunc::NativeExtract(RTContext *ctx, const cypher::Record *record,
     FillProcedureYieldItem("algo.native.extract", yield_items, records);
 }
 
+void AlgoFunc::NativeKHop(RTContext *ctx, const cypher::Record *record,
+                          const cypher::VEC_EXPR &args, const cypher::VEC_STR &yield_items,
+                          std::vector<cypher::Record> *records) {
+    CYPHER_DB_PROCEDURE_GRAPH_CHECK();
+    CYPHER_ARG_CHECK(args.size() / 2 == 1, "wrong arguments number")
+    CYPHER_ARG_CHECK(
+        args[0].IsNode() && args[1].IsInteger() && (args.size() == 2 || args[2].IsMap()),
+        "wrong type")
+    CheckProcedureYieldItem("algo.native.khop", yield_items);
+    CYPHER_THROW_ASSERT(record);
+    auto &txn = *ctx->txn_;
+    auto config = _ParseTraversalConfig(txn, args, 2);
+    auto max_hops = args[1].constant.scalar.integer();
+    CYPHER_ARG_CHECK(max_hops >= 0, "maxHops should not be negative")
+    lgraph_api::GraphDB db(ctx->ac_db_.get(), true);
+    lgraph_api::traversal::FrontierTraversal traversal(db, txn, config.Flags(),
+                                                       txn.GetNumVertices());
+    traversal.SetFrontier(args[0].node->PullVid());
+    // columnar, the vertices of each hop are sorted since a parallel expansion may shuffle them
+    auto ids = cypher::FieldData::Array(0);
+    auto hops = cypher::FieldData::Array(0);
+    std::vector<int64_t> level;
+    for (int64_t hop = 1; hop <= max_hops && traversal.GetFrontier().Size() != 0; hop++) {
+        _ExpandFrontier(traversal, config);
+        auto &frontier = traversal.GetFrontier();
+        level.assign(frontier.begin(), frontier.end());
+        std::sort(level.begin(), level.end());
+        for (auto vid : level) {
+            ids.array->emplace_back(lgraph::FieldData(vid));
+            hops.array->emplace_back(lgraph::FieldData(hop));
+        }
+    }
+    Record r;
+    r.AddConstant(ids);
+    r.AddConstant(hops);
+    records->emplace_back(r.Snapshot());
+    FillProcedureYieldItem("algo.native.khop", yield_items, records);
+}
+
+void AlgoFunc::NativeReachable(RTContext *ctx, const cypher::Record *record,
+                               const cypher::VEC_EXPR &args, const cypher::VEC_STR &yield_items,
+                               std::vector<cypher::Record> *records) {
+    CYPHER_DB_PROCEDURE_GRAPH_CHECK();
+    CYPHER_ARG_CHECK(args.size() / 2 == 1, "wrong arguments number")
+    CYPHER_ARG_CHECK(args[0].IsNode() && args[1].IsNode() && (args.size() == 2 || args[2].IsMap()),
+                     "wrong type")
+    CheckProcedureYieldItem("algo.native.reachable", yield_items);
+    CYPHER_THROW_ASSERT(record);
+    auto &txn = *ctx->txn_;
+    auto config = _ParseTraversalConfig(txn, args, 2);
+    auto start_vid = args[0].node->PullVid();
+    auto end_vid = args[1].node->PullVid();
+    int64_t hops = start_vid == end_vid ? 0 : -1;
+    if (hops < 0) {
+        lgraph_api::GraphDB db(ctx->ac_db_.get(), true);
+        lgraph_api::traversal::FrontierTraversal traversal(db, txn, config.Flags(),
+                                                           txn.GetNumVertices());
+        traversal.SetFrontier(start_vid);
+        for (size_t hop = 1; hop <= config.max_hops && traversal.GetFrontier().Size() != 0;
+             hop++) {
+            _ExpandFrontier(traversal, config, end_vid);
+            auto &frontier = traversal.GetFrontier();
+            if (std::find(frontier.begin(), frontier.end(), (size_t)end_vid) != frontier.end()) {
+                hops = hop;
+                break;
+            }
+        }
+    }
+    Record r;
+    r.AddConstant(lgraph::FieldData(hops >= 0));
+    r.AddConstant(lgraph::FieldData(hops));
+    records->emplace_back(r.Snapshot());
+    FillProcedureYieldItem("algo.native.reachable", yield_items, records);
+}
+
+void AlgoFunc::NativeSSSP(RTContext *ctx, const cypher::Record *record,
+                          const cypher::VEC_EXPR &args, const cypher::VEC_STR &yield_items,
+                          std::vector<cypher::Record> *records) {
+    CYPHER_DB_PROCEDURE_GRAPH_CHECK();
+    CYPHER_ARG_CHECK(args.size() / 2 == 1, "wrong arguments number")
+    CYPHER_ARG_CHECK(
+        args[0].IsNode() && args[1].IsString() && (args.size() == 2 || args[2].IsMap()),
+        "wrong type")
+    CheckProcedureYieldItem("algo.native.sssp", yield_items);
+    CYPHER_THROW_ASSERT(record);
+    auto &txn = *ctx->txn_;
+    auto config = _ParseTraversalConfig(txn, args, 2);
+    CYPHER_ARG_CHECK(config.vertex_labels.empty(), "nodeLabels is not supported by sssp")
+    // costs drop along paths of any length, so a bound on the hops would cut them short
+    CYPHER_ARG_CHECK(args.size() == 2 || !args[2].constant.map->count("maxHops"),
+                     "maxHops is not supported by sssp")
+    lgraph_api::GraphDB db(ctx->ac_db_.get(), true);
+    auto costs = _FrontierSSSP(db, txn, args[0].node->PullVid(),
+                               args[1].constant.scalar.AsString(), config);
+    auto ids = cypher::FieldData::Array(0);
+    auto reached = cypher::FieldData::Array(0);
+    for (size_t vid = 0; vid < costs.size(); vid++) {
+        if (costs[vid] == std::numeric_limits<double>::infinity()) continue;
+        ids.array->emplace_back(lgraph::FieldData(static_cast<int64_t>(vid)));
+        reached.array->emplace_back(lgraph::FieldData(costs[vid]));
+    }
+    Record r;
+    r.AddConstant(ids);
+    r.AddConstant(reached);
+    records->emplace_back(r.Snapshot());
+    FillProcedureYieldItem("algo.native.sssp", yield_items, records);
+}
+
 void AlgoFunc::PageRank(RTContext *ctx, const cypher::Record *record,
                         const cypher::VEC_EXPR &args, const cypher::VEC_STR &yield_items,
                         struct std::vector<cypher::Record> *records) {
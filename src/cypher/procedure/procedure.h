@@ -101,6 +101,15 @@ class BuiltinProcedure {
     static void DbWarmUp(RTContext *ctx, const Record *record, const VEC_EXPR &args,
                          const VEC_STR &yield_items, std::vector<Record> *records);
 
+    static void DbWarmUpLabels(RTContext *ctx, const Record *record, const VEC_EXPR &args,
+                               const VEC_STR &yield_items, std::vector<Record> *records);
+
+    static void DbSpaceStat(RTContext *ctx, const Record *record, const VEC_EXPR &args,
+                            const VEC_STR &yield_items, std::vector<Record> *records);
+
+    static void DbCompact(RTContext *ctx, const Record *record, const VEC_EXPR &args,
+                          const VEC_STR &yield_items, std::vector<Record> *records);
+
     static void DbUpsertVertex(RTContext *ctx, const Record *record, const VEC_EXPR &args,
                                const VEC_STR &yield_items, std::vector<Record> *records);
 
@@ -142,6 +151,8 @@ class BuiltinProcedure {
                                       const VEC_STR &yield_items, std::vector<Record> *records);
     static void DbAlterLabelModFields(RTContext *ctx, const Record *record, const VEC_EXPR &args,
                                       const VEC_STR &yield_items, std::vector<Record> *records);
+    static void DbUpgradeLabelRecords(RTContext *ctx, const Record *record, const VEC_EXPR &args,
+                                      const VEC_STR &yield_items, std::vector<Record> *records);
 
     static void DbCreateEdgeLabel(RTContext *ctx, const Record *record, const VEC_EXPR &args,
                                   const VEC_STR &yield_items, std::vector<Record> *records);
@@ -149,6 +160,22 @@ class BuiltinProcedure {
     static void DbAddVertexIndex(RTContext *ctx, const Record *record, const VEC_EXPR &args,
                                  const VEC_STR &yield_items, std::vector<Record> *records);
 
+    static void DbAlterVertexIndexInclude(RTContext *ctx, const Record *record,
+                                          const VEC_EXPR &args, const VEC_STR &yield_items,
+                                          std::vector<Record> *records);
+
+    static void DbAddVertexColumn(RTContext *ctx, const Record *record, const VEC_EXPR &args,
+                                  const VEC_STR &yield_items, std::vector<Record> *records);
+
+    static void DbDeleteVertexColumn(RTContext *ctx, const Record *record, const VEC_EXPR &args,
+                                     const VEC_STR &yield_items, std::vector<Record> *records);
+
+    static void DbListVertexColumns(RTContext *ctx, const Record *record, const VEC_EXPR &args,
+                                    const VEC_STR &yield_items, std::vector<Record> *records);
+
+    static void DbVertexColumnStat(RTContext *ctx, const Record *record, const VEC_EXPR &args,
+                                   const VEC_STR &yield_items, std::vector<Record> *records);
+
     static void DbAddVertexCompositeIndex(RTContext *ctx, const Record *record,
                                           const VEC_EXPR &args, const VEC_STR &yield_items,
                                           std::vector<Record> *records);
@@ -411,6 +438,15 @@ class AlgoFunc {
     static void NativeExtract(RTContext *ctx, const Record *record, const VEC_EXPR &args,
                               const VEC_STR &yield_items, std::vector<Record> *records);
 
+    static void NativeKHop(RTContext *ctx, const Record *record, const VEC_EXPR &args,
+                           const VEC_STR &yield_items, std::vector<Record> *records);
+
+    static void NativeReachable(RTContext *ctx, const Record *record, const VEC_EXPR &args,
+                                const VEC_STR &yield_items, std::vector<Record> *records);
+
+    static void NativeSSSP(RTContext *ctx, const Record *record, const VEC_EXPR &args,
+                           const VEC_STR &yield_items, std::vector<Record> *records);
+
     static void PageRank(RTContext *ctx, const Record *record, const VEC_EXPR &args,
                          const VEC_STR &yield_items, std::vector<Record> *records);
 
@@ -563,6 +599,24 @@ static std::vector<Procedure> global_procedures = {
     Procedure("db.warmup", BuiltinProcedure::DbWarmUp, Procedure::SIG_SPEC{},
               Procedure::SIG_SPEC{{"time_used", {0, lgraph_api::LGraphType::STRING}}}, true, true),
 
+    Procedure("db.warmupLabels", BuiltinProcedure::DbWarmUpLabels,
+              Procedure::SIG_SPEC{{"labels", {0, lgraph_api::LGraphType::LIST}},
+                                  {"indexes_only", {1, lgraph_api::LGraphType::BOOLEAN}}},
+              Procedure::SIG_SPEC{{"time_used", {0, lgraph_api::LGraphType::STRING}}}, true, true),
+
+    Procedure("db.spaceStat", BuiltinProcedure::DbSpaceStat, Procedure::SIG_SPEC{},
+              Procedure::SIG_SPEC{{"file_size", {0, lgraph_api::LGraphType::INTEGER}},
+                                  {"used_size", {1, lgraph_api::LGraphType::INTEGER}},
+                                  {"free_size", {2, lgraph_api::LGraphType::INTEGER}},
+                                  {"readers", {3, lgraph_api::LGraphType::INTEGER}},
+                                  {"oldest_reader_age", {4, lgraph_api::LGraphType::DOUBLE}}},
+              true, true),
+
+    Procedure("db.compact", BuiltinProcedure::DbCompact, Procedure::SIG_SPEC{},
+              Procedure::SIG_SPEC{{"size_before", {0, lgraph_api::LGraphType::INTEGER}},
+                                  {"size_after", {1, lgraph_api::LGraphType::INTEGER}}},
+              false, true),
+
     Procedure("db.createVertexLabelByJson", BuiltinProcedure::DbCreateVertexLabelByJson,
               Procedure::SIG_SPEC{{"json_data", {0, lgraph_api::LGraphType::STRING}}},
               Procedure::SIG_SPEC{{"", {0, lgraph_api::LGraphType::NUL}}}, false, true),
@@ -688,6 +742,16 @@ static std::vector<Procedure> global_procedures = {
               },
               false, true),
 
+    Procedure("db.upgradeLabelRecords", BuiltinProcedure::DbUpgradeLabelRecords,
+              Procedure::SIG_SPEC{{"label_type", {0, lgraph_api::LGraphType::STRING}},
+                                  {"label_name", {1, lgraph_api::LGraphType::STRING}},
+                                  {"batch_size", {2, lgraph_api::LGraphType::INTEGER}},
+                                  {"interval_ms", {3, lgraph_api::LGraphType::INTEGER}}},
+              Procedure::SIG_SPEC{
+                  {"record_affected", {0, lgraph_api::LGraphType::INTEGER}},
+              },
+              false, true),
+
     Procedure("db.createEdgeLabel", BuiltinProcedure::DbCreateEdgeLabel,
               Procedure::SIG_SPEC{{"type_name", {0, lgraph_api::LGraphType::STRING}},
                                   {"field_specs", {1, lgraph_api::LGraphType::LIST}}},
@@ -699,6 +763,37 @@ static std::vector<Procedure> global_procedures = {
                                   {"unique", {2, lgraph_api::LGraphType::BOOLEAN}}},
               Procedure::SIG_SPEC{{"", {0, lgraph_api::LGraphType::NUL}}}, false, true),
 
+    Procedure("db.alterVertexIndexInclude", BuiltinProcedure::DbAlterVertexIndexInclude,
+              Procedure::SIG_SPEC{{"label_name", {0, lgraph_api::LGraphType::STRING}},
+                                  {"field_name", {1, lgraph_api::LGraphType::STRING}},
+                                  {"include_fields", {2, lgraph_api::LGraphType::LIST}}},
+              Procedure::SIG_SPEC{{"", {0, lgraph_api::LGraphType::NUL}}}, false, true),
+
+    Procedure("db.addVertexColumn", BuiltinProcedure::DbAddVertexColumn,
+              Procedure::SIG_SPEC{{"label_name", {0, lgraph_api::LGraphType::STRING}},
+                                  {"field_name", {1, lgraph_api::LGraphType::STRING}}},
+              Procedure::SIG_SPEC{{"", {0, lgraph_api::LGraphType::NUL}}}, false, true),
+
+    Procedure("db.deleteVertexColumn", BuiltinProcedure::DbDeleteVertexColumn,
+              Procedure::SIG_SPEC{{"label_name", {0, lgraph_api::LGraphType::STRING}},
+                                  {"field_name", {1, lgraph_api::LGraphType::STRING}}},
+              Procedure::SIG_SPEC{{"", {0, lgraph_api::LGraphType::NUL}}}, false, true),
+
+    Procedure("db.listVertexColumns", BuiltinProcedure::DbListVertexColumns,
+              Procedure::SIG_SPEC{},
+              Procedure::SIG_SPEC{{"label", {0, lgraph_api::LGraphType::STRING}},
+                                  {"field", {1, lgraph_api::LGraphType::STRING}}}),
+
+    Procedure("db.vertexColumnStat", BuiltinProcedure::DbVertexColumnStat,
+              Procedure::SIG_SPEC{{"label_name", {0, lgraph_api::LGraphType::STRING}},
+                                  {"field_name", {1, lgraph_api::LGraphType::STRING}}},
+              Procedure::SIG_SPEC{{"count", {0, lgraph_api::LGraphType::INTEGER}},
+                                  {"min", {1, lgraph_api::LGraphType::ANY}},
+                                  {"max", {2, lgraph_api::LGraphType::ANY}},
+                                  {"sum", {3, lgraph_api::LGraphType::DOUBLE}},
+                                  {"blocks", {4, lgraph_api::LGraphType::INTEGER}},
+                                  {"bytes", {5, lgraph_api::LGraphType::INTEGER}}}),
+
     Procedure("db.addVertexCompositeIndex", BuiltinProcedure::DbAddVertexCompositeIndex,
               Procedure::SIG_SPEC{{"label_name", {0, lgraph_api::LGraphType::STRING}},
                                   {"field_names", {1, lgraph_api::LGraphType::LIST}},
@@ -827,7 +922,8 @@ static std::vector<Procedure> global_procedures = {
     Procedure("dbms.graph.createGraph", BuiltinProcedure::DbmsGraphCreateGraph,
               Procedure::SIG_SPEC{{"graph_name", {0, lgraph_api::LGraphType::STRING}},
                                   {"description", {1, lgraph_api::LGraphType::STRING}},
-                                  {"max_size_GB", {2, lgraph_api::LGraphType::INTEGER}}},
+                                  {"max_size_GB", {2, lgraph_api::LGraphType::INTEGER}},
+                                  {"kv_engine", {3, lgraph_api::LGraphType::STRING}}},
               Procedure::SIG_SPEC{{"", {0, lgraph_api::LGraphType::NUL}}}, false, true),
 
     Procedure("dbms.graph.deleteGraph", BuiltinProcedure::DbmsGraphDeleteGraph,
@@ -915,6 +1011,39 @@ static std::vector<Procedure> global_procedures = {
                   {"value", {0, lgraph_api::LGraphType::ANY}},
               }),
 
+    Procedure("algo.native.khop", AlgoFunc::NativeKHop,
+              Procedure::SIG_SPEC{
+                  {"startNode", {0, lgraph_api::LGraphType::NODE}},
+                  {"maxHops", {1, lgraph_api::LGraphType::INTEGER}},
+                  {"config", {2, lgraph_api::LGraphType::MAP}},
+              },
+              Procedure::SIG_SPEC{
+                  {"nodeIds", {0, lgraph_api::LGraphType::LIST}},
+                  {"hops", {1, lgraph_api::LGraphType::LIST}},
+              }),
+
+    Procedure("algo.native.reachable", AlgoFunc::NativeReachable,
+              Procedure::SIG_SPEC{
+                  {"startNode", {0, lgraph_api::LGraphType::NODE}},
+                  {"endNode", {1, lgraph_api::LGraphType::NODE}},
+                  {"config", {2, lgraph_api::LGraphType::MAP}},
+              },
+              Procedure::SIG_SPEC{
+                  {"reachable", {0, lgraph_api::LGraphType::BOOLEAN}},
+                  {"hops", {1, lgraph_api::LGraphType::INTEGER}},
+              }),
+
+    Procedure("algo.native.sssp", AlgoFunc::NativeSSSP,
+              Procedure::SIG_SPEC{
+                  {"startNode", {0, lgraph_api::LGraphType::NODE}},
+                  {"weightProperty", {1, lgraph_api::LGraphType::STRING}},
+                  {"config", {2, lgraph_api::LGraphType::MAP}},
+              },
+              Procedure::SIG_SPEC{
+                  {"nodeIds", {0, lgraph_api::LGraphType::LIST}},
+                  {"costs", {1, lgraph_api::LGraphType::LIST}},
+              }),
+
     Procedure("algo.pagerank", AlgoFunc::PageRank,
               Procedure::SIG_SPEC{
                   {"num_iterations", {0, lgraph_api::LGraphType::INTEGER}},
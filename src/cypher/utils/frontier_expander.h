@@ -0,0 +1,140 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include <omp.h>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "core/transaction.h"
+#include "lgraph/lgraph_exceptions.h"
+#include "db/db.h"
+#include "lgraph/lgraph_db.h"
+#include "lgraph/olap_base.h"
+
+namespace cypher {
+
+/* Set of vertex ids as a bitmap over the dense id space. The bitmap grows with the
+ * largest id added, and Clear only zeroes the words that were touched, so a search
+ * from a small neighbourhood does not pay for the size of the graph.  */
+class VidBitmap {
+    std::vector<uint64_t> words_;
+    std::vector<size_t> touched_;
+
+ public:
+    bool Contains(lgraph::VertexId vid) const {
+        size_t w = static_cast<size_t>(vid) >> 6;
+        return w < words_.size() && (words_[w] >> (vid & 63) & 1);
+    }
+
+    // Returns false if vid is already in the set.
+    bool Add(lgraph::VertexId vid) {
+        size_t w = static_cast<size_t>(vid) >> 6;
+        if (w >= words_.size()) words_.resize(std::max(w + 1, words_.size() * 2), 0);
+        uint64_t bit = (uint64_t)1 << (vid & 63);
+        if (words_[w] & bit) return false;
+        if (!words_[w]) touched_.push_back(w);
+        words_[w] |= bit;
+        return true;
+    }
+
+    void Clear() {
+        for (auto w : touched_) words_[w] = 0;
+        touched_.clear();
+    }
+};
+
+/* Expands the frontiers of breadth-first searches, used by the shortest path procedures
+ * and the frontier mode of VarLenExpand. A large frontier of a read transaction is cut
+ * into blocks, which the OpenMP threads take in turn, each with a read transaction
+ * forked from txn. Every block has an output of its own, so reading the outputs in
+ * block order gives what a serial expansion would.  */
+class FrontierExpander {
+    static constexpr size_t BLOCK_SIZE = 64;
+    static constexpr size_t MIN_PARALLEL_FRONTIER = 1024;
+
+    lgraph::AccessControlledDB *db_;
+    lgraph::Transaction &txn_;
+    // forked on the first parallel level and kept until the search ends
+    std::vector<std::unique_ptr<lgraph::Transaction>> forks_;
+
+ public:
+    FrontierExpander(lgraph::AccessControlledDB *db, lgraph::Transaction &txn)
+        : db_(db), txn_(txn) {}
+
+    lgraph::Transaction &Txn() { return txn_; }
+
+    /* Calls visit(txn, vid, out) on the vertices of frontier until it returns false.
+     * Returns the number of outputs filled, the vertex visit returned false on is in
+     * the last of them.  */
+    template <typename Out, typename Visit>
+    size_t Expand(const std::vector<lgraph::VertexId> &frontier, const Visit &visit,
+                  std::vector<Out> &outs) {
+        int threads = omp_get_max_threads();
+        if (!db_ || !txn_.IsReadOnly() || threads < 2 ||
+            frontier.size() < MIN_PARALLEL_FRONTIER) {
+            outs.assign(1, Out());
+            for (auto vid : frontier) {
+                if (!visit(txn_, vid, outs[0])) break;
+            }
+            return 1;
+        }
+        size_t n_blocks = (frontier.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        outs.assign(n_blocks, Out());
+        if (forks_.size() < (size_t)threads) forks_.resize(threads);
+        // blocks before n_filled are visited completely
+        std::atomic<size_t> n_filled(n_blocks), next_block(0);
+        std::exception_ptr error;
+        std::mutex error_mutex;
+        auto task_ctx = lgraph_api::GetThreadContext();
+        lgraph_api::Worker::SharedWorker()->Delegate([&]() {
+#pragma omp parallel num_threads(threads)
+            {
+                size_t tid = omp_get_thread_num();
+                try {
+                    if (!forks_[tid]) {
+                        forks_[tid] =
+                            std::make_unique<lgraph::Transaction>(db_->ForkTxn(txn_));
+                    }
+                    auto &txn = *forks_[tid];
+                    for (size_t b = next_block++; b < n_filled; b = next_block++) {
+                        if (lgraph_api::ShouldKillThisTask(task_ctx)) break;
+                        size_t end = std::min(frontier.size(), (b + 1) * BLOCK_SIZE);
+                        for (size_t i = b * BLOCK_SIZE; i < end; i++) {
+                            if (visit(txn, frontier[i], outs[b])) continue;
+                            // the blocks after b are not needed any more
+                            size_t filled = n_filled;
+                            while (b + 1 < filled &&
+                                   !n_filled.compare_exchange_weak(filled, b + 1)) {
+                            }
+                            break;
+                        }
+                    }
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!error) error = std::current_exception();
+                    n_filled = 0;
+                }
+            }
+        });
+        if (error) std::rethrow_exception(error);
+        if (lgraph_api::ShouldKillThisTask(task_ctx)) THROW_CODE(TaskKilled);
+        return n_filled;
+    }
+};
+}  // namespace cypher
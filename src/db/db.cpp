@@ -59,6 +59,11 @@ lgraph::Transaction lgraph::AccessControlledDB::ForkTxn(Transaction& txn) {
     return graph_->ForkTxn(txn);
 }
 
+lgraph::Transaction lgraph::AccessControlledDB::CreateSnapshotReadTxn(double max_age_seconds) {
+    CheckReadAccess();
+    return graph_->CreateSnapshotReadTxn(max_age_seconds);
+}
+
 bool lgraph::AccessControlledDB::LoadPlugin(plugin::Type plugin_type, const std::string& user,
                                             const std::string& name,
                                             const std::vector<std::string>& code,
@@ -194,6 +199,13 @@ bool lgraph::AccessControlledDB::AlterLabelModFields(const std::string& label,
     return graph_->AlterLabelModFields(label, mod_fields, is_vertex, n_modified);
 }
 
+bool lgraph::AccessControlledDB::UpgradeLabelRecords(bool is_vertex, const std::string& label,
+                                                     size_t batch_size, size_t interval_ms,
+                                                     size_t* n_upgraded) {
+    CheckFullAccess();
+    return graph_->UpgradeLabelRecords(is_vertex, label, batch_size, interval_ms, n_upgraded);
+}
+
 bool lgraph::AccessControlledDB::AddEdgeConstraints(
     const std::string& label,
     const std::vector<std::pair<std::string, std::string>>& constraints) {
@@ -284,6 +296,13 @@ bool lgraph::AccessControlledDB::DeleteVertexIndex(const std::string& label,
     return graph_->DeleteIndex(label, field, true);
 }
 
+bool lgraph::AccessControlledDB::AlterVertexIndexInclude(
+    const std::string& label, const std::string& field,
+    const std::vector<std::string>& include_fields) {
+    CheckFullAccess();
+    return graph_->AlterVertexIndexInclude(label, field, include_fields);
+}
+
 bool lgraph::AccessControlledDB::DeleteEdgeIndex(const std::string& label,
                                                  const std::string& field) {
     CheckFullAccess();
@@ -302,6 +321,18 @@ bool lgraph::AccessControlledDB::DeleteVectorIndex(bool is_vertex, const std::st
     return graph_->DeleteVectorIndex(is_vertex, label, field);
 }
 
+bool lgraph::AccessControlledDB::AddVertexColumn(const std::string& label,
+                                                 const std::string& field) {
+    CheckFullAccess();
+    return graph_->AddVertexColumn(label, field);
+}
+
+bool lgraph::AccessControlledDB::DeleteVertexColumn(const std::string& label,
+                                                    const std::string& field) {
+    CheckFullAccess();
+    return graph_->DeleteVertexColumn(label, field);
+}
+
 bool lgraph::AccessControlledDB::IsVertexIndexed(const std::string& label,
                                                  const std::string& field) {
     CheckReadAccess();
@@ -320,9 +351,22 @@ bool lgraph::AccessControlledDB::IsVertexCompositeIndexed(const std::string& lab
     return graph_->IsCompositeIndexed(label, fields);
 }
 
-void lgraph::AccessControlledDB::WarmUp() const { graph_->WarmUp(); }
+void lgraph::AccessControlledDB::WarmUp(const std::vector<std::string>& labels,
+                                        bool indexes_only) const {
+    graph_->WarmUp(labels, indexes_only);
+}
 
 size_t lgraph::AccessControlledDB::Backup(const std::string& path, bool compact) const {
     CheckReadAccess();
     return graph_->Backup(path, compact);
 }
+
+lgraph::KvSpaceStat lgraph::AccessControlledDB::GetSpaceStat() const {
+    CheckReadAccess();
+    return graph_->GetSpaceStat();
+}
+
+void lgraph::AccessControlledDB::Compact(KillableRWLock* switch_lock) {
+    CheckFullAccess();
+    graph_->Compact(switch_lock);
+}
@@ -50,6 +50,8 @@ class AccessControlledDB {
 
     Transaction ForkTxn(Transaction& txn);
 
+    Transaction CreateSnapshotReadTxn(double max_age_seconds);
+
     bool LoadPlugin(plugin::Type plugin_type, const std::string& token, const std::string& name,
                     const std::vector<std::string>& code, const std::vector<std::string>& filename,
                     plugin::CodeType code_type, const std::string& desc, bool is_read_only,
@@ -99,6 +101,10 @@ class AccessControlledDB {
 
     bool AlterLabelModFields(const std::string& label, const std::vector<FieldSpec>& mod_fields,
                              bool is_vertex, size_t* n_modified);
+
+    bool UpgradeLabelRecords(bool is_vertex, const std::string& label, size_t batch_size,
+                             size_t interval_ms, size_t* n_upgraded);
+
     bool AddEdgeConstraints(
         const std::string& label,
         const std::vector<std::pair<std::string, std::string>>& constraints);
@@ -117,6 +123,9 @@ class AccessControlledDB {
 
     bool DeleteVertexIndex(const std::string& label, const std::string& field);
 
+    bool AlterVertexIndexInclude(const std::string& label, const std::string& field,
+                                 const std::vector<std::string>& include_fields);
+
     bool DeleteEdgeIndex(const std::string& label, const std::string& field);
 
     bool DeleteVertexCompositeIndex(const std::string& label,
@@ -124,6 +133,10 @@ class AccessControlledDB {
 
     bool DeleteVectorIndex(bool is_vertex, const std::string& label, const std::string& field);
 
+    bool AddVertexColumn(const std::string& label, const std::string& field);
+
+    bool DeleteVertexColumn(const std::string& label, const std::string& field);
+
     bool IsVertexIndexed(const std::string& label, const std::string& field);
 
     bool IsEdgeIndexed(const std::string& label, const std::string& field);
@@ -146,10 +159,14 @@ class AccessControlledDB {
                                                   const std::string& query, int top_n);
     void RefreshCount();
 
-    void WarmUp() const;
+    void WarmUp(const std::vector<std::string>& labels = {}, bool indexes_only = false) const;
 
     size_t Backup(const std::string& path, bool compact) const;
 
+    KvSpaceStat GetSpaceStat() const;
+
+    void Compact(KillableRWLock* switch_lock = nullptr);
+
     inline AccessLevel GetAccessLevel() const { return access_level_; }
 
     inline LightningGraph* GetLightningGraph() const { return graph_; }
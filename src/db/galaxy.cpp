@@ -120,17 +120,37 @@ bool lgraph::Galaxy::JudgeUserTokenNum(const std::string& user) {
     return true;
 }
 
+lgraph::TokenCache::Entry lgraph::Galaxy::ValidateTokenCached(const std::string& token) const {
+    TokenCache::Entry entry;
+    if (token_cache_.Lookup(token, entry)) return entry;
+    std::string password;
+    {
+        _HoldReadLock(acl_lock_);
+        if (!acl_->DecipherToken(token, entry.user, password)) THROW_CODE(Unauthorized);
+        entry.is_admin = acl_->IsAdmin(entry.user);
+        // read the epoch under acl_lock_, so that the entry turns stale if acl_
+        // is modified before it gets inserted
+        entry.epoch = token_cache_.Epoch();
+    }
+    try {
+        entry.refresh_stamp = token_manager_.GetRefreshStamp(token);
+    } catch (std::exception& e) {
+        // not issued by token_manager_, so it cannot be judged from the cache
+        return entry;
+    }
+    token_cache_.Insert(token, entry);
+    return entry;
+}
+
 std::string lgraph::Galaxy::ParseAndValidateToken(const std::string& token) const {
-    std::string user, password;
-    _HoldReadLock(acl_lock_);
-    if (!acl_->DecipherToken(token, user, password)) THROW_CODE(Unauthorized);
-    return user;
+    return ValidateTokenCached(token).user;
 }
 
 std::string lgraph::Galaxy::RefreshUserToken(const std::string& token,
                                         const std::string& user) const {
     std::string new_token = token_manager_.UpdateToken(token);
     _HoldWriteLock(acl_lock_);
+    token_cache_.Invalidate();
     if (new_token != "") {
         acl_->BindTokenUser(token, new_token, user);
     } else {
@@ -142,15 +162,23 @@ std::string lgraph::Galaxy::RefreshUserToken(const std::string& token,
 
 bool lgraph::Galaxy::UnBindTokenUser(const std::string& token) {
     _HoldWriteLock(acl_lock_);
+    token_cache_.Invalidate();
     return acl_->UnBindTokenUser(token);
 }
 
 bool lgraph::Galaxy::UnBindUserAllToken(const std::string& user) {
     _HoldWriteLock(acl_lock_);
+    token_cache_.Invalidate();
     return acl_->UnBindUserAllToken(user);
 }
 
 bool lgraph::Galaxy::JudgeRefreshTime(const std::string& token) {
+    TokenCache::Entry entry;
+    if (token_cache_.Lookup(token, entry)) {
+        if (token_manager_.JudgeRefreshStamp(entry.refresh_stamp)) return true;
+        UnBindTokenUser(token);
+        return false;
+    }
     if (!token_manager_.JudgeRefreshTime(token)) {
         UnBindTokenUser(token);
         return false;
@@ -174,11 +202,9 @@ std::pair<int, int> lgraph::Galaxy::GetTokenTime(const std::string& token) {
 
 std::string lgraph::Galaxy::ParseTokenAndCheckIfIsAdmin(const std::string& token,
                                                         bool* is_admin) const {
-    std::string user, password;
-    _HoldReadLock(acl_lock_);
-    if (!acl_->DecipherToken(token, user, password)) THROW_CODE(Unauthorized, "Invalid token.");
-    if (is_admin) *is_admin = acl_->IsAdmin(user);
-    return user;
+    TokenCache::Entry entry = ValidateTokenCached(token);
+    if (is_admin) *is_admin = entry.is_admin;
+    return entry.user;
 }
 
 bool lgraph::Galaxy::CreateGraph(const std::string& curr_user, const std::string& graph,
@@ -275,6 +301,7 @@ bool lgraph::Galaxy::ModifyACL(const FT& func) {
     if (!r) return r;
     txn.Commit();
     acl_ = std::move(acl_new);
+    token_cache_.Invalidate();
     return true;
 }
 
@@ -478,7 +505,9 @@ void lgraph::Galaxy::LoadIpWhitelist(KvTransaction& txn) {
     }
 }
 
-bool lgraph::Galaxy::LoadSnapshot(const std::string& dir) {
+bool lgraph::Galaxy::LoadSnapshot(
+    const std::string& dir,
+    const std::function<void(const std::string&, const std::string&)>& restore) {
     _HoldWriteLock(reload_lock_);
     auto confs = graphs_->ListGraphs();
     auto metaDir = GetMetaStoreDir(config_.dir);
@@ -490,7 +519,11 @@ bool lgraph::Galaxy::LoadSnapshot(const std::string& dir) {
         fs.RemoveDir(conf.second.dir);
     }
     fs.RemoveDir(metaDir);
-    fs.CopyToLocal(dir, config_.dir);
+    if (restore) {
+        restore(dir, config_.dir);
+    } else {
+        fs.CopyToLocal(dir, config_.dir);
+    }
     ReloadFromDisk(false);
     return true;
 }
@@ -502,7 +535,7 @@ static inline void TryMkDir(const std::string& dir, const fma_common::FileSystem
     }
 }
 
-std::vector<std::string> lgraph::Galaxy::SaveSnapshot(const std::string& dir) {
+std::vector<std::string> lgraph::Galaxy::SaveSnapshot(const std::string& dir, bool compact) {
     // TODO: for now, we require TLSRWLock write lock to be held before saving snapshot // NOLINT
     // However, we should be able to leverage MVCC here and thus avoid locking the whole
     // galaxy.
@@ -520,11 +553,11 @@ std::vector<std::string> lgraph::Galaxy::SaveSnapshot(const std::string& dir) {
     // backup meta data
     std::string meta_dir = GetMetaStoreDir(dir);
     TryMkDir(meta_dir, fs);
-    store_->Backup(meta_dir);
+    store_->Backup(meta_dir, compact);
     std::vector<std::string> ret;
     ret.push_back(meta_dir + "/data.mdb");
     // backup graphs
-    auto files = graphs_->Backup(dir);
+    auto files = graphs_->Backup(dir, compact);
     for (auto& f : files) ret.push_back(f);
     LOG_DEBUG() << "Snapshot files: " << fma_common::ToString(files);
     return ret;
@@ -549,6 +582,7 @@ void lgraph::Galaxy::ReloadFromDisk(bool create_if_not_exist) {
     if (graphs_) graphs_->CloseAllGraphs();
     graphs_.reset();
     acl_.reset();
+    token_cache_.Invalidate();
     store_.reset();
     LMDBKvStore::SetLastOpIdOfAllStores(-1);
     store_.reset(new LMDBKvStore(GetMetaStoreDir(config_.dir), (size_t)1 << 30, config_.durable,
@@ -581,9 +615,10 @@ void lgraph::Galaxy::SetRaftLogIndexBeforeWrite(int64_t id) {
     LMDBKvStore::SetLastOpIdOfAllStores(id);
 }
 
-void lgraph::Galaxy::WarmUp(const std::string& user, const std::vector<std::string>& graphs) {
+void lgraph::Galaxy::WarmUp(const std::string& user, const std::vector<std::string>& graphs,
+                            const std::vector<std::string>& labels, bool indexes_only) {
     for (auto& name : graphs) {
-        OpenGraph(user, name).WarmUp();
+        OpenGraph(user, name).WarmUp(labels, indexes_only);
     }
 }
 
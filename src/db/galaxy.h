@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <functional>
 #include <mutex>
 #include <tuple>
 #include <unordered_set>
@@ -34,6 +35,7 @@
 #include "db/acl.h"
 #include "db/db.h"
 #include "db/graph_manager.h"
+#include "db/token_cache.h"
 #include "db/token_manager.h"
 #include "protobuf/ha.pb.h"
 
@@ -45,7 +47,7 @@ namespace lgraph {
 class HaStateMachine;
 class Galaxy {
     friend class LightningGraph;  // for IncDbCount() and DecDbCount()
-    friend class HaStateMachine;  // for BootstrapRaftLogIndex()
+    friend class HaStateMachine;  // for BootstrapRaftLogIndex() and applying kv deltas
  public:
     struct Config {
         std::string dir = "./TuGraph";
@@ -72,11 +74,17 @@ class Galaxy {
     std::unique_ptr<GraphManager> graphs_;
     mutable KillableRWLock graphs_lock_;
     TokenManager token_manager_;
+    // tokens already verified against acl_ and token_manager_, invalidated
+    // whenever acl_ changes
+    mutable TokenCache token_cache_;
     std::unique_ptr<KvTable> db_info_table_;
     std::unique_ptr<KvTable> ip_whitelist_table_;
     std::unordered_set<std::string> ip_whitelist_;
     mutable KillableRWLock ip_whitelist_rw_lock_;
 
+    // validate token through token_cache_, falling back to acl_ on a miss
+    TokenCache::Entry ValidateTokenCached(const std::string& token) const;
+
  public:
     explicit Galaxy(const std::string& dir,
                     bool create_if_not_exist = true);
@@ -192,12 +200,16 @@ class Galaxy {
                                   const std::vector<std::string>& ips);
 
     // load snapshot from dir, write lock must be held
-    bool LoadSnapshot(const std::string& dir);
+    // if given, restore(dir, db_dir) is used to copy the snapshot files into the db dir
+    bool LoadSnapshot(const std::string& dir,
+                      const std::function<void(const std::string&, const std::string&)>&
+                          restore = nullptr);
 
     // save snapshot
     // for now, write lock must be held before this operation
     // returns the list of files which contains the snapshot
-    std::vector<std::string> SaveSnapshot(const std::string& dir);
+    // without compaction, unchanged pages keep their offsets in the snapshot files
+    std::vector<std::string> SaveSnapshot(const std::string& dir, bool compact = true);
 
     bool IsAdmin(const std::string& user) const;
 
@@ -215,8 +227,9 @@ class Galaxy {
 
     void SetRaftLogIndexBeforeWrite(int64_t id);
 
-    // warmup a list of graphs
-    void WarmUp(const std::string& curr_user, const std::vector<std::string>& graphs);
+    // warmup a list of graphs, see LightningGraph::WarmUp for labels and indexes_only
+    void WarmUp(const std::string& curr_user, const std::vector<std::string>& graphs,
+                const std::vector<std::string>& labels = {}, bool indexes_only = false);
 
     // backup the whole db into dst directory, possibly with compaction
     void Backup(const std::string& dst, bool compact);
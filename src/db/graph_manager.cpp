@@ -87,6 +87,7 @@ inline void UpdateDBConfigWithGMConfig(lgraph::DBConfig& dbc,
     dbc.subprocess_max_idle_seconds = gmc.plugin_subprocess_max_idle_seconds;
     dbc.ft_index_options = gmc.ft_index_options;
     dbc.enable_realtime_count = gmc.enable_realtime_count;
+    dbc.persist_hot_pages = gmc.persist_hot_pages;
 }
 
 bool lgraph::GraphManager::CreateGraph(KvTransaction& txn, const std::string& name,
@@ -127,6 +128,8 @@ bool lgraph::GraphManager::CreateGraphWithData(KvTransaction& txn, const std::st
     real_config.db_size = _detail::DEFAULT_GRAPH_SIZE;
     // update graphs_
     real_config.create_if_not_exist = true;
+    // the data file is an lmdb file
+    real_config.kv_engine = _detail::KV_ENGINE_LMDB;
     if (it == graphs_.end()) {
         real_config.dir = GenNewGraphSubDir();
         StoreConfig(txn, name, real_config);
@@ -146,6 +149,7 @@ bool lgraph::GraphManager::CreateGraphWithData(KvTransaction& txn, const std::st
         graphs_.emplace_hint(it, name, GcDb(graph.release()));
     } else {
         auto origin_graph = graphs_.find(name)->second.GetScopedRef();
+        if (origin_graph->GetKvEngine() != _detail::KV_ENGINE_LMDB) return false;
         real_config.dir = GetGraphActualDir(parent_dir_, origin_graph->GetSecret());
         std::string new_file_path = GetGraphActualDir(GetGraphActualDir(
                                     parent_dir_, origin_graph->GetSecret()), "data.mdb");
@@ -295,7 +299,8 @@ void lgraph::GraphManager::ReloadFromDisk(KvStore* store, KvTransaction& txn,
     }
 }
 
-std::vector<std::string> lgraph::GraphManager::Backup(const std::string& backup_parent_dir) {
+std::vector<std::string> lgraph::GraphManager::Backup(const std::string& backup_parent_dir,
+                                                     bool compact) {
     std::vector<std::string> ret;
     // copy graphs one by one
     for (auto& kv : graphs_) {
@@ -304,13 +309,21 @@ std::vector<std::string> lgraph::GraphManager::Backup(const std::string& backup_
         ScopedRef<LightningGraph> g = kv.second.GetScopedRef();
         std::string sub_dir = fma_common::FilePath(g->GetConfig().dir).Name();
         std::string graph_dir = GetGraphActualDir(backup_parent_dir, sub_dir);
-        ret.push_back(graph_dir + "/data.mdb");
         if (!fma_common::file_system::MkDir(graph_dir)) {
             LOG_WARN() << "Error backing up graph " << name << ": cannot create dir " << graph_dir;
             throw std::runtime_error("Error backing up graph [" + name + "]: cannot create dir " +
                                      graph_dir);
         }
-        g->Backup(graph_dir);
+        g->Backup(graph_dir, compact);
+        if (g->GetKvEngine() == _detail::KV_ENGINE_ROCKSDB) {
+            // a rocksdb store is a dir of many files
+            std::string store_dir = LightningGraph::GetStoreDir(graph_dir, g->GetKvEngine());
+            for (auto& f : std::filesystem::directory_iterator(store_dir)) {
+                ret.push_back(f.path().string());
+            }
+        } else {
+            ret.push_back(graph_dir + "/data.mdb");
+        }
     }
     return ret;
 }
@@ -41,6 +41,7 @@ class GraphManager {
         int plugin_subprocess_max_idle_seconds = 600;
         FullTextIndexOptions ft_index_options;
         bool enable_realtime_count = true;
+        bool persist_hot_pages = false;
 
         Config() {}
         explicit Config(const GlobalConfig& gc)
@@ -48,7 +49,8 @@ class GraphManager {
               load_plugins(true),
               plugin_subprocess_max_idle_seconds(gc.subprocess_max_idle_seconds),
               ft_index_options(gc.ft_index_options),
-              enable_realtime_count(gc.enable_realtime_count) {}
+              enable_realtime_count(gc.enable_realtime_count),
+              persist_hot_pages(gc.persist_hot_pages) {}
     };
 
     struct ModGraphActions {
@@ -100,7 +102,7 @@ class GraphManager {
                         const std::string& parent_dir, const Config& config);
 
     // backup all graphs to dirs under parent_dir
-    std::vector<std::string> Backup(const std::string& parent_dir);
+    std::vector<std::string> Backup(const std::string& parent_dir, bool compact = true);
 
     // closes all graphs before destroy
     void CloseAllGraphs();
@@ -0,0 +1,138 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lgraph {
+/**
+ * A bounded, sharded cache of tokens that have already been verified. Each
+ * entry maps a token to its user, the admin flag of the user and the
+ * refresh_time claim of the jwt, so that a request carrying a known token can
+ * be authenticated with one hash lookup, without taking the acl lock or
+ * verifying the jwt signature again.
+ *
+ * Entries are stamped with the epoch at which they were validated. Any change
+ * that may invalidate a token (logout, refresh, user or role modification,
+ * reload) bumps the epoch through Invalidate(), which makes every existing
+ * entry stale in O(1). The epoch must be read while holding the same lock
+ * under which the token was validated, so that an entry built from an old acl
+ * can never be inserted as fresh.
+ */
+class TokenCache {
+ public:
+    struct Entry {
+        std::string user;
+        bool is_admin = false;
+        double refresh_stamp = 0;
+        uint64_t epoch = 0;
+    };
+
+    static const size_t DEFAULT_CAPACITY = 1 << 16;
+
+ private:
+    static const size_t N_SHARDS = 64;
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<std::string, Entry> map;
+    };
+
+    size_t shard_capacity_;
+    std::atomic<uint64_t> epoch_;
+    std::vector<Shard> shards_;
+
+    Shard& GetShard(const std::string& token) {
+        return shards_[std::hash<std::string>()(token) % N_SHARDS];
+    }
+
+ public:
+    explicit TokenCache(size_t capacity = DEFAULT_CAPACITY)
+        : shard_capacity_(std::max<size_t>(capacity / N_SHARDS, 1)), epoch_(0),
+          shards_(N_SHARDS) {}
+
+    TokenCache(const TokenCache&) = delete;
+    TokenCache& operator=(const TokenCache&) = delete;
+
+    /** Current epoch. Read it under the lock that protects the token mapping. */
+    uint64_t Epoch() const { return epoch_.load(std::memory_order_acquire); }
+
+    /**
+     * Looks up a token.
+     *
+     * @param          token    The token.
+     * @param [out]    entry    The cached entry, if found and not stale.
+     *
+     * @returns True if the token was found in the current epoch.
+     */
+    bool Lookup(const std::string& token, Entry& entry) {
+        uint64_t epoch = Epoch();
+        Shard& shard = GetShard(token);
+        std::lock_guard<std::mutex> l(shard.mutex);
+        auto it = shard.map.find(token);
+        if (it == shard.map.end()) return false;
+        if (it->second.epoch != epoch) {
+            shard.map.erase(it);
+            return false;
+        }
+        entry = it->second;
+        return true;
+    }
+
+    /**
+     * Inserts a verified token. If the shard is full, an arbitrary entry is
+     * evicted, stale entries first.
+     */
+    void Insert(const std::string& token, Entry entry) {
+        Shard& shard = GetShard(token);
+        std::lock_guard<std::mutex> l(shard.mutex);
+        auto it = shard.map.find(token);
+        if (it != shard.map.end()) {
+            it->second = std::move(entry);
+            return;
+        }
+        if (shard.map.size() >= shard_capacity_) {
+            uint64_t epoch = Epoch();
+            for (auto i = shard.map.begin(); i != shard.map.end();) {
+                if (i->second.epoch != epoch)
+                    i = shard.map.erase(i);
+                else
+                    ++i;
+            }
+            if (shard.map.size() >= shard_capacity_) shard.map.erase(shard.map.begin());
+        }
+        shard.map.emplace(token, std::move(entry));
+    }
+
+    /** Makes every cached entry stale. */
+    void Invalidate() { epoch_.fetch_add(1, std::memory_order_acq_rel); }
+
+    /** Number of entries currently held, including stale ones. */
+    size_t Size() {
+        size_t n = 0;
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> l(shard.mutex);
+            n += shard.map.size();
+        }
+        return n;
+    }
+};
+}  // namespace lgraph
@@ -90,12 +90,15 @@ std::string lgraph::TokenManager::UpdateToken(const std::string& token) const {
 }
 
 bool lgraph::TokenManager::JudgeRefreshTime(const std::string& token) {
+    return JudgeRefreshStamp(GetRefreshStamp(token));
+}
+
+double lgraph::TokenManager::GetRefreshStamp(const std::string& token) const {
     auto decode_token = jwt::decode(token);
     verifier_.verify(decode_token);
-    auto refresh_time = decode_token.get_payload_claim("refresh_time").as_string();
-    if ((fma_common::GetTime() - stod(refresh_time)) <= refresh_time_) {
-        return true;
-    } else {
-        return false;
-    }
+    return stod(decode_token.get_payload_claim("refresh_time").as_string());
+}
+
+bool lgraph::TokenManager::JudgeRefreshStamp(double refresh_stamp) const {
+    return (fma_common::GetTime() - refresh_stamp) <= refresh_time_;
 }
@@ -96,5 +96,18 @@ class TokenManager {
     @return   true->valid    false->unvalid
     */
     bool JudgeRefreshTime(const std::string& token);
+
+    /*!
+    @brief  Verify token and return its refresh_time claim
+    @param[in] token      jwt token
+    @return   time at which the token was issued or refreshed
+    */
+    double GetRefreshStamp(const std::string& token) const;
+
+    /*!
+    @param[in] refresh_stamp      refresh_time claim of a verified token
+    @return   true->valid    false->unvalid
+    */
+    bool JudgeRefreshStamp(double refresh_stamp) const;
 };
 }  // namespace lgraph
@@ -83,6 +83,11 @@ Transaction GraphDB::ForkTxn(Transaction& txn) {
     return Transaction(db_->ForkTxn(*(txn.txn_)));
 }
 
+Transaction GraphDB::CreateSnapshotReadTxn(double max_age_seconds) {
+    THROW_IF_INVALID();
+    return Transaction(db_->CreateSnapshotReadTxn(max_age_seconds));
+}
+
 void GraphDB::Flush() {
     THROW_IF_INVALID();
     db_->Flush();
@@ -255,6 +260,18 @@ bool GraphDB::DeleteVectorIndex(
     return db_->DeleteVectorIndex(is_vertex, label, field);
 }
 
+bool GraphDB::AddVertexColumn(const std::string& label, const std::string& field) {
+    THROW_IF_INVALID();
+    THROW_IF_RO();
+    return db_->AddVertexColumn(label, field);
+}
+
+bool GraphDB::DeleteVertexColumn(const std::string& label, const std::string& field) {
+    THROW_IF_INVALID();
+    THROW_IF_RO();
+    return db_->DeleteVertexColumn(label, field);
+}
+
 bool GraphDB::DeleteEdgeIndex(const std::string& label, const std::string& field) {
     THROW_IF_INVALID();
     THROW_IF_RO();
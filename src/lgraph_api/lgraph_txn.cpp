@@ -428,6 +428,17 @@ bool Transaction::IsVertexIndexed(const std::string& label, const std::string& f
     return true;
 }
 
+void Transaction::ScanVertexColumn(const std::string& label, const std::string& field,
+                                   const std::function<bool(int64_t, const FieldData&)>& f,
+                                   int64_t vid_start, int64_t vid_end) {
+    ThrowIfInvalid();
+    lgraph::ColumnStore* store = txn_->GetVertexColumnStore(label, field);
+    store->Scan(txn_->GetTxn(), vid_start, vid_end,
+                [&](lgraph::VertexId vid, const lgraph::Value& v) {
+                    return f(vid, lgraph::field_data_helper::ValueToFieldData(v, store->Type()));
+                });
+}
+
 bool Transaction::IsEdgeIndexed(const std::string& label, const std::string& field) {
     ThrowIfInvalid();
     lgraph::EdgeIndex* idx = txn_->GetEdgeIndex(label, field);
@@ -12,6 +12,7 @@
  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
  */
 
+#include <sys/stat.h>
 #include "lgraph/olap_base.h"
 #include "tools/lgraph_log.h"
 
@@ -127,6 +128,113 @@ void ParallelBitset::Swap(ParallelBitset &other) {
     std::swap(data_, other.data_);
 }
 
+BucketedFrontier::BucketedFrontier() : curr_bucket_(0) {
+    int num_threads = 0;
+#pragma omp parallel
+    {
+        if (omp_get_thread_num() == 0) {
+            num_threads = omp_get_num_threads();
+        }
+    };
+    local_buckets_.resize(num_threads);
+    for (auto &local : local_buckets_) local.ring.resize(N_CYCLIC_BUCKETS);
+}
+
+void BucketedFrontier::Push(size_t vid, size_t bucket) {
+    auto &local = local_buckets_[omp_get_thread_num()];
+    if (bucket < curr_bucket_) bucket = curr_bucket_;
+    if (bucket - curr_bucket_ < N_CYCLIC_BUCKETS) {
+        local.ring[bucket % N_CYCLIC_BUCKETS].push_back(vid);
+    } else {
+        local.overflow.emplace_back(vid, bucket);
+        local.min_overflow = std::min(local.min_overflow, bucket);
+    }
+}
+
+bool BucketedFrontier::Advance() {
+    size_t next_bucket = (size_t)-1;
+    for (auto &local : local_buckets_) {
+        for (size_t i = 0; i < N_CYCLIC_BUCKETS && curr_bucket_ + i < next_bucket; i++) {
+            if (!local.ring[(curr_bucket_ + i) % N_CYCLIC_BUCKETS].empty()) {
+                next_bucket = curr_bucket_ + i;
+                break;
+            }
+        }
+        next_bucket = std::min(next_bucket, local.min_overflow);
+    }
+    frontier_.clear();
+    if (next_bucket == (size_t)-1) return false;
+    curr_bucket_ = next_bucket;
+    // move the overflow the ring now reaches into the ring
+    for (auto &local : local_buckets_) {
+        if (local.min_overflow - curr_bucket_ >= N_CYCLIC_BUCKETS) continue;
+        size_t kept = 0;
+        local.min_overflow = (size_t)-1;
+        for (auto &entry : local.overflow) {
+            if (entry.second - curr_bucket_ < N_CYCLIC_BUCKETS) {
+                local.ring[entry.second % N_CYCLIC_BUCKETS].push_back(entry.first);
+            } else {
+                local.min_overflow = std::min(local.min_overflow, entry.second);
+                local.overflow[kept++] = entry;
+            }
+        }
+        local.overflow.resize(kept);
+    }
+    for (auto &local : local_buckets_) {
+        auto &bucket = local.ring[curr_bucket_ % N_CYCLIC_BUCKETS];
+        frontier_.insert(frontier_.end(), bucket.begin(), bucket.end());
+        bucket.clear();
+    }
+    return true;
+}
+
+void BucketedFrontier::Clear() {
+    for (auto &local : local_buckets_) {
+        for (auto &bucket : local.ring) bucket.clear();
+        local.overflow.clear();
+        local.min_overflow = (size_t)-1;
+    }
+    frontier_.clear();
+    curr_bucket_ = 0;
+}
+
+void *MapFileRange(int fd, size_t offset, size_t size) {
+    if (size == 0) throw std::runtime_error("Cannot map an empty range");
+    struct stat st;
+    if (fstat(fd, &st) != 0 || offset + size > (size_t)st.st_size) {
+        throw std::runtime_error("File range is out of the file");
+    }
+#if USE_VALGRIND
+    char *data = (char *)malloc(size);
+    if (!data) throw std::bad_alloc();
+    for (size_t read_bytes = 0; read_bytes < size;) {
+        ssize_t ret = pread(fd, data + read_bytes, size - read_bytes, offset + read_bytes);
+        if (ret <= 0) {
+            free(data);
+            throw std::runtime_error("Failed to read file range");
+        }
+        read_bytes += ret;
+    }
+    return data;
+#else
+    void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_NORESERVE, fd,
+                      offset);
+    if (data == MAP_FAILED) throw std::runtime_error("Failed to map file range");
+    // both are hints, the mapping works without them
+    madvise(data, size, MADV_HUGEPAGE);
+    madvise(data, size, MADV_WILLNEED);
+    return data;
+#endif
+}
+
+void WriteFileRange(int fd, size_t offset, const void *data, size_t size) {
+    for (size_t written = 0; written < size;) {
+        ssize_t ret = pwrite(fd, (const char *)data + written, size - written, offset + written);
+        if (ret <= 0) throw std::runtime_error("Failed to write file range");
+        written += ret;
+    }
+}
+
 VertexLockGuard::VertexLockGuard(volatile bool *lock) : lock_(lock) {
     do {
         while (*lock_) std::this_thread::yield();
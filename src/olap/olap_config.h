@@ -26,7 +26,8 @@ namespace olap {
 enum SourceType {
     BINARY_FILE,
     TEXT_FILE,
-    ODPS
+    ODPS,
+    CSR_FILE
 };
 
 /**
@@ -144,6 +145,7 @@ class ConfigBase {
     std::string input_dir = "";
     std::string output_dir = "";
     bool id_mapping = false;
+    std::string csr_output = "";
     std::function<std::tuple<size_t, bool>(const char *, const char *, EdgeUnit<EdgeData> &)>
             parse_line = parse_line_unweighted<EdgeData>;
     std::function<std::tuple<size_t, bool>(const char *, const char *, EdgeStringUnit<EdgeData> &)>
@@ -178,6 +180,8 @@ class ConfigBase {
             type = TEXT_FILE;
         } else if (type_str == "binary") {
             type = BINARY_FILE;
+        } else if (type_str == "csr") {
+            type = CSR_FILE;
         } else {
             printf("Unrecognized source type: %s\n", type_str.c_str());
             exit(-1);
@@ -186,7 +190,7 @@ class ConfigBase {
 
     void AddParameterType(fma_common::Configuration& config) {
         config.Add(type_str, "type", true)
-                .Comment("source type, can be text/binary");
+                .Comment("source type, can be text/binary/csr");
     }
 
  private:
@@ -200,6 +204,9 @@ class ConfigBase {
                 .Comment("input file of graph edgelist in txt if need id mapping");
         config.Add(output_dir, "output_dir", true)
                 .Comment("output dir of result");
+        config.Add(csr_output, "csr_output", true)
+                .Comment("binary csr file to write the loaded graph to, "
+                         "which can be loaded later with --type csr");
     }
 
     void PrintFile() {
@@ -207,6 +214,8 @@ class ConfigBase {
             std::cout << "  vertices:     " << num_vertices   << std::endl;
             std::cout << "  input_dir:    " << input_dir      << std::endl;
             std::cout << "  output_dir:   " << output_dir     << std::endl;
+            if (csr_output != "")
+                std::cout << "  csr_output:   " << csr_output     << std::endl;
         }
     }
 };
@@ -61,7 +61,8 @@ class OlapOnDisk : public OlapBase<EdgeData> {
 
     /**
      * 
-     * @brief   Load edge_list from txt file and construct graph.
+     * @brief   Load edge_list from txt or binary file and construct graph, or
+     *          map a csr file written before with --csr_output.
      *
      * @param   config              The ConfigBase of graph.
      * @param   edge_direction_policy   Edge direction policy of graph.
@@ -101,6 +102,27 @@ class OlapOnDisk : public OlapBase<EdgeData> {
             this->num_edges_ = reader.num_edges;
             this->num_vertices_ = GetMaxVertexId() + 1;
             Construct();
+        } else if (config.GetType() == CSR_FILE) {
+            this->MapCsr(config.input_dir, config.id_mapping ? &mapped_to_origin_ : nullptr);
+            if ((this->edge_direction_policy_ == DUAL_DIRECTION) !=
+                (edge_direction_policy == DUAL_DIRECTION)) {
+                throw std::runtime_error(
+                    "The csr file was written with another edge direction policy");
+            }
+            if (config.id_mapping) {
+                for (size_t vi = 0; vi < this->num_vertices_; vi++) {
+                    hash_list_.insert(mapped_to_origin_[vi], vi);
+                }
+            }
+        }
+
+        if (config.csr_output != "" && config.GetType() != CSR_FILE) {
+            if (config.id_mapping) {
+                this->WriteCsr(config.csr_output,
+                               [&](size_t vi) { return mapped_to_origin_[vi]; });
+            } else {
+                this->WriteCsr(config.csr_output);
+            }
         }
 
         cost += get_time();
@@ -155,7 +177,7 @@ class OlapOnDisk : public OlapBase<EdgeData> {
     void Write(ConfigBase<EdgeData> & config, ParallelVector<VertexData>& array,
         size_t array_size, std::string name,
         std::function<bool(VertexData &)> filter_output = filter_output_default<VertexData&>) {
-        if (config.GetType() == TEXT_FILE) {
+        if (config.GetType() == TEXT_FILE || config.GetType() == CSR_FILE) {
             if (config.output_dir == "") return;
             FileWriter<VertexData> fw(config.output_dir, array, array_size,
                       mapped_to_origin_, name, config.id_mapping, filter_output);
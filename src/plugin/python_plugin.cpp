@@ -19,6 +19,7 @@
 #include "tools/lgraph_log.h"
 
 #include "core/data_type.h"
+#include "core/kv_write_set.h"
 #include "core/lightning_graph.h"
 #include "core/task_tracker.h"
 #include "core/thread_id.h"
@@ -126,6 +127,9 @@ void PythonPluginManagerImpl::DoCall(lgraph_api::Transaction* txn, const std::st
                                      const std::string name, const PluginInfoBase* pinfo,
                                      const std::string& request, double timeout, bool in_process,
                                      std::string& output) {
+    // the plugin writes from its own process
+    auto recorder = KvWriteSetRecorder::Current();
+    if (recorder && !pinfo->read_only) recorder->OnUnrecordedWrites("python plugin " + name);
     auto ec = CallInternal(user, name, request, timeout, in_process, pinfo->read_only, output);
     switch (ec) {
     case python_plugin::TaskOutput::ErrorCode::SUCCESS:
@@ -159,7 +159,6 @@ void ApplyRaftRequest(uint64_t index, const bolt_raft::RaftRequest& request) {
         LOG_ERROR() << FMA_FMT(
             "failed to apply cypher, cypher: {}, exception: {}", cypher, e.what());
     }
-    sm->GetGalaxy()->UpdateBoltRaftApplyIndex(index);
 }
 
 void BoltFSM(std::shared_ptr<BoltConnection> conn) {
@@ -310,8 +309,7 @@ void BoltFSM(std::shared_ptr<BoltConnection> conn) {
                     RespondFailure(ErrorCode::UnknownError, e.what());
                 }
                 if (promise_context) {
-                    BoltServer::Instance().StateMachine()->GetGalaxy()->UpdateBoltRaftApplyIndex(
-                        promise_context->index);
+                    // the raft driver persists the apply index
                     promise_context->applied.set_value();
                 }
             }
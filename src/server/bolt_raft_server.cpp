@@ -51,8 +51,10 @@ bool BoltRaftServer::Start(lgraph::StateMachine* sm, int port, uint64_t node_id,
             }
             auto apply_index = sm_->GetGalaxy()->GetBoltRaftApplyIndex();
             LOG_INFO() << "read apply index from metadb, apply index: " << apply_index;
-            raft_driver_ = std::make_unique<RaftDriver>(bolt::ApplyRaftRequest, apply_index,
-                                                        node_id, peers, store_config, config);
+            raft_driver_ = std::make_unique<RaftDriver>(
+                bolt::ApplyRaftRequest,
+                [this](uint64_t index) { sm_->GetGalaxy()->UpdateBoltRaftApplyIndex(index); },
+                apply_index, node_id, peers, store_config, config);
             auto err = raft_driver_->Run();
             if (err != nullptr) {
                 LOG_ERROR() << "raft driver failed to run, error: " << err.String();
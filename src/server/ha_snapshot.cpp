@@ -0,0 +1,197 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include "brpc/policy/snappy_compress.h"
+#include "butil/iobuf.h"
+#include "butil/sha1.h"
+#include "butil/strings/string_number_conversions.h"
+#include "fma-common/string_formatter.h"
+#include "fma-common/type_traits.h"
+#include "core/parallel_for.h"
+#include "tools/lgraph_log.h"
+#include "server/ha_snapshot.h"
+
+namespace lgraph {
+namespace ha_snapshot {
+
+static const char CHUNK_MARK[] = ".chunk.";
+// bytes of chunk buffers held at once while splitting or restoring
+static const size_t MAX_BUFFERED_BYTES = (size_t)1 << 30;
+
+// Threads to split or restore with, so that the buffers of the chunks in flight fit in
+// MAX_BUFFERED_BYTES. A thread holds up to three buffers of a chunk: the raw data, its
+// contiguous copy for the checksum or its decompressed copy, and the compressed data.
+static size_t NumThreads(size_t chunk_size) {
+    size_t n = MAX_BUFFERED_BYTES / std::max<size_t>(3 * chunk_size, 1);
+    return std::max<size_t>(1, std::min<size_t>(n, std::thread::hardware_concurrency()));
+}
+
+class FileDescriptor {
+    int fd_;
+
+ public:
+    FileDescriptor(const std::string& path, int flags) : fd_(::open(path.c_str(), flags, 0644)) {
+        if (fd_ < 0)
+            throw std::runtime_error(FMA_FMT("Failed to open {}: {}", path, strerror(errno)));
+    }
+
+    ~FileDescriptor() { ::close(fd_); }
+
+    DISABLE_COPY(FileDescriptor);
+
+    int Get() const { return fd_; }
+};
+
+static void ReadAt(int fd, off_t offset, size_t size, butil::IOPortal* buf,
+                   const std::string& path) {
+    while (buf->size() < size) {
+        ssize_t nr = buf->pappend_from_file_descriptor(fd, offset + buf->size(),
+                                                       size - buf->size());
+        if (nr < 0)
+            throw std::runtime_error(FMA_FMT("Failed to read {}: {}", path, strerror(errno)));
+        if (nr == 0) break;
+    }
+}
+
+static void WriteAt(int fd, off_t offset, butil::IOBuf* buf, const std::string& path) {
+    while (!buf->empty()) {
+        ssize_t nw = buf->pcut_into_file_descriptor(fd, offset, buf->size());
+        if (nw < 0)
+            throw std::runtime_error(FMA_FMT("Failed to write {}: {}", path, strerror(errno)));
+        offset += nw;
+    }
+}
+
+std::vector<SnapshotFile> SplitIntoChunks(const std::string& dir,
+                                          const std::vector<std::string>& files,
+                                          size_t chunk_size) {
+    if (chunk_size == 0) throw std::runtime_error("Snapshot chunk size must be positive.");
+    struct Chunk {
+        size_t file;
+        size_t offset;
+        size_t size;
+    };
+    std::vector<Chunk> chunks;
+    std::vector<std::unique_ptr<FileDescriptor>> fds;
+    for (size_t i = 0; i < files.size(); i++) {
+        if (files[i].compare(0, dir.size(), dir) != 0)
+            throw std::runtime_error(FMA_FMT("File {} is not under {}", files[i], dir));
+        fds.emplace_back(new FileDescriptor(files[i], O_RDONLY));
+        size_t file_size = std::filesystem::file_size(files[i]);
+        size_t offset = 0;
+        // an empty file still gets a chunk, so that it is restored
+        do {
+            chunks.push_back(Chunk{i, offset, std::min(chunk_size, file_size - offset)});
+            offset += chunk_size;
+        } while (offset < file_size);
+    }
+    std::vector<SnapshotFile> ret(chunks.size());
+    ParallelFor(chunks.size(), NumThreads(chunk_size), [&](size_t i) {
+        const Chunk& c = chunks[i];
+        const std::string& file = files[c.file];
+        butil::IOPortal raw;
+        ReadAt(fds[c.file]->Get(), c.offset, c.size, &raw, file);
+        if (raw.size() != c.size)
+            throw std::runtime_error(FMA_FMT("File {} changed while splitting it", file));
+        std::string sha1 = butil::SHA1HashString(raw.to_string());
+        butil::IOBuf compressed;
+        if (!brpc::policy::SnappyCompress(raw, &compressed))
+            throw std::runtime_error(FMA_FMT("Failed to compress {} at {}", file, c.offset));
+        std::string path = file + CHUNK_MARK + std::to_string(c.offset);
+        FileDescriptor out(path, O_WRONLY | O_CREAT | O_TRUNC);
+        WriteAt(out.Get(), 0, &compressed, path);
+        size_t start = path.find_first_not_of('/', dir.size());
+        ret[i].name = path.substr(start);
+        ret[i].checksum = butil::HexEncode(sha1.data(), sha1.size());
+    });
+    fds.clear();
+    for (auto& f : files) std::filesystem::remove(f);
+    LOG_DEBUG() << "Split " << files.size() << " snapshot files into " << ret.size()
+                << " chunks";
+    return ret;
+}
+
+void RestoreSnapshot(const std::string& src_dir, const std::string& dst_dir) {
+    namespace fs = std::filesystem;
+    struct Chunk {
+        std::string path;
+        size_t target;
+        off_t offset;
+    };
+    std::vector<std::string> targets;
+    std::map<std::string, size_t> target_ids;
+    std::vector<Chunk> chunks;
+    for (auto& e : fs::recursive_directory_iterator(src_dir)) {
+        fs::path rel = fs::relative(e.path(), src_dir);
+        fs::path dst = fs::path(dst_dir) / rel;
+        if (e.is_directory()) {
+            fs::create_directories(dst);
+            continue;
+        }
+        fs::create_directories(dst.parent_path());
+        std::string name = rel.filename().string();
+        size_t pos = name.rfind(CHUNK_MARK);
+        std::string offset = pos == std::string::npos ? "" : name.substr(pos + strlen(CHUNK_MARK));
+        if (offset.empty() || !std::all_of(offset.begin(), offset.end(), ::isdigit)) {
+            fs::copy_file(e.path(), dst, fs::copy_options::overwrite_existing);
+            continue;
+        }
+        std::string target = (dst.parent_path() / name.substr(0, pos)).string();
+        auto it = target_ids.emplace(target, targets.size()).first;
+        if (it->second == targets.size()) targets.push_back(target);
+        chunks.push_back(Chunk{e.path().string(), it->second, (off_t)std::stoll(offset)});
+    }
+    // the chunk size is the largest gap between the offsets of the chunks of a file; it is
+    // unknown if every file fits in a chunk, and then the chunks are restored one at a time
+    std::vector<std::vector<off_t>> offsets(targets.size());
+    for (auto& c : chunks) offsets[c.target].push_back(c.offset);
+    size_t chunk_size = MAX_BUFFERED_BYTES;
+    if (std::any_of(offsets.begin(), offsets.end(),
+                    [](const std::vector<off_t>& o) { return o.size() > 1; })) {
+        chunk_size = 0;
+        for (auto& o : offsets) {
+            std::sort(o.begin(), o.end());
+            for (size_t i = 1; i < o.size(); i++)
+                chunk_size = std::max<size_t>(chunk_size, o[i] - o[i - 1]);
+        }
+    }
+    std::vector<std::unique_ptr<FileDescriptor>> fds;
+    for (auto& t : targets) fds.emplace_back(new FileDescriptor(t, O_WRONLY | O_CREAT | O_TRUNC));
+    ParallelFor(chunks.size(), NumThreads(chunk_size), [&](size_t i) {
+        const Chunk& c = chunks[i];
+        FileDescriptor in(c.path, O_RDONLY);
+        butil::IOPortal compressed;
+        ReadAt(in.Get(), 0, std::filesystem::file_size(c.path), &compressed, c.path);
+        butil::IOBuf raw;
+        if (!brpc::policy::SnappyDecompress(compressed, &raw))
+            throw std::runtime_error(FMA_FMT("Failed to decompress {}", c.path));
+        WriteAt(fds[c.target]->Get(), c.offset, &raw, targets[c.target]);
+    });
+    LOG_DEBUG() << "Restored " << targets.size() << " snapshot files from " << chunks.size()
+                << " chunks";
+}
+
+}  // namespace ha_snapshot
+}  // namespace lgraph
@@ -0,0 +1,61 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace lgraph {
+namespace ha_snapshot {
+
+/**
+ * A file of an HA snapshot, given relative to the snapshot dir, and the checksum of its
+ * content. braft skips copying a file whose name and checksum match a file it already has,
+ * either left by an interrupted install or in its last snapshot. A node that applied the
+ * logs itself has its own page layout, so few chunks of its last snapshot match those of
+ * the leader: the chunks save the transfer when an install is resumed, not on a first one.
+ */
+struct SnapshotFile {
+    std::string name;
+    std::string checksum;
+};
+
+/**
+ * Splits each of the files into chunks of chunk_size bytes, compressed with snappy and stored
+ * next to the file as <file>.chunk.<offset>, then removes the file. Chunks are compressed in
+ * parallel, by as many threads as keep the chunks in flight within 1GB. Since the db files
+ * are copied without compaction, a page that did not change since the last snapshot of the
+ * same node stays at the same offset.
+ *
+ * @param   dir         The snapshot dir, all files must be under it.
+ * @param   files       Full paths of the files to split.
+ * @param   chunk_size  Size of a chunk before compression.
+ *
+ * @returns The chunk files.
+ */
+std::vector<SnapshotFile> SplitIntoChunks(const std::string& dir,
+                                          const std::vector<std::string>& files,
+                                          size_t chunk_size);
+
+/**
+ * Copies the snapshot in src_dir to dst_dir, decompressing the chunks of each split file
+ * straight into its place in dst_dir. Files that are not chunks are copied as they are, so
+ * snapshots saved without chunks are restored too. src_dir is left unchanged. The chunks in
+ * flight are kept within 1GB as when splitting.
+ */
+void RestoreSnapshot(const std::string& src_dir, const std::string& dst_dir);
+
+}  // namespace ha_snapshot
+}  // namespace lgraph
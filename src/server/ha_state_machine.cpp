@@ -1,5 +1,7 @@
 ﻿/* Copyright (c) 2022 AntGroup. All Rights Reserved. */
 
+#include <unordered_set>
+
 #include "braft/protobuf_file.h"
 #include "braft/raft.h"
 #include "braft/util.h"
@@ -8,11 +10,14 @@
 #include "braft/cli.h"
 #include "brpc/closure_guard.h"
 
+#include "braft/local_file_meta.pb.h"
+#include "server/ha_snapshot.h"
 #include "server/ha_state_machine.h"
 #include "restful/server/rest_server.h"
 
 namespace braft {
     DECLARE_bool(raft_enable_witness_to_leader);
+    DECLARE_bool(raft_enable_leader_lease);
     DECLARE_bool(enable_first_snapshot_config);
     DECLARE_string(first_snapshot_start_time);
 }
@@ -76,6 +81,10 @@ void lgraph::HaStateMachine::Start() {
         braft::FLAGS_first_snapshot_start_time =
             config_.ha_first_snapshot_start_time;
     }
+    if (config_.ha_physical_replication && !config_.ha_is_witness) {
+        LOG_INFO() << "HA physical replication is enabled";
+        kv_delta_writer_ = std::make_unique<fma_common::ThreadPool>(1);
+    }
     // start braft::Node
     braft::Node* node = new braft::Node("lgraph", braft::PeerId(addr, 0,
                                                                 config_.ha_is_witness));
@@ -89,6 +98,9 @@ void lgraph::HaStateMachine::Start() {
         }
     }
     braft::FLAGS_raft_enable_witness_to_leader = config_.ha_enable_witness_to_leader;
+    // the master answers read index requests only while its lease is valid
+    braft::FLAGS_raft_enable_leader_lease = true;
+    applied_index_ = galaxy_->GetRaftLogIndex();
     node_options.election_timeout_ms = config_.ha_election_timeout_ms;
     node_options.fsm = this;
     node_options.node_owns_fsm = false;
@@ -99,6 +111,10 @@ void lgraph::HaStateMachine::Start() {
     node_options.snapshot_uri = prefix + "/snapshot";
     node_options.disable_cli = false;
     node_options.witness = config_.ha_is_witness;
+    // skip the snapshot chunks with the same checksum as a local one, which lets an
+    // interrupted install resume; the last local snapshot seldom matches, its pages are laid
+    // out by this node rather than by the leader
+    node_options.filter_before_copy_remote = config_.ha_snapshot_chunk_size_mb > 0;
     int r = node->init(node_options);
     if (r != 0) {
         ::lgraph::StateMachine::Stop();
@@ -150,6 +166,8 @@ void lgraph::HaStateMachine::Stop() {
     if (node_) {
         node_->shutdown(nullptr);
         node_->join();
+        // the requests still queued fail to replicate now that the node is down
+        kv_delta_writer_.reset();
         delete node_;
         node_ = nullptr;
     }
@@ -163,6 +181,8 @@ bool lgraph::HaStateMachine::DoRequest(bool is_write, const LGraphRequest* req,
     brpc::ClosureGuard done_guard(on_done);
     if (req->Req_case() == LGraphRequest::kHaRequest) {
         return ApplyHaRequest(req, resp);
+    } else if (req->Req_case() == LGraphRequest::kKvDeltaRequest) {
+        return RespondBadInput(resp, "Kv delta can only be replicated by the master.");
     } else {
         if (is_write && !IsCurrentMaster()) return RespondRedirect(resp, master_rpc_addr_);
 #if LGRAPH_SHARE_DIR
@@ -174,8 +194,28 @@ bool lgraph::HaStateMachine::DoRequest(bool is_write, const LGraphRequest* req,
             // will fail and thus has no effect.
             std::string user = galaxy_->ParseAndValidateToken(req->token());
             (const_cast<LGraphRequest*>(req))->set_user(user);
+            if (kv_delta_writer_) {
+                auto* done = done_guard.release();
+                kv_delta_writer_->PushTask(0, kv_delta_seq_++, [this, req, resp, done]() {
+                    brpc::ClosureGuard done_guard(done);
+                    try {
+                        ApplyAndReplicateKvDelta(req, resp);
+                    } catch (std::exception& e) {
+                        RespondException(resp, e.what());
+                    }
+                });
+                return true;
+            }
             return ReplicateAndApplyRequest(req, resp, done_guard.release());
         } else {
+            if (req->has_max_staleness_ms()) {
+                std::string error = WaitForConsistentRead(req->max_staleness_ms());
+                if (!error.empty()) {
+                    if (IsLeader() || master_rpc_addr_.empty())
+                        return RespondException(resp, error);
+                    return RespondRedirect(resp, master_rpc_addr_, error);
+                }
+            }
             return ApplyRequestDirectly(req, resp);
         }
 #endif
@@ -244,6 +284,178 @@ bool lgraph::HaStateMachine::ReplicateAndApplyRequest(const LGraphRequest* req,
     return true;
 }
 
+bool lgraph::HaStateMachine::ReplicateAndWaitRequest(const LGraphRequest* req,
+                                                     LGraphResponse* resp) {
+    braft::SynchronizedClosure applied;
+    bool r = ReplicateAndApplyRequest(req, resp, &applied);
+    applied.wait();
+    return r;
+}
+
+bool lgraph::HaStateMachine::ApplyAndReplicateKvDelta(const LGraphRequest* req,
+                                                      LGraphResponse* resp) {
+    std::string graph;
+    if (req->Req_case() == LGraphRequest::kGraphQueryRequest) {
+        graph = req->graph_query_request().graph();
+    } else if (req->Req_case() == LGraphRequest::kPluginRequest &&
+               req->plugin_request().has_call_plugin_request()) {
+        graph = req->plugin_request().graph();
+    }
+    // other writes, such as schema changes or user management, are rare and change
+    // in-memory states as well, so they are always re-executed on the followers
+    if (graph.empty()) return ReplicateAndWaitRequest(req, resp);
+
+    size_t n_replicated = 0;
+    int64_t uncommitted_index = -1;  // a delta replicated, but not committed here yet
+    bool fall_back = false;
+    std::string error;  // why a write of this request was refused, all later ones are refused too
+    auto refuse = [&](const std::string& reason) {
+        if (error.empty()) {
+            error = reason;
+            fall_back = (n_replicated == 0);
+        }
+        THROW_CODE(InternalError, "Write can not be replicated: " + error);
+    };
+    {
+        KvWriteSetRecorder recorder(
+            [&](KvWriteSet& write_set) {
+                if (!error.empty()) refuse(error);
+                std::string reason = CheckKvDelta(graph, write_set);
+                if (!reason.empty()) refuse(reason);
+                if (write_set.Empty()) return;
+                try {
+                    uncommitted_index = ReplicateKvDelta(graph, write_set);
+                } catch (std::exception& e) {
+                    error = e.what();
+                    throw;
+                }
+                n_replicated++;
+            },
+            [&](const std::string& reason) { refuse(reason); },
+            [&](bool success) {
+                if (uncommitted_index < 0) return;
+                FinishKvDeltaCommit(uncommitted_index, success);
+                uncommitted_index = -1;
+            });
+        _HoldReadLock(galaxy_->GetReloadLock());
+        ApplyRequestDirectly(req, resp);
+    }
+    // on_apply is blocked until it knows, it is not expected to get here with a delta pending
+    if (uncommitted_index >= 0) FinishKvDeltaCommit(uncommitted_index, false);
+    if (fall_back) {
+        // nothing was written, so the request can be re-executed on all the nodes instead
+        LOG_DEBUG() << "Replicating request instead of its kv writes: " << error;
+        resp->Clear();
+        return ReplicateAndWaitRequest(req, resp);
+    }
+    if (!error.empty()) {
+        // the txns committed before are kept, just like a plugin that fails half way
+        return RespondException(resp, "Write can not be replicated: " + error);
+    }
+    return true;
+}
+
+std::string lgraph::HaStateMachine::CheckKvDelta(const std::string& graph,
+                                                 const KvWriteSet& write_set) {
+    if (!write_set.IsReplicable()) return write_set.UnreplicableReason();
+    {
+        AutoReadLock l(galaxy_->graphs_lock_, GetMyThreadId());
+        auto gref = galaxy_->graphs_->GetGraphRef(graph);
+        if (write_set.GetStore() != &gref->GetStore()) return "write to another graph";
+    }
+    // these tables are cached in memory, which a delta does not update
+    static const std::unordered_set<std::string> meta_tables = {
+        _detail::V_SCHEMA_TABLE,     _detail::E_SCHEMA_TABLE,
+        _detail::INDEX_TABLE,        _detail::PARTIAL_INDEX_TABLE,
+        _detail::CPP_PLUGIN_TABLE,   _detail::PYTHON_PLUGIN_TABLE,
+        _detail::USER_TABLE_NAME,    _detail::ROLE_TABLE_NAME,
+        _detail::GRAPH_CONFIG_TABLE_NAME, _detail::IP_WHITELIST_TABLE};
+    for (auto& op : write_set.GetOps()) {
+        if (meta_tables.count(op.table)) return "table " + op.table + " written";
+    }
+    return std::string();
+}
+
+int64_t lgraph::HaStateMachine::ReplicateKvDelta(const std::string& graph,
+                                                 const KvWriteSet& write_set) {
+    LGraphRequest req;
+    auto* delta = req.mutable_kv_delta_request();
+    delta->set_graph(graph);
+    delta->mutable_ops()->Reserve(write_set.GetOps().size());
+    for (auto& op : write_set.GetOps()) {
+        auto* dop = delta->add_ops();
+        dop->set_table(op.table);
+        dop->set_key(op.key);
+        if (!op.is_delete) dop->set_value(op.value);
+    }
+    butil::IOBuf log;
+    butil::IOBufAsZeroCopyOutputStream wrapper(&log);
+    if (!req.SerializeToZeroCopyStream(&wrapper))
+        THROW_CODE(InternalError, "Failed to serialize kv delta.");
+    KvDeltaClosure committed;
+    braft::Task task;
+    task.data = &log;
+    task.expected_term = leader_term_.load(std::memory_order_acquire);
+    task.done = &committed;
+    node_->apply(task);
+    committed.wait();
+    if (!committed.status().ok()) {
+        // the delta may still be committed later, then this node applies it as a follower
+        THROW_CODE(InternalError, "Failed to replicate kv delta: " +
+                                      std::string(committed.status().error_cstr()));
+    }
+    // the txn commits right after this, recording the log index with its writes
+    galaxy_->SetRaftLogIndexBeforeWrite(committed.index);
+    return committed.index;
+}
+
+void lgraph::HaStateMachine::FinishKvDeltaCommit(int64_t index, bool success) {
+    std::lock_guard<bthread::Mutex> l(kv_delta_commit_mutex_);
+    kv_delta_committed_index_ = index;
+    kv_delta_commit_ok_ = success;
+    kv_delta_commit_cond_.notify_all();
+}
+
+bool lgraph::HaStateMachine::WaitKvDeltaCommit(int64_t index) {
+    std::unique_lock<bthread::Mutex> l(kv_delta_commit_mutex_);
+    while (kv_delta_committed_index_ < index) kv_delta_commit_cond_.wait(l);
+    return kv_delta_committed_index_ == index && kv_delta_commit_ok_;
+}
+
+void lgraph::HaStateMachine::ApplyKvDelta(const KvDeltaRequest& delta, int64_t index) {
+    AutoReadLock l(galaxy_->graphs_lock_, GetMyThreadId());
+    auto gref = galaxy_->graphs_->GetGraphRef(delta.graph());
+    KvStore* store = &gref->GetStore();
+    auto& cache = kv_delta_tables_[delta.graph()];
+    if (cache.open_id != gref->GetOpenId()) {
+        // the graph was reopened, or dropped and created again, since the tables were opened
+        cache.tables.clear();
+        cache.open_id = gref->GetOpenId();
+    }
+    try {
+        auto txn = store->CreateWriteTxn(false);
+        for (auto& op : delta.ops()) {
+            // the comparators of existing tables are already set when the graph is opened,
+            // reopening them keeps those and lets a compaction of this node go on
+            auto& table = cache.tables[op.table()];
+            if (!table)
+                table = store->OpenTable(*txn, op.table(), false,
+                                         ComparatorDesc::DefaultComparator());
+            if (op.has_value()) {
+                table->SetValue(*txn, Value::ConstRef(op.key()), Value::ConstRef(op.value()));
+            } else {
+                table->DeleteKey(*txn, Value::ConstRef(op.key()));
+            }
+        }
+        galaxy_->SetRaftLogIndexBeforeWrite(index);
+        txn->Commit();
+    } catch (...) {
+        // tables opened in an aborted txn are closed
+        cache.tables.clear();
+        throw;
+    }
+}
+
 void* lgraph::HaStateMachine::save_snapshot(void* arg) {
     auto* sa = (SnapshotArg*) arg;
     std::unique_ptr<SnapshotArg> arg_guard(sa);
@@ -251,14 +463,28 @@ void* lgraph::HaStateMachine::save_snapshot(void* arg) {
     std::string path = sa->writer->get_path() + "/_snapshot_";
     try {
         LOG_DEBUG() << "Saving snapshot to " << path;
-        _HoldReadLock(sa->haStateMachine->galaxy_->GetReloadLock());
-        // bthread_usleep(30 * 1000000);
-        auto files = sa->haStateMachine->galaxy_->SaveSnapshot(path);
+        size_t chunk_size = (size_t)sa->haStateMachine->config_.ha_snapshot_chunk_size_mb << 20;
+        std::vector<std::string> files;
+        {
+            _HoldReadLock(sa->haStateMachine->galaxy_->GetReloadLock());
+            // chunks are compared by offset, so pages must not be moved by compaction
+            files = sa->haStateMachine->galaxy_->SaveSnapshot(path, chunk_size == 0);
+        }
         LOG_DEBUG() << "Snapshot files: " << fma_common::ToString(files);
-        for (auto& f : files) {
-            // normalize file path
-            auto pos = f.find("_snapshot_");
-            if (sa->writer->add_file(f.substr(pos)) != 0) {
+        std::vector<ha_snapshot::SnapshotFile> snapshot_files;
+        if (chunk_size > 0) {
+            snapshot_files =
+                ha_snapshot::SplitIntoChunks(sa->writer->get_path(), files, chunk_size);
+        } else {
+            for (auto& f : files) {
+                // normalize file path
+                snapshot_files.push_back({f.substr(f.find("_snapshot_")), std::string()});
+            }
+        }
+        for (auto& f : snapshot_files) {
+            braft::LocalFileMeta meta;
+            if (!f.checksum.empty()) meta.set_checksum(f.checksum);
+            if (sa->writer->add_file(f.name, &meta) != 0) {
                 sa->done->status().set_error(EIO, "Fail to add file to writer");
                 return NULL;
             }
@@ -311,7 +537,11 @@ int lgraph::HaStateMachine::on_snapshot_load(braft::SnapshotReader* reader) {
         std::vector<std::string> files;
         reader->list_files(&files);
         LOG_DEBUG() << "Snapshot files: " << fma_common::ToString(files);
-        galaxy_->LoadSnapshot(snapshot_path);
+        kv_delta_tables_.clear();
+        // chunks are decompressed straight into the db dir, leaving the snapshot as it is, so
+        // that the next install can reuse its chunks
+        galaxy_->LoadSnapshot(snapshot_path, ha_snapshot::RestoreSnapshot);
+        MarkApplied(meta.last_included_index());
         LOG_DEBUG() << "Successfully loaded snapshot";
     } catch (std::exception& e) {
         LOG_FATAL() << "Failed to load snapshot from " << snapshot_path << ": "
@@ -329,6 +559,7 @@ void lgraph::HaStateMachine::on_apply(braft::Iterator& iter) {
         if (config_.ha_is_witness) {
             LOG_DEBUG() << "addr " << node_->node_id().to_string()
                                     << " skip witness apply " << iter.index();
+            MarkApplied(iter.index());
             continue;
         }
         braft::AsyncClosureGuard closure_guard(iter.done());
@@ -336,6 +567,21 @@ void lgraph::HaStateMachine::on_apply(braft::Iterator& iter) {
         bool need_delete_req_resp = false;
         LGraphResponse* resp = nullptr;
         if (iter.done()) {
+            auto* kc = dynamic_cast<KvDeltaClosure*>(iter.done());
+            if (kc) {
+                // wake up the txn waiting for this delta, which commits it, and wait for that
+                // commit: the delta must not count as applied, e.g. in a snapshot, before it
+                kc->index = iter.index();
+                closure_guard.release()->Run();
+                if (!WaitKvDeltaCommit(iter.index())) {
+                    // the followers have the delta and this node does not, it must not go on
+                    LOG_ERROR() << "Failed to commit kv delta " << iter.index() << " locally";
+                    iter.set_error_and_rollback();
+                    return;
+                }
+                MarkApplied(iter.index());
+                continue;
+            }
             // This task is applied by this node, get value from this
             // closure to avoid additional parsing.
             auto* c = dynamic_cast<ReqRespClosure*>(iter.done());
@@ -366,7 +612,22 @@ void lgraph::HaStateMachine::on_apply(braft::Iterator& iter) {
         }
 
         bool should_apply = (iter.index() > committed_index);
-        if (should_apply) {
+        if (should_apply && req->Req_case() == LGraphRequest::kKvDeltaRequest) {
+            try {
+                ApplyKvDelta(req->kv_delta_request(), iter.index());
+            } catch (std::exception& e) {
+                // skipping the delta would leave this node diverged from the others
+                LOG_ERROR() << "Failed to apply kv delta " << iter.index() << ": " << e.what();
+                iter.set_error_and_rollback();
+                if (need_delete_req_resp) {
+                    delete req;
+                    delete resp;
+                }
+                return;
+            }
+        } else if (should_apply) {
+            // the request may have dropped or reloaded the tables opened for deltas
+            kv_delta_tables_.clear();
             ApplyRequestDirectly(req, resp);
             galaxy_->SetRaftLogIndexBeforeWrite(iter.index());
         } else {
@@ -378,9 +639,85 @@ void lgraph::HaStateMachine::on_apply(braft::Iterator& iter) {
             delete req;
             delete resp;
         }
+        // marked before closure_guard runs the closure, so a read that follows the
+        // acknowledged write sees it
+        MarkApplied(iter.index());
     }
 }
 
+void lgraph::HaStateMachine::MarkApplied(int64_t index) {
+    std::lock_guard<bthread::Mutex> l(applied_mutex_);
+    if (index <= applied_index_) return;
+    applied_index_ = index;
+    applied_cond_.notify_all();
+}
+
+std::string lgraph::HaStateMachine::WaitForConsistentRead(int64_t max_staleness_ms) {
+    if (max_staleness_ms < 0) return std::string();
+    if (IsLeader()) {
+        // writes are acknowledged after they are applied here, but only while the lease is
+        // valid is this node sure that no newer master acknowledged writes it does not have
+        if (!node_->is_leader_lease_valid())
+            return "Master lease is not valid, the read may be stale. Please retry later.";
+        return std::string();
+    }
+    int64_t index = -1;
+    double now = fma_common::GetTime();
+    if (max_staleness_ms > 0) {
+        std::lock_guard<std::mutex> l(leader_applied_mutex_);
+        if (leader_applied_index_ >= 0 &&
+            (now - leader_applied_time_) * 1000 <= (double)max_staleness_ms) {
+            index = leader_applied_index_;
+        }
+    }
+    if (index < 0) index = GetLeaderAppliedIndex();
+    if (index < 0) return "Failed to get the applied index of master.";
+    // wait no longer than an election, after which the master may have changed
+    int64_t deadline_us = butil::gettimeofday_us() + config_.ha_election_timeout_ms * 1000;
+    std::unique_lock<bthread::Mutex> l(applied_mutex_);
+    while (applied_index_ < index) {
+        int64_t left_us = deadline_us - butil::gettimeofday_us();
+        if (left_us <= 0 || applied_cond_.wait_for(l, left_us) == ETIMEDOUT) {
+            if (applied_index_ >= index) break;
+            return FMA_FMT("Timeout waiting for log {} to be applied, applied index={}", index,
+                           applied_index_.load());
+        }
+    }
+    return std::string();
+}
+
+int64_t lgraph::HaStateMachine::GetLeaderAppliedIndex() {
+    braft::PeerId leader = node_->leader_id();
+    if (leader.is_empty()) return -1;
+    brpc::Channel channel;
+    if (channel.Init(leader.addr, nullptr) != 0) return -1;
+    LGraphRPCService_Stub stub(&channel);
+    LGraphRequest req;
+    req.set_token("");
+    req.set_is_write_op(false);
+    req.mutable_ha_request()->mutable_read_index_request();
+    LGraphResponse resp;
+    brpc::Controller controller;
+    controller.set_timeout_ms(config_.ha_election_timeout_ms);
+    double asked_at = fma_common::GetTime();
+    stub.HandleRequest(&controller, &req, &resp, nullptr);
+    if (controller.Failed() || resp.error_code() != LGraphResponse::SUCCESS) {
+        LOG_DEBUG() << "Failed to get read index from master: "
+                    << (controller.Failed() ? controller.ErrorText() : resp.error());
+        return -1;
+    }
+    int64_t index = resp.ha_response().read_index_response().applied_index();
+    UpdateLeaderAppliedIndex(index, asked_at);
+    return index;
+}
+
+void lgraph::HaStateMachine::UpdateLeaderAppliedIndex(int64_t index, double asked_at) {
+    std::lock_guard<std::mutex> l(leader_applied_mutex_);
+    if (asked_at <= leader_applied_time_) return;
+    leader_applied_index_ = index;
+    leader_applied_time_ = asked_at;
+}
+
 bool lgraph::HaStateMachine::ApplyHaRequest(const LGraphRequest* req, LGraphResponse* resp) {
     FMA_DBG_ASSERT(req->Req_case() == LGraphRequest::kHaRequest);
     std::lock_guard<std::mutex> l(hb_mutex_);
@@ -406,6 +743,8 @@ bool lgraph::HaStateMachine::ApplyHaRequest(const LGraphRequest* req, LGraphResp
                 it->second.role = hbreq.role();
                 it->second.last_heartbeat = fma_common::GetTime();
                 if (it->second.rest_addr.empty()) it->second.rest_addr = hbreq.rest_addr();
+                auto* hbresp = resp->mutable_ha_response()->mutable_heartbeat_response();
+                if (node_->is_leader_lease_valid()) hbresp->set_applied_index(applied_index_);
                 return RespondSuccess(resp);
             }
         case HARequest::kGetMasterRequest:
@@ -443,6 +782,19 @@ bool lgraph::HaStateMachine::ApplyHaRequest(const LGraphRequest* req, LGraphResp
                 }
                 return RespondSuccess(resp);
             }
+        case HARequest::kReadIndexRequest:
+            {
+                if (!node_->is_leader()) {
+                    return RespondRedirect(resp, master_rpc_addr_);
+                }
+                // a deposed master may not know it yet, unless its lease is still valid
+                if (!node_->is_leader_lease_valid()) {
+                    return RespondException(resp, "Master lease is not valid.");
+                }
+                resp->mutable_ha_response()->mutable_read_index_response()->set_applied_index(
+                    applied_index_);
+                return RespondSuccess(resp);
+            }
         case HARequest::kSyncMetaRequest:
             {
                 if (!node_->is_leader()) {
@@ -625,11 +977,14 @@ void lgraph::HaStateMachine::SendHeartbeatToMasterLocked() {
     brpc::Controller controller;
     controller.set_timeout_ms(1000);
     controller.set_max_retry(3);
+    double sent_at = fma_common::GetTime();
     rpc_stub_->HandleRequest(&controller, &req, &resp, nullptr);
     if (controller.Failed() || resp.error_code() != LGraphResponse::SUCCESS) {
         LOG_WARN() << "Failed to send heartbeat: " << resp.error();
         return;
     }
+    auto& hbresp = resp.ha_response().heartbeat_response();
+    if (hbresp.has_applied_index()) UpdateLeaderAppliedIndex(hbresp.applied_index(), sent_at);
 }
 
 void lgraph::HaStateMachine::LeaveGroup() {
@@ -2,15 +2,21 @@
 
 #pragma once
 #include <chrono>
+#include <map>
 #include "tools/lgraph_log.h"
 #include "core/global_config.h"
 #include "server/state_machine.h"
 
 #ifndef _WIN32
 #include "braft/raft.h"
+#include "braft/util.h"
 #include "brpc/closure_guard.h"
 #include "brpc/server.h"
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
 
+#include "fma-common/thread_pool.h"
+#include "core/kv_write_set.h"
 #include "core/lightning_graph.h"
 #include "protobuf/ha.pb.h"
 
@@ -31,6 +37,8 @@ class HaStateMachine : public StateMachine, public braft::StateMachine {
         bool ha_is_witness;
         bool ha_enable_witness_to_leader;
         std::string ha_first_snapshot_start_time = "";
+        bool ha_physical_replication = false;
+        int ha_snapshot_chunk_size_mb = 64;
 
         Config() {}
         explicit Config(const GlobalConfig& c) : ::lgraph::StateMachine::Config(c) {
@@ -46,6 +54,8 @@ class HaStateMachine : public StateMachine, public braft::StateMachine {
             ha_is_witness = c.ha_is_witness;
             ha_enable_witness_to_leader = c.ha_enable_witness_to_leader;
             ha_first_snapshot_start_time = c.ha_first_snapshot_start_time;
+            ha_physical_replication = c.ha_physical_replication;
+            ha_snapshot_chunk_size_mb = c.ha_snapshot_chunk_size_mb;
         }
     };
 
@@ -77,6 +87,35 @@ class HaStateMachine : public StateMachine, public braft::StateMachine {
 
     std::thread heartbeat_thread_;
 
+    // In physical replication mode, the leader applies all the write requests on this single
+    // thread: the deltas are then replicated in commit order, and the write set recorder, which
+    // is thread local, stays with the request while it waits for its deltas to be committed.
+    std::unique_ptr<fma_common::ThreadPool> kv_delta_writer_;
+    std::atomic<uint64_t> kv_delta_seq_{0};
+    // last log index applied by on_apply, and a cv to wait for it to advance
+    std::atomic<int64_t> applied_index_{-1};
+    bthread::Mutex applied_mutex_;
+    bthread::ConditionVariable applied_cond_;
+    // on a follower: the applied index of the master, and when it was asked for it
+    std::mutex leader_applied_mutex_;
+    int64_t leader_applied_index_ = -1;
+    double leader_applied_time_ = 0;
+
+    // on the leader: the last delta proposed by this node whose local commit has finished,
+    // on_apply waits for it before the delta counts as applied
+    bthread::Mutex kv_delta_commit_mutex_;
+    bthread::ConditionVariable kv_delta_commit_cond_;
+    int64_t kv_delta_committed_index_ = -1;
+    bool kv_delta_commit_ok_ = false;
+
+    // tables opened by ApplyKvDelta, by graph name, only accessed by the braft fsm thread. The
+    // tables of a graph are dropped once it has been reopened, which changes its open id.
+    struct KvDeltaTables {
+        uint64_t open_id = 0;
+        std::map<std::string, std::unique_ptr<KvTable>> tables;
+    };
+    std::map<std::string, KvDeltaTables> kv_delta_tables_;
+
  public:
     HaStateMachine(const Config& config, const std::shared_ptr<GlobalConfig>& global_config)
         : ::lgraph::StateMachine(config, global_config),
@@ -180,6 +219,13 @@ class HaStateMachine : public StateMachine, public braft::StateMachine {
         google::protobuf::Closure* done_;
     };
 
+    // Closure of a KvDeltaRequest proposed by this node. The txn that made the delta waits on
+    // it and commits locally once the delta is committed, so on_apply does not apply it again,
+    // it waits for that local commit instead.
+    struct KvDeltaClosure : public braft::SynchronizedClosure {
+        int64_t index = -1;
+    };
+
     struct SnapshotArg {
         braft::SnapshotWriter* writer;
         braft::Closure* done;
@@ -191,6 +237,41 @@ class HaStateMachine : public StateMachine, public braft::StateMachine {
     bool ReplicateAndApplyRequest(const LGraphRequest* req, LGraphResponse* resp,
                                   google::protobuf::Closure* on_done);
 
+    // Same as ReplicateAndApplyRequest, but returns once the request is applied.
+    bool ReplicateAndWaitRequest(const LGraphRequest* req, LGraphResponse* resp);
+
+    // Applies a write request on the leader and replicates the kv writes of each of its txns
+    // right before the txn commits. Requests whose writes can not be replicated this way are
+    // replicated with ReplicateAndWaitRequest instead. Runs on kv_delta_writer_.
+    bool ApplyAndReplicateKvDelta(const LGraphRequest* req, LGraphResponse* resp);
+
+    // Returns why write_set of graph can not be replicated as a delta, or an empty string.
+    std::string CheckKvDelta(const std::string& graph, const KvWriteSet& write_set);
+
+    // Replicates a write set of graph, and waits until it is committed. Returns its log index,
+    // the caller must then report the local commit with FinishKvDeltaCommit.
+    int64_t ReplicateKvDelta(const std::string& graph, const KvWriteSet& write_set);
+
+    // Reports that the local commit of the delta at index is done, successfully or not.
+    void FinishKvDeltaCommit(int64_t index, bool success);
+
+    // Waits until the local commit of the delta at index is done, returns whether it succeeded.
+    bool WaitKvDeltaCommit(int64_t index);
+
+    // Applies a KvDeltaRequest replicated by the leader.
+    void ApplyKvDelta(const KvDeltaRequest& delta, int64_t index);
+
+    void MarkApplied(int64_t index);
+
+    // Waits until this node can serve a read with the given max_staleness_ms. Returns an
+    // error message if it can not.
+    std::string WaitForConsistentRead(int64_t max_staleness_ms);
+
+    // Asks the master for its applied index. Returns -1 on failure.
+    int64_t GetLeaderAppliedIndex();
+
+    void UpdateLeaderAppliedIndex(int64_t index, double asked_at);
+
     // apply a HA request, specifically Heartbeat request
     bool ApplyHaRequest(const LGraphRequest* req, LGraphResponse* resp);
 
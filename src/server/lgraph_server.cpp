@@ -341,6 +341,7 @@ int LGraphServer::Start() {
                 rc.tick_interval = config_->bolt_raft_tick_interval;
                 rc.heartbeat_tick = config_->bolt_raft_heartbeat_tick;
                 rc.election_tick = config_->bolt_raft_election_tick;
+                rc.apply_batch_size = config_->bolt_raft_apply_batch_size;
                 if (!rc.Check()) {
                     return -1;
                 }
@@ -0,0 +1,213 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "gtest/gtest.h"
+#include "fma-common/utils.h"
+#include "core/column_store.h"
+#include "core/lightning_graph.h"
+#include "./ut_utils.h"
+using namespace lgraph;
+using namespace fma_common;
+
+class TestColumnStore : public TuGraphTest {};
+
+TEST_F(TestColumnStore, ColumnBlock) {
+    // integers are bit-packed from the minimum, nulls are skipped
+    {
+        ColumnBlock b(FieldType::INT64);
+        for (size_t i = 0; i < ColumnBlock::SIZE; i += 3) {
+            b.Set(i, Value::ConstRef((int64_t)(1000000 + i)));
+        }
+        b.SetNull(3);
+        ColumnBlock d(FieldType::INT64);
+        d.Decode(b.Encode());
+        UT_EXPECT_EQ(d.GetFieldData(0), FieldData::Int64(1000000));
+        UT_EXPECT_TRUE(d.IsNull(1));
+        UT_EXPECT_TRUE(d.IsNull(3));
+        UT_EXPECT_EQ(d.GetFieldData(6), FieldData::Int64(1000006));
+        UT_EXPECT_EQ(d.Get(1023).AsType<int64_t>(), 1001023);
+        // 1024 slots, 341 values of 10 bits
+        UT_EXPECT_LT(b.Encode().Size(), 128 + 16 + 341 * 2);
+    }
+    // strings with few distinct values use a dictionary
+    {
+        ColumnBlock b(FieldType::STRING);
+        for (size_t i = 0; i < ColumnBlock::SIZE; i++) {
+            b.Set(i, Value::ConstRef(std::string("city_") + std::to_string(i % 4)));
+        }
+        b.SetNull(5);
+        Value v = b.Encode();
+        UT_EXPECT_EQ((uint8_t)v.Data()[0], (uint8_t)ColumnBlock::DICTIONARY);
+        ColumnBlock d(FieldType::STRING);
+        d.Decode(v);
+        UT_EXPECT_EQ(d.Get(6).AsString(), "city_2");
+        UT_EXPECT_TRUE(d.IsNull(5));
+        d.Clear();
+        UT_EXPECT_TRUE(d.Empty());
+    }
+    {
+        ColumnBlock b(FieldType::DOUBLE);
+        b.Set(7, Value::ConstRef(1.5));
+        ColumnBlock d(FieldType::DOUBLE);
+        d.Decode(b.Encode());
+        UT_EXPECT_EQ(d.GetFieldData(7), FieldData::Double(1.5));
+        ColumnStat stat;
+        d.AddToStat(stat);
+        UT_EXPECT_EQ(stat.count, 1);
+        UT_EXPECT_EQ(stat.sum, 1.5);
+    }
+}
+
+TEST_F(TestColumnStore, VertexColumn) {
+    AutoCleanDir cleaner("./testdb");
+    DBConfig config;
+    config.dir = "./testdb";
+    LightningGraph db(config);
+    db.DropAllData();
+    std::vector<FieldSpec> v_fds = {{"id", FieldType::INT64, false},
+                                    {"age", FieldType::INT32, false},
+                                    {"city", FieldType::STRING, true},
+                                    {"photo", FieldType::BLOB, true}};
+    UT_EXPECT_TRUE(db.AddLabel("person", v_fds, true, VertexOptions("id")));
+    std::vector<std::string> fields = {"id", "age", "city"};
+    Transaction txn = db.CreateWriteTxn();
+    // 3000 vertices span three blocks, a city every other vertex
+    for (int64_t i = 0; i < 3000; i++) {
+        FieldData city = i % 2 ? FieldData() : FieldData("city_" + std::to_string(i % 5));
+        txn.AddVertex(std::string("person"), fields,
+                      std::vector<FieldData>{FieldData(i), FieldData((int32_t)(i % 100)), city});
+    }
+    txn.Commit();
+    UT_EXPECT_TRUE(db.AddVertexColumn("person", "age"));
+    UT_EXPECT_TRUE(db.AddVertexColumn("person", "city"));
+    UT_EXPECT_TRUE(!db.AddVertexColumn("person", "age"));
+    UT_EXPECT_THROW_CODE(db.AddVertexColumn("person", "photo"), InputError);
+    txn = db.CreateReadTxn();
+    UT_EXPECT_EQ(txn.ListVertexColumns().size(), 2);
+    {
+        ColumnStat stat = txn.GetVertexColumnStore("person", "age")->GetStat(txn.GetTxn());
+        UT_EXPECT_EQ(stat.count, 3000);
+        UT_EXPECT_EQ(stat.n_blocks, 3);
+        UT_EXPECT_EQ(stat.sum, 30 * 4950);
+        UT_EXPECT_EQ(stat.min, FieldData::Int32(0));
+        UT_EXPECT_EQ(stat.max, FieldData::Int32(99));
+        stat = txn.GetVertexColumnStore("person", "city")->GetStat(txn.GetTxn());
+        UT_EXPECT_EQ(stat.count, 1500);
+        UT_EXPECT_EQ(stat.max, FieldData::String("city_4"));
+    }
+    txn.Abort();
+    // the columns are written with the vertices
+    txn = db.CreateWriteTxn();
+    txn.SetVertexProperty(10, std::vector<std::string>{"age", "city"},
+                          std::vector<FieldData>{FieldData::Int32(1000), FieldData()});
+    txn.DeleteVertex(20);
+    VertexId vid = txn.AddVertex(std::string("person"), fields,
+                                 std::vector<FieldData>{FieldData((int64_t)3000),
+                                                        FieldData((int32_t)-1),
+                                                        FieldData("city_9")});
+    txn.Commit();
+    txn = db.CreateReadTxn();
+    {
+        ColumnStore* ages = txn.GetVertexColumnStore("person", "age");
+        Value v;
+        UT_EXPECT_TRUE(ages->GetValue(txn.GetTxn(), 10, v));
+        UT_EXPECT_EQ(v.AsType<int32_t>(), 1000);
+        UT_EXPECT_TRUE(!ages->GetValue(txn.GetTxn(), 20, v));
+        UT_EXPECT_TRUE(ages->GetValue(txn.GetTxn(), vid, v));
+        UT_EXPECT_EQ(v.AsType<int32_t>(), -1);
+        std::vector<VertexId> vids;
+        txn.GetVertexColumnStore("person", "city")
+            ->Scan(txn.GetTxn(), 0, 30, [&](VertexId id, const Value&) {
+                vids.push_back(id);
+                return true;
+            });
+        // 10 is set to null, 20 is deleted
+        UT_EXPECT_EQ(vids.size(), 13);
+        ColumnStat stat = ages->GetStat(txn.GetTxn());
+        UT_EXPECT_EQ(stat.count, 3000);
+        UT_EXPECT_EQ(stat.min, FieldData::Int32(-1));
+        UT_EXPECT_EQ(stat.max, FieldData::Int32(1000));
+    }
+    txn.Abort();
+    UT_EXPECT_TRUE(db.DeleteVertexColumn("person", "city"));
+    UT_EXPECT_TRUE(!db.DeleteVertexColumn("person", "city"));
+    txn = db.CreateReadTxn();
+    UT_EXPECT_THROW_CODE(txn.GetVertexColumnStore("person", "city"), InputError);
+    UT_EXPECT_EQ(txn.ListVertexColumns().size(), 1);
+    txn.Abort();
+}
+
+TEST_F(TestColumnStore, WriteBuffer) {
+    AutoCleanDir cleaner("./testdb");
+    DBConfig config;
+    config.dir = "./testdb";
+    LightningGraph db(config);
+    db.DropAllData();
+    std::vector<FieldSpec> v_fds = {{"id", FieldType::INT64, false},
+                                    {"name", FieldType::STRING, true}};
+    UT_EXPECT_TRUE(db.AddLabel("person", v_fds, true, VertexOptions("id")));
+    UT_EXPECT_TRUE(db.AddVertexColumn("person", "name"));
+    std::vector<std::string> fields = {"id", "name"};
+    // the blocks are written when the txn commits
+    Transaction txn = db.CreateWriteTxn();
+    for (int64_t i = 0; i < 2000; i++) {
+        txn.AddVertex(std::string("person"), fields,
+                      std::vector<FieldData>{FieldData(i), FieldData("n" + std::to_string(i))});
+    }
+    txn.SetVertexProperty(5, std::vector<std::string>{"name"},
+                          std::vector<FieldData>{FieldData("five")});
+    txn.SetVertexProperty(6, std::vector<std::string>{"name"}, std::vector<FieldData>{FieldData()});
+    txn.Commit();
+    txn = db.CreateReadTxn();
+    {
+        ColumnStore* names = txn.GetVertexColumnStore("person", "name");
+        ColumnStat stat = names->GetStat(txn.GetTxn());
+        UT_EXPECT_EQ(stat.count, 1999);
+        UT_EXPECT_EQ(stat.n_blocks, 2);
+        Value v;
+        UT_EXPECT_TRUE(names->GetValue(txn.GetTxn(), 5, v));
+        UT_EXPECT_EQ(v.AsString(), "five");
+        UT_EXPECT_TRUE(!names->GetValue(txn.GetTxn(), 6, v));
+        UT_EXPECT_TRUE(names->GetValue(txn.GetTxn(), 1999, v));
+        UT_EXPECT_EQ(v.AsString(), "n1999");
+    }
+    txn.Abort();
+    // a txn reading the column sees its own writes, an aborted txn writes nothing
+    txn = db.CreateWriteTxn();
+    txn.SetVertexProperty(7, std::vector<std::string>{"name"},
+                          std::vector<FieldData>{FieldData("seven")});
+    txn.DeleteVertex(8);
+    {
+        ColumnStore* names = txn.GetVertexColumnStore("person", "name");
+        Value v;
+        UT_EXPECT_TRUE(names->GetValue(txn.GetTxn(), 7, v));
+        UT_EXPECT_EQ(v.AsString(), "seven");
+        UT_EXPECT_TRUE(!names->GetValue(txn.GetTxn(), 8, v));
+    }
+    txn.SetVertexProperty(9, std::vector<std::string>{"name"},
+                          std::vector<FieldData>{FieldData("nine")});
+    txn.Abort();
+    txn = db.CreateReadTxn();
+    {
+        ColumnStore* names = txn.GetVertexColumnStore("person", "name");
+        Value v;
+        UT_EXPECT_TRUE(names->GetValue(txn.GetTxn(), 7, v));
+        UT_EXPECT_EQ(v.AsString(), "n7");
+        UT_EXPECT_TRUE(names->GetValue(txn.GetTxn(), 8, v));
+        UT_EXPECT_TRUE(names->GetValue(txn.GetTxn(), 9, v));
+        UT_EXPECT_EQ(v.AsString(), "n9");
+        UT_EXPECT_EQ(names->GetStat(txn.GetTxn()).count, 1999);
+    }
+    txn.Abort();
+}
@@ -53,8 +53,8 @@ static const cypher::PARAM_TAB g_param_tab = {
                        lgraph::FieldData("Roy Redgrave")})},
 };
 
-void eval_query_check(cypher::RTContext *ctx, const std::string &query,
-                      const std::string &expect_plan, const int expect_res) {
+// builds and executes the plan of a query, returns the plan dump, or an empty string on failure
+std::string eval_query(cypher::RTContext *ctx, const std::string &query) {
     UT_LOG() << query;
     ANTLRInputStream input(query);
     LcypherLexer lexer(&input);
@@ -80,7 +80,7 @@ void eval_query_check(cypher::RTContext *ctx, const std::string &query,
         UT_LOG() << "dumper.handle(node) gql: " << query;
         UT_LOG() << "dumper.handle(node) ret: " << ToString(ret);
         UT_LOG() << "dumper.handle(node) error_msg: " << dumper.error_msg();
-        return;
+        return "";
     } else {
         UT_DBG() << "--- dumper.handle(node) dump ---";
         UT_DBG() << dumper.dump();
@@ -90,7 +90,7 @@ void eval_query_check(cypher::RTContext *ctx, const std::string &query,
     ret = execution_plan.Build(node, ctx);
     if (ret != geax::frontend::GEAXErrorCode::GEAX_SUCCEED) {
         UT_LOG() << "build execution_plan_v2 failed: " << execution_plan.ErrorMsg();
-        return;
+        return "";
     }
     execution_plan.DumpGraph();
     std::string res_plan = execution_plan.DumpPlan(0, false);
@@ -102,7 +102,13 @@ void eval_query_check(cypher::RTContext *ctx, const std::string &query,
     UT_LOG() << "Plan Execute Time " << t2 - t1 << "s";
     UT_LOG() << t2 - t0 << " " << t2 - t1;
     UT_LOG() << "Result:\n" << ctx->result_->Dump();
+    return res_plan;
+}
 
+void eval_query_check(cypher::RTContext *ctx, const std::string &query,
+                      const std::string &expect_plan, const int expect_res) {
+    std::string res_plan = eval_query(ctx, query);
+    if (res_plan.empty()) return;
     UT_EXPECT_EQ(ctx->result_->Size(), expect_res);
     UT_EXPECT_EQ(res_plan, expect_plan);
 }
@@ -158,3 +164,69 @@ TEST_F(TestCypherPlan, CypherPlan) {
     ifs >> conf;
     test_cypher_plan(conf);
 }
+
+TEST_F(TestCypherPlan, CostModelStartNode) {
+    std::string dir = "./testdb";
+    fma_common::FileSystem::GetFileSystem(dir).RemoveDir(dir);
+    int64_t small_vid = -1;
+    {
+        lgraph_api::Galaxy galaxy(dir, lgraph::_detail::DEFAULT_ADMIN_NAME,
+                                  lgraph::_detail::DEFAULT_ADMIN_PASS, false, true);
+        lgraph_api::GraphDB db = galaxy.OpenGraph("default");
+        std::vector<lgraph::FieldSpec> fds = {{"id", lgraph::FieldType::INT64, false},
+                                              {"grp", lgraph::FieldType::INT64, false}};
+        UT_ASSERT(db.AddVertexLabel("Big", fds, lgraph::VertexOptions("id")));
+        UT_ASSERT(db.AddVertexLabel("Small", fds, lgraph::VertexOptions("id")));
+        UT_ASSERT(db.AddEdgeLabel("R", std::vector<lgraph::FieldSpec>{}, {}));
+        auto txn = db.CreateWriteTxn();
+        small_vid = txn.AddVertex("Small", std::vector<std::string>{"id", "grp"},
+                                  std::vector<std::string>{"0", "0"});
+        txn.Commit();
+    }
+    lgraph::Galaxy::Config gconf;
+    gconf.dir = dir;
+    lgraph::Galaxy galaxy(gconf, true, nullptr);
+    cypher::RTContext ctx(nullptr, &galaxy, lgraph::_detail::DEFAULT_ADMIN_NAME, "default");
+    // the heuristics start from the first labeled node, b
+    const std::string query = "MATCH (b:Big)-[:R]->(s:Small) RETURN b.id, s.id";
+    std::string plan = eval_query(&ctx, query);
+    UT_EXPECT_NE(plan.find("Node By Label Scan [b:Big]"), std::string::npos);
+    UT_EXPECT_EQ(ctx.result_->Size(), 0);
+
+    // with many Big vertices and few R edges, starting from s is much cheaper. The data
+    // changes, so the cached statistics of the empty graph must not be reused.
+    {
+        auto ac_db = galaxy.OpenGraph(lgraph::_detail::DEFAULT_ADMIN_NAME, "default");
+        lgraph_api::GraphDB db(&ac_db, false);
+        auto txn = db.CreateWriteTxn();
+        for (int64_t i = 0; i < 20000; i++) {
+            auto vid = txn.AddVertex(
+                "Big", std::vector<std::string>{"id", "grp"},
+                std::vector<std::string>{std::to_string(i), std::to_string(i % 10)});
+            if (i % 2000 == 0) {
+                txn.AddEdge(vid, small_vid, "R", std::vector<std::string>{},
+                            std::vector<std::string>{});
+            }
+        }
+        txn.Commit();
+    }
+    plan = eval_query(&ctx, query);
+    UT_EXPECT_NE(plan.find("Node By Label Scan [s:Small]"), std::string::npos);
+    UT_EXPECT_EQ(plan.find("Node By Label Scan [b:Big]"), std::string::npos);
+    UT_EXPECT_EQ(ctx.result_->Size(), 10);
+
+    // the reversed pattern already starts from s
+    plan = eval_query(&ctx, "MATCH (s:Small)<-[:R]-(b:Big) RETURN b.id, s.id");
+    UT_EXPECT_NE(plan.find("Node By Label Scan [s:Small]"), std::string::npos);
+    UT_EXPECT_EQ(ctx.result_->Size(), 10);
+
+    // a new index changes the schema, the statistics are rebuilt and the choice is kept
+    {
+        auto ac_db = galaxy.OpenGraph(lgraph::_detail::DEFAULT_ADMIN_NAME, "default");
+        lgraph_api::GraphDB db(&ac_db, false);
+        UT_ASSERT(db.AddVertexIndex("Big", "grp", lgraph::IndexType::NonuniqueIndex));
+    }
+    plan = eval_query(&ctx, query);
+    UT_EXPECT_NE(plan.find("Node By Label Scan [s:Small]"), std::string::npos);
+    UT_EXPECT_EQ(ctx.result_->Size(), 10);
+}
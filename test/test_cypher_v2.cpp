@@ -569,6 +569,13 @@ TEST_F(TestCypherV2, TestOpt) {
     test_files(dir);
 }
 
+TEST_F(TestCypherV2, TestHashJoin) {
+    set_graph_type(GraphFactory::GRAPH_DATASET_TYPE::YAGO);
+    set_query_type(lgraph::ut::QUERY_TYPE::NEWCYPHER);
+    std::string dir = test_suite_dir_ + "/hash_join/cypher";
+    test_files(dir);
+}
+
 TEST_F(TestCypherV2, TestFixCrashIssues) {
     set_graph_type(GraphFactory::GRAPH_DATASET_TYPE::YAGO);
     set_query_type(lgraph::ut::QUERY_TYPE::NEWCYPHER);
@@ -12,6 +12,9 @@
  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
  */
 
+#include <atomic>
+#include <thread>
+
 #include "fma-common/configuration.h"
 #include "fma-common/file_system.h"
 #include "fma-common/utils.h"
@@ -773,3 +776,55 @@ TEST_F(TestGalaxy, Galaxy) {
         }
     }
 }
+
+// the switch of a compaction waits for the requests reading the graph
+TEST_F(TestGalaxy, CompactWithReaders) {
+    const std::string dir = "./testdb";
+    lgraph::AutoCleanDir cleaner(dir);
+    lgraph::Galaxy galaxy(dir);
+    UT_EXPECT_TRUE(galaxy.CreateGraph(lgraph::_detail::DEFAULT_ADMIN_NAME, "cg",
+                                      lgraph::DBConfig()));
+    lgraph::AccessControlledDB db = galaxy.OpenGraph(lgraph::_detail::DEFAULT_ADMIN_NAME, "cg");
+    UT_EXPECT_TRUE(db.AddLabel(true, "person",
+                               {{"id", lgraph::FieldType::INT64, false},
+                                {"name", lgraph::FieldType::STRING, false}},
+                               lgraph::VertexOptions("id")));
+    auto txn = db.CreateWriteTxn();
+    std::vector<std::string> fields = {"id", "name"};
+    const std::string name(1000, 'x');
+    for (int64_t i = 0; i < 1000; i++) {
+        txn.AddVertex(std::string("person"), fields,
+                      std::vector<lgraph::FieldData>{lgraph::FieldData::Int64(i),
+                                                     lgraph::FieldData::String(name)});
+    }
+    txn.Commit();
+    txn = db.CreateWriteTxn();
+    for (lgraph::VertexId i = 0; i < 1000; i += 2) txn.DeleteVertex(i);
+    txn.Commit();
+
+    auto count_vertices = [](lgraph::Transaction& txn) {
+        size_t n = 0;
+        for (auto vit = txn.GetVertexIterator(); vit.IsValid(); vit.Next()) {
+            if (vit.GetField("name").AsString().size() == 1000) n++;
+        }
+        return n;
+    };
+    std::atomic<bool> reading(false), done(false);
+    std::thread reader([&]() {
+        // a request holds the reload lock while its txn is open
+        _HoldReadLock(galaxy.GetReloadLock());
+        auto rtxn = db.CreateReadTxn();
+        reading = true;
+        fma_common::SleepUs(200000);
+        UT_EXPECT_EQ(count_vertices(rtxn), 500);
+        rtxn.Abort();
+        done = true;
+    });
+    while (!reading) fma_common::SleepUs(100);
+    db.Compact(&galaxy.GetReloadLock());
+    UT_EXPECT_TRUE(done);
+    reader.join();
+    txn = db.CreateReadTxn();
+    UT_EXPECT_EQ(count_vertices(txn), 500);
+    txn.Abort();
+}
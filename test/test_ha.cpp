@@ -31,7 +31,7 @@ class TestHA : public TuGraphTest {
             "true --enable_ha true --ha_node_offline_ms 5000 "
             "--ha_node_remove_ms 10000 --ha_snapshot_interval_s -1 "
             "--rpc_port {} --directory ./db --log_dir "
-            "./log  --ha_conf {} --enable_plugin 1 --verbose 1 -c lgraph_ha.json -d start";
+            "./log  --ha_conf {} --enable_plugin 1 --verbose 1 {} -c lgraph_ha.json -d start";
 #else
         std::string cmd_f =
             "mkdir {} && cp -r ../../src/server/lgraph_ha.json "
@@ -40,23 +40,24 @@ class TestHA : public TuGraphTest {
             "true --enable_ha true --ha_node_offline_ms 5000 "
             "--ha_node_remove_ms 10000 --ha_snapshot_interval_s -1 "
             "--rpc_port {} --directory ./db --log_dir "
-            "./log  --ha_conf {} --enable_plugin 1 --use_pthread 1 --verbose 1 -c "
+            "./log  --ha_conf {} --enable_plugin 1 --use_pthread 1 --verbose 1 {} -c "
             "lgraph_ha.json -d start";
 #endif
 
         int rt;
         std::string cmd = FMA_FMT(cmd_f.c_str(), "ha1", "ha1", "ha1", host, "27072", "29092",
-                                  host + ":29092," + host + ":29093," + host + ":29094");
+                                  host + ":29092," + host + ":29093," + host + ":29094",
+                                  extra_options);
         rt = system(cmd.c_str());
         UT_EXPECT_EQ(rt, 0);
         fma_common::SleepS(5);
         cmd = FMA_FMT(cmd_f.c_str(), "ha2", "ha2", "ha2", host, "27073", "29093",
-                      host + ":29092," + host + ":29093," + host + ":29094");
+                      host + ":29092," + host + ":29093," + host + ":29094", extra_options);
         rt = system(cmd.c_str());
         UT_EXPECT_EQ(rt, 0);
         fma_common::SleepS(5);
         cmd = FMA_FMT(cmd_f.c_str(), "ha3", "ha3", "ha3", host, "27074", "29094",
-                      host + ":29092," + host + ":29093," + host + ":29094");
+                      host + ":29092," + host + ":29093," + host + ":29094", extra_options);
         rt = system(cmd.c_str());
         UT_EXPECT_EQ(rt, 0);
         fma_common::SleepS(5);
@@ -78,6 +79,8 @@ class TestHA : public TuGraphTest {
 
  public:
     std::string host;
+    // added to the command line of the servers
+    std::string extra_options;
     const std::string schema =
         "{\"schema\" :\n"
         "[  \n"
@@ -235,3 +238,101 @@ TEST_F(TestHA, AsyncSnapshot) {
     if (snapshot_thread.joinable())
         snapshot_thread.join();
 }
+
+TEST_F(TestHA, ConsistentRead) {
+    lgraph::RpcClient client(this->host + ":29092", "admin", "73@TuGraph");
+    std::string result;
+    UT_EXPECT_TRUE(client.ImportSchemaFromContent(result, schema));
+    for (int i = 0; i < 100; i++) {
+        UT_EXPECT_TRUE(client.CallCypherToLeader(
+            result, FMA_FMT("CREATE (:Person {{name:'p{}', phone:{}}})", i, i)));
+    }
+    auto count_on = [&](const std::string& port) {
+        if (!client.CallCypher(result, "MATCH (n:Person) RETURN count(n) AS c", "default", true,
+                               0, host + ":" + port))
+            return -1;
+        return nlohmann::json::parse(result)[0]["c"].get<int>();
+    };
+    // a read index from the master makes each node see every acknowledged write, a bound on
+    // the staleness lets followers reuse a recent one
+    for (int64_t staleness : {0, 1000}) {
+        client.SetMaxStaleness(staleness);
+        for (auto& port : {"29092", "29093", "29094"}) UT_EXPECT_EQ(count_on(port), 100);
+    }
+    // without a master, a follower cannot tell how stale it is, it redirects the client to
+    // the last master it knew of unless any staleness is fine. ha2 stops first so that ha3
+    // never gets a majority to become master itself
+    std::string cmd_f = "cd {} && ./lgraph_server -c lgraph_ha.json -d stop";
+    UT_EXPECT_EQ(system(FMA_FMT(cmd_f.c_str(), "ha2").c_str()), 0);
+    UT_EXPECT_EQ(system(FMA_FMT(cmd_f.c_str(), "ha1").c_str()), 0);
+    fma_common::SleepS(5);
+    for (int64_t staleness : {0, 1000}) {
+        client.SetMaxStaleness(staleness);
+        UT_EXPECT_EQ(count_on("29094"), -1);
+        UT_EXPECT_TRUE(result.find("applied index of master") != std::string::npos);
+    }
+    client.SetMaxStaleness(-1);
+    UT_EXPECT_EQ(count_on("29094"), 100);
+    client.Logout();
+    // TearDown stops every node
+    cmd_f =
+        "cd {} && ./lgraph_server --host {} --port {} --enable_rpc true --enable_ha true "
+        "--ha_node_offline_ms 5000 --ha_node_remove_ms 10000 --ha_snapshot_interval_s -1 "
+        "--rpc_port {} --directory ./db --log_dir ./log --ha_conf {} --enable_plugin 1 "
+        "-c lgraph_ha.json -d start";
+    std::string conf = host + ":29092," + host + ":29093," + host + ":29094";
+    UT_EXPECT_EQ(system(FMA_FMT(cmd_f.c_str(), "ha1", host, "27072", "29092", conf).c_str()), 0);
+    UT_EXPECT_EQ(system(FMA_FMT(cmd_f.c_str(), "ha2", host, "27073", "29093", conf).c_str()), 0);
+    fma_common::SleepS(5);
+}
+
+class TestHAPhysical : public TestHA {
+ protected:
+    void SetUp() override {
+        extra_options = "--ha_physical_replication true";
+        TestHA::SetUp();
+    }
+};
+
+TEST_F(TestHAPhysical, KvDeltaReplication) {
+    lgraph::RpcClient client(this->host + ":29092", "admin", "73@TuGraph");
+    std::string result;
+    UT_EXPECT_TRUE(client.ImportSchemaFromContent(result, schema));
+    auto create = [&](int from, int to) {
+        for (int i = from; i < to; i++) {
+            UT_EXPECT_TRUE(client.CallCypherToLeader(
+                result, FMA_FMT("CREATE (:Person {{name:'p{}', phone:{}}})", i, i)));
+        }
+    };
+    // a snapshot taken while deltas are committed must hold all the deltas it covers
+    std::thread snapshot_thread([this]() {
+        braft::cli::snapshot("lgraph", braft::PeerId(this->host + ":29092"),
+                             braft::cli::CliOptions());
+    });
+    create(0, 100);
+    snapshot_thread.join();
+    // compaction reopens the graph, the deltas after it must not use the tables opened before
+    UT_EXPECT_TRUE(client.CallCypherToLeader(result, "CALL db.compact()"));
+    create(100, 200);
+    // a follower that was down catches up from the log, or from the snapshot
+    std::string cmd = FMA_FMT("cd {} && ./lgraph_server -c lgraph_ha.json -d stop", "ha3");
+    UT_EXPECT_EQ(system(cmd.c_str()), 0);
+    create(200, 300);
+    cmd = FMA_FMT(
+        "cd {} && ./lgraph_server --host {} --port {} --enable_rpc true --enable_ha true "
+        "--ha_node_offline_ms 5000 --ha_node_remove_ms 10000 --ha_snapshot_interval_s -1 "
+        "--rpc_port {} --directory ./db --log_dir ./log --ha_conf {} --enable_plugin 1 {} "
+        "-c lgraph_ha.json -d start",
+        "ha3", host, "27074", "29094", host + ":29092," + host + ":29093," + host + ":29094",
+        extra_options);
+    UT_EXPECT_EQ(system(cmd.c_str()), 0);
+    fma_common::SleepS(10);
+    client.SetMaxStaleness(0);
+    for (auto& port : {"29092", "29093", "29094"}) {
+        UT_EXPECT_TRUE(client.CallCypher(result, "MATCH (n:Person) RETURN count(n) AS c",
+                                         "default", true, 0, host + ":" + port));
+        nlohmann::json res = nlohmann::json::parse(result);
+        UT_EXPECT_EQ(res[0]["c"], 300);
+    }
+    client.Logout();
+}
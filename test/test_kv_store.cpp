@@ -13,6 +13,8 @@
  */
 
 #include <future>
+#include <map>
+#include <thread>
 
 #include "fma-common/configuration.h"
 #include "fma-common/file_system.h"
@@ -20,6 +22,7 @@
 #include "fma-common/fma_stream.h"
 #include "gtest/gtest.h"
 #include "core/kv_store.h"
+#include "core/kv_write_set.h"
 
 #include "./test_tools.h"
 #include "./ut_utils.h"
@@ -961,3 +964,408 @@ TEST_F(TestKvStore, KvStore) {
     }
 #endif
 }
+
+TEST_F(TestKvStore, KvWriteSet) {
+    AutoCleanDir _("./testkv");
+    AutoCleanDir __("./testkv_replica");
+    auto store = std::make_unique<LMDBKvStore>("./testkv");
+    auto replica = std::make_unique<LMDBKvStore>("./testkv_replica");
+    for (auto* s : {store.get(), replica.get()}) {
+        auto txn = s->CreateWriteTxn();
+        s->OpenTable(*txn, "ws", true, ComparatorDesc::DefaultComparator());
+        txn->Commit();
+    }
+    auto txn = store->CreateReadTxn();
+    auto table = store->OpenTable(*txn, "ws", false, ComparatorDesc::DefaultComparator());
+    txn->Abort();
+    auto rtxn = replica->CreateReadTxn();
+    auto rtable = replica->OpenTable(*rtxn, "ws", false, ComparatorDesc::DefaultComparator());
+    rtxn->Abort();
+
+    UT_LOG() << "Testing recording and replaying write sets";
+    std::vector<KvWriteSet::Op> replayed;
+    std::vector<bool> committed;
+    {
+        KvWriteSetRecorder recorder(
+            [&](KvWriteSet& ws) {
+                UT_EXPECT_TRUE(ws.IsReplicable());
+                UT_EXPECT_EQ(ws.GetStore(), store.get());
+                auto wtxn = replica->CreateWriteTxn();
+                for (auto& op : ws.GetOps()) {
+                    UT_EXPECT_EQ(op.table, "ws");
+                    if (op.is_delete) {
+                        rtable->DeleteKey(*wtxn, Value::ConstRef(op.key));
+                    } else {
+                        rtable->SetValue(*wtxn, Value::ConstRef(op.key), Value::ConstRef(op.value));
+                    }
+                    replayed.push_back(op);
+                }
+                wtxn->Commit();
+            },
+            [](const std::string&) {}, [&](bool success) { committed.push_back(success); });
+        auto txn = store->CreateWriteTxn();
+        UT_EXPECT_TRUE(txn->GetWriteSet() != nullptr);
+        for (int i = 0; i < 10; i++) {
+            table->SetValue(*txn, Value::ConstRef<int>(i), Value::ConstRef<int>(i * 2));
+        }
+        table->DeleteKey(*txn, Value::ConstRef<int>(3));
+        {
+            auto it = table->GetIterator(*txn, Value::ConstRef<int>(5));
+            it->SetValue(Value::ConstRef<int>(100));
+        }
+        txn->Commit();
+        UT_EXPECT_EQ(replayed.size(), 12);
+        // the local commit is reported once the write set has been handed over
+        UT_EXPECT_EQ(committed, std::vector<bool>{true});
+
+        // nothing is recorded for read txns and aborted txns
+        auto read_txn = store->CreateReadTxn();
+        UT_EXPECT_TRUE(read_txn->GetWriteSet() == nullptr);
+        read_txn->Abort();
+        txn = store->CreateWriteTxn();
+        table->SetValue(*txn, Value::ConstRef<int>(20), Value::ConstRef<int>(20));
+        txn->Abort();
+        UT_EXPECT_EQ(replayed.size(), 12);
+        UT_EXPECT_EQ(committed.size(), 1);
+    }
+    {
+        auto txn = store->CreateReadTxn();
+        auto rtxn = replica->CreateReadTxn();
+        UT_EXPECT_EQ(table->GetKeyCount(*txn), 9);
+        UT_EXPECT_EQ(rtable->GetKeyCount(*rtxn), 9);
+        for (int i = 0; i < 10; i++) {
+            Value v, rv;
+            bool found = table->GetValue(*txn, Value::ConstRef<int>(i), v);
+            UT_EXPECT_EQ(rtable->GetValue(*rtxn, Value::ConstRef<int>(i), rv), found);
+            if (found) UT_EXPECT_EQ(v.AsString(), rv.AsString());
+        }
+        UT_EXPECT_EQ(rtable->GetValue(*rtxn, Value::ConstRef<int>(5)).AsType<int>(), 100);
+    }
+
+    UT_LOG() << "Testing unreplicable write sets";
+    {
+        std::string reason;
+        KvWriteSetRecorder recorder([&](KvWriteSet& ws) { reason = ws.UnreplicableReason(); },
+                                    [](const std::string&) {});
+        auto txn = store->CreateWriteTxn();
+        store->OpenTable(*txn, "ws2", true, ComparatorDesc::DefaultComparator());
+        txn->Commit();
+        UT_EXPECT_EQ(reason, "table ws2 created");
+        // reopening an existing table changes nothing a replica does not have
+        reason = "none";
+        txn = store->CreateWriteTxn();
+        store->OpenTable(*txn, "ws2", true, ComparatorDesc::DefaultComparator());
+        txn->Commit();
+        UT_EXPECT_EQ(reason, "");
+    }
+    {
+        KvWriteSetRecorder recorder(
+            [](KvWriteSet&) { throw std::runtime_error("refused"); },
+            [](const std::string&) {});
+        auto txn = store->CreateWriteTxn();
+        table->SetValue(*txn, Value::ConstRef<int>(30), Value::ConstRef<int>(30));
+        UT_EXPECT_ANY_THROW(txn->Commit());
+        txn->Abort();
+        auto rtxn = store->CreateReadTxn();
+        UT_EXPECT_TRUE(!table->HasKey(*rtxn, Value::ConstRef<int>(30)));
+    }
+    {
+        // no recorder, nothing recorded
+        auto txn = store->CreateWriteTxn();
+        UT_EXPECT_TRUE(txn->GetWriteSet() == nullptr);
+        txn->Abort();
+    }
+}
+
+TEST_F(TestKvStore, WarmUp) {
+    AutoCleanDir _("./testkv");
+    auto store = std::make_unique<LMDBKvStore>("./testkv");
+    std::vector<std::string> names = {"w1", "w2", "w3"};
+    std::map<std::string, size_t> sizes;
+    {
+        auto txn = store->CreateWriteTxn();
+        for (size_t t = 0; t < names.size(); t++) {
+            auto table =
+                store->OpenTable(*txn, names[t], true, ComparatorDesc::DefaultComparator());
+            for (int i = 0; i < 100; i++) {
+                // some values are large enough to be put in overflow pages
+                std::string value(i % 10 == 0 ? 10000 : 10 * t + 1, 'a');
+                table->SetValue(*txn, Value::ConstRef<int>(i), Value::ConstRef(value));
+                sizes[names[t]] += sizeof(int) + value.size();
+            }
+        }
+        txn->Commit();
+    }
+    size_t size = 0;
+    store->WarmUp(&size, {}, 2);
+    UT_EXPECT_EQ(size, sizes["w1"] + sizes["w2"] + sizes["w3"]);
+    store->WarmUp(&size, {"w2"});
+    UT_EXPECT_EQ(size, sizes["w2"]);
+    store->WarmUp(&size, {"w1", "w3"}, 1);
+    UT_EXPECT_EQ(size, sizes["w1"] + sizes["w3"]);
+    UT_EXPECT_ANY_THROW(store->WarmUp(&size, {"no_such_table"}));
+
+    store->SaveHotPages("./testkv/hot_pages");
+    UT_EXPECT_TRUE(fma_common::file_system::FileExists("./testkv/hot_pages"));
+    store->PrefetchHotPages("./testkv/hot_pages");
+    // a missing file is ignored
+    store->PrefetchHotPages("./testkv/no_hot_pages");
+}
+
+TEST_F(TestKvStore, Compaction) {
+    AutoCleanDir _("./testkv");
+    auto store = std::make_unique<LMDBKvStore>("./testkv");
+    std::string value(1000, 'a');
+    {
+        auto txn = store->CreateWriteTxn();
+        auto table = store->OpenTable(*txn, "c", true, ComparatorDesc::DefaultComparator());
+        for (int i = 0; i < 1000; i++)
+            table->SetValue(*txn, Value::ConstRef<int>(i), Value::ConstRef(value));
+        txn->Commit();
+        txn = store->CreateWriteTxn();
+        for (int i = 100; i < 1000; i++) table->DeleteKey(*txn, Value::ConstRef<int>(i));
+        txn->Commit();
+    }
+    KvSpaceStat before;
+    {
+        auto txn = store->CreateReadTxn();
+        store->DumpStat(*txn, before);
+    }
+    UT_EXPECT_GT(before.free_size, 0);
+    UT_EXPECT_GE(before.file_size, before.used_size + before.free_size);
+
+    // writes made while compacting are applied to the copy
+    store->StartCompaction();
+    {
+        auto txn = store->CreateWriteTxn();
+        auto table = store->OpenTable(*txn, "c", false, ComparatorDesc::DefaultComparator());
+        store->OpenTable(*txn, "d", true, ComparatorDesc::DefaultComparator());
+        txn->Commit();
+        // creating a table cannot be replayed on the copy, so this compaction fails, the
+        // writes below stay in the store
+        txn = store->CreateWriteTxn();
+        table->SetValue(*txn, Value::ConstRef<int>(5000), Value::ConstRef(value));
+        table->SetValue(*txn, Value::ConstRef<int>(1), Value::ConstRef(std::string("b")));
+        table->DeleteKey(*txn, Value::ConstRef<int>(0));
+        txn->Commit();
+    }
+    UT_EXPECT_ANY_THROW(store->FinishCompaction());
+    UT_EXPECT_TRUE(fma_common::file_system::FileExists("./testkv/data.mdb"));
+
+    store->StartCompaction();
+    {
+        auto txn = store->CreateReadTxn();
+        auto table = store->OpenTable(*txn, "c", false, ComparatorDesc::DefaultComparator());
+        txn->Commit();
+        txn = store->CreateWriteTxn();
+        table->SetValue(*txn, Value::ConstRef<int>(6000), Value::ConstRef(value));
+        table->SetValue(*txn, Value::ConstRef<int>(2), Value::ConstRef(std::string("c")));
+        table->DeleteKey(*txn, Value::ConstRef<int>(3));
+        txn->Commit();
+    }
+    store->FinishCompaction();
+    KvSpaceStat after;
+    {
+        auto txn = store->CreateReadTxn();
+        store->DumpStat(*txn, after);
+        auto table = store->OpenTable(*txn, "c", false, ComparatorDesc::DefaultComparator());
+        UT_EXPECT_EQ(table->GetKeyCount(*txn), 100);
+        UT_EXPECT_FALSE(table->HasKey(*txn, Value::ConstRef<int>(0)));
+        UT_EXPECT_EQ(table->GetValue(*txn, Value::ConstRef<int>(1)).AsString(), "b");
+        UT_EXPECT_EQ(table->GetValue(*txn, Value::ConstRef<int>(2)).AsString(), "c");
+        UT_EXPECT_FALSE(table->HasKey(*txn, Value::ConstRef<int>(3)));
+        UT_EXPECT_TRUE(table->HasKey(*txn, Value::ConstRef<int>(5000)));
+        UT_EXPECT_TRUE(table->HasKey(*txn, Value::ConstRef<int>(6000)));
+    }
+    UT_EXPECT_LT(after.file_size, before.file_size);
+    UT_EXPECT_LT(after.free_size, before.free_size);
+    UT_EXPECT_FALSE(fma_common::file_system::DirExists("./testkv/.compaction"));
+
+    // the compacted file is what a new store opens, and it can be written
+    {
+        auto txn = store->CreateWriteTxn();
+        auto table = store->OpenTable(*txn, "c", false, ComparatorDesc::DefaultComparator());
+        table->SetValue(*txn, Value::ConstRef<int>(7000), Value::ConstRef(value));
+        txn->Commit();
+    }
+    store.reset();
+    store = std::make_unique<LMDBKvStore>("./testkv", (size_t)1 << 30, false, false);
+    {
+        auto txn = store->CreateReadTxn();
+        auto table = store->OpenTable(*txn, "c", false, ComparatorDesc::DefaultComparator());
+        UT_EXPECT_EQ(table->GetKeyCount(*txn), 101);
+        UT_EXPECT_EQ(table->GetValue(*txn, Value::ConstRef<int>(1)).AsString(), "b");
+        UT_EXPECT_EQ(table->GetValue(*txn, Value::ConstRef<int>(2)).AsString(), "c");
+        UT_EXPECT_FALSE(table->HasKey(*txn, Value::ConstRef<int>(3)));
+        UT_EXPECT_TRUE(table->HasKey(*txn, Value::ConstRef<int>(6000)));
+        UT_EXPECT_TRUE(table->HasKey(*txn, Value::ConstRef<int>(7000)));
+    }
+}
+
+// a follower applies kv deltas to index tables it reopens with the default comparator
+TEST_F(TestKvStore, CompactionWithIndex) {
+    AutoCleanDir _("./testkv");
+    auto store = std::make_unique<LMDBKvStore>("./testkv");
+    auto desc = ComparatorDesc::SingleDataComp(FieldType::INT32);
+    {
+        auto txn = store->CreateWriteTxn();
+        auto index = store->OpenTable(*txn, "index", true, desc);
+        for (int i = 0; i < 1000; i++)
+            index->SetValue(*txn, Value::ConstRef<int>(i), Value::ConstRef<int>(i));
+        txn->Commit();
+    }
+    store->StartCompaction();
+    {
+        auto txn = store->CreateWriteTxn();
+        auto index = store->OpenTable(*txn, "index", false, ComparatorDesc::DefaultComparator());
+        for (int i = -300; i < 0; i++)
+            index->SetValue(*txn, Value::ConstRef<int>(i), Value::ConstRef<int>(i));
+        for (int i = 1000; i < 1300; i++)
+            index->SetValue(*txn, Value::ConstRef<int>(i), Value::ConstRef<int>(i));
+        index->DeleteKey(*txn, Value::ConstRef<int>(500));
+        txn->Commit();
+    }
+    store->FinishCompaction();
+    store.reset();
+    store = std::make_unique<LMDBKvStore>("./testkv", (size_t)1 << 30, false, false);
+    auto txn = store->CreateReadTxn();
+    auto index = store->OpenTable(*txn, "index", false, desc);
+    UT_EXPECT_EQ(index->GetKeyCount(*txn), 1599);
+    // the copy kept the order of the comparator, so lookups and scans still work
+    int expected = -300;
+    auto it = index->GetIterator(*txn);
+    for (it->GotoFirstKey(); it->IsValid(); it->Next()) {
+        if (expected == 500) expected++;
+        UT_EXPECT_EQ(it->GetKey().AsType<int>(), expected);
+        expected++;
+    }
+    it.reset();
+    UT_EXPECT_EQ(expected, 1300);
+    for (int i : {-300, -1, 0, 999, 1000, 1299}) {
+        UT_EXPECT_EQ(index->GetValue(*txn, Value::ConstRef<int>(i)).AsType<int>(), i);
+    }
+    UT_EXPECT_FALSE(index->HasKey(*txn, Value::ConstRef<int>(500)));
+}
+
+TEST_F(TestKvStore, RocksDB) {
+    AutoCleanDir _("./testkv");
+    {
+        auto store = std::make_unique<RocksDBKvStore>("./testkv");
+        UT_EXPECT_TRUE(RocksDBKvStore::IsStoreDir("./testkv"));
+        auto txn = store->CreateWriteTxn();
+        auto table = store->OpenTable(*txn, "t", true, ComparatorDesc::SingleDataComp(
+                                                           FieldType::INT32));
+        // the keys are sorted by the comparator of the table, not byte by byte
+        for (int i = -50; i < 50; i++)
+            table->SetValue(*txn, Value::ConstRef<int>(i), Value::ConstRef(std::to_string(i)));
+        UT_EXPECT_FALSE(table->AddKV(*txn, Value::ConstRef<int>(0), Value::ConstRef("x")));
+        UT_EXPECT_EQ(table->GetKeyCount(*txn), 100);
+        auto it = table->GetIterator(*txn);
+        UT_EXPECT_TRUE(it->GotoFirstKey());
+        UT_EXPECT_EQ(it->GetKey().AsType<int>(), -50);
+        // deleting a key places the iterator at the next one
+        while (it->IsValid()) {
+            if (it->GetKey().AsType<int>() % 2 == 0) {
+                it->DeleteKey();
+            } else {
+                it->Next();
+            }
+        }
+        UT_EXPECT_EQ(table->GetKeyCount(*txn), 50);
+        it.reset();
+        // a table created by a txn that aborts is gone
+        auto table2 = store->OpenTable(*txn, "t2", true, ComparatorDesc::DefaultComparator());
+        txn->Commit();
+        txn = store->CreateWriteTxn();
+        store->OpenTable(*txn, "t3", true, ComparatorDesc::DefaultComparator());
+        txn->Abort();
+        txn = store->CreateReadTxn();
+        UT_EXPECT_EQ(store->ListAllTables(*txn), std::vector<std::string>({"t", "t2"}));
+        txn->Abort();
+        txn = store->CreateWriteTxn();
+        UT_EXPECT_TRUE(store->DeleteTable(*txn, "t2"));
+        UT_EXPECT_ANY_THROW(
+            store->OpenTable(*txn, "t2", true, ComparatorDesc::DefaultComparator()));
+        txn->Commit();
+    }
+    {
+        // tables are opened again with their comparators
+        auto store = std::make_unique<RocksDBKvStore>("./testkv");
+        auto txn = store->CreateReadTxn();
+        UT_EXPECT_EQ(store->ListAllTables(*txn), std::vector<std::string>({"t"}));
+        auto table = store->OpenTable(*txn, "t", false, ComparatorDesc::SingleDataComp(
+                                                            FieldType::INT32));
+        auto it = table->GetIterator(*txn);
+        UT_EXPECT_TRUE(it->GotoLastKey());
+        UT_EXPECT_EQ(it->GetKey().AsType<int>(), 49);
+        UT_EXPECT_EQ(it->GetValue().AsString(), "49");
+        UT_EXPECT_TRUE(it->GotoClosestKey(Value::ConstRef<int>(-10)));
+        UT_EXPECT_EQ(it->GetKey().AsType<int>(), -9);
+        UT_EXPECT_FALSE(it->GotoKey(Value::ConstRef<int>(-10)));
+        it.reset();
+        txn->Abort();
+
+        // a read txn keeps seeing its snapshot
+        auto rtxn = store->CreateReadTxn();
+        txn = store->CreateWriteTxn();
+        table->SetValue(*txn, Value::ConstRef<int>(100), Value::ConstRef("100"));
+        txn->Commit();
+        UT_EXPECT_FALSE(table->HasKey(*rtxn, Value::ConstRef<int>(100)));
+        rtxn->Abort();
+
+        // an optimistic txn cannot write a key written by others after its snapshot
+        auto t1 = store->CreateWriteTxn(true);
+        auto t2 = store->CreateWriteTxn(true);
+        table->SetValue(*t2, Value::ConstRef<int>(1), Value::ConstRef("b"));
+        t2->Commit();
+        UT_EXPECT_THROW_CODE(
+            table->SetValue(*t1, Value::ConstRef<int>(1), Value::ConstRef("a")), TxnConflict);
+        t1->Abort();
+    }
+}
+
+TEST_F(TestKvStore, Readers) {
+    AutoCleanDir _("./testkv");
+    auto store = std::make_unique<LMDBKvStore>("./testkv");
+    std::unique_ptr<KvTable> table;
+    {
+        auto txn = store->CreateWriteTxn();
+        table = store->OpenTable(*txn, "r", true, ComparatorDesc::DefaultComparator());
+        table->SetValue(*txn, Value::ConstRef<int>(1), Value::ConstRef(std::string("a")));
+        txn->Commit();
+    }
+    auto get_stat = [&]() {
+        KvSpaceStat stat;
+        auto txn = store->CreateReadTxn();
+        store->DumpStat(*txn, stat);
+        return stat;
+    };
+    // the txn of DumpStat is left out
+    UT_EXPECT_EQ(get_stat().readers, 0);
+    auto reader = store->CreateReadTxn();
+    auto fork = reader->Fork();
+    auto optimistic = store->CreateWriteTxn(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    KvSpaceStat stat = get_stat();
+    UT_EXPECT_EQ(stat.readers, 3);
+    UT_EXPECT_GE(stat.oldest_reader_age, 0.1);
+    reader.reset();
+    optimistic->Abort();
+    UT_EXPECT_EQ(get_stat().readers, 1);
+    fork.reset();
+    stat = get_stat();
+    UT_EXPECT_EQ(stat.readers, 0);
+    UT_EXPECT_EQ(stat.oldest_reader_age, 0);
+
+    // a clone has the last committed state, and can be opened as a store
+    store->Clone("./testkv/clone");
+    {
+        auto txn = store->CreateWriteTxn();
+        table->SetValue(*txn, Value::ConstRef<int>(1), Value::ConstRef(std::string("b")));
+        txn->Commit();
+    }
+    LMDBKvStore clone("./testkv/clone");
+    auto txn = clone.CreateReadTxn();
+    auto clone_table = clone.OpenTable(*txn, "r", false, ComparatorDesc::DefaultComparator());
+    UT_EXPECT_EQ(clone_table->GetValue(*txn, Value::ConstRef<int>(1)).AsString(), "a");
+}
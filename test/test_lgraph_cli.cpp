@@ -106,19 +106,18 @@ ReadOnly:1
 Execution Plan:
 Produce Results
     Project [n]
-        Expand(All) [n --> m ]
+        Expand(All) [n --> m ] (1 estimated)
             All Node Scan [n]
 
 r
 [:is_friend {message:"hi.."}]
 @profile
-Current Pattern Graph:
-N[0] n: (MATCHED)
-N[1] m: (MATCHED)
-R[0 --> 1] r:{<0>: } (MATCHED)
-Symbol: [n] type(NODE), scope(LOCAL), symbol_id(0)
-Symbol: [r] type(RELATIONSHIP), scope(LOCAL), symbol_id(2)
-Symbol: [m] type(NODE), scope(LOCAL), symbol_id(1)
+ReadOnly:1
+Profile statistics:
+Produce Results (1 rows)
+    Project [r] (1 rows)
+        Expand(All) [n --> m ] (1 rows, 1 estimated)
+            All Node Scan [n] (2 rows)
 
 p
 (:person {int16:16,float:1.11,double:100.98,int8:8,string:"foo bar",int32:32,int64:64,bool:true,datetime:"2017-05-01 10:00:00",date:"2017-05-03"})-[:is_friend {message:"hi.."}]->(:person {int16:116,float:11.11,double:1100.98,int8:18,string:"bar foo",int32:132,int64:164,bool:true,datetime:"2018-05-01 10:00:00",date:"2018-05-03"})
@@ -157,11 +156,11 @@ p
 ["n"]
 ["(:person {int16:16,float:1.11,double:100.98,int8:8,string:\"foo bar\",int32:32,int64:64,bool:true,datetime:\"2017-05-01 10:00:00\",date:\"2017-05-03\"})"]
 ["@plan"]
-["ReadOnly:1\nExecution Plan:\nProduce Results\n    Project [n]\n        Expand(All) [n --> m ]\n            All Node Scan [n]\n"]
+["ReadOnly:1\nExecution Plan:\nProduce Results\n    Project [n]\n        Expand(All) [n --> m ] (1 estimated)\n            All Node Scan [n]\n"]
 ["r"]
 ["[:is_friend {message:\"hi..\"}]"]
 ["@profile"]
-["Current Pattern Graph:\nN[0] n: (MATCHED)\nN[1] m: (MATCHED)\nR[0 --> 1] r:{<0>: } (MATCHED)\nSymbol: [n] type(NODE), scope(LOCAL), symbol_id(0)\nSymbol: [r] type(RELATIONSHIP), scope(LOCAL), symbol_id(2)\nSymbol: [m] type(NODE), scope(LOCAL), symbol_id(1)\n"]
+["ReadOnly:1\nProfile statistics:\nProduce Results (1 rows)\n    Project [r] (1 rows)\n        Expand(All) [n --> m ] (1 rows, 1 estimated)\n            All Node Scan [n] (2 rows)\n"]
 ["p"]
 ["(:person {int16:16,float:1.11,double:100.98,int8:8,string:\"foo bar\",int32:32,int64:64,bool:true,datetime:\"2017-05-01 10:00:00\",date:\"2017-05-03\"})-[:is_friend {message:\"hi..\"}]->(:person {int16:116,float:11.11,double:1100.98,int8:18,string:\"bar foo\",int32:132,int64:164,bool:true,datetime:\"2018-05-01 10:00:00\",date:\"2018-05-03\"})"]
 )xx";
@@ -226,16 +225,16 @@ p
 
 1 rows
 
-+--------------------------------+
-| @plan                          |
-+--------------------------------+
-| ReadOnly:1                     |
-| Execution Plan:                |
-| Produce Results                |
-|     Project [n]                |
-|         Expand(All) [n --> m ] |
-|             All Node Scan [n]  |
-+--------------------------------+
++----------------------------------------------+
+| @plan                                        |
++----------------------------------------------+
+| ReadOnly:1                                   |
+| Execution Plan:                              |
+| Produce Results                              |
+|     Project [n]                              |
+|         Expand(All) [n --> m ] (1 estimated) |
+|             All Node Scan [n]                |
++----------------------------------------------+
 
 1 rows
 
@@ -247,17 +246,16 @@ p
 
 1 rows
 
-+------------------------------------------------------------+
-| @profile                                                   |
-+------------------------------------------------------------+
-| Current Pattern Graph:                                     |
-| N[0] n: (MATCHED)                                          |
-| N[1] m: (MATCHED)                                          |
-| R[0 --> 1] r:{<0>: } (MATCHED)                             |
-| Symbol: [n] type(NODE), scope(LOCAL), symbol_id(0)         |
-| Symbol: [r] type(RELATIONSHIP), scope(LOCAL), symbol_id(2) |
-| Symbol: [m] type(NODE), scope(LOCAL), symbol_id(1)         |
-+------------------------------------------------------------+
++------------------------------------------------------+
+| @profile                                             |
++------------------------------------------------------+
+| ReadOnly:1                                           |
+| Profile statistics:                                  |
+| Produce Results (1 rows)                             |
+|     Project [r] (1 rows)                             |
+|         Expand(All) [n --> m ] (1 rows, 1 estimated) |
+|             All Node Scan [n] (2 rows)               |
++------------------------------------------------------+
 
 1 rows
 
@@ -15,6 +15,7 @@
 #include "gtest/gtest.h"
 #include "./ut_utils.h"
 #include "lgraph/olap_on_db.h"
+#include "lgraph/olap_sampling.h"
 #include "fma-common/utils.h"
 #include "import/import_v3.h"
 
@@ -457,3 +458,153 @@ TEST_F(TestOlapOnDB, OlapOnDB) {
                                              "test_weighted.csv", "test_write_to_db.csv"};
     ClearCsvFiles(del_filename);
 }
+
+TEST_F(TestOlapOnDB, SubgraphSampler) {
+    WriteOlapDbFiles();
+    std::string db_path = "./testdb_olap";
+    lgraph::import_v3::Importer::Config config;
+    config.config_file = "./test_olap_on_db.conf";
+    config.db_dir = db_path;
+    config.delete_if_exists = true;
+    config.graph = "default";
+    config.parse_block_threads = 1;
+    config.parse_file_threads = 1;
+    config.generate_sst_threads = 1;
+    lgraph::import_v3::Importer importer(config);
+    importer.DoImportOffline();
+    Galaxy g(db_path);
+    g.SetCurrentUser("admin", "73@TuGraph");
+    GraphDB db = g.OpenGraph("default");
+    {
+        auto txn = db.CreateWriteTxn();
+        auto vit = txn.GetVertexIterator(0);
+        vit.SetField("value", FieldData::String("not a label"));
+        txn.Commit();
+    }
+
+    auto txn = db.CreateReadTxn();
+    OlapOnDB<double> graph(db, txn, SNAPSHOT_PARALLEL, nullptr, edge_convert_weight<double>);
+    // Export opens a txn of its own
+    txn.Abort();
+    auto is_edge = [&](size_t src, size_t dst) {
+        for (auto& edge : graph.OutEdges(src)) {
+            if (edge.neighbour == dst) return true;
+        }
+        return false;
+    };
+    auto export_edges = [&](SubgraphSampler<double>& sampler, std::vector<int64_t>& src,
+                            std::vector<int64_t>& dst) {
+        src.assign(sampler.NumEdges(), -1);
+        dst.assign(sampler.NumEdges(), -1);
+        sampler.Export(db, "", "", 0, nullptr, nullptr, nullptr, nullptr, src.data(),
+                       dst.data(), nullptr);
+    };
+    std::vector<int64_t> src, dst;
+
+    UT_LOG() << "Test NeighborSample";
+    SubgraphSampler<double> sampler(graph, 42);
+    std::vector<size_t> seeds = {0, 20};
+    sampler.NeighborSample(seeds.data(), seeds.size(), 3);
+    // 0 has five out-edges, 20 has none
+    UT_EXPECT_EQ(sampler.NumEdges(), 3);
+    export_edges(sampler, src, dst);
+    for (size_t i = 0; i < src.size(); i++) {
+        UT_EXPECT_EQ(src[i], 0);
+        UT_EXPECT_TRUE(is_edge(src[i], dst[i]));
+    }
+    // a batch depends on the seed only
+    {
+        SubgraphSampler<double> same(graph, 42);
+        same.NeighborSample(seeds.data(), seeds.size(), 3);
+        std::vector<int64_t> same_src, same_dst;
+        export_edges(same, same_src, same_dst);
+        UT_EXPECT_TRUE(same_src == src);
+        UT_EXPECT_TRUE(same_dst == dst);
+    }
+    size_t num_nodes = sampler.NumNodes();
+    UT_EXPECT_TRUE(num_nodes >= 3 && num_nodes <= 5);
+    std::vector<int64_t> nodes(num_nodes, -1), vertex_types(num_nodes, -1),
+        edge_types(sampler.NumEdges(), -1);
+    sampler.Export(db, "", "", 0, nodes.data(), nullptr, nullptr, vertex_types.data(), nullptr,
+                   nullptr, edge_types.data());
+    UT_EXPECT_EQ(nodes.front(), 0);
+    UT_EXPECT_EQ(nodes.back(), 20);
+    UT_EXPECT_TRUE(std::is_sorted(nodes.begin(), nodes.end()));
+    for (auto t : vertex_types) UT_EXPECT_EQ(t, 0);
+    for (auto t : edge_types) UT_EXPECT_EQ(t, 0);
+    UT_EXPECT_THROW(sampler.NeighborSample(std::vector<size_t>{21}.data(), 1, 3),
+                    std::runtime_error);
+
+    UT_LOG() << "Test RandomWalk";
+    sampler.Clear();
+    UT_EXPECT_EQ(sampler.NumNodes(), 0);
+    seeds = {7};
+    sampler.RandomWalk(seeds.data(), seeds.size(), 10);
+    export_edges(sampler, src, dst);
+    // a walk from 7 stops at 18, 19 or 20, which have no out-edges, within 5 steps
+    UT_EXPECT_TRUE(!src.empty() && src.size() <= 5);
+    UT_EXPECT_EQ(src[0], 7);
+    for (size_t i = 0; i < src.size(); i++) {
+        UT_EXPECT_TRUE(is_edge(src[i], dst[i]));
+        if (i > 0) UT_EXPECT_EQ(src[i], dst[i - 1]);
+    }
+
+    UT_LOG() << "Test Node2VecWalk";
+    sampler.Clear();
+    seeds = {0, 9};
+    size_t walk_length = 5, num_walks = 3;
+    std::vector<int64_t> walks(seeds.size() * num_walks * walk_length, -2);
+    UT_EXPECT_THROW(sampler.Node2VecWalk(seeds.data(), seeds.size(), walk_length, num_walks, 0,
+                                         1, walks.data()),
+                    std::invalid_argument);
+    UT_EXPECT_THROW(sampler.Node2VecWalk(seeds.data(), seeds.size(), walk_length, num_walks, 1,
+                                         std::nan(""), walks.data()),
+                    std::invalid_argument);
+    UT_EXPECT_EQ(sampler.NumEdges(), 0);
+    sampler.Node2VecWalk(seeds.data(), seeds.size(), walk_length, num_walks, 0.5, 2,
+                         walks.data());
+    for (size_t t = 0; t < seeds.size() * num_walks; t++) {
+        int64_t* walk = walks.data() + t * walk_length;
+        UT_EXPECT_EQ(walk[0], seeds[t % seeds.size()]);
+        for (size_t k = 1; k < walk_length && walk[k] != -1; k++) {
+            UT_EXPECT_TRUE(is_edge(walk[k - 1], walk[k]));
+        }
+    }
+
+    UT_LOG() << "Test EdgeSample and NegativeSample";
+    sampler.Clear();
+    sampler.EdgeSample(1);
+    UT_EXPECT_EQ(sampler.NumEdges(), 35);
+    UT_EXPECT_EQ(sampler.NumNodes(), 21);
+    sampler.Clear();
+    sampler.EdgeSample(0);
+    UT_EXPECT_EQ(sampler.NumEdges(), 0);
+    sampler.NegativeSample(100);
+    export_edges(sampler, src, dst);
+    UT_EXPECT_TRUE(!src.empty());
+    for (size_t i = 0; i < src.size(); i++) {
+        UT_EXPECT_NE(src[i], dst[i]);
+        UT_EXPECT_TRUE(!is_edge(src[i], dst[i]));
+    }
+    // no sampler is built on an empty graph, so no pair is drawn from zero vertices
+    {
+        UT_EXPECT_TRUE(g.CreateGraph("empty"));
+        GraphDB empty_db = g.OpenGraph("empty");
+        auto empty_txn = empty_db.CreateReadTxn();
+        UT_EXPECT_THROW(OlapOnDB<double> empty(empty_db, empty_txn, SNAPSHOT_PARALLEL),
+                        std::runtime_error);
+    }
+
+    UT_LOG() << "Test errors of Export are rethrown";
+    sampler.Clear();
+    seeds = {0};
+    sampler.NeighborSample(seeds.data(), seeds.size(), 5);
+    std::vector<int64_t> labels(sampler.NumNodes(), -1);
+    // the label of vertex 0 is a string
+    UT_EXPECT_ANY_THROW(sampler.Export(db, "", "value", 0, nullptr, nullptr, labels.data(),
+                                       nullptr, nullptr, nullptr, nullptr));
+
+    std::vector<std::string> del_filename = {"test_olap_on_db.conf", "test_vertices.csv",
+                                             "test_weighted.csv"};
+    ClearCsvFiles(del_filename);
+}
@@ -12,6 +12,10 @@
  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
  */
 
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "./ut_utils.h"
 #include "olap/olap_on_disk.h"
@@ -177,6 +181,82 @@ TEST_P(TestOlapOnDisk, OlapOnDisk) {
         UT_EXPECT_EQ(label.Size(), 21);
         UT_EXPECT_EQ(label.Back(), -1);
 
+        // test SortedNeighbours and set intersections
+        auto sorted = graph.AllocSortedNeighbours();
+        auto oriented = graph.AllocSortedNeighbours(true);
+        size_t oriented_edges = 0;
+        for (size_t v = 0; v < graph.NumVertices(); v++) {
+            std::vector<size_t> expected_nbrs;
+            for (auto& edge : graph.OutEdges(v)) {
+                if (edge.neighbour != v) expected_nbrs.push_back(edge.neighbour);
+            }
+            std::sort(expected_nbrs.begin(), expected_nbrs.end());
+            expected_nbrs.erase(std::unique(expected_nbrs.begin(), expected_nbrs.end()),
+                                expected_nbrs.end());
+            UT_EXPECT_TRUE(std::vector<size_t>(sorted.Begin(v), sorted.End(v)) == expected_nbrs);
+            UT_EXPECT_TRUE(std::is_sorted(oriented.Begin(v), oriented.End(v)));
+            for (auto ptr = oriented.Begin(v); ptr != oriented.End(v); ptr++) {
+                size_t du = graph.OutDegree(v), dv = graph.OutDegree(*ptr);
+                UT_EXPECT_TRUE(du < dv || (du == dv && v < *ptr));
+            }
+            oriented_edges += oriented.Degree(v);
+        }
+        UT_EXPECT_LE(oriented_edges, sorted.NumEdges());
+        for (size_t size_b : {0, 3, 17, 64, 1000}) {
+            std::vector<size_t> a, b;
+            for (size_t i = 0; i < 50; i++) a.push_back(i * 3);
+            for (size_t i = 0; i < size_b; i++) b.push_back(i * 2 + (i % 5 == 0));
+            std::vector<size_t> common;
+            std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                                  std::back_inserter(common));
+            std::vector<size_t> visited;
+            size_t count = IntersectForEach(a.data(), a.size(), b.data(), b.size(),
+                                            [&](size_t pos_a, size_t pos_b) {
+                                                UT_EXPECT_EQ(a[pos_a], b[pos_b]);
+                                                visited.push_back(a[pos_a]);
+                                            });
+            UT_EXPECT_EQ(count, common.size());
+            UT_EXPECT_TRUE(visited == common);
+            UT_EXPECT_EQ(IntersectCount(b.data(), b.size(), a.data(), a.size()), common.size());
+        }
+
+        // test csr file
+        graph.WriteCsr("./test_olap.csr");
+        {
+            UnWeight_Config csr_config(argc, argv);
+            csr_config.type = CSR_FILE;
+            csr_config.input_dir = "./test_olap.csr";
+            OlapOnDisk<Empty> csr_graph;
+            csr_graph.Load(csr_config, DUAL_DIRECTION);
+            UT_EXPECT_EQ(csr_graph.NumVertices(), graph.NumVertices());
+            UT_EXPECT_EQ(csr_graph.NumEdges(), graph.NumEdges());
+            for (size_t v = 0; v < graph.NumVertices(); v++) {
+                UT_EXPECT_EQ(csr_graph.OutDegree(v), graph.OutDegree(v));
+                UT_EXPECT_EQ(csr_graph.InDegree(v), graph.InDegree(v));
+                auto expected = graph.OutEdges(v).begin();
+                for (auto& edge : csr_graph.OutEdges(v)) {
+                    UT_EXPECT_EQ(edge.neighbour, (expected++)->neighbour);
+                }
+                expected = graph.InEdges(v).begin();
+                for (auto& edge : csr_graph.InEdges(v)) {
+                    UT_EXPECT_EQ(edge.neighbour, (expected++)->neighbour);
+                }
+            }
+            OlapOnDisk<Empty> symmetric_graph;
+            UT_EXPECT_THROW_MSG(symmetric_graph.Load(csr_config, MAKE_SYMMETRIC),
+                                "another edge direction policy");
+            OlapOnDisk<double> weight_csr_graph;
+            Weight_Config weight_csr_config(argc, argv);
+            weight_csr_config.type = CSR_FILE;
+            weight_csr_config.input_dir = "./test_olap.csr";
+            UT_EXPECT_THROW_MSG(weight_csr_graph.Load(weight_csr_config),
+                                "does not match the graph");
+            csr_config.id_mapping = true;
+            OlapOnDisk<Empty> names_graph;
+            UT_EXPECT_THROW_MSG(names_graph.Load(csr_config), "has no id map");
+        }
+        system("rm -f ./test_olap.csr");
+
         graph.ProcessVertexInRange<size_t>([&](size_t v) {
             if (graph.OutDegree(v) == 0) return 0;
             for (auto& edge : graph.OutEdges(v)) {
@@ -308,6 +388,95 @@ TEST_P(TestOlapOnDisk, OlapOnDisk) {
             return 0;
         }, active);
         UT_EXPECT_EQ(label[1], 1);
+
+        // test csr file with id map
+        weight_config.csr_output = "./test_olap.csr";
+        {
+            OlapOnDisk<double> written_graph;
+            written_graph.Load(weight_config, MAKE_SYMMETRIC);
+        }
+        {
+            Weight_Config csr_config(argc, argv);
+            csr_config.type = CSR_FILE;
+            csr_config.id_mapping = true;
+            csr_config.input_dir = "./test_olap.csr";
+            OlapOnDisk<double> csr_graph;
+            csr_graph.Load(csr_config, MAKE_SYMMETRIC);
+            UT_EXPECT_EQ(csr_graph.NumVertices(), graph.NumVertices());
+            UT_EXPECT_EQ(csr_graph.NumEdges(), graph.NumEdges());
+            for (size_t v = 0; v < graph.NumVertices(); v++) {
+                UT_EXPECT_EQ(csr_graph.mapped_to_origin_[v], graph.mapped_to_origin_[v]);
+                UT_EXPECT_EQ(csr_graph.hash_list_.find(graph.mapped_to_origin_[v]), v);
+                UT_EXPECT_EQ(csr_graph.InDegree(v), graph.InDegree(v));
+                auto expected = graph.OutEdges(v).begin();
+                for (auto& edge : csr_graph.OutEdges(v)) {
+                    UT_EXPECT_EQ(edge.neighbour, expected->neighbour);
+                    UT_EXPECT_EQ(edge.edge_data, (expected++)->edge_data);
+                }
+            }
+        }
+        system("rm -f ./test_olap.csr");
+
+        // test BucketedFrontier against Bellman-Ford
+        auto expected = graph.AllocVertexArray<double>();
+        expected.Fill(1e10);
+        expected[0] = 0;
+        for (size_t round = 0; round < graph.NumVertices(); round++) {
+            for (size_t v = 0; v < graph.NumVertices(); v++) {
+                for (auto& edge : graph.OutEdges(v)) {
+                    if (expected[v] + edge.edge_data < expected[edge.neighbour])
+                        expected[edge.neighbour] = expected[v] + edge.edge_data;
+                }
+            }
+        }
+        auto distance = graph.AllocVertexArray<double>();
+        distance.Fill(1e10);
+        distance[0] = 0;
+        double delta = 5;
+        auto frontier = graph.AllocBucketedFrontier();
+        frontier.Push(0, 0);
+        size_t last_bucket = 0;
+        while (frontier.Advance()) {
+            size_t bucket = frontier.CurrentBucket();
+            UT_EXPECT_GE(bucket, last_bucket);
+            last_bucket = bucket;
+            graph.ProcessVertexBucket<size_t>([&](size_t v) {
+                if (distance[v] < delta * bucket) return 0;
+                for (auto& edge : graph.OutEdges(v)) {
+                    double d = distance[v] + edge.edge_data;
+                    if (write_min(&distance[edge.neighbour], d))
+                        frontier.Push(edge.neighbour, (size_t)(d / delta));
+                }
+                return 0;
+            }, frontier);
+        }
+        UT_EXPECT_EQ(frontier.Size(), 0);
+        for (size_t v = 0; v < graph.NumVertices(); v++) {
+            UT_EXPECT_EQ(distance[v], expected[v]);
+        }
+
+        // far apart buckets are kept in the overflow list until the ring reaches them
+        frontier.Clear();
+        size_t far_bucket = (size_t)1 << 40;
+        frontier.Push(1, 0);
+        frontier.Push(2, far_bucket);
+        frontier.Push(3, BucketedFrontier::N_CYCLIC_BUCKETS + 3);
+        frontier.Push(4, BucketedFrontier::N_CYCLIC_BUCKETS - 1);
+        std::vector<std::pair<size_t, size_t> > order = {
+            {0, 1}, {BucketedFrontier::N_CYCLIC_BUCKETS - 1, 4},
+            {BucketedFrontier::N_CYCLIC_BUCKETS + 3, 3}, {far_bucket, 2}};
+        for (auto& expected_bucket : order) {
+            UT_EXPECT_TRUE(frontier.Advance());
+            UT_EXPECT_EQ(frontier.CurrentBucket(), expected_bucket.first);
+            UT_EXPECT_EQ(frontier.Size(), 1);
+            UT_EXPECT_EQ(frontier[0], expected_bucket.second);
+        }
+        // a lower bucket is taken as the current one
+        frontier.Push(5, 1);
+        UT_EXPECT_TRUE(frontier.Advance());
+        UT_EXPECT_EQ(frontier.CurrentBucket(), far_bucket);
+        UT_EXPECT_EQ(frontier[0], 5);
+        UT_EXPECT_FALSE(frontier.Advance());
     }
     system("rm -rf ./ut_data");
 }
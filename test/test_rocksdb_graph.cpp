@@ -0,0 +1,142 @@
+/**
+ * Copyright 2022 AntGroup CO., Ltd.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ */
+
+#include "fma-common/file_system.h"
+#include "fma-common/utils.h"
+
+#include "gtest/gtest.h"
+
+#include "db/galaxy.h"
+#include "./ut_utils.h"
+
+class TestRocksDBGraph : public TuGraphTest {};
+
+using namespace lgraph;
+
+static size_t CountVertices(Transaction& txn) {
+    size_t n = 0;
+    for (auto vit = txn.GetVertexIterator(); vit.IsValid(); vit.Next()) n++;
+    return n;
+}
+
+static size_t CountEdges(Transaction& txn) {
+    size_t n = 0;
+    for (auto vit = txn.GetVertexIterator(); vit.IsValid(); vit.Next()) {
+        for (auto eit = vit.GetOutEdgeIterator(); eit.IsValid(); eit.Next()) n++;
+    }
+    return n;
+}
+
+static size_t CountIndexed(Transaction& txn, int64_t age) {
+    size_t n = 0;
+    for (auto iit = txn.GetVertexIndexIterator("person", "age", FieldData::Int64(age),
+                                               FieldData::Int64(age));
+         iit.IsValid(); iit.Next()) {
+        n++;
+    }
+    return n;
+}
+
+// the paths of a graph kept in rocksdb, through the graph manager down to the store
+TEST_F(TestRocksDBGraph, RocksDBGraph) {
+    const std::string dir = "./testdb";
+    const std::string backup_dir = "./testdb_backup";
+    const std::string snapshot_dir = "./testdb_snapshot";
+    AutoCleanDir cleaner(dir);
+    AutoCleanDir backup_cleaner(backup_dir);
+    AutoCleanDir snapshot_cleaner(snapshot_dir);
+    {
+        Galaxy galaxy(dir);
+        DBConfig config;
+        config.kv_engine = _detail::KV_ENGINE_ROCKSDB;
+        UT_EXPECT_TRUE(galaxy.CreateGraph(_detail::DEFAULT_ADMIN_NAME, "rg", config));
+        AccessControlledDB db = galaxy.OpenGraph(_detail::DEFAULT_ADMIN_NAME, "rg");
+        LightningGraph* graph = db.GetLightningGraph();
+        UT_EXPECT_EQ(graph->GetKvEngine(), _detail::KV_ENGINE_ROCKSDB);
+        UT_EXPECT_TRUE(db.AddLabel(true, "person",
+                                   {{"id", FieldType::INT64, false},
+                                    {"age", FieldType::INT64, false}},
+                                   VertexOptions("id")));
+        UT_EXPECT_TRUE(db.AddLabel(false, "knows", {{"weight", FieldType::DOUBLE, false}},
+                                   EdgeOptions()));
+        UT_EXPECT_TRUE(db.AddVertexIndex("person", "age", IndexType::NonuniqueIndex));
+        while (!db.IsVertexIndexed("person", "age")) fma_common::SleepUs(100);
+
+        UT_LOG() << "Test vertices, edges and indexes";
+        Transaction txn = db.CreateWriteTxn();
+        std::vector<std::string> v_fields = {"id", "age"};
+        std::vector<std::string> e_fields = {"weight"};
+        for (int64_t i = 0; i < 100; i++) {
+            txn.AddVertex(std::string("person"), v_fields,
+                          std::vector<FieldData>{FieldData::Int64(i), FieldData::Int64(i % 10)});
+        }
+        for (VertexId i = 0; i < 100; i++) {
+            txn.AddEdge(i, (i + 1) % 100, std::string("knows"), e_fields,
+                        std::vector<FieldData>{FieldData::Double(i * 0.5)});
+        }
+        txn.Commit();
+        txn = db.CreateWriteTxn();
+        UT_EXPECT_TRUE(txn.DeleteVertex(3));
+        txn.SetVertexProperty(4, std::vector<std::string>{"age"},
+                              std::vector<FieldData>{FieldData::Int64(100)});
+        txn.Commit();
+        txn = db.CreateReadTxn();
+        UT_EXPECT_EQ(CountVertices(txn), 99);
+        // the two edges of vertex 3 are deleted with it
+        UT_EXPECT_EQ(CountEdges(txn), 98);
+        UT_EXPECT_EQ(CountIndexed(txn, 3), 9);
+        UT_EXPECT_EQ(CountIndexed(txn, 4), 9);
+        UT_EXPECT_EQ(CountIndexed(txn, 100), 1);
+        txn.Abort();
+
+        UT_LOG() << "Test snapshot";
+        txn = db.CreateReadTxn();
+        graph->Snapshot(txn, snapshot_dir);
+        txn.Abort();
+        txn = db.CreateWriteTxn();
+        txn.DeleteVertex(5);
+        txn.Commit();
+        graph->LoadSnapshot(snapshot_dir);
+        txn = db.CreateReadTxn();
+        UT_EXPECT_EQ(CountVertices(txn), 99);
+        UT_EXPECT_EQ(CountIndexed(txn, 5), 10);
+        txn.Abort();
+
+        UT_LOG() << "Test compaction, which leaves the graph open";
+        txn = db.CreateWriteTxn();
+        for (VertexId i = 50; i < 100; i++) txn.DeleteVertex(i);
+        txn.Commit();
+        uint64_t open_id = graph->GetOpenId();
+        graph->Compact();
+        UT_EXPECT_EQ(graph->GetOpenId(), open_id);
+        txn = db.CreateReadTxn();
+        UT_EXPECT_EQ(CountVertices(txn), 49);
+        UT_EXPECT_EQ(CountEdges(txn), 47);
+        txn.Abort();
+
+        UT_LOG() << "Test backup";
+        galaxy.Backup(backup_dir, false);
+    }
+    // a graph is reopened with the engine it was created with
+    for (auto& d : {dir, backup_dir}) {
+        Galaxy galaxy(d);
+        AccessControlledDB db = galaxy.OpenGraph(_detail::DEFAULT_ADMIN_NAME, "rg");
+        UT_EXPECT_EQ(db.GetLightningGraph()->GetKvEngine(), _detail::KV_ENGINE_ROCKSDB);
+        Transaction txn = db.CreateReadTxn();
+        UT_EXPECT_EQ(CountVertices(txn), 49);
+        UT_EXPECT_EQ(CountEdges(txn), 47);
+        UT_EXPECT_EQ(CountIndexed(txn, 5), 5);
+        txn.Abort();
+    }
+}
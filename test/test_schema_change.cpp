@@ -778,3 +778,81 @@ TEST_F(TestSchemaChange, UpdateSchemaAndData) {
         UT_EXPECT_EQ(ret.size(), 6);
     }
 }
+
+TEST_F(TestSchemaChange, UpgradeRecords) {
+    using namespace lgraph;
+    std::string dir = "./testdb";
+    AutoCleanDir cleaner(dir);
+    CreateSampleDB(dir, true);
+    DBConfig conf;
+    conf.dir = dir;
+    LightningGraph graph(conf);
+
+    UT_LOG() << "Test fast alter leaves records as they are";
+    size_t n_changed = 1;
+    UT_EXPECT_TRUE(graph.AlterLabelAddFields(
+        "person", std::vector<FieldSpec>({FieldSpec("cond", FieldType::INT32, true)}),
+        std::vector<FieldData>({FieldData::Int32(7)}), true, &n_changed));
+    UT_EXPECT_EQ(n_changed, 0);
+    UT_EXPECT_TRUE(graph.AlterLabelDelFields("person", std::vector<std::string>({"desc"}), true,
+                                             &n_changed));
+    UT_EXPECT_EQ(n_changed, 0);
+    UT_EXPECT_TRUE(graph.AlterLabelModFields(
+        "person", std::vector<FieldSpec>({FieldSpec("age", FieldType::DOUBLE, true)}), true,
+        &n_changed));
+    UT_EXPECT_EQ(n_changed, 0);
+
+    UT_LOG() << "Test records are upgraded on write";
+    {
+        auto txn = graph.CreateWriteTxn();
+        auto vit = txn.GetVertexIterator(0);
+        txn.SetVertexProperty(vit, std::vector<std::string>({"name"}),
+                              std::vector<FieldData>({FieldData::String("p0")}));
+        txn.Commit();
+    }
+    size_t n_upgraded = 0;
+    UT_EXPECT_TRUE(graph.UpgradeLabelRecords(true, "person", 1, 0, &n_upgraded));
+    UT_EXPECT_EQ(n_upgraded, 1);
+    UT_EXPECT_TRUE(graph.UpgradeLabelRecords(true, "person", 1, 0, &n_upgraded));
+    UT_EXPECT_EQ(n_upgraded, 0);
+    {
+        auto txn = graph.CreateReadTxn();
+        auto fields = GetVertexFields(txn, 0);
+        UT_EXPECT_EQ(fields.size(), 6);
+        UT_EXPECT_EQ(fields["name"], FieldData::String("p0"));
+        UT_EXPECT_EQ(fields["age"], FieldData::Double(11.5));
+        UT_EXPECT_EQ(fields["cond"], FieldData::Int32(7));
+        UT_EXPECT_TRUE(fields.find("desc") == fields.end());
+        fields = GetVertexFields(txn, 1);
+        UT_EXPECT_EQ(fields.size(), 6);
+        UT_EXPECT_EQ(fields["name"], FieldData::String("p2"));
+        UT_EXPECT_EQ(fields["age"], FieldData::Double(12));
+        UT_EXPECT_EQ(fields["cond"], FieldData::Int32(7));
+        UT_EXPECT_EQ(fields["img2"].AsBlob(), std::string(8192, 'c'));
+    }
+
+    UT_LOG() << "Test upgrading edges in batches";
+    UT_EXPECT_TRUE(graph.AlterLabelAddFields(
+        "knows", std::vector<FieldSpec>({FieldSpec("note", FieldType::STRING, true)}),
+        std::vector<FieldData>({FieldData::String("n")}), false, &n_changed));
+    UT_EXPECT_EQ(n_changed, 0);
+    UT_EXPECT_TRUE(graph.UpgradeLabelRecords(false, "knows", 1, 1, &n_upgraded));
+    UT_EXPECT_EQ(n_upgraded, 4);
+    UT_EXPECT_TRUE(graph.UpgradeLabelRecords(false, "knows", 100, 0, &n_upgraded));
+    UT_EXPECT_EQ(n_upgraded, 0);
+    {
+        auto txn = graph.CreateReadTxn();
+        auto vit = txn.GetVertexIterator(0);
+        size_t n_edges = 0;
+        for (auto eit = vit.GetOutEdgeIterator(); eit.IsValid(); eit.Next()) {
+            UT_EXPECT_EQ(txn.GetEdgeField(eit, std::string("note")), FieldData::String("n"));
+            n_edges++;
+        }
+        for (auto eit = vit.GetInEdgeIterator(); eit.IsValid(); eit.Next()) {
+            UT_EXPECT_EQ(txn.GetEdgeField(eit, std::string("note")), FieldData::String("n"));
+            n_edges++;
+        }
+        UT_EXPECT_EQ(n_edges, 4);
+    }
+    UT_EXPECT_FALSE(graph.UpgradeLabelRecords(true, "no_such_label", 1, 0, &n_upgraded));
+}
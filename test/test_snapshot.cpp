@@ -20,6 +20,7 @@
 
 #include "db/galaxy.h"
 #include "db/db.h"
+#include "server/ha_snapshot.h"
 #include "./ut_utils.h"
 
 class TestSnapshot : public TuGraphTest {};
@@ -105,3 +106,40 @@ TEST_F(TestSnapshot, Snapshot) {
     fma_common::file_system::RemoveDir("./snap");
     fma_common::SleepS(1);  // waiting for memory reclaiming by async task
 }
+
+TEST_F(TestSnapshot, ChunkedSnapshot) {
+    using namespace lgraph;
+
+    { CreateTestDB(); }
+    {
+        Galaxy galaxy("./testdb");
+        auto split = [&](const std::string& dir) {
+            fma_common::file_system::RemoveDir(dir);
+            auto files = galaxy.SaveSnapshot(dir + "/_snapshot_", false);
+            return ha_snapshot::SplitIntoChunks(dir, files, 64 << 10);
+        };
+        auto chunks = split("./snap");
+        UT_EXPECT_GT(chunks.size(), 1);
+        for (auto& c : chunks) {
+            UT_EXPECT_EQ(c.name.find("_snapshot_/"), 0);
+            UT_EXPECT_FALSE(c.checksum.empty());
+        }
+        // nothing changed, so every chunk is the same
+        auto chunks2 = split("./snap2");
+        UT_EXPECT_EQ(chunks2.size(), chunks.size());
+        for (size_t i = 0; i < chunks.size(); i++) {
+            UT_EXPECT_EQ(chunks2[i].name, chunks[i].name);
+            UT_EXPECT_EQ(chunks2[i].checksum, chunks[i].checksum);
+        }
+        UT_EXPECT_TRUE(galaxy.LoadSnapshot("./snap/_snapshot_", ha_snapshot::RestoreSnapshot));
+        // the chunks are kept for the next install
+        UT_EXPECT_TRUE(fma_common::file_system::FileExists("./snap/" + chunks[0].name));
+        AccessControlledDB db = galaxy.OpenGraph("admin", "default");
+        auto txn = db.CreateReadTxn();
+        VertexIndexIterator iit = txn.GetVertexIndexIterator("v", "name", "v2", "v2");
+        UT_EXPECT_TRUE(iit.IsValid());
+    }
+    fma_common::file_system::RemoveDir("./snap");
+    fma_common::file_system::RemoveDir("./snap2");
+    fma_common::SleepS(1);  // waiting for memory reclaiming by async task
+}
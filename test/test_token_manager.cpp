@@ -15,6 +15,7 @@
 #include "fma-common/configuration.h"
 #include "gtest/gtest.h"
 
+#include "db/token_cache.h"
 #include "db/token_manager.h"
 #include "./test_tools.h"
 #include "./ut_utils.h"
@@ -52,3 +53,39 @@ TEST_F(TestTokenManager, TokenManager) {
     auto new_token = m.UpdateToken(tok2);
     UT_EXPECT_EQ(m.JudgeRefreshTime(new_token), true);
 }
+
+TEST_F(TestTokenManager, TokenCache) {
+    using lgraph::TokenCache;
+
+    TokenCache cache(TokenCache::DEFAULT_CAPACITY);
+    TokenCache::Entry entry;
+    UT_EXPECT_EQ(cache.Lookup("tok1", entry), false);
+    entry.user = "admin";
+    entry.is_admin = true;
+    entry.refresh_stamp = 1.0;
+    entry.epoch = cache.Epoch();
+    cache.Insert("tok1", entry);
+    TokenCache::Entry found;
+    UT_EXPECT_EQ(cache.Lookup("tok1", found), true);
+    UT_EXPECT_EQ(found.user, "admin");
+    UT_EXPECT_EQ(found.is_admin, true);
+    UT_EXPECT_EQ(found.refresh_stamp, 1.0);
+
+    UT_LOG() << "===Invalidating...";
+    // an entry validated before the invalidation must not become visible
+    uint64_t old_epoch = cache.Epoch();
+    cache.Invalidate();
+    UT_EXPECT_EQ(cache.Lookup("tok1", found), false);
+    entry.epoch = old_epoch;
+    cache.Insert("tok2", entry);
+    UT_EXPECT_EQ(cache.Lookup("tok2", found), false);
+
+    UT_LOG() << "===Evicting...";
+    TokenCache small(64);
+    for (int i = 0; i < 1000; i++) {
+        entry.epoch = small.Epoch();
+        small.Insert("tok" + std::to_string(i), entry);
+    }
+    UT_EXPECT_LE(small.Size(), 64);
+    UT_EXPECT_EQ(small.Lookup("tok999", found), true);
+}
@@ -13,6 +13,8 @@
  */
 
 #include <condition_variable>
+#include <filesystem>
+#include <future>
 #include <mutex>
 #include "fma-common/configuration.h"
 #include "gtest/gtest.h"
@@ -78,3 +80,60 @@ TEST_F(TestTxnFork, Fork) {
         reader.join();
     }
 }
+
+TEST_F(TestTxnFork, SnapshotRead) {
+    using namespace lgraph;
+    DBConfig db_config;
+    db_config.dir = "./testdb";
+    AutoCleanDir _(db_config.dir);
+    LightningGraph db(db_config);
+    db.AddLabel("v", {FieldSpec("id", FieldType::STRING, false)}, true, VertexOptions("id"));
+    auto add_vertices = [&](size_t n, const std::string& prefix) {
+        auto txn = db.CreateWriteTxn();
+        for (size_t i = 0; i < n; i++) {
+            txn.AddVertex(std::string("v"), std::vector<std::string>({"id"}),
+                          std::vector<std::string>({prefix + std::to_string(i)}));
+        }
+        txn.Commit();
+    };
+    auto count_vertices = [](Transaction& txn) {
+        size_t n = 0;
+        for (auto it = txn.GetVertexIterator(); it.IsValid(); it.Next()) n++;
+        return n;
+    };
+    add_vertices(10, "a");
+    // a long reader of a copy keeps reading the state it started with, while others write
+    std::promise<void> started, written;
+    std::thread reader([&]() {
+        auto txn = db.CreateSnapshotReadTxn();
+        UT_EXPECT_EQ(count_vertices(txn), 10);
+        // a fork reads the same copy
+        std::thread forked([&]() {
+            auto fork = db.ForkTxn(txn);
+            UT_EXPECT_EQ(count_vertices(fork), 10);
+        });
+        forked.join();
+        started.set_value();
+        written.get_future().wait();
+        UT_EXPECT_EQ(count_vertices(txn), 10);
+    });
+    started.get_future().wait();
+    add_vertices(100, "b");
+    // the reader reads the copy, not the store
+    UT_EXPECT_EQ(db.GetSpaceStat().readers, 0);
+    written.set_value();
+    reader.join();
+    {
+        auto txn = db.CreateSnapshotReadTxn(0);
+        UT_EXPECT_EQ(count_vertices(txn), 110);
+    }
+    // making a copy waits for the writer, which would be this very thread
+    {
+        auto txn = db.CreateWriteTxn();
+        UT_EXPECT_THROW_CODE(db.CreateSnapshotReadTxn(0), InternalError);
+        txn.Abort();
+    }
+    // a copy is deleted with the last txn reading it
+    std::string snapshot_dir = db_config.dir + "/" + _detail::READ_SNAPSHOT_DIR;
+    UT_EXPECT_TRUE(std::filesystem::is_empty(snapshot_dir));
+}
@@ -412,10 +412,67 @@ int TestVRefreshContentIfKvIteratorModified() {
     return 0;
 }
 
+int TestVertexIndexSeek() {
+    auto store = std::make_unique<LMDBKvStore>("./testdb", (size_t)1 << 30, true);
+    auto txn = store->CreateWriteTxn();
+    store->DropAll(*txn);
+    txn->Commit();
+    // NonuniqueIndex, even keys with two vids each
+    {
+        txn = store->CreateWriteTxn();
+        auto idx_tab = VertexIndex::OpenTable(*txn, *store, "seek_nonunique", FieldType::INT32,
+                                              lgraph::IndexType::NonuniqueIndex);
+        VertexIndex idx(std::move(idx_tab), FieldType::INT32, lgraph::IndexType::NonuniqueIndex);
+        for (int32_t k = 0; k < 100; k += 2) {
+            UT_EXPECT_TRUE(idx.Add(*txn, Value::ConstRef(k), k * 10));
+            UT_EXPECT_TRUE(idx.Add(*txn, Value::ConstRef(k), k * 10 + 1));
+        }
+        txn->Commit();
+        txn = store->CreateReadTxn();
+        auto it = idx.GetUnmanagedIterator(*txn, Value::ConstRef(0), Value::ConstRef(0));
+        UT_EXPECT_TRUE(it.IsValid());
+        UT_EXPECT_TRUE(it.Seek(Value::ConstRef(4)));
+        UT_EXPECT_EQ(it.GetVid(), 40);
+        UT_EXPECT_TRUE(it.Next());
+        UT_EXPECT_EQ(it.GetVid(), 41);
+        UT_EXPECT_TRUE(!it.Next());
+        UT_EXPECT_TRUE(!it.Seek(Value::ConstRef(5)));
+        UT_EXPECT_TRUE(!it.IsValid());
+        // seeking backwards works too
+        UT_EXPECT_TRUE(it.Seek(Value::ConstRef(2)));
+        UT_EXPECT_EQ(it.GetVid(), 20);
+        UT_EXPECT_TRUE(it.Seek(Value::ConstRef(98)));
+        UT_EXPECT_EQ(it.GetVid(), 980);
+        UT_EXPECT_TRUE(!it.Seek(Value::ConstRef(100)));
+        txn->Abort();
+    }
+    // GlobalUniqueIndex
+    {
+        txn = store->CreateWriteTxn();
+        auto idx_tab = VertexIndex::OpenTable(*txn, *store, "seek_unique", FieldType::STRING,
+                                              lgraph::IndexType::GlobalUniqueIndex);
+        VertexIndex idx(std::move(idx_tab), FieldType::STRING,
+                        lgraph::IndexType::GlobalUniqueIndex);
+        UT_EXPECT_TRUE(idx.Add(*txn, Value::ConstRef("a"), 1));
+        UT_EXPECT_TRUE(idx.Add(*txn, Value::ConstRef("c"), 3));
+        txn->Commit();
+        txn = store->CreateReadTxn();
+        auto it = idx.GetUnmanagedIterator(*txn, Value::ConstRef("a"), Value::ConstRef("a"));
+        UT_EXPECT_TRUE(it.IsValid());
+        UT_EXPECT_TRUE(!it.Seek(Value::ConstRef("b")));
+        UT_EXPECT_TRUE(it.Seek(Value::ConstRef("c")));
+        UT_EXPECT_EQ(it.GetVid(), 3);
+        UT_EXPECT_TRUE(!it.Next());
+        txn->Abort();
+    }
+    return 0;
+}
+
 TEST_F(TestVertexIndex, VertexIndex) {
     TestVertexIndexImpl();
     CURDVertexWithTooLongKey();
     TestVRefreshContentIfKvIteratorModified();
+    TestVertexIndexSeek();
 }
 
 TEST_F(TestVertexIndex, addIndexDetach) {
@@ -495,6 +552,27 @@ TEST_F(TestVertexIndex, addIndexDetach) {
             i++;
         }
     }
+    // reverse
+    {
+        int32_t i = 99999;
+        for (auto iter = txn.GetVertexIndexIterator("v1", "int32", FieldData(), FieldData(), true);
+             iter.IsValid(); iter.Next()) {
+            UT_EXPECT_TRUE(iter.GetKeyData() == FieldData::Int32(i));
+            UT_EXPECT_TRUE(iter.GetVid() == i);
+            i--;
+        }
+        UT_EXPECT_EQ(i, -1);
+    }
+    {
+        int32_t i = 500;
+        for (auto iter = txn.GetVertexIndexIterator("v1", "string", FieldData::String("00100"),
+                                                    FieldData::String("00500"), true);
+             iter.IsValid(); iter.Next()) {
+            UT_EXPECT_TRUE(iter.GetVid() == i);
+            i--;
+        }
+        UT_EXPECT_EQ(i, 99);
+    }
 
     // edge
     {
@@ -21,12 +21,18 @@
 int main(int argc, char** argv) {
     std::string dir;
     std::string graph_list = "default";
+    std::string label_list;
+    bool indexes_only = false;
 
     fma_common::Configuration config;
     config.ExitAfterHelp(true);
     config.Add(dir, "d,directory", false).Comment("Data directory");
     config.Add(graph_list, "g,graph_list", true)
         .Comment("List of graphs to warmup, separated with commas");
+    config.Add(label_list, "l,label_list", true)
+        .Comment("List of labels to warmup, separated with commas. All data if empty");
+    config.Add(indexes_only, "indexes_only", true)
+        .Comment("Only warmup the indexes of the labels, or of all labels if none is given");
     try {
         config.ParseAndFinalize(argc, argv);
     } catch (std::exception& e) {
@@ -34,12 +40,15 @@ int main(int argc, char** argv) {
         return -1;
     }
     std::vector<std::string> graphs = fma_common::Split(graph_list, ",");
+    std::vector<std::string> labels;
+    if (!label_list.empty()) labels = fma_common::Split(label_list, ",");
 
     double t1 = fma_common::GetTime();
     LOG_INFO() << "Warming up data in [" << dir << "]";
     LOG_INFO() << "Graph list: " << fma_common::ToString(graphs);
+    if (!labels.empty()) LOG_INFO() << "Label list: " << fma_common::ToString(labels);
     lgraph::Galaxy g(dir, false);
-    g.WarmUp("admin", graphs);
+    g.WarmUp("admin", graphs, labels, indexes_only);
     double t2 = fma_common::GetTime();
     LOG_INFO() << "Warm up successful in " << t2 - t1 << " seconds.";
     return 0;